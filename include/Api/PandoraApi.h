@@ -23,6 +23,13 @@ class PandoraApi
 {
 public:
     /* Map object creation into PandoraApi */
+
+    /**
+     *  @brief  Calo hit creation. ATTN CaloHit::Create returns success once a calo hit is created and added to the input list, but its
+     *          pseudo layer is assigned later, together with those of all other calo hits in the event, when the event is processed.
+     *          A calo hit for which the pseudo layer plugin fails is then removed from the input list and deleted, before any calo
+     *          hits are matched to mc particles. The number of calo hits rejected in this way is given by GetNRejectedCaloHits.
+     */
     typedef object_creation::CaloHit CaloHit;
     typedef object_creation::MCParticle MCParticle;
     typedef object_creation::Track Track;
@@ -145,6 +152,23 @@ public:
      */
     static pandora::StatusCode GetPfoList(const pandora::Pandora &pandora, const std::string &pfoListName, const pandora::PfoList *&pPfoList);
 
+    /**
+     *  @brief  Get the cross-event pseudo layer cache, e.g. to inspect its size and hit-rate statistics
+     * 
+     *  @param  pandora the pandora instance to get the cache from
+     *  @param  pPseudoLayerCache to receive the address of the pseudo layer cache
+     */
+    static pandora::StatusCode GetPseudoLayerCache(const pandora::Pandora &pandora, const pandora::PseudoLayerCache *&pPseudoLayerCache);
+
+    /**
+     *  @brief  Get the number of calo hits created for the current event, but rejected when their pseudo layers were assigned, so
+     *          absent from the input calo hit list
+     * 
+     *  @param  pandora the pandora instance
+     *  @param  nRejectedCaloHits to receive the number of rejected calo hits
+     */
+    static pandora::StatusCode GetNRejectedCaloHits(const pandora::Pandora &pandora, unsigned int &nRejectedCaloHits);
+
     /**
      *  @brief  Set the external parameters associated with an algorithm instance of a specific type. It is enforced that there
      *          be only a single instance of an externally-configured algorithm, per algorithm type, per Pandora instance
@@ -120,6 +120,20 @@ private:
      */
     StatusCode GetPfoList(const std::string &pfoListName, const PfoList *&pPfoList) const;
 
+    /**
+     *  @brief  Get the cross-event pseudo layer cache
+     * 
+     *  @param  pPseudoLayerCache to receive the address of the pseudo layer cache
+     */
+    StatusCode GetPseudoLayerCache(const PseudoLayerCache *&pPseudoLayerCache) const;
+
+    /**
+     *  @brief  Get the number of calo hits rejected when their pseudo layers were assigned
+     * 
+     *  @param  nRejectedCaloHits to receive the number of rejected calo hits
+     */
+    StatusCode GetNRejectedCaloHits(unsigned int &nRejectedCaloHits) const;
+
     /**
      *  @brief  Set the granularity level to be associated with a specified hit type
      * 
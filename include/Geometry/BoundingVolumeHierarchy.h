@@ -0,0 +1,248 @@
+/**
+ *  @file   PandoraSDK/include/Geometry/BoundingVolumeHierarchy.h
+ * 
+ *  @brief  Header file for the bounding volume hierarchy class.
+ * 
+ *  $Log: $
+ */
+#ifndef PANDORA_BOUNDING_VOLUME_HIERARCHY_H
+#define PANDORA_BOUNDING_VOLUME_HIERARCHY_H 1
+
+#include "Objects/CartesianVector.h"
+
+#include "Pandora/PandoraInternal.h"
+
+#include <algorithm>
+
+namespace pandora
+{
+
+/**
+ *  @brief  BoundingVolumeHierarchy class, a binary tree of axis-aligned bounding boxes over a fixed list of items (e.g. detector gaps
+ *          or volumes), built once by median splits, for finding the items whose boxes contain a position or overlap a box
+ */
+class BoundingVolumeHierarchy
+{
+public:
+    /**
+     *  @brief  BoundingBox class, an axis-aligned box, which may grow with the tolerance of a query
+     */
+    class BoundingBox
+    {
+    public:
+        /**
+         *  @brief  Default constructor, creating an empty box
+         */
+        BoundingBox();
+
+        /**
+         *  @brief  Extend the box to contain another box
+         * 
+         *  @param  rhs the other box
+         */
+        void Extend(const BoundingBox &rhs);
+
+        /**
+         *  @brief  Extend the box to contain a point
+         * 
+         *  @param  x the point x coordinate
+         *  @param  y the point y coordinate
+         *  @param  z the point z coordinate
+         */
+        void Extend(const float x, const float y, const float z);
+
+        /**
+         *  @brief  Pad the box, by a small fraction of its largest coordinate magnitude, to allow for rounding in exact item tests
+         */
+        void Pad();
+
+        /**
+         *  @brief  Whether the box, expanded by a margin, contains a position
+         * 
+         *  @param  positionVector the position vector
+         *  @param  margin the margin
+         * 
+         *  @return boolean
+         */
+        bool Contains(const CartesianVector &positionVector, const float margin) const;
+
+        /**
+         *  @brief  Whether the box, expanded by a margin, overlaps another box
+         * 
+         *  @param  rhs the other box
+         *  @param  margin the margin
+         * 
+         *  @return boolean
+         */
+        bool Overlaps(const BoundingBox &rhs, const float margin) const;
+
+        float           m_min[3];           ///< The minimum x, y and z coordinates
+        float           m_max[3];           ///< The maximum x, y and z coordinates
+        float           m_toleranceScale;   ///< The growth of the box, along any axis, per unit query tolerance
+    };
+
+    typedef std::vector<BoundingBox> BoundingBoxVector;
+
+    /**
+     *  @brief  Default constructor, creating an empty hierarchy
+     */
+    BoundingVolumeHierarchy();
+
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  boundingBoxes the bounding boxes of the items, the item index being the position in this vector
+     */
+    BoundingVolumeHierarchy(const BoundingBoxVector &boundingBoxes);
+
+    /**
+     *  @brief  Whether the hierarchy holds no items
+     * 
+     *  @return boolean
+     */
+    bool IsEmpty() const;
+
+    /**
+     *  @brief  Visit the items whose boxes, expanded by the tolerance times the box tolerance scale, contain a position. A negative
+     *          tolerance shrinks each item box, which is exact only for items that shrink by the tolerance along every axis (e.g. lar
+     *          tpcs); where an exact item test follows, pass a tolerance of at least zero.
+     * 
+     *  @param  positionVector the position vector
+     *  @param  tolerance the query tolerance, which may be negative
+     *  @param  visitor the visitor, called with each item index, returning true to end the search
+     * 
+     *  @return whether the search was ended by the visitor
+     */
+    template <typename VISITOR>
+    bool VisitContaining(const CartesianVector &positionVector, const float tolerance, VISITOR &&visitor) const;
+
+    /**
+     *  @brief  Visit the items whose boxes, expanded by the tolerance times the box tolerance scale, overlap a box. A negative
+     *          tolerance shrinks each item box, as for VisitContaining.
+     * 
+     *  @param  boundingBox the box
+     *  @param  tolerance the query tolerance, which may be negative
+     *  @param  visitor the visitor, called with each item index
+     */
+    template <typename VISITOR>
+    void VisitOverlapping(const BoundingBox &boundingBox, const float tolerance, VISITOR &&visitor) const;
+
+private:
+    /**
+     *  @brief  Node class, a node of the hierarchy
+     */
+    class Node
+    {
+    public:
+        BoundingBox     m_boundingBox;      ///< The box containing all items beneath the node
+        unsigned int    m_begin;            ///< The position of the first item beneath the node, in the leaf order
+        unsigned int    m_end;              ///< The position beyond the last item beneath the node, in the leaf order
+        unsigned int    m_firstChild;       ///< The index of the first child node (the second child follows it), if not a leaf node
+        bool            m_isLeaf;           ///< Whether the node is a leaf node
+    };
+
+    typedef std::vector<Node> NodeVector;
+
+    /**
+     *  @brief  Fill a node, containing a range of the items in the leaf order, and create its descendants
+     * 
+     *  @param  nodeIndex the index of the node, already added to the node vector
+     *  @param  begin the position of the first item of the range in the leaf order
+     *  @param  end the position beyond the last item of the range in the leaf order
+     */
+    void BuildNode(const unsigned int nodeIndex, const unsigned int begin, const unsigned int end);
+
+    static const unsigned int   MAX_ITEMS_PER_LEAF; ///< The maximum number of items in a leaf node
+    static const unsigned int   MAX_DEPTH = 64;     ///< The maximum hierarchy depth (median splits bound it by log2 of the item count)
+
+    BoundingBoxVector           m_boundingBoxes;    ///< The bounding boxes of the items, in the leaf order
+    UIntVector                  m_itemIndices;      ///< The item indices, in the leaf order
+    NodeVector                  m_nodes;            ///< The nodes, the first being the root
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool BoundingVolumeHierarchy::IsEmpty() const
+{
+    return m_nodes.empty();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename VISITOR>
+inline bool BoundingVolumeHierarchy::VisitContaining(const CartesianVector &positionVector, const float tolerance, VISITOR &&visitor) const
+{
+    if (m_nodes.empty())
+        return false;
+
+    // ATTN Node boxes are not shrunk by a negative tolerance: a node tolerance scale is the largest of its items, so would shrink it
+    // by more than some of the item boxes it must contain
+    const float nodeTolerance(std::max(tolerance, 0.f));
+    unsigned int nodeStack[MAX_DEPTH], stackSize(0);
+    nodeStack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const Node &node(m_nodes[nodeStack[--stackSize]]);
+
+        if (!node.m_boundingBox.Contains(positionVector, nodeTolerance * node.m_boundingBox.m_toleranceScale))
+            continue;
+
+        if (!node.m_isLeaf)
+        {
+            nodeStack[stackSize++] = node.m_firstChild + 1;
+            nodeStack[stackSize++] = node.m_firstChild;
+            continue;
+        }
+
+        for (unsigned int position = node.m_begin; position < node.m_end; ++position)
+        {
+            const BoundingBox &boundingBox(m_boundingBoxes[position]);
+
+            if (boundingBox.Contains(positionVector, tolerance * boundingBox.m_toleranceScale) && visitor(m_itemIndices[position]))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename VISITOR>
+inline void BoundingVolumeHierarchy::VisitOverlapping(const BoundingBox &queryBoundingBox, const float tolerance, VISITOR &&visitor) const
+{
+    if (m_nodes.empty())
+        return;
+
+    const float nodeTolerance(std::max(tolerance, 0.f));
+    unsigned int nodeStack[MAX_DEPTH], stackSize(0);
+    nodeStack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const Node &node(m_nodes[nodeStack[--stackSize]]);
+
+        if (!node.m_boundingBox.Overlaps(queryBoundingBox, nodeTolerance * node.m_boundingBox.m_toleranceScale))
+            continue;
+
+        if (!node.m_isLeaf)
+        {
+            nodeStack[stackSize++] = node.m_firstChild + 1;
+            nodeStack[stackSize++] = node.m_firstChild;
+            continue;
+        }
+
+        for (unsigned int position = node.m_begin; position < node.m_end; ++position)
+        {
+            const BoundingBox &boundingBox(m_boundingBoxes[position]);
+
+            if (boundingBox.Overlaps(queryBoundingBox, tolerance * boundingBox.m_toleranceScale))
+                visitor(m_itemIndices[position]);
+        }
+    }
+}
+
+} // namespace pandora
+
+#endif // #ifndef PANDORA_BOUNDING_VOLUME_HIERARCHY_H
@@ -8,6 +8,8 @@
 #ifndef PANDORA_DETECTOR_GAP_H
 #define PANDORA_DETECTOR_GAP_H 1
 
+#include "Geometry/RegularPolygon.h"
+
 #include "Pandora/ObjectCreation.h"
 
 namespace pandora
@@ -39,6 +41,34 @@ public:
      *  @return boolean
      */
     virtual bool IsInGap(const CartesianVector &positionVector, const HitType hitType, const float gapTolerance = 0.f) const = 0;
+
+    /**
+     *  @brief  Whether each of a list of positions, provided as separate coordinate arrays, lies within the gap. The default
+     *          implementation tests each position in turn.
+     * 
+     *  @param  xCoordinates the position x coordinates
+     *  @param  yCoordinates the position y coordinates
+     *  @param  zCoordinates the position z coordinates
+     *  @param  hitType the hit type, providing context to aid interpretation of provided positions
+     *  @param  gapTolerance tolerance allowed when declaring a point to be "in" a gap region, units mm
+     *  @param  isInGapVector to receive, for each position, whether it lies within the gap
+     */
+    virtual void IsInGap(const FloatVector &xCoordinates, const FloatVector &yCoordinates, const FloatVector &zCoordinates,
+        const HitType hitType, const float gapTolerance, BoolVector &isInGapVector) const;
+
+protected:
+    /**
+     *  @brief  Get the number of positions provided as separate coordinate arrays, checking that the array sizes agree
+     * 
+     *  @param  xCoordinates the position x coordinates
+     *  @param  yCoordinates the position y coordinates
+     *  @param  zCoordinates the position z coordinates
+     * 
+     *  @return the number of positions
+     */
+    static unsigned int GetNPositions(const FloatVector &xCoordinates, const FloatVector &yCoordinates, const FloatVector &zCoordinates);
+
+    static const unsigned int   BLOCK_SIZE = 256;   ///< The number of positions tested together in the batch gap tests
 };
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -50,6 +80,8 @@ class LineGap : public DetectorGap
 {
 public:
     bool IsInGap(const CartesianVector &positionVector, const HitType hitType, const float gapTolerance) const;
+    void IsInGap(const FloatVector &xCoordinates, const FloatVector &yCoordinates, const FloatVector &zCoordinates,
+        const HitType hitType, const float gapTolerance, BoolVector &isInGapVector) const;
 
     /**
      *  @brief  Get the line gap type
@@ -112,6 +144,8 @@ class BoxGap : public DetectorGap
 {
 public:
     bool IsInGap(const CartesianVector &positionVector, const HitType hitType, const float gapTolerance) const;
+    void IsInGap(const FloatVector &xCoordinates, const FloatVector &yCoordinates, const FloatVector &zCoordinates,
+        const HitType hitType, const float gapTolerance, BoolVector &isInGapVector) const;
 
     /**
      *  @brief  Get the gap vertex
@@ -166,6 +200,8 @@ class ConcentricGap : public DetectorGap
 {
 public:
     bool IsInGap(const CartesianVector &positionVector, const HitType hitType, const float gapTolerance) const;
+    void IsInGap(const FloatVector &xCoordinates, const FloatVector &yCoordinates, const FloatVector &zCoordinates,
+        const HitType hitType, const float gapTolerance, BoolVector &isInGapVector) const;
 
     /**
      *  @brief  Get the min cylindrical polar z coordinate, origin interaction point
@@ -231,29 +267,6 @@ private:
      */
     ConcentricGap(const object_creation::Geometry::ConcentricGap::Parameters &parameters);
 
-    /**
-     *  @brief  Populate list of polygon vertices, assuming regular polygon in XY plane at constant z coordinate
-     * 
-     *  @brief  rCoordinate polygon r coordinate
-     *  @brief  zCoordinate polygon z coordinate
-     *  @brief  phiCoordinate polygon phi coordinate
-     *  @brief  symmetryOrder polygon symmetry order
-     *  @param  vertexPointList to receive the vertex point list, with vertexPointList[symmetryOrder] = vertexPointList[0]
-     */
-    void GetPolygonVertices(const float rCoordinate, const float zCoordinate, const float phiCoordinate,
-        const unsigned int symmetryOrder, VertexPointList &vertexPointList) const;
-
-    /**
-     *  @brief  Winding number test for a point in a 2D polygon in the XY plane (z coordinates are ignored)
-     * 
-     *  @param  point the test point
-     *  @param  vertexPointList vertex points of a polygon, with vertexPointList[symmetryOrder] = vertexPointList[0]
-     *  @param  symmetryOrder order of symmetry of polygon
-     * 
-     *  @return whether point is inside polygon
-     */
-    bool IsIn2DPolygon(const CartesianVector &point, const VertexPointList &vertexPointList, const unsigned int symmetryOrder) const;
-
     const float             m_minZCoordinate;       ///< Min cylindrical polar z coordinate, origin interaction point, units mm
     const float             m_maxZCoordinate;       ///< Max cylindrical polar z coordinate, origin interaction point, units mm
     const float             m_innerRCoordinate;     ///< Inner cylindrical polar r coordinate, origin interaction point, units mm
@@ -263,8 +276,8 @@ private:
     const float             m_outerPhiCoordinate;   ///< Outer cylindrical polar phi coordinate (angle wrt cartesian x axis)
     const unsigned int      m_outerSymmetryOrder;   ///< Order of symmetry of the outermost edge of gap
 
-    VertexPointList         m_innerVertexPointList; ///< The vertex points of the inner polygon
-    VertexPointList         m_outerVertexPointList; ///< The vertex points of the outer polygon
+    const RegularPolygon    m_innerPolygon;         ///< The edge table of the innermost edge of gap
+    const RegularPolygon    m_outerPolygon;         ///< The edge table of the outermost edge of gap
 
     friend class PandoraObjectFactory<object_creation::Geometry::ConcentricGap::Parameters, object_creation::Geometry::ConcentricGap::Object>;
 };
@@ -0,0 +1,186 @@
+/**
+ *  @file   PandoraSDK/include/Geometry/DetectorGapIndex.h
+ * 
+ *  @brief  Header file for the detector gap index class.
+ * 
+ *  $Log: $
+ */
+#ifndef PANDORA_DETECTOR_GAP_INDEX_H
+#define PANDORA_DETECTOR_GAP_INDEX_H 1
+
+#include "Geometry/BoundingVolumeHierarchy.h"
+
+#include "Pandora/PandoraEnumeratedTypes.h"
+#include "Pandora/PandoraInternal.h"
+
+namespace pandora
+{
+
+/**
+ *  @brief  DetectorGapIndex class, a spatial index over a list of detector gaps, built once for a fixed gap list. Line gaps are held
+ *          as sorted interval tables (z intervals for each wire gap view, x intervals for drift gaps), so that a query is a binary
+ *          search. Box and concentric gaps are held in a bounding volume hierarchy, so that only gaps whose bounding boxes contain
+ *          a query position are tested with DetectorGap::IsInGap. Gaps of any other (e.g. user-derived) type are tested in turn.
+ */
+class DetectorGapIndex
+{
+public:
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  detectorGapList the list of detector gaps to index
+     */
+    DetectorGapIndex(const DetectorGapList &detectorGapList);
+
+    /**
+     *  @brief  Whether a specified position lies within any of the indexed gaps. Equivalent to testing each gap with
+     *          DetectorGap::IsInGap, except that an exception is raised whenever any gap does not accept the hit type
+     * 
+     *  @param  positionVector the position vector
+     *  @param  hitType the hit type, providing context to aid interpretation of provided position vector
+     *  @param  gapTolerance tolerance allowed when declaring a point to be "in" a gap region, units mm
+     * 
+     *  @return boolean
+     */
+    bool IsInGap(const CartesianVector &positionVector, const HitType hitType, const float gapTolerance) const;
+
+    /**
+     *  @brief  Whether each of a list of positions, provided as separate coordinate arrays, lies within any of the indexed gaps. Line
+     *          gaps are looked up position by position. Positions are divided into consecutive blocks, and each block is tested with
+     *          the batch DetectorGap::IsInGap against the box and concentric gaps whose bounding boxes overlap its own, so this is best
+     *          suited to ordered, spatially compact lists of positions, e.g. sampling points along a cluster trajectory. Gaps of other
+     *          types are tested with the batch DetectorGap::IsInGap for all positions.
+     * 
+     *  @param  xCoordinates the position x coordinates
+     *  @param  yCoordinates the position y coordinates
+     *  @param  zCoordinates the position z coordinates
+     *  @param  hitType the hit type, providing context to aid interpretation of provided positions
+     *  @param  gapTolerance tolerance allowed when declaring a point to be "in" a gap region, units mm
+     *  @param  isInGapVector to receive, for each position, whether it lies within any gap
+     */
+    void IsInGap(const FloatVector &xCoordinates, const FloatVector &yCoordinates, const FloatVector &zCoordinates, const HitType hitType,
+        const float gapTolerance, BoolVector &isInGapVector) const;
+
+private:
+    /**
+     *  @brief  IntervalTable class, a table of intervals sorted by start coordinate, with the running maximum end coordinate
+     */
+    class IntervalTable
+    {
+    public:
+        /**
+         *  @brief  Add an interval to the table
+         * 
+         *  @param  start the interval start coordinate
+         *  @param  end the interval end coordinate
+         */
+        void AddInterval(const float start, const float end);
+
+        /**
+         *  @brief  Sort the intervals and fill the running maximum end coordinates, to be called once all intervals are added
+         */
+        void Build();
+
+        /**
+         *  @brief  Whether a coordinate lies within any interval, with the same comparisons as LineGap::IsInGap
+         * 
+         *  @param  coordinate the coordinate
+         *  @param  gapTolerance the gap tolerance
+         * 
+         *  @return boolean
+         */
+        bool Contains(const float coordinate, const float gapTolerance) const;
+
+    private:
+        FloatVector     m_starts;           ///< The interval start coordinates, in ascending order
+        FloatVector     m_ends;             ///< The interval end coordinates, ordered as the start coordinates
+        FloatVector     m_maxEnds;          ///< The maximum end coordinate of each interval and all intervals preceding it
+    };
+
+    typedef BoundingVolumeHierarchy::BoundingBox BoundingBox;
+
+    /**
+     *  @brief  Get the bounding box of a box gap
+     * 
+     *  @param  pBoxGap address of the box gap
+     *  @param  boundingBox to receive the bounding box
+     * 
+     *  @return whether the gap is bounded (i.e. its sides are linearly independent)
+     */
+    static bool GetBoundingBox(const BoxGap *const pBoxGap, BoundingBox &boundingBox);
+
+    /**
+     *  @brief  Get the bounding box of a concentric gap
+     * 
+     *  @param  pConcentricGap address of the concentric gap
+     *  @param  boundingBox to receive the bounding box
+     * 
+     *  @return whether the gap is bounded (i.e. its outer polygon has at least three sides)
+     */
+    static bool GetBoundingBox(const ConcentricGap *const pConcentricGap, BoundingBox &boundingBox);
+
+    /**
+     *  @brief  Whether a position lies within any of the gaps in the bounding volume hierarchy
+     * 
+     *  @param  positionVector the position vector
+     *  @param  hitType the hit type
+     *  @param  gapTolerance the gap tolerance
+     * 
+     *  @return boolean
+     */
+    bool IsInVolumeGap(const CartesianVector &positionVector, const HitType hitType, const float gapTolerance) const;
+
+    /**
+     *  @brief  Test a block of positions against the box and concentric gaps whose bounding boxes overlap that of the block
+     * 
+     *  @param  xCoordinates the block position x coordinates
+     *  @param  yCoordinates the block position y coordinates
+     *  @param  zCoordinates the block position z coordinates
+     *  @param  hitType the hit type
+     *  @param  gapTolerance the gap tolerance
+     *  @param  offset the index of the first block position in the full list of positions
+     *  @param  isInThisGapVector scratch vector, reused across calls, to receive the results for each individual gap
+     *  @param  isInGapVector the vector, for the full list of positions, in which to mark positions found to lie within a gap
+     */
+    void MarkPositionsInVolumeGaps(const FloatVector &xCoordinates, const FloatVector &yCoordinates, const FloatVector &zCoordinates,
+        const HitType hitType, const float gapTolerance, const unsigned int offset, BoolVector &isInThisGapVector,
+        BoolVector &isInGapVector) const;
+
+    /**
+     *  @brief  Check that the hit type is accepted by all of the indexed gaps
+     * 
+     *  @param  hitType the hit type
+     */
+    void CheckHitType(const HitType hitType) const;
+
+    /**
+     *  @brief  Test a list of positions against a gap with the batch DetectorGap::IsInGap, marking those found to lie within it
+     * 
+     *  @param  pDetectorGap address of the detector gap
+     *  @param  xCoordinates the position x coordinates
+     *  @param  yCoordinates the position y coordinates
+     *  @param  zCoordinates the position z coordinates
+     *  @param  hitType the hit type
+     *  @param  gapTolerance the gap tolerance
+     *  @param  offset the index of the first provided position in the vector of marks
+     *  @param  isInThisGapVector scratch vector, reused across calls, to receive the results for this gap
+     *  @param  isInGapVector the vector in which to mark positions found to lie within the gap
+     */
+    static void MarkPositionsInGap(const DetectorGap *const pDetectorGap, const FloatVector &xCoordinates, const FloatVector &yCoordinates,
+        const FloatVector &zCoordinates, const HitType hitType, const float gapTolerance, const unsigned int offset,
+        BoolVector &isInThisGapVector, BoolVector &isInGapVector);
+
+    static const unsigned int   POSITIONS_PER_BLOCK;    ///< The number of positions tested together against the box and concentric gaps
+
+    IntervalTable               m_wireGapIntervals[3];  ///< The z intervals of the wire gaps, for the u, v and w views
+    IntervalTable               m_driftGapIntervals;    ///< The x intervals of the drift gaps
+    bool                        m_hasLineGaps;          ///< Whether any line gaps are indexed
+    bool                        m_hasVolumeGaps;        ///< Whether any box or concentric gaps are indexed
+    DetectorGapVector           m_volumeGaps;           ///< The bounded box and concentric gaps
+    BoundingVolumeHierarchy     m_volumeGapHierarchy;   ///< The bounding volume hierarchy over the bounded box and concentric gaps
+    DetectorGapVector           m_otherGaps;            ///< Gaps of other types, and unbounded gaps, tested in turn
+};
+
+} // namespace pandora
+
+#endif // #ifndef PANDORA_DETECTOR_GAP_INDEX_H
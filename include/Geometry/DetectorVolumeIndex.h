@@ -0,0 +1,92 @@
+/**
+ *  @file   PandoraSDK/include/Geometry/DetectorVolumeIndex.h
+ * 
+ *  @brief  Header file for the detector volume index class.
+ * 
+ *  $Log: $
+ */
+#ifndef PANDORA_DETECTOR_VOLUME_INDEX_H
+#define PANDORA_DETECTOR_VOLUME_INDEX_H 1
+
+#include "Geometry/BoundingVolumeHierarchy.h"
+
+#include "Pandora/PandoraInternal.h"
+
+namespace pandora
+{
+
+/**
+ *  @brief  DetectorVolumeIndex class, a spatial index over the lar tpcs and sub detectors, built once for fixed lists, so that the
+ *          volumes containing a position are found without testing every volume
+ */
+class DetectorVolumeIndex
+{
+public:
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  larTPCMap the map from volume id to lar tpc
+     *  @param  subDetectorMap the map from name to sub detector
+     */
+    DetectorVolumeIndex(const LArTPCMap &larTPCMap, const SubDetectorMap &subDetectorMap);
+
+    /**
+     *  @brief  Get the lar tpc containing a position, i.e. whose box, expanded by a tolerance on each side, contains the position
+     * 
+     *  @param  positionVector the position vector
+     *  @param  tolerance the tolerance, units mm
+     * 
+     *  @return address of the containing lar tpc with the lowest volume id, or nullptr if no lar tpc contains the position
+     */
+    const LArTPC *GetContainingLArTPC(const CartesianVector &positionVector, const float tolerance) const;
+
+    /**
+     *  @brief  Get all lar tpcs containing a position, i.e. whose boxes, expanded by a tolerance on each side, contain the position
+     * 
+     *  @param  positionVector the position vector
+     *  @param  tolerance the tolerance, units mm
+     *  @param  larTPCVector to receive the addresses of the containing lar tpcs, in order of volume id
+     */
+    void GetContainingLArTPCs(const CartesianVector &positionVector, const float tolerance, LArTPCVector &larTPCVector) const;
+
+    /**
+     *  @brief  Get the sub detector containing a position, as defined by SubDetector::IsInSubDetector with the given tolerance
+     * 
+     *  @param  positionVector the position vector
+     *  @param  tolerance the tolerance, units mm
+     * 
+     *  @return address of the first containing sub detector in order of name, or nullptr if no sub detector contains the position
+     */
+    const SubDetector *GetContainingSubDetector(const CartesianVector &positionVector, const float tolerance) const;
+
+private:
+    typedef BoundingVolumeHierarchy::BoundingBox BoundingBox;
+
+    /**
+     *  @brief  Get the box of a lar tpc
+     * 
+     *  @param  pLArTPC address of the lar tpc
+     * 
+     *  @return the box
+     */
+    static BoundingBox GetBoundingBox(const LArTPC *const pLArTPC);
+
+    /**
+     *  @brief  Get the bounding box of a sub detector
+     * 
+     *  @param  pSubDetector address of the sub detector
+     *  @param  boundingBox to receive the bounding box
+     * 
+     *  @return whether the sub detector can contain any position (i.e. its outer edge is a circle or a polygon with at least three sides)
+     */
+    static bool GetBoundingBox(const SubDetector *const pSubDetector, BoundingBox &boundingBox);
+
+    LArTPCVector                m_larTPCs;                  ///< The lar tpcs, in order of volume id
+    BoundingVolumeHierarchy     m_larTPCHierarchy;          ///< The bounding volume hierarchy over the lar tpc boxes
+    SubDetectorVector           m_subDetectors;             ///< The sub detectors able to contain positions, in order of name
+    BoundingVolumeHierarchy     m_subDetectorHierarchy;     ///< The bounding volume hierarchy over the sub detector bounding boxes
+};
+
+} // namespace pandora
+
+#endif // #ifndef PANDORA_DETECTOR_VOLUME_INDEX_H
@@ -0,0 +1,83 @@
+/**
+ *  @file   PandoraSDK/include/Geometry/RegularPolygon.h
+ * 
+ *  @brief  Header file for the regular polygon class.
+ * 
+ *  $Log: $
+ */
+#ifndef PANDORA_REGULAR_POLYGON_H
+#define PANDORA_REGULAR_POLYGON_H 1
+
+#include "Pandora/PandoraInternal.h"
+
+namespace pandora
+{
+
+/**
+ *  @brief  RegularPolygon class, a regular polygon in the xy plane, centred on the origin, as described by the r coordinate, phi
+ *          coordinate and symmetry order of sub detectors and concentric gaps. The polygon is held as a table of edge half-planes, with
+ *          outward unit normals at phi coordinate + 2 pi k / symmetry order and distance r coordinate from the origin.
+ */
+class RegularPolygon
+{
+public:
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  rCoordinate the polygon r coordinate, the distance from the origin to the centre of each edge
+     *  @param  phiCoordinate the polygon phi coordinate
+     *  @param  symmetryOrder the polygon symmetry order, zero denoting a circle of radius r coordinate
+     */
+    RegularPolygon(const float rCoordinate, const float phiCoordinate, const unsigned int symmetryOrder);
+
+    /**
+     *  @brief  Whether a point lies inside the polygon. The edge facing the point is found from its phi coordinate, and the point is
+     *          tested against that edge and its neighbours, so the result agrees exactly with a test against every edge. Polygons of
+     *          symmetry order one or two contain no points.
+     * 
+     *  @param  x the point x coordinate
+     *  @param  y the point y coordinate
+     *  @param  tolerance the distance by which to move each edge outwards (or inwards, if negative) before testing the point
+     * 
+     *  @return boolean
+     */
+    bool IsInside(const float x, const float y, const float tolerance = 0.f) const;
+
+    /**
+     *  @brief  Whether each of a block of points lies inside the polygon, testing every edge for every point so that the loops
+     *          vectorise. Agrees exactly with the single point IsInside.
+     * 
+     *  @param  pX address of the point x coordinates
+     *  @param  pY address of the point y coordinates
+     *  @param  nPoints the number of points
+     *  @param  pIsInside address of the array to receive, for each point, whether it lies inside the polygon
+     */
+    void IsInside(const float *const pX, const float *const pY, const unsigned int nPoints, unsigned char *const pIsInside) const;
+
+    /**
+     *  @brief  Get the distance from the origin to the polygon vertices
+     * 
+     *  @return the distance from the origin to the polygon vertices
+     */
+    float GetVertexRCoordinate() const;
+
+private:
+    float           m_rCoordinate;          ///< The distance from the origin to the centre of each edge
+    float           m_vertexRCoordinate;    ///< The distance from the origin to the polygon vertices
+    float           m_phiCoordinate;        ///< The polygon phi coordinate, that of the normal to the first edge
+    float           m_sectorsPerRadian;     ///< The number of edges per radian of phi coordinate
+    unsigned int    m_symmetryOrder;        ///< The polygon symmetry order
+    FloatVector     m_normalX;              ///< The x components of the outward unit normals to the edges
+    FloatVector     m_normalY;              ///< The y components of the outward unit normals to the edges
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline float RegularPolygon::GetVertexRCoordinate() const
+{
+    return m_vertexRCoordinate;
+}
+
+} // namespace pandora
+
+#endif // #ifndef PANDORA_REGULAR_POLYGON_H
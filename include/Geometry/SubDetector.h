@@ -8,6 +8,8 @@
 #ifndef PANDORA_SUB_DETECTOR_H
 #define PANDORA_SUB_DETECTOR_H 1
 
+#include "Geometry/RegularPolygon.h"
+
 #include "Pandora/ObjectCreation.h"
 
 #include <string>
@@ -160,6 +162,19 @@ public:
      */
     const SubDetectorLayerVector &GetSubDetectorLayerVector() const;
 
+    /**
+     *  @brief  Whether a position lies within the sub detector: between its innermost and outermost edges in the xy plane, and
+     *          between its inner and outer z coordinates (or their reflections in the z=0 plane, if mirrored in z). The edges are
+     *          tested via precomputed edge tables, with the edge facing the position found directly from its phi coordinate. A
+     *          tolerance moves the z limits and the outermost edges outwards, and the innermost edges inwards, by the given distance.
+     * 
+     *  @param  positionVector the position vector
+     *  @param  tolerance the tolerance, units mm
+     * 
+     *  @return boolean
+     */
+    bool IsInSubDetector(const CartesianVector &positionVector, const float tolerance = 0.f) const;
+
 protected:
     /**
      *  @brief  Constructor
@@ -186,6 +201,8 @@ protected:
     bool                    m_isMirroredInZ;            ///< Whether a second sub detector exists, equivalent to a reflection in z=0 plane
     unsigned int            m_nLayers;                  ///< The number of layers in the sub detector section
     SubDetectorLayerVector  m_subDetectorLayerVector;   ///< The vector of layer parameters for the sub detector section
+    RegularPolygon          m_innerPolygon;             ///< The edge table of the innermost edge of sub detector
+    RegularPolygon          m_outerPolygon;             ///< The edge table of the outermost edge of sub detector
 
     friend class GeometryManager;
     friend class PandoraObjectFactory<object_creation::Geometry::SubDetector::Parameters, object_creation::Geometry::SubDetector::Object>;
@@ -0,0 +1,172 @@
+/**
+ *  @file   PandoraSDK/include/Helpers/HelixHelper.h
+ * 
+ *  @brief  Header file for the helix helper class.
+ * 
+ *  $Log: $
+ */
+#ifndef PANDORA_HELIX_HELPER_H
+#define PANDORA_HELIX_HELPER_H 1
+
+#include "Objects/CartesianVector.h"
+
+#include "Pandora/PandoraInternal.h"
+#include "Pandora/StatusCodes.h"
+
+namespace pandora
+{
+
+class Helix;
+class Pandora;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  HelixPair class, describing the closest approach of the helices of two tracks
+ */
+class HelixPair
+{
+public:
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  pTrack1 address of the first track
+     *  @param  pTrack2 address of the second track
+     *  @param  positionOfClosestApproach the position of closest approach
+     *  @param  v0Momentum the sum of the track momenta, extrapolated to the position of closest approach
+     *  @param  helixDistance the distance between the helices at closest approach
+     */
+    HelixPair(const Track *const pTrack1, const Track *const pTrack2, const CartesianVector &positionOfClosestApproach,
+        const CartesianVector &v0Momentum, const float helixDistance);
+
+    /**
+     *  @brief  Get the address of the first track
+     * 
+     *  @return the address of the first track
+     */
+    const Track *GetTrack1() const;
+
+    /**
+     *  @brief  Get the address of the second track
+     * 
+     *  @return the address of the second track
+     */
+    const Track *GetTrack2() const;
+
+    /**
+     *  @brief  Get the position of closest approach
+     * 
+     *  @return the position of closest approach
+     */
+    const CartesianVector &GetPositionOfClosestApproach() const;
+
+    /**
+     *  @brief  Get the sum of the track momenta, extrapolated to the position of closest approach
+     * 
+     *  @return the v0 momentum
+     */
+    const CartesianVector &GetV0Momentum() const;
+
+    /**
+     *  @brief  Get the distance between the helices at closest approach
+     * 
+     *  @return the helix distance
+     */
+    float GetHelixDistance() const;
+
+private:
+    const Track            *m_pTrack1;                      ///< The address of the first track
+    const Track            *m_pTrack2;                      ///< The address of the second track
+    CartesianVector         m_positionOfClosestApproach;    ///< The position of closest approach
+    CartesianVector         m_v0Momentum;                   ///< The sum of the track momenta at the position of closest approach
+    float                   m_helixDistance;                ///< The distance between the helices at closest approach
+};
+
+typedef std::vector<HelixPair> HelixPairVector;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  HelixHelper class
+ */
+class HelixHelper
+{
+public:
+    /**
+     *  @brief  Find all pairs of tracks whose helices at the track start (see Track::GetHelixAtStart) approach within a specified
+     *          distance (e.g. for v0 and kink searches). Pairs whose helix circles are separated, in the xy plane, by more than the
+     *          maximum distance are rejected before the full Helix::GetDistanceToHelix calculation. The search is divided between
+     *          the number of threads specified in the pandora settings. Pairs are returned in the order of the input track list,
+     *          with the first track preceding the second track in the list.
+     * 
+     *  @param  pandora the pandora instance, providing the number of threads
+     *  @param  trackList the track list
+     *  @param  maxHelixDistance the maximum distance between the helices at closest approach
+     *  @param  helixPairVector to receive the helix pairs
+     */
+    static StatusCode GetClosestApproachPairs(const Pandora &pandora, const TrackList &trackList, const float maxHelixDistance,
+        HelixPairVector &helixPairVector);
+
+private:
+    /**
+     *  @brief  Get the minimum distance, in the xy plane, between the circles of two helices
+     * 
+     *  @param  helix1 the first helix
+     *  @param  helix2 the second helix
+     * 
+     *  @return the minimum distance between the circles (zero if the circles intersect)
+     */
+    static float GetCircleSeparation(const Helix &helix1, const Helix &helix2);
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline HelixPair::HelixPair(const Track *const pTrack1, const Track *const pTrack2, const CartesianVector &positionOfClosestApproach,
+        const CartesianVector &v0Momentum, const float helixDistance) :
+    m_pTrack1(pTrack1),
+    m_pTrack2(pTrack2),
+    m_positionOfClosestApproach(positionOfClosestApproach),
+    m_v0Momentum(v0Momentum),
+    m_helixDistance(helixDistance)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const Track *HelixPair::GetTrack1() const
+{
+    return m_pTrack1;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const Track *HelixPair::GetTrack2() const
+{
+    return m_pTrack2;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const CartesianVector &HelixPair::GetPositionOfClosestApproach() const
+{
+    return m_positionOfClosestApproach;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const CartesianVector &HelixPair::GetV0Momentum() const
+{
+    return m_v0Momentum;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline float HelixPair::GetHelixDistance() const
+{
+    return m_helixDistance;
+}
+
+} // namespace pandora
+
+#endif // #ifndef PANDORA_HELIX_HELPER_H
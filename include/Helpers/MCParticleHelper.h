@@ -11,6 +11,8 @@
 #include "Pandora/PandoraInternal.h"
 #include "Pandora/StatusCodes.h"
 
+#include <unordered_map>
+
 namespace pandora
 {
 
@@ -29,8 +31,203 @@ public:
      */
     template <typename T>
     static const MCParticle *GetMainMCParticle(const T *const pT);
+
+    /**
+     *  @brief  Add the mc particle weights of all calo hits in a specified calo hit list, cluster or cluster list to a weight map
+     * 
+     *  @param  pT address of the calo hit list, cluster or cluster list to examine
+     *  @param  mcParticleWeightMap to receive the summed mc particle weights
+     */
+    template <typename T>
+    static void AddMCParticleWeights(const T *const pT, MCParticleWeightMap &mcParticleWeightMap);
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  TruthMatch class, describing the mc particle contributions to an object
+ */
+class TruthMatch
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    TruthMatch();
+
+    /**
+     *  @brief  Get the address of the main mc particle, throws if there are no mc particle contributions
+     * 
+     *  @return address of the main mc particle
+     */
+    const MCParticle *GetMainMCParticle() const;
+
+    /**
+     *  @brief  Get the summed weight of the main mc particle
+     * 
+     *  @return the summed weight of the main mc particle
+     */
+    float GetMainMCParticleWeight() const;
+
+    /**
+     *  @brief  Get the summed weight of all contributing mc particles
+     * 
+     *  @return the summed weight of all contributing mc particles
+     */
+    float GetTotalWeight() const;
+
+    /**
+     *  @brief  Get the summed weight of each contributing mc particle
+     * 
+     *  @return the mc particle weight map
+     */
+    const MCParticleWeightMap &GetMCParticleWeightMap() const;
+
+private:
+    /**
+     *  @brief  Identify the main mc particle and total weight, following population of the mc particle weight map
+     */
+    void Finalize();
+
+    MCParticleWeightMap     m_mcParticleWeightMap;      ///< The summed weight of each contributing mc particle
+    const MCParticle       *m_pMainMCParticle;          ///< The address of the main mc particle
+    float                   m_mainMCParticleWeight;     ///< The summed weight of the main mc particle
+    float                   m_totalWeight;              ///< The summed weight of all contributing mc particles
+    uint64_t                m_contentVersion;           ///< The content version of the cluster for which the truth match was calculated, zero if none
+
+    friend class MCParticleHelper;
+    friend class TruthMatchCache;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  TruthMatchCache class, holding cluster truth matches that are recalculated only when cluster content changes.
+ *          A cache should be owned by a single client and cleared at the end of each event.
+ */
+class TruthMatchCache
+{
+public:
+    typedef std::unordered_map<const Cluster*, TruthMatch> ClusterToTruthMatchMap;
+    typedef std::unordered_map<const ParticleFlowObject*, TruthMatch> PfoToTruthMatchMap;
+
+    /**
+     *  @brief  Default constructor
+     */
+    TruthMatchCache();
+
+    /**
+     *  @brief  Get the truth match for a cluster, calculating it only if the cluster content has changed since last requested
+     * 
+     *  @param  pCluster address of the cluster
+     * 
+     *  @return the truth match
+     */
+    const TruthMatch &GetTruthMatch(const Cluster *const pCluster);
+
+    /**
+     *  @brief  Get the truth match for a pfo, combining the cached truth matches of its clusters
+     * 
+     *  @param  pPfo address of the pfo
+     *  @param  truthMatch to receive the truth match
+     */
+    void GetTruthMatch(const ParticleFlowObject *const pPfo, TruthMatch &truthMatch);
+
+    /**
+     *  @brief  Ensure the cached truth matches for all clusters in a list are up to date, with outdated matches calculated in parallel
+     * 
+     *  @param  clusterList the cluster list
+     *  @param  nThreads the maximum number of threads to use
+     */
+    void CalculateTruthMatches(const ClusterList &clusterList, const unsigned int nThreads);
+
+    /**
+     *  @brief  Get the truth matches for all pfos in a list, with outdated cluster truth matches calculated in parallel
+     * 
+     *  @param  pfoList the pfo list
+     *  @param  nThreads the maximum number of threads to use
+     *  @param  pfoToTruthMatchMap to receive the pfo truth matches
+     */
+    void CalculateTruthMatches(const PfoList &pfoList, const unsigned int nThreads, PfoToTruthMatchMap &pfoToTruthMatchMap);
+
+    /**
+     *  @brief  Clear the cache, e.g. at the end of an event
+     */
+    void Clear();
+
+    /**
+     *  @brief  Get the number of truth match requests satisfied by the cache
+     * 
+     *  @return the number of cache hits
+     */
+    unsigned int GetNCacheHits() const;
+
+    /**
+     *  @brief  Get the number of truth match requests requiring calculation
+     * 
+     *  @return the number of cache misses
+     */
+    unsigned int GetNCacheMisses() const;
+
+private:
+    /**
+     *  @brief  Get the cached truth match entry for a cluster, identifying whether it must be (re)calculated
+     * 
+     *  @param  pCluster address of the cluster
+     * 
+     *  @return address of the truth match entry if calculation is required, otherwise nullptr
+     */
+    TruthMatch *GetOutdatedEntry(const Cluster *const pCluster);
+
+    /**
+     *  @brief  Calculate the truth match for a cluster
+     * 
+     *  @param  pCluster address of the cluster
+     *  @param  truthMatch to receive the truth match
+     */
+    static void CalculateTruthMatch(const Cluster *const pCluster, TruthMatch &truthMatch);
+
+    ClusterToTruthMatchMap  m_clusterToTruthMatchMap;   ///< The cluster to truth match map
+    unsigned int            m_nCacheHits;               ///< The number of truth match requests satisfied by the cache
+    unsigned int            m_nCacheMisses;             ///< The number of truth match requests requiring calculation
 };
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline float TruthMatch::GetMainMCParticleWeight() const
+{
+    return m_mainMCParticleWeight;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline float TruthMatch::GetTotalWeight() const
+{
+    return m_totalWeight;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const MCParticleWeightMap &TruthMatch::GetMCParticleWeightMap() const
+{
+    return m_mcParticleWeightMap;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int TruthMatchCache::GetNCacheHits() const
+{
+    return m_nCacheHits;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int TruthMatchCache::GetNCacheMisses() const
+{
+    return m_nCacheMisses;
+}
+
 } // namespace pandora
 
 #endif // #ifndef PANDORA_MC_PARTICLE_HELPER_H
@@ -0,0 +1,152 @@
+/**
+ *  @file   PandoraSDK/include/Helpers/ParallelHelper.h
+ * 
+ *  @brief  Header file for the parallel helper class.
+ * 
+ *  $Log: $
+ */
+#ifndef PANDORA_PARALLEL_HELPER_H
+#define PANDORA_PARALLEL_HELPER_H 1
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace pandora
+{
+
+/**
+ *  @brief  ParallelHelper class
+ */
+class ParallelHelper
+{
+public:
+    /**
+     *  @brief  Call a function for each index in the range [0, nItems), dividing the range into contiguous blocks processed by
+     *          up to nThreads threads. The function must only modify state associated with the index it is given. The first
+     *          exception raised by any block is rethrown in the calling thread, once all threads have completed.
+     *
+     *  @param  nItems the number of items
+     *  @param  nThreads the maximum number of threads to use (a value of one processes all items in the calling thread)
+     *  @param  function the function, called as function(index)
+     */
+    template <typename FUNCTION>
+    static void ForEachIndex(const size_t nItems, const unsigned int nThreads, const FUNCTION &function);
+
+    /**
+     *  @brief  Divide the range [0, nItems) into contiguous blocks, each processed by a single thread, and call a function once
+     *          per block. Blocks are numbered from zero to GetNBlocks(nItems, nThreads) - 1, so the block index can be used to
+     *          address per-thread state, such as partial results that are reduced once this function returns. The first
+     *          exception raised by any block is rethrown in the calling thread, once all threads have completed.
+     *
+     *  @param  nItems the number of items
+     *  @param  nThreads the maximum number of threads to use (a value of one processes all items in the calling thread)
+     *  @param  function the function, called as function(blockIndex, begin, end)
+     */
+    template <typename FUNCTION>
+    static void ForEachBlock(const size_t nItems, const unsigned int nThreads, const FUNCTION &function);
+
+    /**
+     *  @brief  Get the number of blocks into which ForEachBlock will divide a specified range
+     *
+     *  @param  nItems the number of items
+     *  @param  nThreads the maximum number of threads to use
+     *
+     *  @return the number of blocks (zero if there are no items)
+     */
+    static size_t GetNBlocks(const size_t nItems, const unsigned int nThreads);
+
+private:
+    /**
+     *  @brief  Call a function for a specified block
+     *
+     *  @param  blockIndex the block index
+     *  @param  begin the first index in the block
+     *  @param  end one past the last index in the block
+     *  @param  function the function, called as function(blockIndex, begin, end)
+     *  @param  exceptionPtr to receive any exception raised by the function
+     */
+    template <typename FUNCTION>
+    static void ProcessBlock(const size_t blockIndex, const size_t begin, const size_t end, const FUNCTION &function,
+        std::exception_ptr &exceptionPtr);
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename FUNCTION>
+inline void ParallelHelper::ForEachIndex(const size_t nItems, const unsigned int nThreads, const FUNCTION &function)
+{
+    ParallelHelper::ForEachBlock(nItems, nThreads, [&function](const size_t, const size_t begin, const size_t end)
+    {
+        for (size_t index = begin; index < end; ++index)
+            function(index);
+    });
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename FUNCTION>
+inline void ParallelHelper::ForEachBlock(const size_t nItems, const unsigned int nThreads, const FUNCTION &function)
+{
+    const size_t nBlocks(ParallelHelper::GetNBlocks(nItems, nThreads));
+
+    if (nBlocks < 2)
+    {
+        if (nItems > 0)
+            function(0, 0, nItems);
+
+        return;
+    }
+
+    // ATTN Blocks are sized to match GetNBlocks, so that every block index in [0, nBlocks) is used
+    const size_t blockSize(nItems / nBlocks), nLargerBlocks(nItems % nBlocks);
+    std::vector<std::exception_ptr> exceptionPtrs(nBlocks);
+    std::vector<std::thread> threads;
+    threads.reserve(nBlocks - 1);
+
+    for (size_t iBlock = 1; iBlock < nBlocks; ++iBlock)
+    {
+        const size_t begin((iBlock * blockSize) + std::min(iBlock, nLargerBlocks)), end(begin + blockSize + ((iBlock < nLargerBlocks) ? 1 : 0));
+        threads.emplace_back(&ParallelHelper::ProcessBlock<FUNCTION>, iBlock, begin, end, std::cref(function), std::ref(exceptionPtrs[iBlock]));
+    }
+
+    ParallelHelper::ProcessBlock(0, 0, blockSize + ((0 < nLargerBlocks) ? 1 : 0), function, exceptionPtrs[0]);
+
+    for (std::thread &thread : threads)
+        thread.join();
+
+    for (const std::exception_ptr &exceptionPtr : exceptionPtrs)
+    {
+        if (exceptionPtr)
+            std::rethrow_exception(exceptionPtr);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline size_t ParallelHelper::GetNBlocks(const size_t nItems, const unsigned int nThreads)
+{
+    return std::min(nItems, static_cast<size_t>(std::max(nThreads, 1U)));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename FUNCTION>
+inline void ParallelHelper::ProcessBlock(const size_t blockIndex, const size_t begin, const size_t end, const FUNCTION &function,
+    std::exception_ptr &exceptionPtr)
+{
+    try
+    {
+        function(blockIndex, begin, end);
+    }
+    catch (...)
+    {
+        exceptionPtr = std::current_exception();
+    }
+}
+
+} // namespace pandora
+
+#endif // #ifndef PANDORA_PARALLEL_HELPER_H
@@ -10,6 +10,7 @@
 
 #include "Managers/InputObjectManager.h"
 #include "Managers/Metadata.h"
+#include "Managers/PseudoLayerCache.h"
 
 #include "Pandora/ObjectCreation.h"
 #include "Pandora/PandoraInternal.h"
@@ -42,9 +43,47 @@ private:
      *  @param  parameters the calo hit parameters
      *  @param  pCaloHit to receive the address of the calo hit
      *  @param  factory the factory that performs the object allocation
+     *  @param  shouldDeferPseudoLayer whether to defer pseudo layer assignment until creation of the input list, when the pseudo
+     *          layers of all deferred calo hits are assigned together
      */
     StatusCode Create(const object_creation::CaloHit::Parameters &parameters, const CaloHit *&pCaloHit,
-        const ObjectFactory<object_creation::CaloHit::Parameters, object_creation::CaloHit::Object> &factory);
+        const ObjectFactory<object_creation::CaloHit::Parameters, object_creation::CaloHit::Object> &factory,
+        const bool shouldDeferPseudoLayer = false);
+
+    /**
+     *  @brief  Defer pseudo layer assignment for a calo hit, unless its pseudo layer can be taken from the pseudo layer cache
+     * 
+     *  @param  parameters the calo hit parameters
+     *  @param  pCaloHit address of the calo hit
+     */
+    StatusCode DeferPseudoLayer(const object_creation::CaloHit::Parameters &parameters, const CaloHit *const pCaloHit);
+
+    /**
+     *  @brief  Get the pseudo layer cache, creating it if pseudo layer caching is enabled and the cache does not yet exist
+     * 
+     *  @return address of the pseudo layer cache, or nullptr if pseudo layer caching is not enabled
+     */
+    PseudoLayerCache *GetPseudoLayerCache();
+
+    /**
+     *  @brief  Remove all entries from the pseudo layer cache, if it exists, so that no pseudo layers assigned with an earlier
+     *          geometry or pseudo layer plugin configuration are reused
+     */
+    void ClearPseudoLayerCache();
+
+    /**
+     *  @brief  Create the input list (accessible to algorithms), using objects created by client application, first assigning
+     *          pseudo layers to any calo hits for which assignment was deferred
+     */
+    StatusCode CreateInputList();
+
+    /**
+     *  @brief  Assign pseudo layers to all calo hits for which assignment was deferred, processing contiguous blocks of calo hits
+     *          via the pseudo layer plugin batch interface (in parallel, if the plugin is thread safe). Calo hits for which no pseudo
+     *          layer can be assigned are removed from the input list and deleted, as if their creation had failed, and are counted
+     *          as rejected calo hits.
+     */
+    StatusCode AssignDeferredPseudoLayers();
 
     /**
      *  @brief  Alter the metadata information stored in a calo hit
@@ -195,6 +234,10 @@ private:
     unsigned int                    m_nReclusteringProcesses;           ///< The number of reclustering algorithms currently in operation
     ReclusterMetadata              *m_pCurrentReclusterMetadata;        ///< Address of the current recluster metadata
     ReclusterMetadataList           m_reclusterMetadataList;            ///< The recluster metadata list
+    CaloHitVector                   m_deferredPseudoLayerCaloHits;      ///< The calo hits awaiting pseudo layer assignment
+    PseudoLayerCache::CellKeyVector m_deferredCellKeys;                 ///< The cell keys of the calo hits awaiting pseudo layer assignment
+    PseudoLayerCache               *m_pPseudoLayerCache;                ///< Address of the cross-event pseudo layer cache, if enabled
+    unsigned int                    m_nRejectedCaloHits;                ///< The number of calo hits rejected in pseudo layer assignment
 
     friend class PandoraApiImpl;
     friend class PandoraContentApiImpl;
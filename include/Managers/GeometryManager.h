@@ -11,15 +11,42 @@
 #include "Pandora/ObjectCreation.h"
 #include "Pandora/PandoraEnumeratedTypes.h"
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
 namespace pandora
 {
 
+class DetectorGapIndex;
+class DetectorVolumeIndex;
+
 /**
  *  @brief  GeometryManager class
  */
 class GeometryManager
 {
 public:
+    static constexpr unsigned int N_SUB_DETECTOR_TYPES = SUB_DETECTOR_OTHER + 1;    ///< The number of sub detector types
+
+    typedef std::array<Granularity, HIT_CUSTOM> DefaultGranularityTable;
+
+    /**
+     *  @brief  The default granularity for each hit type preceding HIT_CUSTOM, indexed by hit type. HIT_CUSTOM has no default and
+     *          must be registered with a specific granularity via PandoraApi::SetHitTypeGranularity before use.
+     */
+    static constexpr DefaultGranularityTable DEFAULT_HIT_TYPE_GRANULARITIES = {{
+        VERY_FINE,      // TRACKER
+        FINE,           // ECAL
+        COARSE,         // HCAL
+        VERY_COARSE,    // MUON
+        VERY_FINE,      // TPC_VIEW_U
+        VERY_FINE,      // TPC_VIEW_V
+        VERY_FINE,      // TPC_VIEW_W
+        VERY_FINE       // TPC_3D
+    }};
+
     /**
      *  @brief  Constructor
      * 
@@ -72,6 +99,57 @@ public:
      */
     const LArTPCMap &GetLArTPCMap() const;
 
+    /**
+     *  @brief  Get the lar tpc containing a specified position, i.e. whose box, expanded by a tolerance on each side, contains the
+     *          position. Uses a spatial index over the lar tpcs and sub detectors, built on the first query after they are created.
+     * 
+     *  @param  positionVector the position vector
+     *  @param  tolerance the tolerance, units mm
+     * 
+     *  @return address of the containing lar tpc with the lowest volume id, or nullptr if no lar tpc contains the position
+     */
+    const LArTPC *GetContainingLArTPC(const CartesianVector &positionVector, const float tolerance = 0.f) const;
+
+    /**
+     *  @brief  Get the lar tpc containing each of a list of positions
+     * 
+     *  @param  positionVectors the position vectors
+     *  @param  tolerance the tolerance, units mm
+     *  @param  larTPCVector to receive, for each position, the address of the containing lar tpc with the lowest volume id, or nullptr
+     */
+    void GetContainingLArTPCBatch(const CartesianPointVector &positionVectors, const float tolerance, LArTPCVector &larTPCVector) const;
+
+    /**
+     *  @brief  Get all lar tpcs containing a specified position, i.e. whose boxes, expanded by a tolerance on each side, contain the
+     *          position (e.g. several, near the boundaries of adjacent lar tpcs)
+     * 
+     *  @param  positionVector the position vector
+     *  @param  tolerance the tolerance, units mm
+     *  @param  larTPCVector to receive the addresses of the containing lar tpcs, in order of volume id
+     */
+    void GetContainingLArTPCs(const CartesianVector &positionVector, const float tolerance, LArTPCVector &larTPCVector) const;
+
+    /**
+     *  @brief  Get the sub detector containing a specified position, as defined by SubDetector::IsInSubDetector with a tolerance
+     * 
+     *  @param  positionVector the position vector
+     *  @param  tolerance the tolerance, units mm
+     * 
+     *  @return address of the first containing sub detector in order of name, or nullptr if no sub detector contains the position
+     */
+    const SubDetector *GetContainingSubDetector(const CartesianVector &positionVector, const float tolerance = 0.f) const;
+
+    /**
+     *  @brief  Get the sub detector containing each of a list of positions
+     * 
+     *  @param  positionVectors the position vectors
+     *  @param  tolerance the tolerance, units mm
+     *  @param  subDetectorVector to receive, for each position, the address of the first containing sub detector in order of name,
+     *          or nullptr
+     */
+    void GetContainingSubDetectorBatch(const CartesianPointVector &positionVectors, const float tolerance,
+        SubDetectorVector &subDetectorVector) const;
+
     /**
      *  @brief  Get the list of gaps in the active detector volume
      * 
@@ -79,6 +157,45 @@ public:
      */
     const DetectorGapList &GetDetectorGapList() const;
 
+    /**
+     *  @brief  Whether a specified position lies within any gap in the active detector volume. Uses a spatial index over the gaps,
+     *          built on the first query after the gaps are created. Equivalent to testing each gap with DetectorGap::IsInGap, except
+     *          that an exception is raised whenever any gap does not accept the hit type.
+     * 
+     *  @param  positionVector the position vector
+     *  @param  hitType the hit type, providing context to aid interpretation of provided position vector
+     *  @param  gapTolerance tolerance allowed when declaring a point to be "in" a gap region, units mm
+     * 
+     *  @return boolean
+     */
+    bool IsInGap(const CartesianVector &positionVector, const HitType hitType, const float gapTolerance = 0.f) const;
+
+    /**
+     *  @brief  Whether each of a list of positions lies within any gap in the active detector volume
+     * 
+     *  @param  positionVectors the position vectors
+     *  @param  hitType the hit type, providing context to aid interpretation of provided position vectors
+     *  @param  gapTolerance tolerance allowed when declaring a point to be "in" a gap region, units mm
+     *  @param  isInGapVector to receive, for each position, whether it lies within a gap
+     */
+    void IsInGap(const CartesianPointVector &positionVectors, const HitType hitType, const float gapTolerance,
+        BoolVector &isInGapVector) const;
+
+    /**
+     *  @brief  Whether each of a list of positions, provided as separate coordinate arrays, lies within any gap in the active detector
+     *          volume. Suited to spatially compact lists of positions, e.g. sampling points along a cluster trajectory, which are
+     *          tested in one batch against each nearby gap.
+     * 
+     *  @param  xCoordinates the position x coordinates
+     *  @param  yCoordinates the position y coordinates
+     *  @param  zCoordinates the position z coordinates
+     *  @param  hitType the hit type, providing context to aid interpretation of provided positions
+     *  @param  gapTolerance tolerance allowed when declaring a point to be "in" a gap region, units mm
+     *  @param  isInGapVector to receive, for each position, whether it lies within a gap
+     */
+    void IsInGap(const FloatVector &xCoordinates, const FloatVector &yCoordinates, const FloatVector &zCoordinates, const HitType hitType,
+        const float gapTolerance, BoolVector &isInGapVector) const;
+
     /**
      *  @brief  Get the granularity level specified for a given calorimeter hit type
      * 
@@ -116,35 +233,58 @@ private:
     template <typename PARAMETERS, typename OBJECT>
     StatusCode CreateGap(const PARAMETERS &parameters, const ObjectFactory<PARAMETERS, OBJECT> &factory);
 
+    /**
+     *  @brief  Get the spatial index over the detector gaps, building it if the gap list has changed
+     * 
+     *  @return the detector gap index
+     */
+    const DetectorGapIndex &GetDetectorGapIndex() const;
+
+    /**
+     *  @brief  Get the spatial index over the lar tpcs and sub detectors, building it if either has changed
+     * 
+     *  @return the detector volume index
+     */
+    const DetectorVolumeIndex &GetDetectorVolumeIndex() const;
+
     /**
      *  @brief  Erase all geometry manager content
      */
     StatusCode EraseAllContent();
 
-    typedef std::map<HitType, Granularity> HitTypeToGranularityMap;
-
     /**
-     *  @brief  Get the default hit type to granularity map
-     * 
-     *  @return the default hit type to granularity map
+     *  @brief  Restore the default granularity for each hit type, leaving HIT_CUSTOM unregistered
      */
-    HitTypeToGranularityMap GetDefaultHitTypeToGranularityMap() const;
+    void ResetHitTypeGranularities();
 
     /**
-     *  @brief  Set the granularity level to be associated with a specified hit type
+     *  @brief  Set the granularity level to be associated with a specified hit type, which must not follow HIT_CUSTOM
      * 
      *  @param  hitType the specified hit type
      *  @param  granularity the specified granularity
      */
     StatusCode SetHitTypeGranularity(const HitType hitType, const Granularity granularity);
 
-    typedef std::multimap<SubDetectorType, const SubDetector*> SubDetectorTypeMap;
+    typedef std::array<const SubDetector*, N_SUB_DETECTOR_TYPES> SubDetectorTypeTable;
+    typedef std::array<unsigned int, N_SUB_DETECTOR_TYPES> SubDetectorTypeCountTable;
+    typedef std::array<Granularity, N_HIT_TYPES> GranularityTable;
+    typedef std::array<bool, N_HIT_TYPES> GranularityFlagTable;
 
     SubDetectorMap              m_subDetectorMap;           ///< Map from sub detector name to sub detector
-    SubDetectorTypeMap          m_subDetectorTypeMap;       ///< Map from sub detector type to sub detector
+    SubDetectorTypeTable        m_subDetectorTypeTable;     ///< The sub detector of each type (the last created, if several)
+    SubDetectorTypeCountTable   m_subDetectorTypeCounts;    ///< The number of sub detectors of each type, indexed by type
     LArTPCMap                   m_larTPCMap;                ///< Map from lar tpc volume id to lar tpc
     DetectorGapList             m_detectorGapList;          ///< List of gaps in the active detector volume
-    HitTypeToGranularityMap     m_hitTypeToGranularityMap;  ///< The hit type to granularity map
+    GranularityTable            m_granularityTable;         ///< The granularity of each hit type, indexed by hit type
+    GranularityFlagTable        m_isGranularityRegistered;  ///< Whether each hit type is registered with a granularity
+
+    mutable std::unique_ptr<const DetectorGapIndex> m_pDetectorGapIndex;    ///< The spatial index over the detector gaps
+    mutable std::atomic<bool>   m_isDetectorGapIndexUpToDate;   ///< Whether the detector gap index describes the current gap list
+    mutable std::mutex          m_detectorGapIndexMutex;    ///< The mutex guarding construction of the detector gap index
+
+    mutable std::unique_ptr<const DetectorVolumeIndex> m_pDetectorVolumeIndex;  ///< The spatial index over the lar tpcs and sub detectors
+    mutable std::atomic<bool>   m_isDetectorVolumeIndexUpToDate;    ///< Whether the detector volume index describes the current volumes
+    mutable std::mutex          m_detectorVolumeIndexMutex; ///< The mutex guarding construction of the detector volume index
 
     const Pandora *const        m_pPandora;                 ///< The associated pandora object
 
@@ -153,6 +293,19 @@ private:
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+inline const SubDetector &GeometryManager::GetSubDetector(const SubDetectorType subDetectorType) const
+{
+    if ((subDetectorType >= N_SUB_DETECTOR_TYPES) || (0 == m_subDetectorTypeCounts[subDetectorType]))
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+
+    if (1 != m_subDetectorTypeCounts[subDetectorType])
+        throw StatusCodeException(STATUS_CODE_OUT_OF_RANGE);
+
+    return *(m_subDetectorTypeTable[subDetectorType]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 inline const SubDetectorMap &GeometryManager::GetSubDetectorMap() const
 {
     return m_subDetectorMap;
@@ -172,6 +325,17 @@ inline const DetectorGapList &GeometryManager::GetDetectorGapList() const
     return m_detectorGapList;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline Granularity GeometryManager::GetHitTypeGranularity(const HitType hitType) const
+{
+    if ((hitType < N_HIT_TYPES) && m_isGranularityRegistered[hitType])
+        return m_granularityTable[hitType];
+
+    std::cout << "GeometryManager: specified hitType must be registered with a specific granularity. See PandoraApi.h " << std::endl;
+    throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+}
+
 } // namespace pandora
 
 #endif // #ifndef PANDORA_GEOMETRY_MANAGER_H
@@ -87,21 +87,49 @@ private:
     StatusCode SelectPfoTargets();
 
     /**
-     *  @brief  Apply mc pfo selection rules 
+     *  @brief  Apply mc pfo selection rules to the decay chain of a root particle, using an iterative depth-first traversal
      *
-     *  @param  mcRootParticle address of the mc root particle
-     *  @param  mcPfoSet set of all MCPFOs selected so far
+     *  @param  rootIndex the index of the mc root particle in the flattened mc particle tree
+     *  @param  selectionStamps per-particle record of the root index (plus one) for which the particle was last selected as a pfo target
+     *  @param  indexStack workspace for the traversal
      */
-    StatusCode ApplyPfoSelectionRules(const MCParticle *const mcRootParticle, MCParticleSet &mcPfoSet) const;
+    void ApplyPfoSelectionRules(const unsigned int rootIndex, UIntVector &selectionStamps, UIntVector &indexStack) const;
 
     /**
-     *  @brief  Set pfo target for a mc tree
+     *  @brief  Whether a mc particle passes the mc pfo selection cuts
+     *
+     *  @param  pMCParticle address of the mc particle
+     *
+     *  @return boolean
+     */
+    bool PassesPfoSelectionCuts(const MCParticle *const pMCParticle) const;
+
+    /**
+     *  @brief  Set pfo target for a mc tree, using an iterative traversal
      * 
-     *  @param  pMCParticle address of a particle in the mc tree
+     *  @param  index the index of a particle in the flattened mc particle tree
      *  @param  pPfoTarget address of the pfo target
-     *  @param  onlyDaughters if "true" go through daughters only, if false go through parents as well
+     *  @param  onlyDaughters if "true" go through daughters of the initial particle only, if false go through parents as well
+     *  @param  indexStack workspace for the traversal
+     */
+    void SetPfoTargetInTree(const unsigned int index, const MCParticle *const pPfoTarget, const bool onlyDaughters, UIntVector &indexStack) const;
+
+    /**
+     *  @brief  Build the flattened, index-based mc particle tree from the input list and the registered parent-daughter relationships
      */
-    StatusCode SetPfoTargetInTree(const MCParticle *const pMCParticle, const MCParticle *const pPfoTarget, bool onlyDaughters = false) const;
+    StatusCode BuildMCParticleTree();
+
+    /**
+     *  @brief  Group the root particles in the flattened mc particle tree by connected component of the mc particle hierarchy
+     *
+     *  @param  rootIndicesPerComponent to receive the root particle indices, in input list order, for each connected component
+     */
+    void GetRootIndicesPerComponent(std::vector<UIntVector> &rootIndicesPerComponent) const;
+
+    /**
+     *  @brief  Clear the flattened mc particle tree
+     */
+    void ClearMCParticleTree();
 
    /**
      *  @brief  Create a map relating calo hit uid to mc pfo target
@@ -118,9 +146,10 @@ private:
     StatusCode CreateTrackToPfoTargetsMap(UidToMCParticleWeightMap &trackToPfoTargetsMap) const;
 
     /**
-     *  @brief  Apply mc particle associations (parent-daughter) that have been registered with the mc manager
+     *  @brief  Apply mc particle associations (parent-daughter) that have been registered with the mc manager, building the
+     *          flattened mc particle tree used for pfo target identification
      */
-    StatusCode AddMCParticleRelationships() const;
+    StatusCode AddMCParticleRelationships();
 
     /**
      *  @brief  Remove all mc particle associations that have been registered with the mc manager
@@ -164,6 +193,12 @@ private:
     ObjectRelationMap               m_caloHitToMCParticleMap;           ///< The calo hit to mc particle relation map
     ObjectRelationMap               m_trackToMCParticleMap;             ///< The track to mc particle relation map
 
+    MCParticleVector                m_treeMCParticleVector;             ///< The mc particles in the flattened tree, in input list order
+    UIntVector                      m_treeDaughterOffsets;              ///< Per-particle offsets into the tree daughter indices, plus end offset
+    UIntVector                      m_treeDaughterIndices;              ///< The tree daughter indices, grouped by parent
+    UIntVector                      m_treeParentOffsets;                ///< Per-particle offsets into the tree parent indices, plus end offset
+    UIntVector                      m_treeParentIndices;                ///< The tree parent indices, grouped by daughter
+
     friend class PandoraApiImpl;
     friend class PandoraContentApiImpl;
     friend class PandoraImpl;
@@ -0,0 +1,226 @@
+/**
+ *  @file   PandoraSDK/include/Managers/PseudoLayerCache.h
+ * 
+ *  @brief  Header file for the pseudo layer cache class.
+ * 
+ *  $Log: $
+ */
+#ifndef PANDORA_PSEUDO_LAYER_CACHE_H
+#define PANDORA_PSEUDO_LAYER_CACHE_H 1
+
+#include "Pandora/ObjectCreation.h"
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace pandora
+{
+
+/**
+ *  @brief  PseudoLayerCache class, holding the pseudo layers assigned to calorimeter cells, so that they can be reused across events.
+ *          Cells are identified by hit type and the user-supplied cell id, if provided, or otherwise by hit type, layer and position.
+ *          If the number of cached cells reaches the configured maximum, the cache is flushed before further cells are added.
+ * 
+ *          Positions are compared bit for bit, so the fallback key only finds cells whose calo hits are always given exactly the same
+ *          position, e.g. the cell centre. Hits with continuously varying positions rarely reuse an entry, and instead fill the cache
+ *          and cause flushes; clients should provide cell ids for such hits, or disable pseudo layer caching.
+ */
+class PseudoLayerCache
+{
+public:
+    /**
+     *  @brief  CellKey class
+     */
+    class CellKey
+    {
+    public:
+        /**
+         *  @brief  Constructor
+         * 
+         *  @param  parameters the parameters of a calo hit in the cell
+         */
+        CellKey(const object_creation::CaloHit::Parameters &parameters);
+
+        /**
+         *  @brief  Equality operator
+         * 
+         *  @param  rhs the cell key for comparison
+         * 
+         *  @return boolean
+         */
+        bool operator==(const CellKey &rhs) const;
+
+        /**
+         *  @brief  Get the hash of the cell key
+         * 
+         *  @return the hash
+         */
+        size_t GetHash() const;
+
+    private:
+        typedef std::array<std::uint32_t, 5> WordArray;
+
+        WordArray       m_words;                ///< The words identifying the cell
+    };
+
+    typedef std::vector<CellKey> CellKeyVector;
+
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  maxNEntries the maximum number of cells for which pseudo layers may be cached
+     */
+    PseudoLayerCache(const unsigned int maxNEntries);
+
+    /**
+     *  @brief  Find the cached pseudo layer for a cell, recording the outcome in the cache statistics
+     * 
+     *  @param  cellKey the cell key
+     *  @param  pseudoLayer to receive the cached pseudo layer, if found
+     * 
+     *  @return whether the pseudo layer was found
+     */
+    bool Find(const CellKey &cellKey, unsigned int &pseudoLayer);
+
+    /**
+     *  @brief  Cache the pseudo layer for a cell, first flushing the cache if it is full
+     * 
+     *  @param  cellKey the cell key
+     *  @param  pseudoLayer the pseudo layer
+     */
+    void Insert(const CellKey &cellKey, const unsigned int pseudoLayer);
+
+    /**
+     *  @brief  Remove all cached pseudo layers, e.g. because the geometry or pseudo layer plugin has changed. Unlike a flush on
+     *          reaching the maximum size, this is not recorded in the cache statistics.
+     */
+    void Clear();
+
+    /**
+     *  @brief  Get the number of cells for which pseudo layers are cached
+     * 
+     *  @return the number of cached cells
+     */
+    unsigned int GetNEntries() const;
+
+    /**
+     *  @brief  Get the maximum number of cells for which pseudo layers may be cached
+     * 
+     *  @return the maximum number of cached cells
+     */
+    unsigned int GetMaxNEntries() const;
+
+    /**
+     *  @brief  Get the number of pseudo layer requests satisfied by the cache
+     * 
+     *  @return the number of cache hits
+     */
+    std::uint64_t GetNCacheHits() const;
+
+    /**
+     *  @brief  Get the number of pseudo layer requests requiring calculation
+     * 
+     *  @return the number of cache misses
+     */
+    std::uint64_t GetNCacheMisses() const;
+
+    /**
+     *  @brief  Get the number of times the cache has been flushed, having reached its maximum size
+     * 
+     *  @return the number of cache flushes
+     */
+    unsigned int GetNFlushes() const;
+
+private:
+    /**
+     *  @brief  CellKeyHasher class
+     */
+    class CellKeyHasher
+    {
+    public:
+        /**
+         *  @brief  Get the hash of a cell key
+         * 
+         *  @param  cellKey the cell key
+         * 
+         *  @return the hash
+         */
+        size_t operator()(const CellKey &cellKey) const;
+    };
+
+    typedef std::unordered_map<CellKey, unsigned int, CellKeyHasher> CellKeyToPseudoLayerMap;
+
+    CellKeyToPseudoLayerMap     m_cellKeyToPseudoLayerMap;  ///< The cell key to pseudo layer map
+    const unsigned int          m_maxNEntries;              ///< The maximum number of cells for which pseudo layers may be cached
+    std::uint64_t               m_nCacheHits;               ///< The number of pseudo layer requests satisfied by the cache
+    std::uint64_t               m_nCacheMisses;             ///< The number of pseudo layer requests requiring calculation
+    unsigned int                m_nFlushes;                 ///< The number of times the cache has been flushed
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool PseudoLayerCache::CellKey::operator==(const CellKey &rhs) const
+{
+    return (m_words == rhs.m_words);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline size_t PseudoLayerCache::CellKey::GetHash() const
+{
+    std::uint64_t hash(14695981039346656037ULL);
+
+    for (const std::uint32_t word : m_words)
+        hash = (hash ^ word) * 1099511628211ULL;
+
+    return static_cast<size_t>(hash ^ (hash >> 32));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int PseudoLayerCache::GetNEntries() const
+{
+    return m_cellKeyToPseudoLayerMap.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int PseudoLayerCache::GetMaxNEntries() const
+{
+    return m_maxNEntries;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline std::uint64_t PseudoLayerCache::GetNCacheHits() const
+{
+    return m_nCacheHits;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline std::uint64_t PseudoLayerCache::GetNCacheMisses() const
+{
+    return m_nCacheMisses;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int PseudoLayerCache::GetNFlushes() const
+{
+    return m_nFlushes;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline size_t PseudoLayerCache::CellKeyHasher::operator()(const CellKey &cellKey) const
+{
+    return cellKey.GetHash();
+}
+
+} // namespace pandora
+
+#endif // #ifndef PANDORA_PSEUDO_LAYER_CACHE_H
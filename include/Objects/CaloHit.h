@@ -11,6 +11,8 @@
 #include "Pandora/ObjectCreation.h"
 #include "Pandora/StatusCodes.h"
 
+#include <memory>
+
 namespace pandora
 {
 
@@ -219,6 +221,13 @@ public:
      */
     void GetCellCorners(CartesianPointVector &cartesianPointVector) const;
 
+    /**
+     *  @brief  Get the sort key, packing the position and input energy, that defines the deterministic ordering of calo hits
+     * 
+     *  @return the sort key
+     */
+    const SortKey &GetSortKey() const;
+
     /**
      *  @brief  operator< sorting by position, then energy
      * 
@@ -309,34 +318,55 @@ protected:
      */
     void SetAvailability(bool isAvailable);
 
+    /**
+     *  @brief  ColdData class, holding the calo hit properties that are rarely read inside hit loops
+     */
+    class ColdData
+    {
+    public:
+        /**
+         *  @brief  Constructor
+         * 
+         *  @param  parameters the calo hit parameters
+         */
+        ColdData(const object_creation::CaloHit::Parameters &parameters);
+
+        float                   m_x0;                       ///< For LArTPC usage, the x-coordinate shift associated with a drift time t0 shift, units mm
+        const CartesianVector   m_expectedDirection;        ///< Unit vector in direction of expected hit propagation
+        const CartesianVector   m_cellNormalVector;         ///< Unit normal to the sampling layer, pointing outwards from the origin
+        const CellGeometry      m_cellGeometry;             ///< The cell geometry type, pointing or rectangular
+        const float             m_cellSize0;                ///< Cell size 0 [pointing: pseudo rapidity, eta, rectangular: up in ENDCAP, along beam in BARREL, units mm]
+        const float             m_cellSize1;                ///< Cell size 1 [pointing: azimuthal angle, phi, rectangular: perpendicular to size 0 and thickness, units mm]
+        const float             m_cellThickness;            ///< Thickness of cell, units mm
+        const float             m_nCellRadiationLengths;    ///< Absorber material in front of cell, units radiation lengths
+        const float             m_nCellInteractionLengths;  ///< Absorber material in front of cell, units interaction lengths
+        const float             m_time;                     ///< Time of (earliest) energy deposition in this cell, units ns
+        const HitRegion         m_hitRegion;                ///< Region of the detector in which the calo hit is located
+        const unsigned int      m_layer;                    ///< The subdetector readout layer number
+        const bool              m_isInOuterSamplingLayer;   ///< Whether cell is in one of the outermost detector sampling layers
+        MCParticleWeightMap     m_mcParticleWeightMap;      ///< The mc particle weight map
+        const void *const       m_pParentAddress;           ///< The address of the parent calo hit in the user framework
+    };
+
+    // ATTN Hot members, read on every iteration of hit loops or sorts, are packed together at the start of the object (72 bytes, including
+    // vptr). All but the sort key lie within the first 64-byte cache line, and the cold data pointer brings the object to 80 bytes.
     CartesianVector         m_positionVector;           ///< Position vector of center of calorimeter cell, units mm
-    float                   m_x0;                       ///< For LArTPC usage, the x-coordinate shift associated with a drift time t0 shift, units mm
-    const CartesianVector   m_expectedDirection;        ///< Unit vector in direction of expected hit propagation
-    const CartesianVector   m_cellNormalVector;         ///< Unit normal to the sampling layer, pointing outwards from the origin
-    const CellGeometry      m_cellGeometry;             ///< The cell geometry type, pointing or rectangular
-    const float             m_cellSize0;                ///< Cell size 0 [pointing: pseudo rapidity, eta, rectangular: up in ENDCAP, along beam in BARREL, units mm]
-    const float             m_cellSize1;                ///< Cell size 1 [pointing: azimuthal angle, phi, rectangular: perpendicular to size 0 and thickness, units mm]
-    const float             m_cellThickness;            ///< Thickness of cell, units mm
-    const float             m_nCellRadiationLengths;    ///< Absorber material in front of cell, units radiation lengths
-    const float             m_nCellInteractionLengths;  ///< Absorber material in front of cell, units interaction lengths
-    const float             m_time;                     ///< Time of (earliest) energy deposition in this cell, units ns
     const float             m_inputEnergy;              ///< Corrected energy of calorimeter cell in user framework, units GeV
     const float             m_mipEquivalentEnergy;      ///< The calibrated mip equivalent energy, units mip
     const float             m_electromagneticEnergy;    ///< The calibrated electromagnetic energy measure, units GeV
     const float             m_hadronicEnergy;           ///< The calibrated hadronic energy measure, units GeV
-    const bool              m_isDigital;                ///< Whether cell should be treated as digital (implies constant cell energy)
-    const HitType           m_hitType;                  ///< The type of calorimeter hit
-    const HitRegion         m_hitRegion;                ///< Region of the detector in which the calo hit is located
-    const unsigned int      m_layer;                    ///< The subdetector readout layer number
-    InputUInt               m_pseudoLayer;              ///< The pseudo layer to which the calo hit has been assigned
-    const bool              m_isInOuterSamplingLayer;   ///< Whether cell is in one of the outermost detector sampling layers
+    float                   m_weight;                   ///< The calo hit weight, which may not be unity if the hit has been fragmented
     float                   m_cellLengthScale;          ///< Typical length scale [pointing: measured at cell mid-point, rectangular: std::sqrt(cellSize0 * cellSize1), units mm ]
+    unsigned int            m_pseudoLayer;              ///< The pseudo layer to which the calo hit has been assigned
+    const HitType           m_hitType;                  ///< The type of calorimeter hit
+    const bool              m_isDigital;                ///< Whether cell should be treated as digital (implies constant cell energy)
     bool                    m_isPossibleMip;            ///< Whether the calo hit is a possible mip hit
     bool                    m_isIsolated;               ///< Whether the calo hit is isolated
     bool                    m_isAvailable;              ///< Whether the calo hit is available to be added to a cluster
-    float                   m_weight;                   ///< The calo hit weight, which may not be unity if the hit has been fragmented
-    MCParticleWeightMap     m_mcParticleWeightMap;      ///< The mc particle weight map
-    const void             *m_pParentAddress;           ///< The address of the parent calo hit in the user framework
+    SortKey                 m_sortKey;                  ///< The sort key, packing the position and input energy
+    const std::unique_ptr<ColdData> m_pColdData;        ///< The rarely-accessed calo hit properties, owned by the calo hit
+
+    static const unsigned int UNSET_PSEUDO_LAYER;       ///< Pseudo layer value indicating that no pseudo layer has yet been assigned
 
     friend class CaloHitMetadata;
     friend class CaloHitManager;
@@ -356,63 +386,63 @@ inline const CartesianVector &CaloHit::GetPositionVector() const
 
 inline float CaloHit::GetX0() const
 {
-    return m_x0;
+    return m_pColdData->m_x0;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline const CartesianVector &CaloHit::GetExpectedDirection() const
 {
-    return m_expectedDirection;
+    return m_pColdData->m_expectedDirection;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline const CartesianVector &CaloHit::GetCellNormalVector() const
 {
-    return m_cellNormalVector;
+    return m_pColdData->m_cellNormalVector;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline CellGeometry CaloHit::GetCellGeometry() const
 {
-    return m_cellGeometry;
+    return m_pColdData->m_cellGeometry;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline float CaloHit::GetCellSize0() const
 {
-    return m_cellSize0;
+    return m_pColdData->m_cellSize0;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline float CaloHit::GetCellSize1() const
 {
-    return m_cellSize1;
+    return m_pColdData->m_cellSize1;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline float CaloHit::GetCellThickness() const
 {
-    return m_cellThickness;
+    return m_pColdData->m_cellThickness;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline float CaloHit::GetNCellRadiationLengths() const
 {
-    return m_nCellRadiationLengths;
+    return m_pColdData->m_nCellRadiationLengths;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline float CaloHit::GetNCellInteractionLengths() const
 {
-    return m_nCellInteractionLengths;
+    return m_pColdData->m_nCellInteractionLengths;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -426,7 +456,7 @@ inline float CaloHit::GetInputEnergy() const
 
 inline float CaloHit::GetTime() const
 {
-    return m_time;
+    return m_pColdData->m_time;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -447,28 +477,31 @@ inline HitType CaloHit::GetHitType() const
 
 inline HitRegion CaloHit::GetHitRegion() const
 {
-    return m_hitRegion;
+    return m_pColdData->m_hitRegion;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline unsigned int CaloHit::GetLayer() const
 {
-    return m_layer;
+    return m_pColdData->m_layer;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline unsigned int CaloHit::GetPseudoLayer() const
 {
-    return m_pseudoLayer.Get();
+    if (UNSET_PSEUDO_LAYER == m_pseudoLayer)
+        throw StatusCodeException(STATUS_CODE_NOT_INITIALIZED);
+
+    return m_pseudoLayer;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline bool CaloHit::IsInOuterSamplingLayer() const
 {
-    return m_isInOuterSamplingLayer;
+    return m_pColdData->m_isInOuterSamplingLayer;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -524,14 +557,28 @@ inline bool CaloHit::IsIsolated() const
 
 inline const MCParticleWeightMap &CaloHit::GetMCParticleWeightMap() const
 {
-    return m_mcParticleWeightMap;
+    return m_pColdData->m_mcParticleWeightMap;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline const void *CaloHit::GetParentAddress() const
 {
-    return m_pParentAddress;
+    return m_pColdData->m_pParentAddress;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const SortKey &CaloHit::GetSortKey() const
+{
+    return m_sortKey;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool CaloHit::operator< (const CaloHit &rhs) const
+{
+    return (m_sortKey < rhs.m_sortKey);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
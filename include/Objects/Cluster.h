@@ -276,6 +276,14 @@ public:
      */
     void GetClusterSpanZ(const float xmin, const float xmax, float &zmin, float &zmax) const;
 
+    /**
+     *  @brief  Get the cluster content version, which changes whenever calo hits (or isolated calo hits) are added to or removed from the cluster.
+     *          Versions are unique across all clusters, so a (cluster address, version) pair identifies specific cluster content.
+     * 
+     *  @return The cluster content version
+     */
+    uint64_t GetContentVersion() const;
+
 protected:
     /**
      *  @brief  Constructor
@@ -380,6 +388,13 @@ protected:
      */
     void ResetOutdatedProperties();
 
+    /**
+     *  @brief  Get a new, unique cluster content version
+     * 
+     *  @return the new content version
+     */
+    static uint64_t GetNewContentVersion();
+
     /**
      *  @brief  Add the calo hits from a second cluster to this
      * 
@@ -414,17 +429,46 @@ protected:
     void SetAvailability(bool isAvailable);
 
     /**
-     *  @brief  SimplePoint class
+     *  @brief  PseudoLayerSums class, the running sums for the calo hits in a single pseudo layer
      */
-    class SimplePoint
+    class PseudoLayerSums
     {
     public:
+        /**
+         *  @brief  Default constructor
+         */
+        PseudoLayerSums();
+
         double                  m_xyzPositionSums[3];           ///< The sum of the x, y and z hit positions in the pseudo layer
         unsigned int            m_nHits;                        ///< The number of hits in the pseudo layer
+        double                  m_hitTypeEnergySums[N_HIT_TYPES];///< The sum of the hadronic energies in the pseudo layer, for each hit type
+        unsigned int            m_hitTypeNHits[N_HIT_TYPES];    ///< The number of hits in the pseudo layer, for each hit type
     };
 
-    typedef std::map<unsigned int, SimplePoint> PointByPseudoLayerMap;///< The point by pseudo layer typedef
-    typedef std::map<HitType, float> HitTypeToEnergyMap;        ///< The hit type to energy map typedef
+    typedef std::vector<PseudoLayerSums> PseudoLayerSumsVector; ///< The pseudo layer sums vector typedef
+
+    /**
+     *  @brief  Get the running sums for a pseudo layer, extending the pseudo layer sums to cover the pseudo layer if required
+     * 
+     *  @param  pseudoLayer the pseudo layer
+     * 
+     *  @return the running sums for the pseudo layer
+     */
+    PseudoLayerSums &GetPseudoLayerSums(const unsigned int pseudoLayer);
+
+    /**
+     *  @brief  Remove empty entries from the start and end of the pseudo layer sums, so that they span the inner to outer pseudo layers
+     */
+    void TrimPseudoLayerSums();
+
+    /**
+     *  @brief  Get the index of a hit type in the per hit type sums
+     * 
+     *  @param  hitType the hit type
+     * 
+     *  @return the index
+     */
+    static unsigned int GetHitTypeIndex(const HitType hitType);
 
     OrderedCaloHitList          m_orderedCaloHitList;           ///< The ordered calo hit list
     CaloHitList                 m_isolatedCaloHitList;          ///< The list of isolated hits, which contribute only towards cluster energy
@@ -437,7 +481,8 @@ protected:
     double                      m_isolatedHadronicEnergy;       ///< Sum of hadronic energy measures of isolated calo hits, units GeV
     int                         m_particleId;                   ///< The particle id flag
     const Track                *m_pTrackSeed;                   ///< Address of the track with which the cluster is seeded
-    PointByPseudoLayerMap       m_sumXYZByPseudoLayer;          ///< Construct to allow rapid calculation of centroid in each pseudolayer
+    PseudoLayerSumsVector       m_pseudoLayerSums;              ///< The running sums for each pseudo layer, indexed by pseudo layer - offset
+    unsigned int                m_pseudoLayerSumsOffset;        ///< The pseudo layer of the first pseudo layer sums entry (the inner pseudo layer)
     InputUInt                   m_innerPseudoLayer;             ///< The innermost pseudo layer in the cluster
     InputUInt                   m_outerPseudoLayer;             ///< The outermost pseudo layer in the cluster
 
@@ -459,6 +504,7 @@ protected:
 
     TrackList                   m_associatedTrackList;          ///< The list of tracks associated with the cluster
     bool                        m_isAvailable;                  ///< Whether the cluster is available to be added to a particle flow object
+    uint64_t                    m_contentVersion;               ///< The cluster content version, changed upon addition/removal of any calo hit
 
     friend class ClusterManager;
     friend class AlgorithmObjectManager<Cluster>;
@@ -586,6 +632,13 @@ inline bool Cluster::IsAvailable() const
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+inline uint64_t Cluster::GetContentVersion() const
+{
+    return m_contentVersion;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 inline void Cluster::SetAvailability(bool isAvailable)
 {
     m_isAvailable = isAvailable;
@@ -239,6 +239,18 @@ public:
      */
     float GetRadius() const;
 
+    /**
+     *  @brief  Get the phi change from a reference point to a point on the circle, in the direction of motion of the particle.
+     *          Written without branches, so that it can be used in vectorisable loops over many helices.
+     * 
+     *  @param  phi the phi of the point about the circle centre
+     *  @param  phiReference the phi of the reference point about the circle centre
+     *  @param  charge the particle charge
+     * 
+     *  @return The phi change
+     */
+    static float GetDeltaPhi(const float phi, const float phiReference, const float charge);
+
 private:
     static const float FCT;
     static const float TWO_PI;
@@ -386,6 +398,17 @@ inline float Helix::GetRadius() const
     return m_radius;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline float Helix::GetDeltaPhi(const float phi, const float phiReference, const float charge)
+{
+    const float deltaPhi(phi - phiReference);
+    const float positiveShift(((deltaPhi < 0.f) && (charge < 0.f)) ? TWO_PI : 0.f);
+    const float negativeShift(((deltaPhi > 0.f) && (charge > 0.f)) ? TWO_PI : 0.f);
+
+    return (deltaPhi + positiveShift - negativeShift);
+}
+
 } // namespace pandora
 
 #endif // #ifndef PANDORA_HELIX_H
@@ -0,0 +1,176 @@
+/**
+ *  @file   PandoraSDK/include/Objects/HelixBatch.h
+ * 
+ *  @brief  Header file for the helix batch class.
+ * 
+ *  $Log: $
+ */
+#ifndef PANDORA_HELIX_BATCH_H
+#define PANDORA_HELIX_BATCH_H 1
+
+#include "Objects/Helix.h"
+
+#include "Pandora/PandoraInternal.h"
+#include "Pandora/StatusCodes.h"
+
+namespace pandora
+{
+
+/**
+ *  @brief  HelixBatch class, a structure-of-arrays copy of the parameters of many helices, for propagating the helices to a common
+ *          surface, or for comparing helices with many points, in single loops. Each helix is propagated from its own reference
+ *          point and the terms that depend only on the helix (e.g. the phi of the reference point about the circle centre) are
+ *          evaluated once, when the helix is added. Results match those of the corresponding Helix member functions.
+ */
+class HelixBatch
+{
+public:
+    typedef std::vector<StatusCode> StatusCodeVector;
+
+    /**
+     *  @brief  Default constructor
+     */
+    HelixBatch();
+
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  helixVector the helices to add to the batch
+     */
+    HelixBatch(const std::vector<Helix> &helixVector);
+
+    /**
+     *  @brief  Add a helix to the batch
+     * 
+     *  @param  helix the helix
+     */
+    void AddHelix(const Helix &helix);
+
+    /**
+     *  @brief  Reserve space for a specified number of helices
+     * 
+     *  @param  nHelices the number of helices
+     */
+    void Reserve(const unsigned int nHelices);
+
+    /**
+     *  @brief  Get the number of helices in the batch
+     * 
+     *  @return The number of helices
+     */
+    unsigned int GetNHelices() const;
+
+    /**
+     *  @brief  Get the intersection of each helix with a plane parallel to z axis. The plane is defined by two coordinates in the
+     *          plane (x0,y0) and a normal vector (ax,ay). Mirrors Helix::GetPointInXY for each helix, using its reference point.
+     * 
+     *  @param  x0 x coordinate in the specified plane
+     *  @param  y0 y coordinate in the specified plane
+     *  @param  ax x component of vector normal to specified plane
+     *  @param  ay y component of vector normal to specified plane
+     *  @param  intersectionPoints to receive the intersection point for each helix
+     *  @param  genericTimes to receive the generic time for each helix
+     *  @param  statusCodes to receive the status code for each helix (intersection point and time are only valid on success)
+     */
+    void GetPointsInXY(const float x0, const float y0, const float ax, const float ay, CartesianPointVector &intersectionPoints,
+        FloatVector &genericTimes, StatusCodeVector &statusCodes) const;
+
+    /**
+     *  @brief  Get the intersection of each helix with a plane perpendicular to z axis. Mirrors Helix::GetPointInZ for each helix,
+     *          using its reference point.
+     * 
+     *  @param  zPlane the z coordinate for the specified plane
+     *  @param  intersectionPoints to receive the intersection point for each helix
+     *  @param  genericTimes to receive the generic time for each helix
+     *  @param  statusCodes to receive the status code for each helix (intersection point and time are only valid on success)
+     */
+    void GetPointsInZ(const float zPlane, CartesianPointVector &intersectionPoints, FloatVector &genericTimes,
+        StatusCodeVector &statusCodes) const;
+
+    /**
+     *  @brief  Get the intersection of each helix with a cylinder, aligned along z-axis. Mirrors Helix::GetPointOnCircle for each
+     *          helix, using its reference point.
+     * 
+     *  @param  radius the radius of the cylinder
+     *  @param  intersectionPoints to receive the intersection point for each helix
+     *  @param  genericTimes to receive the generic time for each helix
+     *  @param  statusCodes to receive the status code for each helix (intersection point and time are only valid on success)
+     */
+    void GetPointsOnCircle(const float radius, CartesianPointVector &intersectionPoints, FloatVector &genericTimes,
+        StatusCodeVector &statusCodes) const;
+
+    /**
+     *  @brief  Get the distance of closest approach of each helix to a specified point. Mirrors Helix::GetDistanceToPoint.
+     * 
+     *  @param  point coordinates of the specified point
+     *  @param  distances to receive, for each helix, the distance in the R-Phi plane (x), along Z axis (y) and 3D magnitude (z)
+     *  @param  genericTimes to receive the generic time for each helix
+     */
+    void GetDistancesToPoint(const CartesianVector &point, CartesianPointVector &distances, FloatVector &genericTimes) const;
+
+    /**
+     *  @brief  Get the distance of closest approach of a single helix in the batch to each of a list of points. Mirrors
+     *          Helix::GetDistanceToPoint.
+     * 
+     *  @param  helixIndex the index of the helix in the batch
+     *  @param  points the coordinates of the specified points
+     *  @param  distances to receive, for each point, the distance in the R-Phi plane (x), along Z axis (y) and 3D magnitude (z)
+     *  @param  genericTimes to receive the generic time for each point
+     */
+    void GetDistancesToPoints(const unsigned int helixIndex, const CartesianPointVector &points, CartesianPointVector &distances,
+        FloatVector &genericTimes) const;
+
+private:
+    /**
+     *  @brief  Given the two candidate intersection points for each helix, select the one reached first and its generic time
+     * 
+     *  @param  xx1 the first candidate x coordinates, to receive the x coordinates of the selected intersections
+     *  @param  yy1 the first candidate y coordinates, to receive the y coordinates of the selected intersections
+     *  @param  xx2 the second candidate x coordinates
+     *  @param  yy2 the second candidate y coordinates
+     *  @param  statusCodes the status code for each helix, intersections being selected only for helices with status code success
+     *  @param  genericTimes to receive the generic time of each selected intersection, or zero if no intersection is selected
+     * 
+     *  @return The number of helices with a selected intersection, for which either candidate has a negative generic time
+     */
+    unsigned int SelectFirstIntersections(FloatVector &xx1, FloatVector &yy1, const FloatVector &xx2, const FloatVector &yy2,
+        const StatusCodeVector &statusCodes, FloatVector &genericTimes) const;
+
+    /**
+     *  @brief  Get the distance of closest approach of a helix in the batch to a specified point
+     * 
+     *  @param  index the index of the helix in the batch
+     *  @param  pointX the x coordinate of the point
+     *  @param  pointY the y coordinate of the point
+     *  @param  pointZ the z coordinate of the point
+     *  @param  distance to receive the distance in the R-Phi plane (x), along Z axis (y) and 3D magnitude (z)
+     *  @param  genericTime to receive the generic time
+     */
+    void GetDistanceToPoint(const unsigned int index, const float pointX, const float pointY, const float pointZ, CartesianVector &distance,
+        float &genericTime) const;
+
+    static const float TWO_PI;
+
+    FloatVector         m_xCentre;              ///< The circle centre x coordinates
+    FloatVector         m_yCentre;              ///< The circle centre y coordinates
+    FloatVector         m_radius;               ///< The circle radii in the XY plane
+    FloatVector         m_charge;               ///< The particle charges
+    FloatVector         m_pxy;                  ///< The transverse momenta
+    FloatVector         m_pz;                   ///< The z momentum components at the reference points
+    FloatVector         m_tanLambda;            ///< The tangents of the dip angles
+    FloatVector         m_referenceZ;           ///< The reference point z coordinates
+    FloatVector         m_phiReference;         ///< The phi of each reference point about its circle centre
+    FloatVector         m_distCentreToIP;       ///< The distance from each circle centre to the IP in the XY plane
+    FloatVector         m_phiCentre;            ///< The phi of each circle centre about the IP
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int HelixBatch::GetNHelices() const
+{
+    return static_cast<unsigned int>(m_xCentre.size());
+}
+
+} // namespace pandora
+
+#endif // #ifndef PANDORA_HELIX_BATCH_H
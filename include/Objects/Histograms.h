@@ -8,11 +8,16 @@
 #ifndef PANDORA_HISTOGRAMS_H
 #define PANDORA_HISTOGRAMS_H 1
 
-#include <map>
+#include "Pandora/PandoraInternal.h"
+
+#include <atomic>
+#include <mutex>
 
 namespace pandora
 {
 
+class BinaryFileReader;
+class BinaryFileWriter;
 class TiXmlDocument;
 class TiXmlHandle;
 
@@ -41,6 +46,14 @@ public:
      */
     Histogram(const TiXmlHandle *const pXmlHandle, const std::string &xmlElementName);
 
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  fileReader the binary file reader, positioned at the start of a histogram written via WriteToBinary
+     *  @param  histogramName the name of the histogram, which must match the name recorded in the file
+     */
+    Histogram(BinaryFileReader &fileReader, const std::string &histogramName);
+
     /**
      *  @brief  Copy constructor
      * 
@@ -210,7 +223,7 @@ public:
     void SetBinContent(const int binX, const float value);
 
     /**
-     *  @brief  Add an entry to the histogram
+     *  @brief  Add an entry to the histogram, ignoring entries with nan values
      * 
      *  @param  valueX the value for the entry
      *  @param  weight the weight associated with this entry
@@ -224,6 +237,19 @@ public:
      */
     void Scale(const float scaleFactor);
 
+    /**
+     *  @brief  Add the contents of another histogram, with identical binning, to this histogram
+     * 
+     *  @param  rhs the histogram to add
+     *  @param  scaleFactor the factor by which to scale the contents of rhs before adding
+     */
+    void Add(const Histogram &rhs, const float scaleFactor = 1.f);
+
+    /**
+     *  @brief  Reset the contents of all histogram bins to zero
+     */
+    void Reset();
+
     /**
      *  @brief  Write the histogram to an xml document
      * 
@@ -232,10 +258,26 @@ public:
      */
     void WriteToXml(TiXmlDocument *const pTiXmlDocument, const std::string &xmlElementName) const;
 
+    /**
+     *  @brief  Write the histogram, in binary form, at the current position of a binary file writer. No event or geometry
+     *          container is opened, so histograms should be written to dedicated files, rather than interleaved with events.
+     * 
+     *  @param  fileWriter the binary file writer
+     *  @param  histogramName the name of the histogram, recorded in the file
+     */
+    void WriteToBinary(BinaryFileWriter &fileWriter, const std::string &histogramName) const;
+
 private:
-    typedef std::map<int, float> HistogramMap;
+    /**
+     *  @brief  Get the index in the bin contents vector for a specified bin
+     * 
+     *  @param  binX the specified bin number, which must lie in the range [underflow bin, overflow bin]
+     * 
+     *  @return The index in the bin contents vector
+     */
+    unsigned int GetBinIndex(const int binX) const;
 
-    HistogramMap        m_histogramMap;         ///< The histogram map
+    FloatVector         m_binContents;          ///< The bin contents, ordered from the underflow bin to the overflow bin
 
     int                 m_nBinsX;               ///< The number of x bins
     float               m_xLow;                 ///< The min binned x value
@@ -273,6 +315,14 @@ public:
      */
     TwoDHistogram(const TiXmlHandle *const pXmlHandle, const std::string &xmlElementName);
 
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  fileReader the binary file reader, positioned at the start of a histogram written via WriteToBinary
+     *  @param  histogramName the name of the histogram, which must match the name recorded in the file
+     */
+    TwoDHistogram(BinaryFileReader &fileReader, const std::string &histogramName);
+
     /**
      *  @brief  Copy constructor
      * 
@@ -280,6 +330,13 @@ public:
      */
     TwoDHistogram(const TwoDHistogram &rhs);
 
+    /**
+     *  @brief  Assignment operator
+     * 
+     *  @param  rhs the histogram to assign
+     */
+    TwoDHistogram &operator=(const TwoDHistogram &rhs);
+
     /**
      *  @brief  Get the number of x bins
      * 
@@ -434,7 +491,8 @@ public:
 
     /**
      *  @brief  Get the cumulative sum of bin entries in a specified range of the histogram
-     *          (includes overflow and underflow bins if specified)
+     *          (includes overflow and underflow bins if specified). Evaluated in constant time using a summed area table,
+     *          which is rebuilt on first use after the bin contents change.
      * 
      *  @param  xLowBin bin at start of specified x range
      *  @param  xHighBin bin at end of specified x range
@@ -564,7 +622,7 @@ public:
     void SetBinContent(const int binX, const int binY, const float value);
 
     /**
-     *  @brief  Add an entry to the histogram
+     *  @brief  Add an entry to the histogram, ignoring entries with nan values
      * 
      *  @param  valueX the x value for the entry
      *  @param  valueY the y value for the entry
@@ -579,6 +637,19 @@ public:
      */
     void Scale(const float scaleFactor);
 
+    /**
+     *  @brief  Add the contents of another histogram, with identical binning, to this histogram
+     * 
+     *  @param  rhs the histogram to add
+     *  @param  scaleFactor the factor by which to scale the contents of rhs before adding
+     */
+    void Add(const TwoDHistogram &rhs, const float scaleFactor = 1.f);
+
+    /**
+     *  @brief  Reset the contents of all histogram bins to zero
+     */
+    void Reset();
+
     /**
      *  @brief  Write the histogram to an xml document
      * 
@@ -587,12 +658,40 @@ public:
      */
     void WriteToXml(TiXmlDocument *const pTiXmlDocument, const std::string &xmlElementName) const;
 
+    /**
+     *  @brief  Write the histogram, in binary form, at the current position of a binary file writer. No event or geometry
+     *          container is opened, so histograms should be written to dedicated files, rather than interleaved with events.
+     * 
+     *  @param  fileWriter the binary file writer
+     *  @param  histogramName the name of the histogram, recorded in the file
+     */
+    void WriteToBinary(BinaryFileWriter &fileWriter, const std::string &histogramName) const;
+
 private:
-    typedef std::map<int, float> HistogramMap;
-    typedef std::map<int, HistogramMap> TwoDHistogramMap;
+    typedef std::vector<double> SummedAreaTable;
+
+    /**
+     *  @brief  Get the index in the bin contents vector for a specified bin
+     * 
+     *  @param  binX the specified x bin number, which must lie in the range [underflow x bin, overflow x bin]
+     *  @param  binY the specified y bin number, which must lie in the range [underflow y bin, overflow y bin]
+     * 
+     *  @return The index in the bin contents vector
+     */
+    unsigned int GetBinIndex(const int binX, const int binY) const;
+
+    /**
+     *  @brief  Get the summed area table, rebuilding it if the bin contents have changed since it was last built. Concurrent const
+     *          readers are safe, as for the other const member functions; modifying the histogram concurrently with any reader is not.
+     * 
+     *  @return The summed area table
+     */
+    const SummedAreaTable &GetSummedAreaTable() const;
 
-    TwoDHistogramMap    m_xyHistogramMap;       ///< The x->y->value 2d histogram map
-    TwoDHistogramMap    m_yxHistogramMap;       ///< The y->x->value 2d histogram map
+    FloatVector                 m_binContents;                  ///< The bin contents, in y rows of (nBinsX + 2) x bins, including under/overflow
+    mutable SummedAreaTable     m_summedAreaTable;              ///< The summed area table, with a leading row and column of zeros
+    mutable std::atomic<bool>   m_isSummedAreaTableUpToDate;    ///< Whether the summed area table reflects the current bin contents
+    mutable std::mutex          m_summedAreaTableMutex;         ///< The mutex guarding construction of the summed area table
 
     int                 m_nBinsX;               ///< The number of x bins
     float               m_xLow;                 ///< The min binned x value
@@ -608,6 +707,60 @@ private:
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+/**
+ *  @brief  HistogramAccumulator class, holding one partial histogram per thread (e.g. per ParallelHelper::ForEachBlock block
+ *          index), so that parallel loops can fill histograms without locks. The partial histograms are reduced into a target
+ *          histogram, in a fixed order, once the parallel region has completed.
+ */
+template <typename HISTOGRAM>
+class HistogramAccumulator
+{
+public:
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  prototype the histogram defining the binning of the partial histograms (its contents are not copied)
+     *  @param  nPartials the number of partial histograms
+     */
+    HistogramAccumulator(const HISTOGRAM &prototype, const unsigned int nPartials);
+
+    /**
+     *  @brief  Get the number of partial histograms
+     * 
+     *  @return The number of partial histograms
+     */
+    unsigned int GetNPartials() const;
+
+    /**
+     *  @brief  Get a partial histogram, which must only be filled by a single thread at a time
+     * 
+     *  @param  index the index of the partial histogram
+     * 
+     *  @return The partial histogram
+     */
+    HISTOGRAM &GetPartial(const unsigned int index);
+
+    /**
+     *  @brief  Add the contents of all partial histograms to a target histogram, with identical binning
+     * 
+     *  @param  histogram the target histogram
+     */
+    void Merge(HISTOGRAM &histogram) const;
+
+    /**
+     *  @brief  Reset the contents of all partial histograms to zero
+     */
+    void Reset();
+
+private:
+    typedef std::vector<HISTOGRAM> HistogramVector;
+
+    HistogramVector     m_partials;             ///< The partial histograms
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 inline int Histogram::GetNBinsX() const
 {
     return m_nBinsX;
@@ -664,6 +817,13 @@ inline int Histogram::GetOverflowBinNumber() const
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+inline unsigned int Histogram::GetBinIndex(const int binX) const
+{
+    return static_cast<unsigned int>(binX - this->GetUnderflowBinNumber());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 inline float Histogram::GetCumulativeSum() const
 {
     return this->GetCumulativeSum(this->GetMinBinNumber(), this->GetMaxBinNumber());
@@ -803,6 +963,14 @@ inline int TwoDHistogram::GetOverflowBinNumberY() const
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+inline unsigned int TwoDHistogram::GetBinIndex(const int binX, const int binY) const
+{
+    return (static_cast<unsigned int>(binY - this->GetUnderflowBinNumberY()) * static_cast<unsigned int>(m_nBinsX + 2)) +
+        static_cast<unsigned int>(binX - this->GetUnderflowBinNumberX());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 inline float TwoDHistogram::GetCumulativeSum() const
 {
     return this->GetCumulativeSum(this->GetMinBinNumberX(), this->GetMaxBinNumberX(), this->GetMinBinNumberY(), this->GetMaxBinNumberY());
@@ -843,6 +1011,53 @@ inline float TwoDHistogram::GetStandardDeviationY() const
     return this->GetStandardDeviationY(this->GetMinBinNumberX(), this->GetMaxBinNumberX(), this->GetMinBinNumberY(), this->GetMaxBinNumberY());
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename HISTOGRAM>
+inline HistogramAccumulator<HISTOGRAM>::HistogramAccumulator(const HISTOGRAM &prototype, const unsigned int nPartials) :
+    m_partials(nPartials, prototype)
+{
+    this->Reset();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename HISTOGRAM>
+inline unsigned int HistogramAccumulator<HISTOGRAM>::GetNPartials() const
+{
+    return static_cast<unsigned int>(m_partials.size());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename HISTOGRAM>
+inline HISTOGRAM &HistogramAccumulator<HISTOGRAM>::GetPartial(const unsigned int index)
+{
+    if (index >= m_partials.size())
+        throw StatusCodeException(STATUS_CODE_OUT_OF_RANGE);
+
+    return m_partials[index];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename HISTOGRAM>
+inline void HistogramAccumulator<HISTOGRAM>::Merge(HISTOGRAM &histogram) const
+{
+    for (const HISTOGRAM &partial : m_partials)
+        histogram.Add(partial);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename HISTOGRAM>
+inline void HistogramAccumulator<HISTOGRAM>::Reset()
+{
+    for (HISTOGRAM &partial : m_partials)
+        partial.Reset();
+}
+
 } // namespace pandora
 
 #endif // #ifndef PANDORA_HISTOGRAMS_H
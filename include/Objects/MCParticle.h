@@ -130,6 +130,13 @@ public:
      */
     const MCParticleList &GetDaughterList() const;
 
+    /**
+     *  @brief  Get the sort key, packing the vertex position and energy, that defines the deterministic ordering of mc particles
+     * 
+     *  @return the sort key
+     */
+    const SortKey &GetSortKey() const;
+
     /**
      *  @brief  operator< sorting by vertex position, then energy
      * 
@@ -201,6 +208,7 @@ protected:
     const float             m_outerRadius;              ///< Outer radius of the particle's path, units mm
     const int               m_particleId;               ///< The PDG code of the mc particle
     const MCParticleType    m_mcParticleType;           ///< The type of the mc particle, e.g. vertex, 2D-projection, etc.
+    const SortKey           m_sortKey;                  ///< The sort key, packing the vertex position and energy
     const MCParticle       *m_pPfoTarget;               ///< The address of the pfo target
     MCParticleList          m_daughterList;             ///< The list of mc daughter particles
     MCParticleList          m_parentList;               ///< The list of mc parent particles
@@ -308,6 +316,20 @@ inline const MCParticleList &MCParticle::GetDaughterList() const
     return m_daughterList;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const SortKey &MCParticle::GetSortKey() const
+{
+    return m_sortKey;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool MCParticle::operator< (const MCParticle &rhs) const
+{
+    return (m_sortKey < rhs.m_sortKey);
+}
+
 } // namespace pandora
 
 #endif // #ifndef PANDORA_MC_PARTICLE_H
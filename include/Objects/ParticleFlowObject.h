@@ -11,6 +11,9 @@
 #include "Pandora/ObjectCreation.h"
 #include "Pandora/StatusCodes.h"
 
+#include <deque>
+#include <mutex>
+
 namespace pandora
 {
 
@@ -19,6 +22,67 @@ template<typename T, typename S> class PandoraObjectFactory;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+/**
+ *  @brief  PropertyRegistry class, interning pfo property names to small integer ids. Ids are shared by all pandora instances and
+ *          remain valid for the lifetime of the process, so clients should look up the ids of frequently used properties only once.
+ */
+class PropertyRegistry
+{
+public:
+    /**
+     *  @brief  Get the id for a property name, registering the name if it is not yet known
+     * 
+     *  @param  propertyName the property name
+     * 
+     *  @return the property id
+     */
+    static PropertyId GetPropertyId(const std::string &propertyName);
+
+    /**
+     *  @brief  Get the name of a registered property
+     * 
+     *  @param  propertyId the property id
+     * 
+     *  @return the property name
+     */
+    static const std::string &GetPropertyName(const PropertyId propertyId);
+
+    /**
+     *  @brief  Find the id for a property name, without registering the name if it is not yet known
+     * 
+     *  @param  propertyName the property name
+     *  @param  propertyId to receive the property id
+     * 
+     *  @return whether the property name is registered
+     */
+    static bool FindPropertyId(const std::string &propertyName, PropertyId &propertyId);
+
+    /**
+     *  @brief  Whether a property id has been registered
+     * 
+     *  @param  propertyId the property id
+     * 
+     *  @return boolean
+     */
+    static bool IsRegistered(const PropertyId propertyId);
+
+private:
+    /**
+     *  @brief  Get the process-wide registry instance
+     * 
+     *  @return the registry instance
+     */
+    static PropertyRegistry &GetInstance();
+
+    typedef std::unordered_map<std::string, PropertyId> NameToIdMap;
+
+    std::mutex              m_mutex;                    ///< The mutex guarding registration and lookup
+    NameToIdMap             m_nameToIdMap;              ///< The map from property name to property id
+    std::deque<std::string> m_propertyNames;            ///< The property names, indexed by property id
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 /**
  *  @brief  ParticleFlowObject class
  */
@@ -89,7 +153,8 @@ public:
     TrackAddressList GetTrackAddressList() const;
 
     /**
-     *  @brief  Get the cluster address list
+     *  @brief  Get the cluster address list, holding the parent addresses of the calo hits and isolated calo hits in each cluster,
+     *          ordered by pseudo layer
      * 
      *  @return The cluster address list
      */
@@ -138,11 +203,36 @@ public:
     unsigned int GetNDaughterPfos() const;
 
     /**
-     *  @brief  Get the map from registered property name to floating point property value
+     *  @brief  Get the map from registered property name to floating point property value, built on demand from the property vector
      * 
      *  @return The properties map
      */
-    const PropertiesMap &GetPropertiesMap() const;
+    PropertiesMap GetPropertiesMap() const;
+
+    /**
+     *  @brief  Get the interned property ids and floating point property values, ordered by property id
+     * 
+     *  @return The property vector
+     */
+    const PropertyVector &GetProperties() const;
+
+    /**
+     *  @brief  Whether the particle flow object has a value for a specified property
+     * 
+     *  @param  propertyId the interned property id
+     * 
+     *  @return boolean
+     */
+    bool HasProperty(const PropertyId propertyId) const;
+
+    /**
+     *  @brief  Get the value of a specified property, throws if the property is not present
+     * 
+     *  @param  propertyId the interned property id
+     * 
+     *  @return The property value
+     */
+    float GetProperty(const PropertyId propertyId) const;
 
 protected:
     /**
@@ -209,23 +299,54 @@ protected:
     StatusCode RemoveDaughter(const ParticleFlowObject *const pPfo);
 
     /**
-     *  @brief  Update the properties map
+     *  @brief  Update the properties, applying either all or none of the property changes in the metadata
      * 
      *  @param  metaData the new particle flow object metadata
      */
-    StatusCode UpdatePropertiesMap(const object_creation::ParticleFlowObject::Metadata &metadata);
+    StatusCode UpdateProperties(const object_creation::ParticleFlowObject::Metadata &metadata);
+
+    /**
+     *  @brief  Find the entry for a specified property in the property vector
+     * 
+     *  @param  propertyId the interned property id
+     * 
+     *  @return iterator to the entry if present, otherwise to the position at which it would be inserted
+     */
+    PropertyVector::const_iterator FindProperty(const PropertyId propertyId) const;
+
+    /**
+     *  @brief  Get the interned ids and values of the properties to add, and the ids of the properties to remove, from metadata. New
+     *          property names are registered only once all of the property changes have been validated.
+     * 
+     *  @param  metadata the particle flow object metadata
+     *  @param  propertiesToAdd to receive the properties to add, in order of application
+     *  @param  propertyIdsToRemove to receive the ids of the properties to remove
+     * 
+     *  @return STATUS_CODE_INVALID_PARAMETER for unregistered property ids or properties both added and removed, STATUS_CODE_NOT_FOUND
+     *          for properties to remove that are not present
+     */
+    StatusCode GetPropertyChanges(const object_creation::ParticleFlowObject::Metadata &metadata, PropertyVector &propertiesToAdd,
+        PropertyIdVector &propertyIdsToRemove) const;
+
+    /**
+     *  @brief  Fill a calo hit address list with the parent addresses of the calo hits and isolated calo hits in a cluster
+     * 
+     *  @param  pCluster address of the cluster
+     *  @param  caloHitAddressList to receive the calo hit addresses, ordered by pseudo layer
+     */
+    static void FillCaloHitAddressList(const Cluster *const pCluster, CaloHitAddressList &caloHitAddressList);
 
     int                     m_particleId;               ///< The particle flow object id (PDG code)
     int                     m_charge;                   ///< The particle flow object charge
     float                   m_mass;                     ///< The particle flow object mass
     float                   m_energy;                   ///< The particle flow object energy
     CartesianVector         m_momentum;                 ///< The particle flow object momentum
-    TrackList               m_trackList;                ///< The track list
-    ClusterList             m_clusterList;              ///< The cluster list
-    VertexList              m_vertexList;               ///< The vertex list
-    PfoList                 m_parentPfoList;            ///< The list of parent pfos
-    PfoList                 m_daughterPfoList;          ///< The list of daughter pfos
-    PropertiesMap           m_propertiesMap;            ///< The map from registered property name to floating point property value
+    IndexedList<TrackList>  m_trackList;                ///< The track list
+    IndexedList<ClusterList> m_clusterList;             ///< The cluster list
+    IndexedList<VertexList> m_vertexList;               ///< The vertex list
+    IndexedList<PfoList>    m_parentPfoList;            ///< The list of parent pfos
+    IndexedList<PfoList>    m_daughterPfoList;          ///< The list of daughter pfos
+    PropertyVector          m_properties;               ///< The interned property ids and floating point property values, ordered by id
 
     friend class ParticleFlowObjectManager;
     friend class AlgorithmObjectManager<ParticleFlowObject>;
@@ -273,70 +394,86 @@ inline const CartesianVector &ParticleFlowObject::GetMomentum() const
 
 inline const TrackList &ParticleFlowObject::GetTrackList() const
 {
-    return m_trackList;
+    return m_trackList.GetList();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline const ClusterList &ParticleFlowObject::GetClusterList() const
 {
-    return m_clusterList;
+    return m_clusterList.GetList();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline const VertexList &ParticleFlowObject::GetVertexList() const
 {
-    return m_vertexList;
+    return m_vertexList.GetList();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline unsigned int ParticleFlowObject::GetNTracks() const
 {
-    return m_trackList.size();
+    return m_trackList.GetList().size();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline unsigned int ParticleFlowObject::GetNClusters() const
 {
-    return m_clusterList.size();
+    return m_clusterList.GetList().size();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline const PfoList &ParticleFlowObject::GetParentPfoList() const
 {
-    return m_parentPfoList;
+    return m_parentPfoList.GetList();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline const PfoList &ParticleFlowObject::GetDaughterPfoList() const
 {
-    return m_daughterPfoList;
+    return m_daughterPfoList.GetList();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline unsigned int ParticleFlowObject::GetNParentPfos() const
 {
-    return m_parentPfoList.size();
+    return m_parentPfoList.GetList().size();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 inline unsigned int ParticleFlowObject::GetNDaughterPfos() const
 {
-    return m_daughterPfoList.size();
+    return m_daughterPfoList.GetList().size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const PropertyVector &ParticleFlowObject::GetProperties() const
+{
+    return m_properties;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool ParticleFlowObject::HasProperty(const PropertyId propertyId) const
+{
+    const PropertyVector::const_iterator iter(this->FindProperty(propertyId));
+    return ((m_properties.end() != iter) && (propertyId == iter->first));
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-inline const PropertiesMap &ParticleFlowObject::GetPropertiesMap() const
+inline PropertyVector::const_iterator ParticleFlowObject::FindProperty(const PropertyId propertyId) const
 {
-    return m_propertiesMap;
+    return std::lower_bound(m_properties.begin(), m_properties.end(), propertyId,
+        [](const PropertyVector::value_type &entry, const PropertyId id) -> bool { return (entry.first < id); });
 }
 
 } // namespace pandora
@@ -11,9 +11,14 @@
 #include "Pandora/ObjectCreation.h"
 #include "Pandora/StatusCodes.h"
 
+#include <memory>
+#include <mutex>
+
 namespace pandora
 {
 
+class Helix;
+class PluginManager;
 template<typename T> class InputObjectManager;
 template<typename T, typename S> class PandoraObjectFactory;
 
@@ -95,6 +100,28 @@ public:
      */
     const TrackState &GetTrackStateAtCalorimeter() const;
 
+    /**
+     *  @brief  Get the helix describing the track state at the start of the track. The helix is built on first request, using the
+     *          b field at the origin, and is then cached for the lifetime of the track (i.e. until the event is reset)
+     * 
+     *  @return the helix at the start of the track
+     */
+    const Helix &GetHelixAtStart() const;
+
+    /**
+     *  @brief  Get the helix describing the track state at the end of the track, built on first request and then cached
+     * 
+     *  @return the helix at the end of the track
+     */
+    const Helix &GetHelixAtEnd() const;
+
+    /**
+     *  @brief  Get the helix describing the track state at the calorimeter, built on first request and then cached
+     * 
+     *  @return the helix at the calorimeter
+     */
+    const Helix &GetHelixAtCalorimeter() const;
+
     /**
      *  @brief  Get the (sometimes projected) time at the calorimeter
      * 
@@ -262,6 +289,24 @@ protected:
      */
     void SetAvailability(bool isAvailable);
 
+    /**
+     *  @brief  Set the plugin manager, providing the b field used to build the track helices
+     * 
+     *  @param  pPluginManager the address of the plugin manager
+     */
+    void SetPluginManager(const PluginManager *const pPluginManager);
+
+    /**
+     *  @brief  Get the helix describing a track state, building the helix if it is not yet cached. Safe for concurrent callers.
+     * 
+     *  @param  trackState the track state
+     *  @param  onceFlag the flag recording whether the helix has been built
+     *  @param  pHelix the cached helix
+     * 
+     *  @return the helix
+     */
+    const Helix &GetHelix(const TrackState &trackState, std::once_flag &onceFlag, std::unique_ptr<const Helix> &pHelix) const;
+
     const float             m_d0;                       ///< The 2D impact parameter wrt (0,0), units mm
     const float             m_z0;                       ///< The z coordinate at the 2D distance of closest approach, units mm
     const int               m_particleId;               ///< The PDG code of the tracked particle
@@ -284,6 +329,14 @@ protected:
     TrackList               m_siblingTrackList;         ///< The list of sibling track addresses
     TrackList               m_daughterTrackList;        ///< The list of daughter track addresses
     bool                    m_isAvailable;              ///< Whether the track is available to be added to a particle flow object
+    const PluginManager    *m_pPluginManager;           ///< The plugin manager, providing the b field for the track helices
+
+    mutable std::once_flag                  m_helixAtStartFlag;         ///< Whether the helix at the start of the track has been built
+    mutable std::once_flag                  m_helixAtEndFlag;           ///< Whether the helix at the end of the track has been built
+    mutable std::once_flag                  m_helixAtCalorimeterFlag;   ///< Whether the helix at the calorimeter has been built
+    mutable std::unique_ptr<const Helix>    m_pHelixAtStart;            ///< The cached helix at the start of the track
+    mutable std::unique_ptr<const Helix>    m_pHelixAtEnd;              ///< The cached helix at the end of the track
+    mutable std::unique_ptr<const Helix>    m_pHelixAtCalorimeter;      ///< The cached helix at the calorimeter
 
     friend class TrackManager;
     friend class InputObjectManager<Track>;
@@ -362,6 +415,27 @@ inline const TrackState &Track::GetTrackStateAtCalorimeter() const
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+inline const Helix &Track::GetHelixAtStart() const
+{
+    return this->GetHelix(m_trackStateAtStart, m_helixAtStartFlag, m_pHelixAtStart);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const Helix &Track::GetHelixAtEnd() const
+{
+    return this->GetHelix(m_trackStateAtEnd, m_helixAtEndFlag, m_pHelixAtEnd);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const Helix &Track::GetHelixAtCalorimeter() const
+{
+    return this->GetHelix(m_trackStateAtCalorimeter, m_helixAtCalorimeterFlag, m_pHelixAtCalorimeter);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 inline float Track::GetTimeAtCalorimeter() const
 {
     return m_timeAtCalorimeter;
@@ -451,6 +525,13 @@ inline void Track::SetAvailability(bool isAvailable)
     m_isAvailable = isAvailable;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline void Track::SetPluginManager(const PluginManager *const pPluginManager)
+{
+    m_pPluginManager = pPluginManager;
+}
+
 } // namespace pandora
 
 #endif // #ifndef PANDORA_TRACK_H
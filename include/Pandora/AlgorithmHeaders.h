@@ -15,6 +15,7 @@
 #include "Geometry/SubDetector.h"
 
 #include "Helpers/ClusterFitHelper.h"
+#include "Helpers/HelixHelper.h"
 #include "Helpers/MCParticleHelper.h"
 #include "Helpers/XmlHelper.h"
 
@@ -25,6 +26,7 @@
 #include "Objects/CartesianVector.h"
 #include "Objects/Cluster.h"
 #include "Objects/Helix.h"
+#include "Objects/HelixBatch.h"
 #include "Objects/Histograms.h"
 #include "Objects/MCParticle.h"
 #include "Objects/OrderedCaloHitList.h"
@@ -137,6 +137,7 @@ public:
     pandora::InputUInt                  m_layer;                    ///< The subdetector readout layer number
     pandora::InputBool                  m_isInOuterSamplingLayer;   ///< Whether cell is in one of the outermost detector sampling layers
     pandora::InputAddress               m_pParentAddress;           ///< Address of the parent calo hit in the user framework
+    pandora::InputUInt64                m_cellId;                   ///< Optional unique calorimeter cell id, keying the pseudo layer cache
 };
 
 typedef ObjectCreationHelper<CaloHitParameters, CaloHitMetadata, pandora::CaloHit> CaloHit;
@@ -343,6 +344,8 @@ public:
     pandora::InputCartesianVector       m_momentum;                 ///< The particle flow object momentum
     pandora::PropertiesMap              m_propertiesToAdd;          ///< The mapping from pfo property names to new values
     pandora::StringVector               m_propertiesToRemove;       ///< The vector of pfo property names to remove
+    pandora::PropertyVector             m_propertyIdsToAdd;         ///< The interned pfo property ids and new values, applied after named properties
+    pandora::PropertyIdVector           m_propertyIdsToRemove;      ///< The vector of interned pfo property ids to remove
 };
 
 /**
@@ -74,6 +74,11 @@ enum HitType
     HIT_CUSTOM
 };
 
+/**
+ *  @brief  The number of calorimeter hit types, including HIT_CUSTOM, for tables indexed by hit type
+ */
+static const unsigned int N_HIT_TYPES = HIT_CUSTOM + 1;
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 /**
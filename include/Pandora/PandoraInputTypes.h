@@ -16,6 +16,7 @@
 #include "Pandora/StatusCodes.h"
 
 #include <cmath>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -108,6 +109,7 @@ private:
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 typedef PandoraInputType<unsigned int> InputUInt;
+typedef PandoraInputType<std::uint64_t> InputUInt64;
 typedef PandoraInputType<int> InputInt;
 typedef PandoraInputType<float> InputFloat;
 typedef PandoraInputType<const void *> InputAddress;
@@ -10,8 +10,10 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
+#include <iterator>
 #include <list>
 #include <map>
 #include <set>
@@ -21,6 +23,8 @@
 #include <unordered_set>
 #include <vector>
 
+#include "Pandora/StatusCodes.h"
+
 namespace pandora
 {
 
@@ -45,6 +49,7 @@ class OrderedCaloHitList;
 class ParticleFlowObject;
 class ParticleIdPlugin;
 class PandoraSettings;
+class PseudoLayerCache;
 class PseudoLayerPlugin;
 class ShowerProfilePlugin;
 class SubDetector;
@@ -171,6 +176,176 @@ inline bool PointerLessThan<T>::operator()(const T *lhs, const T *rhs) const
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+/**
+ *  @brief  SortKey class, a packed integer representation of a position and an energy. Comparison of sort keys orders by z, then x, then
+ *          y coordinate (ascending) and then by energy (descending), using integer comparisons alone.
+ */
+class SortKey
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    SortKey();
+
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  x the x coordinate
+     *  @param  y the y coordinate
+     *  @param  z the z coordinate
+     *  @param  energy the energy
+     */
+    SortKey(const float x, const float y, const float z, const float energy);
+
+    /**
+     *  @brief  operator<
+     * 
+     *  @param  rhs the sort key for comparison
+     * 
+     *  @return boolean
+     */
+    bool operator< (const SortKey &rhs) const;
+
+    /**
+     *  @brief  operator==
+     * 
+     *  @param  rhs the sort key for comparison
+     * 
+     *  @return boolean
+     */
+    bool operator== (const SortKey &rhs) const;
+
+private:
+    /**
+     *  @brief  Convert a float to an unsigned integer with the same ordering
+     * 
+     *  @param  value the float value
+     * 
+     *  @return the ordered integer
+     */
+    static uint64_t ToOrderedInteger(const float value);
+
+    uint64_t    m_high;         ///< The ordered z coordinate (upper 32 bits) and x coordinate (lower 32 bits)
+    uint64_t    m_low;          ///< The ordered y coordinate (upper 32 bits) and inverted energy (lower 32 bits)
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline SortKey::SortKey() :
+    m_high(0),
+    m_low(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline SortKey::SortKey(const float x, const float y, const float z, const float energy) :
+    m_high((ToOrderedInteger(z) << 32) | ToOrderedInteger(x)),
+    m_low((ToOrderedInteger(y) << 32) | (0xffffffffULL ^ ToOrderedInteger(energy)))
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool SortKey::operator< (const SortKey &rhs) const
+{
+    return ((m_high < rhs.m_high) || ((m_high == rhs.m_high) && (m_low < rhs.m_low)));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool SortKey::operator== (const SortKey &rhs) const
+{
+    return ((m_high == rhs.m_high) && (m_low == rhs.m_low));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t SortKey::ToOrderedInteger(const float value)
+{
+    // ATTN Map -0 to +0, then flip all bits of negative values and only the sign bit of positive values
+    const float positiveZero(0.f);
+    uint32_t bits(0);
+    std::memcpy(&bits, (0.f == value) ? &positiveZero : &value, sizeof(bits));
+
+    return static_cast<uint64_t>((bits & 0x80000000U) ? ~bits : (bits | 0x80000000U));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Sort a vector of object addresses using the precomputed sort keys of the target objects. Sorting is performed on a contiguous
+ *          copy of the keys, so the target objects are visited only once. Objects with identical keys retain their relative order.
+ * 
+ *  @param  objectVector the vector of object addresses
+ */
+template <typename T>
+void SortByKey(std::vector<const T *> &objectVector);
+
+/**
+ *  @brief  Sort a list of object addresses using the precomputed sort keys of the target objects. Sorting is performed on a contiguous
+ *          copy of the keys, so the target objects are visited only once. Objects with identical keys retain their relative order.
+ * 
+ *  @param  objectList the list of object addresses
+ */
+template <typename T>
+void SortByKey(std::list<const T *> &objectList);
+
+/**
+ *  @brief  Fill a vector of sort key and object address pairs, sorted by sort key
+ * 
+ *  @param  begin the start of the range of object addresses
+ *  @param  end the end of the range of object addresses
+ *  @param  keyVector to receive the sorted sort keys and object addresses
+ */
+template <typename T, typename ITERATOR>
+void GetSortedKeys(ITERATOR begin, ITERATOR end, std::vector<std::pair<SortKey, const T *> > &keyVector);
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename T>
+inline void SortByKey(std::vector<const T *> &objectVector)
+{
+    std::vector<std::pair<SortKey, const T *> > keyVector;
+    GetSortedKeys<T>(objectVector.begin(), objectVector.end(), keyVector);
+
+    for (size_t index = 0; index < keyVector.size(); ++index)
+        objectVector[index] = keyVector[index].second;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename T>
+inline void SortByKey(std::list<const T *> &objectList)
+{
+    std::vector<std::pair<SortKey, const T *> > keyVector;
+    GetSortedKeys<T>(objectList.begin(), objectList.end(), keyVector);
+
+    typename std::vector<std::pair<SortKey, const T *> >::const_iterator keyIter(keyVector.begin());
+
+    for (const T *&pT : objectList)
+        pT = (keyIter++)->second;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename T, typename ITERATOR>
+inline void GetSortedKeys(ITERATOR begin, ITERATOR end, std::vector<std::pair<SortKey, const T *> > &keyVector)
+{
+    keyVector.clear();
+
+    for (ITERATOR iter = begin; iter != end; ++iter)
+        keyVector.emplace_back((*iter)->GetSortKey(), *iter);
+
+    std::stable_sort(keyVector.begin(), keyVector.end(),
+        [](const std::pair<SortKey, const T *> &lhs, const std::pair<SortKey, const T *> &rhs) {return (lhs.first < rhs.first);});
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 /**
  *  @brief  Wrapper around std::list
  */
@@ -428,6 +603,461 @@ inline void MyList<T>::clear()
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+/**
+ *  @brief  IndexedList class, a list of object addresses offering constant time membership checks and removals whilst preserving
+ *          insertion order. A hash index of list positions is only built once the list exceeds MIN_INDEXED_SIZE entries.
+ */
+template <typename LIST>
+class IndexedList
+{
+public:
+    typedef typename LIST::value_type value_type;
+
+    /**
+     *  @brief  Default constructor
+     */
+    IndexedList();
+
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  list the initial list contents
+     */
+    IndexedList(const LIST &list);
+
+    /**
+     *  @brief  Copy constructor
+     * 
+     *  @param  rhs the indexed list to copy
+     */
+    IndexedList(const IndexedList &rhs);
+
+    /**
+     *  @brief  Assignment operator
+     * 
+     *  @param  rhs the indexed list to assign
+     */
+    IndexedList &operator=(const IndexedList &rhs);
+
+    /**
+     *  @brief  Get the list, in insertion order
+     * 
+     *  @return the list
+     */
+    const LIST &GetList() const;
+
+    /**
+     *  @brief  Whether the list contains a specified value
+     * 
+     *  @param  value the value
+     * 
+     *  @return boolean
+     */
+    bool Contains(const value_type &value) const;
+
+    /**
+     *  @brief  Add a value to the end of the list
+     * 
+     *  @param  value the value
+     */
+    StatusCode Add(const value_type &value);
+
+    /**
+     *  @brief  Remove (the first occurrence of) a value from the list
+     * 
+     *  @param  value the value
+     */
+    StatusCode Remove(const value_type &value);
+
+private:
+    typedef typename LIST::const_iterator const_iterator;
+    typedef std::unordered_map<value_type, const_iterator> IndexMap;
+
+    /**
+     *  @brief  Find (the first occurrence of) a value in the list
+     * 
+     *  @param  value the value
+     * 
+     *  @return iterator to the value, or the list end if not found
+     */
+    const_iterator Find(const value_type &value) const;
+
+    /**
+     *  @brief  Build the index, if the list size exceeds the threshold for indexing
+     */
+    void BuildIndex();
+
+    static constexpr unsigned int MIN_INDEXED_SIZE = 8;     ///< The list size above which the index is built and maintained
+
+    LIST            m_list;             ///< The list
+    IndexMap        m_indexMap;         ///< The index of (first occurrences of) values in the list, empty if not yet indexed
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename LIST>
+inline IndexedList<LIST>::IndexedList()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename LIST>
+inline IndexedList<LIST>::IndexedList(const LIST &list) :
+    m_list(list)
+{
+    this->BuildIndex();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename LIST>
+inline IndexedList<LIST>::IndexedList(const IndexedList &rhs) :
+    m_list(rhs.m_list)
+{
+    this->BuildIndex();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename LIST>
+inline IndexedList<LIST> &IndexedList<LIST>::operator=(const IndexedList &rhs)
+{
+    if (this != &rhs)
+    {
+        m_list = rhs.m_list;
+        this->BuildIndex();
+    }
+
+    return *this;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename LIST>
+inline const LIST &IndexedList<LIST>::GetList() const
+{
+    return m_list;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename LIST>
+inline bool IndexedList<LIST>::Contains(const value_type &value) const
+{
+    return (m_list.end() != this->Find(value));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename LIST>
+inline StatusCode IndexedList<LIST>::Add(const value_type &value)
+{
+    if (m_list.end() != this->Find(value))
+        return STATUS_CODE_ALREADY_PRESENT;
+
+    m_list.push_back(value);
+
+    if (!m_indexMap.empty())
+    {
+        m_indexMap.insert(typename IndexMap::value_type(value, std::prev(m_list.end())));
+    }
+    else
+    {
+        this->BuildIndex();
+    }
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename LIST>
+inline StatusCode IndexedList<LIST>::Remove(const value_type &value)
+{
+    const const_iterator iter(this->Find(value));
+
+    if (m_list.end() == iter)
+        return STATUS_CODE_NOT_FOUND;
+
+    m_list.erase(iter);
+
+    if (!m_indexMap.empty())
+    {
+        m_indexMap.erase(value);
+
+        // ATTN Only lists initialised with duplicate entries can hold further occurrences of the value, which must now be indexed
+        if (m_indexMap.size() != m_list.size())
+        {
+            const const_iterator nextIter(std::find(m_list.begin(), m_list.end(), value));
+
+            if (m_list.end() != nextIter)
+                m_indexMap.insert(typename IndexMap::value_type(value, nextIter));
+        }
+    }
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename LIST>
+inline typename IndexedList<LIST>::const_iterator IndexedList<LIST>::Find(const value_type &value) const
+{
+    if (m_indexMap.empty())
+        return std::find(m_list.begin(), m_list.end(), value);
+
+    const typename IndexMap::const_iterator indexIter(m_indexMap.find(value));
+    return ((m_indexMap.end() == indexIter) ? m_list.end() : indexIter->second);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename LIST>
+inline void IndexedList<LIST>::BuildIndex()
+{
+    m_indexMap.clear();
+
+    if (m_list.size() <= MIN_INDEXED_SIZE)
+        return;
+
+    for (const_iterator iter = m_list.begin(); iter != m_list.end(); ++iter)
+        m_indexMap.insert(typename IndexMap::value_type(*iter, iter));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  MCParticleWeightMap class, a small sorted flat map from mc particle address to weight. Up to N_LOCAL_ENTRIES entries are held
+ *          without any heap allocation. Entries are kept in the deterministic order defined by PointerLessThan<MCParticle>.
+ */
+class MCParticleWeightMap
+{
+public:
+    typedef std::pair<const MCParticle *, float> value_type;
+    typedef value_type *iterator;
+    typedef const value_type *const_iterator;
+
+    /**
+     *  @brief  Default constructor
+     */
+    MCParticleWeightMap();
+
+    /**
+     *  @brief  begin
+     */
+    const_iterator begin() const;
+
+    /**
+     *  @brief  end
+     */
+    const_iterator end() const;
+
+    /**
+     *  @brief  begin
+     */
+    iterator begin();
+
+    /**
+     *  @brief  end
+     */
+    iterator end();
+
+    /**
+     *  @brief  size
+     * 
+     *  @return size
+     */
+    unsigned int size() const;
+
+    /**
+     *  @brief  empty
+     * 
+     *  @return boolean
+     */
+    bool empty() const;
+
+    /**
+     *  @brief  clear
+     */
+    void clear();
+
+    /**
+     *  @brief  find
+     * 
+     *  @param  pMCParticle the mc particle address
+     */
+    const_iterator find(const MCParticle *const pMCParticle) const;
+
+    /**
+     *  @brief  find
+     * 
+     *  @param  pMCParticle the mc particle address
+     */
+    iterator find(const MCParticle *const pMCParticle);
+
+    /**
+     *  @brief  count
+     * 
+     *  @param  pMCParticle the mc particle address
+     * 
+     *  @return the number of entries for the mc particle, zero or one
+     */
+    unsigned int count(const MCParticle *const pMCParticle) const;
+
+    /**
+     *  @brief  at, throws STATUS_CODE_NOT_FOUND if there is no entry for the mc particle
+     * 
+     *  @param  pMCParticle the mc particle address
+     * 
+     *  @return the weight
+     */
+    float at(const MCParticle *const pMCParticle) const;
+
+    /**
+     *  @brief  operator[], inserting an entry with zero weight if there is no entry for the mc particle
+     * 
+     *  @param  pMCParticle the mc particle address
+     * 
+     *  @return the weight
+     */
+    float &operator[](const MCParticle *const pMCParticle);
+
+    /**
+     *  @brief  insert, at the position defined by PointerLessThan<MCParticle>
+     * 
+     *  @param  value the mc particle address and weight
+     * 
+     *  @return iterator to the entry for the mc particle, and whether a new entry was inserted
+     */
+    std::pair<iterator, bool> insert(const value_type &value);
+
+private:
+    static const unsigned int N_LOCAL_ENTRIES = 3;
+
+    value_type                  m_localEntries[N_LOCAL_ENTRIES];    ///< The entries, if there are no more than N_LOCAL_ENTRIES
+    std::vector<value_type>     m_heapEntries;                      ///< The entries, if there are more than N_LOCAL_ENTRIES
+    unsigned int                m_size;                             ///< The number of entries
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline MCParticleWeightMap::MCParticleWeightMap() :
+    m_size(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline MCParticleWeightMap::const_iterator MCParticleWeightMap::begin() const
+{
+    return (m_heapEntries.empty() ? m_localEntries : m_heapEntries.data());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline MCParticleWeightMap::const_iterator MCParticleWeightMap::end() const
+{
+    return (this->begin() + m_size);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline MCParticleWeightMap::iterator MCParticleWeightMap::begin()
+{
+    return (m_heapEntries.empty() ? m_localEntries : m_heapEntries.data());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline MCParticleWeightMap::iterator MCParticleWeightMap::end()
+{
+    return (this->begin() + m_size);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int MCParticleWeightMap::size() const
+{
+    return m_size;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool MCParticleWeightMap::empty() const
+{
+    return (0 == m_size);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline void MCParticleWeightMap::clear()
+{
+    m_heapEntries.clear();
+    m_size = 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline MCParticleWeightMap::const_iterator MCParticleWeightMap::find(const MCParticle *const pMCParticle) const
+{
+    const_iterator iter(this->begin());
+    const const_iterator endIter(this->end());
+
+    while ((endIter != iter) && (pMCParticle != iter->first))
+        ++iter;
+
+    return iter;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline MCParticleWeightMap::iterator MCParticleWeightMap::find(const MCParticle *const pMCParticle)
+{
+    iterator iter(this->begin());
+    const iterator endIter(this->end());
+
+    while ((endIter != iter) && (pMCParticle != iter->first))
+        ++iter;
+
+    return iter;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int MCParticleWeightMap::count(const MCParticle *const pMCParticle) const
+{
+    return ((this->end() != this->find(pMCParticle)) ? 1 : 0);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline float MCParticleWeightMap::at(const MCParticle *const pMCParticle) const
+{
+    const_iterator iter(this->find(pMCParticle));
+
+    if (this->end() == iter)
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+
+    return iter->second;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline float &MCParticleWeightMap::operator[](const MCParticle *const pMCParticle)
+{
+    iterator iter(this->find(pMCParticle));
+
+    if (this->end() != iter)
+        return iter->second;
+
+    return this->insert(value_type(pMCParticle, 0.f)).first->second;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 #define MANAGED_CONTAINER std::list
 
 typedef MANAGED_CONTAINER<const CaloHit *> CaloHitList;
@@ -463,7 +1093,9 @@ typedef std::unordered_set<const SubDetector *> SubDetectorSet;
 typedef std::unordered_set<const Track *> TrackSet;
 typedef std::unordered_set<const Vertex *> VertexSet;
 
+typedef std::vector<bool> BoolVector;
 typedef std::vector<int> IntVector;
+typedef std::vector<unsigned int> UIntVector;
 typedef std::vector<float> FloatVector;
 typedef std::vector<std::string> StringVector;
 typedef std::vector<CartesianVector> CartesianPointVector;
@@ -472,13 +1104,16 @@ typedef std::vector<AlgorithmTool *> AlgorithmToolVector;
 
 typedef const void * Uid;
 typedef std::unordered_map<Uid, const MCParticle *> UidToMCParticleMap;
-typedef std::unordered_map<const MCParticle *, float> MCParticleWeightMap;
 typedef std::unordered_map<Uid, MCParticleWeightMap> UidToMCParticleWeightMap;
 typedef std::unordered_map<const Cluster *, const Track * > ClusterToTrackMap;
 typedef std::unordered_map<const Track *, const Cluster * > TrackToClusterMap;
 
 typedef std::set<std::string> StringSet;
 typedef std::map<std::string, float> PropertiesMap;
+
+typedef unsigned int PropertyId;
+typedef std::vector<PropertyId> PropertyIdVector;
+typedef std::vector<std::pair<PropertyId, float> > PropertyVector;
 typedef std::map<std::string, const SubDetector *> SubDetectorMap;
 typedef std::map<unsigned int, const LArTPC *> LArTPCMap;
 
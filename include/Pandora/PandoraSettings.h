@@ -113,6 +113,27 @@ public:
      */
     float GetGapTolerance() const;
 
+    /**
+     *  @brief  Get the number of worker threads available to helpers offering batch, parallel processing
+     * 
+     *  @return the number of worker threads
+     */
+    unsigned int GetNumberOfThreads() const;
+
+    /**
+     *  @brief  Whether to cache the pseudo layers assigned to calorimeter cells, for reuse in subsequent events
+     * 
+     *  @return boolean
+     */
+    bool ShouldCachePseudoLayers() const;
+
+    /**
+     *  @brief  Get the maximum number of calorimeter cells for which pseudo layers may be cached
+     * 
+     *  @return the maximum number of cached cells
+     */
+    unsigned int GetPseudoLayerCacheMaxEntries() const;
+
 private:
     /**
      *  @brief  Initialize pandora settings
@@ -141,6 +162,9 @@ private:
     float    m_mcPfoSelectionLowEnergyNPCutOff;             ///< Low energy cut-off for selection of protons/neutrons as MCPFOs
 
     float    m_gapTolerance;                                ///< Tolerance allowed when declaring a point to be "in" a gap region, units mm
+    unsigned int m_nThreads;                                ///< The number of worker threads available to batch, parallel helpers
+    bool     m_shouldCachePseudoLayers;                     ///< Whether to cache calorimeter cell pseudo layers for reuse across events
+    unsigned int m_pseudoLayerCacheMaxEntries;              ///< The maximum number of calorimeter cells for which pseudo layers are cached
 
     const Pandora *const m_pPandora;                        ///< The associated pandora object
 
@@ -225,6 +249,27 @@ inline float PandoraSettings::GetGapTolerance() const
     return m_gapTolerance;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int PandoraSettings::GetNumberOfThreads() const
+{
+    return m_nThreads;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool PandoraSettings::ShouldCachePseudoLayers() const
+{
+    return m_shouldCachePseudoLayers;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int PandoraSettings::GetPseudoLayerCacheMaxEntries() const
+{
+    return m_pseudoLayerCacheMaxEntries;
+}
+
 } // namespace pandora
 
 #endif // #ifndef PANDORA_SETTINGS_H
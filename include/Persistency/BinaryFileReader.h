@@ -117,8 +117,16 @@ private:
      */
     StatusCode ReadRelationship(bool checkComponentId = true);
 
+    /**
+     *  @brief  Get the number of bytes remaining in the current event/geometry container or, outside a container, in the file
+     * 
+     *  @return the number of bytes remaining
+     */
+    std::streamoff GetNRemainingBytes();
+
     std::ifstream::pos_type         m_containerPosition;    ///< Position of start of the current event/geometry container object in file
     std::ifstream::pos_type         m_containerSize;        ///< Size of the current event/geometry container object in the file
+    std::ifstream::pos_type         m_fileSize;             ///< Size of the file
     std::ifstream                   m_fileStream;           ///< The stream class to read from the file
 };
 
@@ -160,6 +168,28 @@ inline StatusCode BinaryFileReader::ReadVariable(std::string &t)
     return STATUS_CODE_SUCCESS;
 }
 
+template<>
+inline StatusCode BinaryFileReader::ReadVariable(FloatVector &t)
+{
+    unsigned int vectorSize;
+    const StatusCode statusCode(this->ReadVariable(vectorSize));
+
+    if (STATUS_CODE_SUCCESS != statusCode)
+        return statusCode;
+
+    // ATTN Check the recorded size against the remaining length, so a corrupt size cannot trigger an arbitrarily large allocation
+    if (this->GetNRemainingBytes() / static_cast<std::streamoff>(sizeof(float)) < static_cast<std::streamoff>(vectorSize))
+        return STATUS_CODE_FAILURE;
+
+    t.resize(vectorSize);
+    m_fileStream.read(reinterpret_cast<char*>(t.data()), static_cast<std::streamsize>(vectorSize) * sizeof(float));
+
+    if (!m_fileStream.good())
+        return STATUS_CODE_FAILURE;
+
+    return STATUS_CODE_SUCCESS;
+}
+
 template<>
 inline StatusCode BinaryFileReader::ReadVariable(CartesianVector &t)
 {
@@ -87,6 +87,19 @@ inline StatusCode BinaryFileWriter::WriteVariable(const std::string &t)
     return STATUS_CODE_SUCCESS;
 }
 
+template<>
+inline StatusCode BinaryFileWriter::WriteVariable(const FloatVector &t)
+{
+    const unsigned int vectorSize(t.size());
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->WriteVariable(vectorSize));
+    m_fileStream.write(reinterpret_cast<const char*>(t.data()), vectorSize * sizeof(float));
+
+    if (!m_fileStream.good())
+        return STATUS_CODE_FAILURE;
+
+    return STATUS_CODE_SUCCESS;
+}
+
 template<>
 inline StatusCode BinaryFileWriter::WriteVariable(const CartesianVector &t)
 {
@@ -0,0 +1,450 @@
+/**
+ *  @file   PandoraSDK/include/Persistency/GeometrySnapshot.h
+ * 
+ *  @brief  Header file for the geometry snapshot class.
+ * 
+ *  $Log: $
+ */
+#ifndef PANDORA_GEOMETRY_SNAPSHOT_H
+#define PANDORA_GEOMETRY_SNAPSHOT_H 1
+
+#include "Pandora/PandoraInternal.h"
+#include "Pandora/StatusCodes.h"
+
+#include <cstdint>
+#include <string>
+
+namespace pandora
+{
+
+class Pandora;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  GeometrySnapshot class, a read-only view of a binary geometry snapshot file. The file holds the sub detectors (and their
+ *          layers), lar tpcs and detector gaps of a geometry manager as flat arrays of fixed size records, at aligned offsets listed in
+ *          a versioned header. The file is mapped into memory and the records are used in place, without parsing. The mapping is
+ *          read-only and shared, so all processes on a node reading the same snapshot share a single copy of its pages.
+ */
+class GeometrySnapshot
+{
+public:
+    /**
+     *  @brief  SubDetectorRecord class, the parameters of a sub detector
+     */
+    class SubDetectorRecord
+    {
+    public:
+        uint32_t    m_nameOffset;               ///< The offset of the sub detector name in the string table
+        uint32_t    m_nameLength;               ///< The length of the sub detector name
+        uint32_t    m_subDetectorType;          ///< The sub detector type
+        float       m_innerRCoordinate;         ///< Inner cylindrical polar r coordinate, units mm
+        float       m_innerZCoordinate;         ///< Inner cylindrical polar z coordinate, units mm
+        float       m_innerPhiCoordinate;       ///< Inner cylindrical polar phi coordinate
+        uint32_t    m_innerSymmetryOrder;       ///< Order of symmetry of the innermost edge
+        float       m_outerRCoordinate;         ///< Outer cylindrical polar r coordinate, units mm
+        float       m_outerZCoordinate;         ///< Outer cylindrical polar z coordinate, units mm
+        float       m_outerPhiCoordinate;       ///< Outer cylindrical polar phi coordinate
+        uint32_t    m_outerSymmetryOrder;       ///< Order of symmetry of the outermost edge
+        uint32_t    m_isMirroredInZ;            ///< Whether the sub detector is mirrored in the z=0 plane
+        uint32_t    m_firstLayer;               ///< The index of the first layer record of the sub detector
+        uint32_t    m_nLayers;                  ///< The number of layers
+    };
+
+    /**
+     *  @brief  LayerRecord class, the parameters of a sub detector layer
+     */
+    class LayerRecord
+    {
+    public:
+        float       m_closestDistanceToIp;      ///< Closest distance of the layer from the interaction point, units mm
+        float       m_nRadiationLengths;        ///< Absorber material in front of layer, units radiation lengths
+        float       m_nInteractionLengths;      ///< Absorber material in front of layer, units interaction lengths
+    };
+
+    /**
+     *  @brief  LArTPCRecord class, the parameters of a lar tpc
+     */
+    class LArTPCRecord
+    {
+    public:
+        uint32_t    m_larTPCVolumeId;           ///< The lar tpc volume id
+        float       m_centerX;                  ///< The center in x, units mm
+        float       m_centerY;                  ///< The center in y, units mm
+        float       m_centerZ;                  ///< The center in z, units mm
+        float       m_widthX;                   ///< The width in x, units mm
+        float       m_widthY;                   ///< The width in y, units mm
+        float       m_widthZ;                   ///< The width in z, units mm
+        float       m_wirePitchU;               ///< The u wire pitch, units mm
+        float       m_wirePitchV;               ///< The v wire pitch, units mm
+        float       m_wirePitchW;               ///< The w wire pitch, units mm
+        float       m_wireAngleU;               ///< The u wire angle to the vertical, units radians
+        float       m_wireAngleV;               ///< The v wire angle to the vertical, units radians
+        float       m_wireAngleW;               ///< The w wire angle to the vertical, units radians
+        float       m_sigmaUVW;                 ///< The u, v, w resolution, units mm
+        uint32_t    m_isDriftInPositiveX;       ///< Whether the electron drift is in the positive x direction
+    };
+
+    /**
+     *  @brief  LineGapRecord class, the parameters of a line gap
+     */
+    class LineGapRecord
+    {
+    public:
+        uint32_t    m_lineGapType;              ///< The type of line gap
+        float       m_lineStartX;               ///< The line start x coordinate, units mm
+        float       m_lineEndX;                 ///< The line end x coordinate, units mm
+        float       m_lineStartZ;               ///< The line start z coordinate, units mm
+        float       m_lineEndZ;                 ///< The line end z coordinate, units mm
+    };
+
+    /**
+     *  @brief  BoxGapRecord class, the parameters of a box gap
+     */
+    class BoxGapRecord
+    {
+    public:
+        float       m_vertex[3];                ///< Cartesian coordinates of a gap vertex, units mm
+        float       m_side1[3];                 ///< Cartesian vector describing first side meeting vertex, units mm
+        float       m_side2[3];                 ///< Cartesian vector describing second side meeting vertex, units mm
+        float       m_side3[3];                 ///< Cartesian vector describing third side meeting vertex, units mm
+    };
+
+    /**
+     *  @brief  ConcentricGapRecord class, the parameters of a concentric gap
+     */
+    class ConcentricGapRecord
+    {
+    public:
+        float       m_minZCoordinate;           ///< Min cylindrical polar z coordinate, units mm
+        float       m_maxZCoordinate;           ///< Max cylindrical polar z coordinate, units mm
+        float       m_innerRCoordinate;         ///< Inner cylindrical polar r coordinate, units mm
+        float       m_innerPhiCoordinate;       ///< Inner cylindrical polar phi coordinate
+        uint32_t    m_innerSymmetryOrder;       ///< Order of symmetry of the innermost edge
+        float       m_outerRCoordinate;         ///< Outer cylindrical polar r coordinate, units mm
+        float       m_outerPhiCoordinate;       ///< Outer cylindrical polar phi coordinate
+        uint32_t    m_outerSymmetryOrder;       ///< Order of symmetry of the outermost edge
+    };
+
+    /**
+     *  @brief  Constructor, mapping and validating a geometry snapshot file
+     * 
+     *  @param  fileName the name of the geometry snapshot file
+     */
+    GeometrySnapshot(const std::string &fileName);
+
+    /**
+     *  @brief  Destructor, unmapping the geometry snapshot file
+     */
+    ~GeometrySnapshot();
+
+    GeometrySnapshot(const GeometrySnapshot &) = delete;
+    GeometrySnapshot &operator=(const GeometrySnapshot &) = delete;
+
+    /**
+     *  @brief  Write the current geometry of a pandora instance to a geometry snapshot file, replacing any existing file. Only the
+     *          parameters of the standard geometry objects are written, not any additional parameters persisted by user factories.
+     * 
+     *  @param  pandora the pandora instance
+     *  @param  fileName the name of the geometry snapshot file
+     */
+    static StatusCode Write(const Pandora &pandora, const std::string &fileName);
+
+    /**
+     *  @brief  Create the geometry described by the snapshot in a pandora instance, using the standard geometry object factories.
+     *          Gaps are created in the order line gaps, box gaps, concentric gaps.
+     * 
+     *  @param  pandora the pandora instance
+     */
+    StatusCode CreateGeometry(const Pandora &pandora) const;
+
+    /**
+     *  @brief  Get the format version of the snapshot file
+     * 
+     *  @return the format version
+     */
+    unsigned int GetVersion() const;
+
+    /**
+     *  @brief  Get the number of sub detector records
+     * 
+     *  @return the number of sub detector records
+     */
+    unsigned int GetNSubDetectorRecords() const;
+
+    /**
+     *  @brief  Get the address of the first sub detector record, in order of sub detector name
+     * 
+     *  @return the address of the first sub detector record
+     */
+    const SubDetectorRecord *GetSubDetectorRecords() const;
+
+    /**
+     *  @brief  Get the name of a sub detector
+     * 
+     *  @param  subDetectorRecord the sub detector record
+     * 
+     *  @return the sub detector name
+     */
+    std::string GetSubDetectorName(const SubDetectorRecord &subDetectorRecord) const;
+
+    /**
+     *  @brief  Get the number of layer records
+     * 
+     *  @return the number of layer records
+     */
+    unsigned int GetNLayerRecords() const;
+
+    /**
+     *  @brief  Get the address of the first layer record, with the layers of each sub detector stored contiguously
+     * 
+     *  @return the address of the first layer record
+     */
+    const LayerRecord *GetLayerRecords() const;
+
+    /**
+     *  @brief  Get the number of lar tpc records
+     * 
+     *  @return the number of lar tpc records
+     */
+    unsigned int GetNLArTPCRecords() const;
+
+    /**
+     *  @brief  Get the address of the first lar tpc record, in order of volume id
+     * 
+     *  @return the address of the first lar tpc record
+     */
+    const LArTPCRecord *GetLArTPCRecords() const;
+
+    /**
+     *  @brief  Get the number of line gap records
+     * 
+     *  @return the number of line gap records
+     */
+    unsigned int GetNLineGapRecords() const;
+
+    /**
+     *  @brief  Get the address of the first line gap record
+     * 
+     *  @return the address of the first line gap record
+     */
+    const LineGapRecord *GetLineGapRecords() const;
+
+    /**
+     *  @brief  Get the number of box gap records
+     * 
+     *  @return the number of box gap records
+     */
+    unsigned int GetNBoxGapRecords() const;
+
+    /**
+     *  @brief  Get the address of the first box gap record
+     * 
+     *  @return the address of the first box gap record
+     */
+    const BoxGapRecord *GetBoxGapRecords() const;
+
+    /**
+     *  @brief  Get the number of concentric gap records
+     * 
+     *  @return the number of concentric gap records
+     */
+    unsigned int GetNConcentricGapRecords() const;
+
+    /**
+     *  @brief  Get the address of the first concentric gap record
+     * 
+     *  @return the address of the first concentric gap record
+     */
+    const ConcentricGapRecord *GetConcentricGapRecords() const;
+
+    static const unsigned int   FORMAT_VERSION;             ///< The snapshot format version written by this class
+
+private:
+    /**
+     *  @brief  The snapshot section enum
+     */
+    enum Section
+    {
+        SUB_DETECTOR_SECTION,
+        LAYER_SECTION,
+        LAR_TPC_SECTION,
+        LINE_GAP_SECTION,
+        BOX_GAP_SECTION,
+        CONCENTRIC_GAP_SECTION,
+        STRING_SECTION,
+        N_SECTIONS
+    };
+
+    /**
+     *  @brief  SectionRecord class, the location of a section in the snapshot file
+     */
+    class SectionRecord
+    {
+    public:
+        uint64_t    m_offset;                   ///< The offset of the section from the start of the file, a multiple of eight bytes
+        uint32_t    m_nRecords;                 ///< The number of records in the section
+        uint32_t    m_recordSize;               ///< The size of each record in the section, units bytes
+    };
+
+    /**
+     *  @brief  HeaderRecord class, the header at the start of the snapshot file
+     */
+    class HeaderRecord
+    {
+    public:
+        char            m_magic[8];                     ///< The magic string identifying a geometry snapshot file
+        uint32_t        m_version;                      ///< The snapshot format version
+        uint32_t        m_byteOrderMark;                ///< The byte order mark, identifying the byte order of the writing host
+        uint64_t        m_fileSize;                     ///< The total size of the file, units bytes
+        SectionRecord   m_sections[N_SECTIONS];         ///< The locations of the sections
+    };
+
+    /**
+     *  @brief  Check that the mapped file is a complete geometry snapshot of the current format version
+     */
+    void Validate() const;
+
+    /**
+     *  @brief  Get the records of a section
+     * 
+     *  @param  section the section
+     * 
+     *  @return the address of the first record of the section
+     */
+    template <typename RECORD>
+    const RECORD *GetRecords(const Section section) const;
+
+    /**
+     *  @brief  Get the number of records in a section
+     * 
+     *  @param  section the section
+     * 
+     *  @return the number of records
+     */
+    unsigned int GetNRecords(const Section section) const;
+
+    static const char           MAGIC[8];                   ///< The magic string identifying a geometry snapshot file
+    static const uint32_t       BYTE_ORDER_MARK;            ///< The byte order mark
+
+    const char                 *m_pData;                    ///< The address of the mapped file
+    size_t                      m_dataSize;                 ///< The size of the mapped file, units bytes
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int GeometrySnapshot::GetVersion() const
+{
+    return reinterpret_cast<const HeaderRecord*>(m_pData)->m_version;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int GeometrySnapshot::GetNSubDetectorRecords() const
+{
+    return this->GetNRecords(SUB_DETECTOR_SECTION);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const GeometrySnapshot::SubDetectorRecord *GeometrySnapshot::GetSubDetectorRecords() const
+{
+    return this->GetRecords<SubDetectorRecord>(SUB_DETECTOR_SECTION);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline std::string GeometrySnapshot::GetSubDetectorName(const SubDetectorRecord &subDetectorRecord) const
+{
+    return std::string(this->GetRecords<char>(STRING_SECTION) + subDetectorRecord.m_nameOffset, subDetectorRecord.m_nameLength);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int GeometrySnapshot::GetNLayerRecords() const
+{
+    return this->GetNRecords(LAYER_SECTION);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const GeometrySnapshot::LayerRecord *GeometrySnapshot::GetLayerRecords() const
+{
+    return this->GetRecords<LayerRecord>(LAYER_SECTION);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int GeometrySnapshot::GetNLArTPCRecords() const
+{
+    return this->GetNRecords(LAR_TPC_SECTION);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const GeometrySnapshot::LArTPCRecord *GeometrySnapshot::GetLArTPCRecords() const
+{
+    return this->GetRecords<LArTPCRecord>(LAR_TPC_SECTION);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int GeometrySnapshot::GetNLineGapRecords() const
+{
+    return this->GetNRecords(LINE_GAP_SECTION);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const GeometrySnapshot::LineGapRecord *GeometrySnapshot::GetLineGapRecords() const
+{
+    return this->GetRecords<LineGapRecord>(LINE_GAP_SECTION);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int GeometrySnapshot::GetNBoxGapRecords() const
+{
+    return this->GetNRecords(BOX_GAP_SECTION);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const GeometrySnapshot::BoxGapRecord *GeometrySnapshot::GetBoxGapRecords() const
+{
+    return this->GetRecords<BoxGapRecord>(BOX_GAP_SECTION);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int GeometrySnapshot::GetNConcentricGapRecords() const
+{
+    return this->GetNRecords(CONCENTRIC_GAP_SECTION);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const GeometrySnapshot::ConcentricGapRecord *GeometrySnapshot::GetConcentricGapRecords() const
+{
+    return this->GetRecords<ConcentricGapRecord>(CONCENTRIC_GAP_SECTION);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename RECORD>
+inline const RECORD *GeometrySnapshot::GetRecords(const Section section) const
+{
+    return reinterpret_cast<const RECORD*>(m_pData + reinterpret_cast<const HeaderRecord*>(m_pData)->m_sections[section].m_offset);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int GeometrySnapshot::GetNRecords(const Section section) const
+{
+    return reinterpret_cast<const HeaderRecord*>(m_pData)->m_sections[section].m_nRecords;
+}
+
+} // namespace pandora
+
+#endif // #ifndef PANDORA_GEOMETRY_SNAPSHOT_H
@@ -72,6 +72,7 @@ enum FileType
 {
     BINARY,
     XML,
+    GEOMETRY_SNAPSHOT,
     UNKNOWN_FILE_TYPE
 };
 
@@ -29,7 +29,50 @@ public:
      */
     virtual float GetBField(const CartesianVector &positionVector) const = 0;
 
+    /**
+     *  @brief  Get the bfield values for a contiguous range of position vectors. The default implementation calls GetBField for
+     *          each position; derived plugins may override this to amortise per-call work across the range.
+     * 
+     *  @param  pPositionVectors address of the first of the specified positions
+     *  @param  nPositions the number of specified positions
+     *  @param  pBFields address of the first of nPositions elements to receive the bfield values, units Tesla
+     */
+    virtual void GetBFields(const CartesianVector *const pPositionVectors, const unsigned int nPositions, float *const pBFields) const;
+
 protected:
+    /**
+     *  @brief  Register the details of another bfield plugin, e.g. one wrapped by a derived plugin
+     * 
+     *  @param  bFieldPlugin the other bfield plugin
+     *  @param  pPandora address of the pandora object that will run the other plugin
+     *  @param  type the other plugin type
+     *  @param  instanceName the other plugin instance name
+     */
+    static StatusCode RegisterPluginDetails(BFieldPlugin &bFieldPlugin, const Pandora *const pPandora, const std::string &type,
+        const std::string &instanceName);
+
+    /**
+     *  @brief  Read the settings of another bfield plugin, e.g. one wrapped by a derived plugin
+     * 
+     *  @param  bFieldPlugin the other bfield plugin
+     *  @param  xmlHandle the relevant xml handle
+     */
+    static StatusCode ReadPluginSettings(BFieldPlugin &bFieldPlugin, const TiXmlHandle xmlHandle);
+
+    /**
+     *  @brief  Initialize another bfield plugin, e.g. one wrapped by a derived plugin
+     * 
+     *  @param  bFieldPlugin the other bfield plugin
+     */
+    static StatusCode InitializePlugin(BFieldPlugin &bFieldPlugin);
+
+    /**
+     *  @brief  Reset another bfield plugin, e.g. one wrapped by a derived plugin
+     * 
+     *  @param  bFieldPlugin the other bfield plugin
+     */
+    static StatusCode ResetPlugin(BFieldPlugin &bFieldPlugin);
+
     friend class PluginManager;
 };
 
@@ -0,0 +1,198 @@
+/**
+ *  @file   PandoraSDK/include/Plugins/GriddedBFieldPlugin.h
+ * 
+ *  @brief  Header file for the gridded bfield plugin class.
+ * 
+ *  $Log: $
+ */
+#ifndef PANDORA_GRIDDED_BFIELD_PLUGIN_H
+#define PANDORA_GRIDDED_BFIELD_PLUGIN_H 1
+
+#include "Objects/CartesianVector.h"
+
+#include "Plugins/BFieldPlugin.h"
+
+namespace pandora
+{
+
+/**
+ *  @brief  GriddedBFieldPlugin class, an adaptor that samples an underlying bfield plugin onto a regular three dimensional grid at
+ *          initialisation, then answers queries within the grid by trilinear interpolation. Queries outside the grid are passed to
+ *          the underlying plugin. The accuracy of the interpolation is measured at initialisation, at the centres of grid cells.
+ */
+class GriddedBFieldPlugin : public BFieldPlugin
+{
+public:
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  pBFieldPlugin address of the underlying bfield plugin, ownership of which is taken by the gridded bfield plugin
+     */
+    GriddedBFieldPlugin(BFieldPlugin *const pBFieldPlugin);
+
+    /**
+     *  @brief  Destructor
+     */
+    ~GriddedBFieldPlugin();
+
+    float GetBField(const CartesianVector &positionVector) const;
+    void GetBFields(const CartesianVector *const pPositionVectors, const unsigned int nPositions, float *const pBFields) const;
+
+    /**
+     *  @brief  Whether a specified position lies within the grid, where queries are answered by interpolation
+     * 
+     *  @param  positionVector the specified position
+     * 
+     *  @return boolean
+     */
+    bool IsInGrid(const CartesianVector &positionVector) const;
+
+    /**
+     *  @brief  Get the grid corner with the minimum coordinates, units mm
+     * 
+     *  @return the grid minimum
+     */
+    const CartesianVector &GetGridMinimum() const;
+
+    /**
+     *  @brief  Get the grid corner with the maximum coordinates, units mm
+     * 
+     *  @return the grid maximum
+     */
+    const CartesianVector &GetGridMaximum() const;
+
+    /**
+     *  @brief  Get the number of points at which the underlying bfield was sampled
+     * 
+     *  @return the number of grid points
+     */
+    unsigned int GetNGridPoints() const;
+
+    /**
+     *  @brief  Get the number of points at which the accuracy of the interpolation was measured
+     * 
+     *  @return the number of accuracy test points
+     */
+    unsigned int GetNAccuracyTestPoints() const;
+
+    /**
+     *  @brief  Get the maximum absolute difference between interpolated and underlying bfield values, units Tesla
+     * 
+     *  @return the maximum absolute deviation
+     */
+    float GetMaxAbsoluteDeviation() const;
+
+    /**
+     *  @brief  Get the mean absolute difference between interpolated and underlying bfield values, units Tesla
+     * 
+     *  @return the mean absolute deviation
+     */
+    float GetMeanAbsoluteDeviation() const;
+
+private:
+    StatusCode ReadSettings(const TiXmlHandle xmlHandle);
+    StatusCode Initialize();
+    StatusCode Reset();
+
+    /**
+     *  @brief  Sample the underlying bfield plugin at each grid point
+     */
+    void SampleGrid();
+
+    /**
+     *  @brief  Measure the accuracy of the interpolation at the centres of a strided selection of grid cells
+     */
+    void MeasureAccuracy();
+
+    /**
+     *  @brief  Get the grid point position for specified grid indices
+     * 
+     *  @param  xIndex the x index
+     *  @param  yIndex the y index
+     *  @param  zIndex the z index
+     * 
+     *  @return the grid point position
+     */
+    CartesianVector GetGridPosition(const float xIndex, const float yIndex, const float zIndex) const;
+
+    /**
+     *  @brief  Get the interpolated bfield value for a position within the grid
+     * 
+     *  @param  positionVector the position
+     * 
+     *  @return the interpolated bfield, units Tesla
+     */
+    float Interpolate(const CartesianVector &positionVector) const;
+
+    BFieldPlugin           *m_pBFieldPlugin;            ///< Address of the underlying bfield plugin
+    CartesianVector         m_gridMinimum;              ///< The grid corner with the minimum coordinates, units mm
+    CartesianVector         m_gridMaximum;              ///< The grid corner with the maximum coordinates, units mm
+    unsigned int            m_nPointsX;                 ///< The number of grid points along x
+    unsigned int            m_nPointsY;                 ///< The number of grid points along y
+    unsigned int            m_nPointsZ;                 ///< The number of grid points along z
+    float                   m_inverseSpacingX;          ///< The inverse grid spacing along x, units 1/mm
+    float                   m_inverseSpacingY;          ///< The inverse grid spacing along y, units 1/mm
+    float                   m_inverseSpacingZ;          ///< The inverse grid spacing along z, units 1/mm
+    FloatVector             m_gridBFields;              ///< The sampled bfield values, with x index varying fastest, then y, then z
+
+    unsigned int            m_maxNAccuracyTestPoints;   ///< The maximum number of points at which to measure the interpolation accuracy
+    bool                    m_shouldDisplayAccuracy;    ///< Whether to display the interpolation accuracy at initialisation
+    unsigned int            m_nAccuracyTestPoints;      ///< The number of points at which the interpolation accuracy was measured
+    float                   m_maxAbsoluteDeviation;     ///< The maximum absolute deviation of interpolated from underlying values
+    float                   m_meanAbsoluteDeviation;    ///< The mean absolute deviation of interpolated from underlying values
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool GriddedBFieldPlugin::IsInGrid(const CartesianVector &positionVector) const
+{
+    return ((positionVector.GetX() >= m_gridMinimum.GetX()) && (positionVector.GetX() <= m_gridMaximum.GetX()) &&
+        (positionVector.GetY() >= m_gridMinimum.GetY()) && (positionVector.GetY() <= m_gridMaximum.GetY()) &&
+        (positionVector.GetZ() >= m_gridMinimum.GetZ()) && (positionVector.GetZ() <= m_gridMaximum.GetZ()));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const CartesianVector &GriddedBFieldPlugin::GetGridMinimum() const
+{
+    return m_gridMinimum;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const CartesianVector &GriddedBFieldPlugin::GetGridMaximum() const
+{
+    return m_gridMaximum;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int GriddedBFieldPlugin::GetNGridPoints() const
+{
+    return m_gridBFields.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int GriddedBFieldPlugin::GetNAccuracyTestPoints() const
+{
+    return m_nAccuracyTestPoints;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline float GriddedBFieldPlugin::GetMaxAbsoluteDeviation() const
+{
+    return m_maxAbsoluteDeviation;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline float GriddedBFieldPlugin::GetMeanAbsoluteDeviation() const
+{
+    return m_meanAbsoluteDeviation;
+}
+
+} // namespace pandora
+
+#endif // #ifndef PANDORA_GRIDDED_BFIELD_PLUGIN_H
@@ -15,7 +15,8 @@ namespace pandora
 {
 
 /**
- *  @brief  LArTransformationPlugin class
+ *  @brief  LArTransformationPlugin class. Each transform has a batch variant, operating on contiguous arrays of coordinates, whose
+ *          default implementation calls the scalar transform for each element; derived plugins may override the batch variants
  */
 class LArTransformationPlugin : public Process
 {
@@ -153,6 +154,168 @@ public:
     virtual void GetMinChiSquaredYZ(const double u, const double v, const double w, const double sigmaU, const double sigmaV, const double sigmaW,
         const double uFit, const double vFit, const double wFit, const double sigmaFit, double &y, double &z, double &chiSquared) const = 0;
 
+    /**
+     *  @brief  Transform from (U,V) to W positions for contiguous arrays of coordinates
+     *
+     *  @param  pU address of the first of the U positions
+     *  @param  pV address of the first of the V positions
+     *  @param  nPositions the number of positions
+     *  @param  pW address of the first of nPositions elements to receive the W positions
+     */
+    virtual void UVtoWBatch(const double *const pU, const double *const pV, const unsigned int nPositions, double *const pW) const;
+
+    /**
+     *  @brief  Transform from (V,W) to U positions for contiguous arrays of coordinates
+     *
+     *  @param  pV address of the first of the V positions
+     *  @param  pW address of the first of the W positions
+     *  @param  nPositions the number of positions
+     *  @param  pU address of the first of nPositions elements to receive the U positions
+     */
+    virtual void VWtoUBatch(const double *const pV, const double *const pW, const unsigned int nPositions, double *const pU) const;
+
+    /**
+     *  @brief  Transform from (W,U) to V positions for contiguous arrays of coordinates
+     *
+     *  @param  pW address of the first of the W positions
+     *  @param  pU address of the first of the U positions
+     *  @param  nPositions the number of positions
+     *  @param  pV address of the first of nPositions elements to receive the V positions
+     */
+    virtual void WUtoVBatch(const double *const pW, const double *const pU, const unsigned int nPositions, double *const pV) const;
+
+    /**
+     *  @brief  Transform from (U,V) to Y positions for contiguous arrays of coordinates
+     *
+     *  @param  pU address of the first of the U positions
+     *  @param  pV address of the first of the V positions
+     *  @param  nPositions the number of positions
+     *  @param  pY address of the first of nPositions elements to receive the Y positions
+     */
+    virtual void UVtoYBatch(const double *const pU, const double *const pV, const unsigned int nPositions, double *const pY) const;
+
+    /**
+     *  @brief  Transform from (U,V) to Z positions for contiguous arrays of coordinates
+     *
+     *  @param  pU address of the first of the U positions
+     *  @param  pV address of the first of the V positions
+     *  @param  nPositions the number of positions
+     *  @param  pZ address of the first of nPositions elements to receive the Z positions
+     */
+    virtual void UVtoZBatch(const double *const pU, const double *const pV, const unsigned int nPositions, double *const pZ) const;
+
+    /**
+     *  @brief  Transform from (U,W) to Y positions for contiguous arrays of coordinates
+     *
+     *  @param  pU address of the first of the U positions
+     *  @param  pW address of the first of the W positions
+     *  @param  nPositions the number of positions
+     *  @param  pY address of the first of nPositions elements to receive the Y positions
+     */
+    virtual void UWtoYBatch(const double *const pU, const double *const pW, const unsigned int nPositions, double *const pY) const;
+
+    /**
+     *  @brief  Transform from (U,W) to Z positions for contiguous arrays of coordinates
+     *
+     *  @param  pU address of the first of the U positions
+     *  @param  pW address of the first of the W positions
+     *  @param  nPositions the number of positions
+     *  @param  pZ address of the first of nPositions elements to receive the Z positions
+     */
+    virtual void UWtoZBatch(const double *const pU, const double *const pW, const unsigned int nPositions, double *const pZ) const;
+
+    /**
+     *  @brief  Transform from (V,W) to Y positions for contiguous arrays of coordinates
+     *
+     *  @param  pV address of the first of the V positions
+     *  @param  pW address of the first of the W positions
+     *  @param  nPositions the number of positions
+     *  @param  pY address of the first of nPositions elements to receive the Y positions
+     */
+    virtual void VWtoYBatch(const double *const pV, const double *const pW, const unsigned int nPositions, double *const pY) const;
+
+    /**
+     *  @brief  Transform from (V,W) to Z positions for contiguous arrays of coordinates
+     *
+     *  @param  pV address of the first of the V positions
+     *  @param  pW address of the first of the W positions
+     *  @param  nPositions the number of positions
+     *  @param  pZ address of the first of nPositions elements to receive the Z positions
+     */
+    virtual void VWtoZBatch(const double *const pV, const double *const pW, const unsigned int nPositions, double *const pZ) const;
+
+    /**
+     *  @brief  Transform from (Y,Z) to U positions for contiguous arrays of coordinates
+     *
+     *  @param  pY address of the first of the Y positions
+     *  @param  pZ address of the first of the Z positions
+     *  @param  nPositions the number of positions
+     *  @param  pU address of the first of nPositions elements to receive the U positions
+     */
+    virtual void YZtoUBatch(const double *const pY, const double *const pZ, const unsigned int nPositions, double *const pU) const;
+
+    /**
+     *  @brief  Transform from (Y,Z) to V positions for contiguous arrays of coordinates
+     *
+     *  @param  pY address of the first of the Y positions
+     *  @param  pZ address of the first of the Z positions
+     *  @param  nPositions the number of positions
+     *  @param  pV address of the first of nPositions elements to receive the V positions
+     */
+    virtual void YZtoVBatch(const double *const pY, const double *const pZ, const unsigned int nPositions, double *const pV) const;
+
+    /**
+     *  @brief  Transform from (Y,Z) to W positions for contiguous arrays of coordinates
+     *
+     *  @param  pY address of the first of the Y positions
+     *  @param  pZ address of the first of the Z positions
+     *  @param  nPositions the number of positions
+     *  @param  pW address of the first of nPositions elements to receive the W positions
+     */
+    virtual void YZtoWBatch(const double *const pY, const double *const pZ, const unsigned int nPositions, double *const pW) const;
+
+    /**
+     *  @brief  Get the y, z positions that yield the minimum chi squared values with respect to specified u, v and w coordinates,
+     *          for contiguous arrays of coordinates sharing the same uncertainties
+     *
+     *  @param  pU address of the first of the u coordinates
+     *  @param  pV address of the first of the v coordinates
+     *  @param  pW address of the first of the w coordinates
+     *  @param  nPositions the number of positions
+     *  @param  sigmaU the uncertainty in the u coordinates
+     *  @param  sigmaV the uncertainty in the v coordinates
+     *  @param  sigmaW the uncertainty in the w coordinates
+     *  @param  pY address of the first of nPositions elements to receive the y coordinates
+     *  @param  pZ address of the first of nPositions elements to receive the z coordinates
+     *  @param  pChiSquared address of the first of nPositions elements to receive the chi squared values
+     */
+    virtual void GetMinChiSquaredYZBatch(const double *const pU, const double *const pV, const double *const pW,
+        const unsigned int nPositions, const double sigmaU, const double sigmaV, const double sigmaW, double *const pY, double *const pZ,
+        double *const pChiSquared) const;
+
+    /**
+     *  @brief  Get the y, z positions that yield the minimum chi squared values with respect to specified u, v and w coordinates
+     *          and provided fits to overall trajectories in 3D, for contiguous arrays of coordinates sharing the same uncertainties
+     *
+     *  @param  pU address of the first of the u coordinates
+     *  @param  pV address of the first of the v coordinates
+     *  @param  pW address of the first of the w coordinates
+     *  @param  pUFit address of the first of the u coordinates from fits to overall trajectories
+     *  @param  pVFit address of the first of the v coordinates from fits to overall trajectories
+     *  @param  pWFit address of the first of the w coordinates from fits to overall trajectories
+     *  @param  nPositions the number of positions
+     *  @param  sigmaU the uncertainty in the u coordinates
+     *  @param  sigmaV the uncertainty in the v coordinates
+     *  @param  sigmaW the uncertainty in the w coordinates
+     *  @param  sigmaFit the uncertainty in coordinates extracted from the fits to overall trajectories
+     *  @param  pY address of the first of nPositions elements to receive the y coordinates
+     *  @param  pZ address of the first of nPositions elements to receive the z coordinates
+     *  @param  pChiSquared address of the first of nPositions elements to receive the chi squared values
+     */
+    virtual void GetMinChiSquaredYZBatch(const double *const pU, const double *const pV, const double *const pW, const double *const pUFit,
+        const double *const pVFit, const double *const pWFit, const unsigned int nPositions, const double sigmaU, const double sigmaV,
+        const double sigmaW, const double sigmaFit, double *const pY, double *const pZ, double *const pChiSquared) const;
+
 protected:
     friend class PluginManager;
 };
@@ -0,0 +1,303 @@
+/**
+ *  @file   PandoraSDK/include/Plugins/LArWireAngleTransformationPlugin.h
+ * 
+ *  @brief  Header file for the lar wire angle transformation plugin class.
+ * 
+ *  $Log: $
+ */
+#ifndef PANDORA_LAR_WIRE_ANGLE_TRANSFORMATION_PLUGIN_H
+#define PANDORA_LAR_WIRE_ANGLE_TRANSFORMATION_PLUGIN_H 1
+
+#include "Plugins/LArTransformationPlugin.h"
+
+namespace pandora
+{
+
+/**
+ *  @brief  LArWireAngleTransformationPlugin class, implementing the standard linear transformation between the (y,z) plane and the
+ *          u, v and w wire coordinates, where each wire coordinate is z * cos(theta) - y * sin(theta) for the wire angle, theta, to
+ *          the vertical. Wire angles are taken from the lar tpcs registered with the geometry (which must all share the same wire
+ *          angles), unless specified in the plugin settings. Every transform reduces to a fixed linear combination of its inputs,
+ *          evaluated over contiguous arrays by the batch variants without per-element virtual calls.
+ */
+class LArWireAngleTransformationPlugin : public LArTransformationPlugin
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    LArWireAngleTransformationPlugin();
+
+    double UVtoW(const double u, const double v) const;
+    double VWtoU(const double v, const double w) const;
+    double WUtoV(const double w, const double u) const;
+    double UVtoY(const double u, const double v) const;
+    double UVtoZ(const double u, const double v) const;
+    double UWtoY(const double u, const double w) const;
+    double UWtoZ(const double u, const double w) const;
+    double VWtoY(const double v, const double w) const;
+    double VWtoZ(const double v, const double w) const;
+    double YZtoU(const double y, const double z) const;
+    double YZtoV(const double y, const double z) const;
+    double YZtoW(const double y, const double z) const;
+
+    void GetMinChiSquaredYZ(const double u, const double v, const double w, const double sigmaU, const double sigmaV, const double sigmaW,
+        double &y, double &z, double &chiSquared) const;
+    void GetMinChiSquaredYZ(const double u, const double v, const double w, const double sigmaU, const double sigmaV, const double sigmaW,
+        const double uFit, const double vFit, const double wFit, const double sigmaFit, double &y, double &z, double &chiSquared) const;
+
+    void UVtoWBatch(const double *const pU, const double *const pV, const unsigned int nPositions, double *const pW) const;
+    void VWtoUBatch(const double *const pV, const double *const pW, const unsigned int nPositions, double *const pU) const;
+    void WUtoVBatch(const double *const pW, const double *const pU, const unsigned int nPositions, double *const pV) const;
+    void UVtoYBatch(const double *const pU, const double *const pV, const unsigned int nPositions, double *const pY) const;
+    void UVtoZBatch(const double *const pU, const double *const pV, const unsigned int nPositions, double *const pZ) const;
+    void UWtoYBatch(const double *const pU, const double *const pW, const unsigned int nPositions, double *const pY) const;
+    void UWtoZBatch(const double *const pU, const double *const pW, const unsigned int nPositions, double *const pZ) const;
+    void VWtoYBatch(const double *const pV, const double *const pW, const unsigned int nPositions, double *const pY) const;
+    void VWtoZBatch(const double *const pV, const double *const pW, const unsigned int nPositions, double *const pZ) const;
+    void YZtoUBatch(const double *const pY, const double *const pZ, const unsigned int nPositions, double *const pU) const;
+    void YZtoVBatch(const double *const pY, const double *const pZ, const unsigned int nPositions, double *const pV) const;
+    void YZtoWBatch(const double *const pY, const double *const pZ, const unsigned int nPositions, double *const pW) const;
+
+    void GetMinChiSquaredYZBatch(const double *const pU, const double *const pV, const double *const pW, const unsigned int nPositions,
+        const double sigmaU, const double sigmaV, const double sigmaW, double *const pY, double *const pZ, double *const pChiSquared) const;
+    void GetMinChiSquaredYZBatch(const double *const pU, const double *const pV, const double *const pW, const double *const pUFit,
+        const double *const pVFit, const double *const pWFit, const unsigned int nPositions, const double sigmaU, const double sigmaV,
+        const double sigmaW, const double sigmaFit, double *const pY, double *const pZ, double *const pChiSquared) const;
+
+private:
+    /**
+     *  @brief  LinearCombination class, the coefficients expressing a transform output as a linear combination of its two inputs
+     */
+    class LinearCombination
+    {
+    public:
+        /**
+         *  @brief  Default constructor
+         */
+        LinearCombination();
+
+        /**
+         *  @brief  Constructor
+         * 
+         *  @param  alpha the coefficient of the first input
+         *  @param  beta the coefficient of the second input
+         */
+        LinearCombination(const double alpha, const double beta);
+
+        /**
+         *  @brief  Evaluate the linear combination for specified inputs
+         * 
+         *  @param  a the first input
+         *  @param  b the second input
+         * 
+         *  @return the output
+         */
+        double Evaluate(const double a, const double b) const;
+
+        /**
+         *  @brief  Evaluate the linear combination for contiguous arrays of inputs
+         * 
+         *  @param  pA address of the first of the first inputs
+         *  @param  pB address of the first of the second inputs
+         *  @param  nPositions the number of inputs
+         *  @param  pOutput address of the first of nPositions elements to receive the outputs
+         */
+        void Evaluate(const double *const pA, const double *const pB, const unsigned int nPositions, double *const pOutput) const;
+
+    private:
+        double      m_alpha;        ///< The coefficient of the first input
+        double      m_beta;         ///< The coefficient of the second input
+    };
+
+    /**
+     *  @brief  MinChiSquaredSolution class, the coefficients expressing the minimum chi squared y, z position as linear combinations of
+     *          the weighted u, v and w coordinates, for a fixed set of coordinate uncertainties
+     */
+    class MinChiSquaredSolution
+    {
+    public:
+        double      m_weights[3];       ///< The weights of the u, v and w coordinates, 1/sigma^2
+        double      m_fitWeight;        ///< The weight of each coordinate from a fit to an overall trajectory, 1/sigmaFit^2
+        double      m_yCoefficients[3]; ///< The y coefficients of the weighted u, v and w coordinate sums
+        double      m_zCoefficients[3]; ///< The z coefficients of the weighted u, v and w coordinate sums
+    };
+
+    StatusCode ReadSettings(const TiXmlHandle xmlHandle);
+    StatusCode Initialize();
+
+    /**
+     *  @brief  Get the wire angles shared by all lar tpcs registered with the geometry
+     */
+    StatusCode GetLArTPCWireAngles();
+
+    /**
+     *  @brief  Get the transform coefficients for a pair of input wire coordinates, a and b, given the wire angles
+     * 
+     *  @param  thetaA the wire angle for input coordinate a
+     *  @param  thetaB the wire angle for input coordinate b
+     *  @param  thetaC the wire angle for the output coordinate, c
+     *  @param  abToC to receive the coefficients for the (a,b) to c transform
+     *  @param  abToY to receive the coefficients for the (a,b) to y transform
+     *  @param  abToZ to receive the coefficients for the (a,b) to z transform
+     */
+    static StatusCode GetWirePairCoefficients(const double thetaA, const double thetaB, const double thetaC, LinearCombination &abToC,
+        LinearCombination &abToY, LinearCombination &abToZ);
+
+    /**
+     *  @brief  Get the min chi squared solution for specified coordinate uncertainties
+     * 
+     *  @param  sigmaU the uncertainty in the u coordinate
+     *  @param  sigmaV the uncertainty in the v coordinate
+     *  @param  sigmaW the uncertainty in the w coordinate
+     *  @param  sigmaFit the uncertainty in coordinates from a fit to an overall trajectory, or zero if there is no such fit
+     *  @param  solution to receive the min chi squared solution
+     */
+    void GetMinChiSquaredSolution(const double sigmaU, const double sigmaV, const double sigmaW, const double sigmaFit,
+        MinChiSquaredSolution &solution) const;
+
+    /**
+     *  @brief  Get the minimum chi squared y, z position, using a precomputed solution
+     * 
+     *  @param  solution the min chi squared solution
+     *  @param  coordinates the u, v and w coordinates
+     *  @param  fitCoordinates the u, v and w coordinates from a fit to an overall trajectory
+     *  @param  y to receive the y coordinate
+     *  @param  z to receive the z coordinate
+     *  @param  chiSquared to receive the chi squared value
+     */
+    void EvaluateMinChiSquaredYZ(const MinChiSquaredSolution &solution, const double (&coordinates)[3], const double (&fitCoordinates)[3],
+        double &y, double &z, double &chiSquared) const;
+
+    bool                m_shouldUseLArTPCWireAngles;    ///< Whether to take the wire angles from the lar tpcs registered with the geometry
+    double              m_thetaU;                       ///< The u wire angle to the vertical, units radians
+    double              m_thetaV;                       ///< The v wire angle to the vertical, units radians
+    double              m_thetaW;                       ///< The w wire angle to the vertical, units radians
+    double              m_sinTheta[3];                  ///< The sines of the u, v and w wire angles
+    double              m_cosTheta[3];                  ///< The cosines of the u, v and w wire angles
+
+    LinearCombination   m_uvToW;                        ///< The (u,v) to w transform
+    LinearCombination   m_vwToU;                        ///< The (v,w) to u transform
+    LinearCombination   m_wuToV;                        ///< The (w,u) to v transform
+    LinearCombination   m_uvToY;                        ///< The (u,v) to y transform
+    LinearCombination   m_uvToZ;                        ///< The (u,v) to z transform
+    LinearCombination   m_uwToY;                        ///< The (u,w) to y transform
+    LinearCombination   m_uwToZ;                        ///< The (u,w) to z transform
+    LinearCombination   m_vwToY;                        ///< The (v,w) to y transform
+    LinearCombination   m_vwToZ;                        ///< The (v,w) to z transform
+    LinearCombination   m_yzToU;                        ///< The (y,z) to u transform
+    LinearCombination   m_yzToV;                        ///< The (y,z) to v transform
+    LinearCombination   m_yzToW;                        ///< The (y,z) to w transform
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline double LArWireAngleTransformationPlugin::UVtoW(const double u, const double v) const
+{
+    return m_uvToW.Evaluate(u, v);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline double LArWireAngleTransformationPlugin::VWtoU(const double v, const double w) const
+{
+    return m_vwToU.Evaluate(v, w);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline double LArWireAngleTransformationPlugin::WUtoV(const double w, const double u) const
+{
+    return m_wuToV.Evaluate(w, u);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline double LArWireAngleTransformationPlugin::UVtoY(const double u, const double v) const
+{
+    return m_uvToY.Evaluate(u, v);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline double LArWireAngleTransformationPlugin::UVtoZ(const double u, const double v) const
+{
+    return m_uvToZ.Evaluate(u, v);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline double LArWireAngleTransformationPlugin::UWtoY(const double u, const double w) const
+{
+    return m_uwToY.Evaluate(u, w);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline double LArWireAngleTransformationPlugin::UWtoZ(const double u, const double w) const
+{
+    return m_uwToZ.Evaluate(u, w);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline double LArWireAngleTransformationPlugin::VWtoY(const double v, const double w) const
+{
+    return m_vwToY.Evaluate(v, w);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline double LArWireAngleTransformationPlugin::VWtoZ(const double v, const double w) const
+{
+    return m_vwToZ.Evaluate(v, w);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline double LArWireAngleTransformationPlugin::YZtoU(const double y, const double z) const
+{
+    return m_yzToU.Evaluate(y, z);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline double LArWireAngleTransformationPlugin::YZtoV(const double y, const double z) const
+{
+    return m_yzToV.Evaluate(y, z);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline double LArWireAngleTransformationPlugin::YZtoW(const double y, const double z) const
+{
+    return m_yzToW.Evaluate(y, z);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline LArWireAngleTransformationPlugin::LinearCombination::LinearCombination() :
+    m_alpha(0.),
+    m_beta(0.)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline LArWireAngleTransformationPlugin::LinearCombination::LinearCombination(const double alpha, const double beta) :
+    m_alpha(alpha),
+    m_beta(beta)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline double LArWireAngleTransformationPlugin::LinearCombination::Evaluate(const double a, const double b) const
+{
+    return (m_alpha * a + m_beta * b);
+}
+
+} // namespace pandora
+
+#endif // #ifndef PANDORA_LAR_WIRE_ANGLE_TRANSFORMATION_PLUGIN_H
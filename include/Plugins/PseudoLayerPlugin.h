@@ -29,6 +29,18 @@ public:
      */
     virtual unsigned int GetPseudoLayer(const CartesianVector &positionVector) const = 0;
 
+    /**
+     *  @brief  Get the appropriate pseudolayers for a contiguous range of position vectors. The default implementation calls
+     *          GetPseudoLayer for each position; derived plugins may override this to amortise per-call work across the range.
+     *          Pandora calls this function concurrently, on disjoint ranges, only if the plugin declares itself thread safe.
+     * 
+     *  @param  pPositionVectors address of the first of the specified positions
+     *  @param  nPositions the number of specified positions
+     *  @param  pPseudoLayers address of the first of nPositions elements to receive the appropriate pseudolayers
+     */
+    virtual void GetPseudoLayers(const CartesianVector *const pPositionVectors, const unsigned int nPositions,
+        unsigned int *const pPseudoLayers) const;
+
     /**
      *  @brief  Get the pseudolayer assigned to a point at the ip, i.e. the initial offset for pseudolayer values
      *          and the start of the pseudolayer scale
@@ -37,10 +49,25 @@ public:
      */
     virtual unsigned int GetPseudoLayerAtIp() const = 0;
 
+    /**
+     *  @brief  Whether GetPseudoLayer and GetPseudoLayers may safely be called from several threads at once. Plugins must opt in,
+     *          by overriding this function, before Pandora will assign pseudo layers in parallel.
+     * 
+     *  @return boolean
+     */
+    virtual bool IsThreadSafe() const;
+
 protected:
     friend class PluginManager;
 };
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline bool PseudoLayerPlugin::IsThreadSafe() const
+{
+    return false;
+}
+
 } // namespace pandora
 
 #endif // #ifndef PANDORA_PSEUDO_LAYER_PLUGIN_H
@@ -96,6 +96,20 @@ pandora::StatusCode PandoraApi::GetPfoList(const pandora::Pandora &pandora, cons
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+pandora::StatusCode PandoraApi::GetPseudoLayerCache(const pandora::Pandora &pandora, const pandora::PseudoLayerCache *&pPseudoLayerCache)
+{
+    return pandora.GetPandoraApiImpl()->GetPseudoLayerCache(pPseudoLayerCache);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+pandora::StatusCode PandoraApi::GetNRejectedCaloHits(const pandora::Pandora &pandora, unsigned int &nRejectedCaloHits)
+{
+    return pandora.GetPandoraApiImpl()->GetNRejectedCaloHits(nRejectedCaloHits);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 pandora::StatusCode PandoraApi::SetExternalParameters(const pandora::Pandora &pandora, const std::string &algorithmType,
     pandora::ExternalParameters *const pExternalParameters)
 {
@@ -51,42 +51,57 @@ StatusCode PandoraApiImpl::Create(const object_creation::CaloHit::Parameters &pa
     const ObjectFactory<object_creation::CaloHit::Parameters, object_creation::CaloHit::Object> &factory) const
 {
     const CaloHit *pCaloHit(nullptr);
-    return m_pPandora->m_pCaloHitManager->Create(parameters, pCaloHit, factory);
+    return m_pPandora->m_pCaloHitManager->Create(parameters, pCaloHit, factory, true);
 }
 
 template <>
 StatusCode PandoraApiImpl::Create(const object_creation::Geometry::SubDetector::Parameters &parameters,
     const ObjectFactory<object_creation::Geometry::SubDetector::Parameters, object_creation::Geometry::SubDetector::Object> &factory) const
 {
-    return m_pPandora->m_pGeometryManager->CreateSubDetector(parameters, factory);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, m_pPandora->m_pGeometryManager->CreateSubDetector(parameters, factory));
+    m_pPandora->m_pCaloHitManager->ClearPseudoLayerCache();
+
+    return STATUS_CODE_SUCCESS;
 }
 
 template <>
 StatusCode PandoraApiImpl::Create(const object_creation::Geometry::LArTPC::Parameters &parameters,
     const ObjectFactory<object_creation::Geometry::LArTPC::Parameters, object_creation::Geometry::LArTPC::Object> &factory) const
 {
-    return m_pPandora->m_pGeometryManager->CreateLArTPC(parameters, factory);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, m_pPandora->m_pGeometryManager->CreateLArTPC(parameters, factory));
+    m_pPandora->m_pCaloHitManager->ClearPseudoLayerCache();
+
+    return STATUS_CODE_SUCCESS;
 }
 
 template <>
 StatusCode PandoraApiImpl::Create(const object_creation::Geometry::LineGap::Parameters &parameters,
     const ObjectFactory<object_creation::Geometry::LineGap::Parameters, object_creation::Geometry::LineGap::Object> &factory) const
 {
-    return m_pPandora->m_pGeometryManager->CreateGap(parameters, factory);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, m_pPandora->m_pGeometryManager->CreateGap(parameters, factory));
+    m_pPandora->m_pCaloHitManager->ClearPseudoLayerCache();
+
+    return STATUS_CODE_SUCCESS;
 }
 
 template <>
 StatusCode PandoraApiImpl::Create(const object_creation::Geometry::BoxGap::Parameters &parameters,
     const ObjectFactory<object_creation::Geometry::BoxGap::Parameters, object_creation::Geometry::BoxGap::Object> &factory) const
 {
-    return m_pPandora->m_pGeometryManager->CreateGap(parameters, factory);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, m_pPandora->m_pGeometryManager->CreateGap(parameters, factory));
+    m_pPandora->m_pCaloHitManager->ClearPseudoLayerCache();
+
+    return STATUS_CODE_SUCCESS;
 }
 
 template <>
 StatusCode PandoraApiImpl::Create(const object_creation::Geometry::ConcentricGap::Parameters &parameters,
     const ObjectFactory<object_creation::Geometry::ConcentricGap::Parameters, object_creation::Geometry::ConcentricGap::Object> &factory) const
 {
-    return m_pPandora->m_pGeometryManager->CreateGap(parameters, factory);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, m_pPandora->m_pGeometryManager->CreateGap(parameters, factory));
+    m_pPandora->m_pCaloHitManager->ClearPseudoLayerCache();
+
+    return STATUS_CODE_SUCCESS;
 }
 
 template <typename PARAMETERS, typename OBJECT>
@@ -176,6 +191,27 @@ StatusCode PandoraApiImpl::GetPfoList(const std::string &pfoListName, const PfoL
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+StatusCode PandoraApiImpl::GetPseudoLayerCache(const PseudoLayerCache *&pPseudoLayerCache) const
+{
+    pPseudoLayerCache = m_pPandora->m_pCaloHitManager->m_pPseudoLayerCache;
+
+    if (!pPseudoLayerCache)
+        return STATUS_CODE_NOT_INITIALIZED;
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode PandoraApiImpl::GetNRejectedCaloHits(unsigned int &nRejectedCaloHits) const
+{
+    nRejectedCaloHits = m_pPandora->m_pCaloHitManager->m_nRejectedCaloHits;
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 StatusCode PandoraApiImpl::SetHitTypeGranularity(const HitType hitType, const Granularity granularity) const
 {
     return m_pPandora->m_pGeometryManager->SetHitTypeGranularity(hitType, granularity);
@@ -199,7 +235,10 @@ StatusCode PandoraApiImpl::SetLArTransformationPlugin(LArTransformationPlugin *c
 
 StatusCode PandoraApiImpl::SetPseudoLayerPlugin(PseudoLayerPlugin *const pPseudoLayerPlugin) const
 {
-    return m_pPandora->m_pPluginManager->SetPseudoLayerPlugin(pPseudoLayerPlugin);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, m_pPandora->m_pPluginManager->SetPseudoLayerPlugin(pPseudoLayerPlugin));
+    m_pPandora->m_pCaloHitManager->ClearPseudoLayerCache();
+
+    return STATUS_CODE_SUCCESS;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
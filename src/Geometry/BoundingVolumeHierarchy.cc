@@ -0,0 +1,174 @@
+/**
+ *  @file   PandoraSDK/src/Geometry/BoundingVolumeHierarchy.cc
+ * 
+ *  @brief  Implementation of the bounding volume hierarchy class.
+ * 
+ *  $Log: $
+ */
+
+#include "Geometry/BoundingVolumeHierarchy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace pandora
+{
+
+const unsigned int BoundingVolumeHierarchy::MAX_ITEMS_PER_LEAF = 4;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(const BoundingBoxVector &boundingBoxes) :
+    m_boundingBoxes(boundingBoxes)
+{
+    if (m_boundingBoxes.empty())
+        return;
+
+    m_itemIndices.resize(m_boundingBoxes.size());
+
+    for (unsigned int index = 0; index < m_itemIndices.size(); ++index)
+        m_itemIndices[index] = index;
+
+    m_nodes.push_back(Node());
+    this->BuildNode(0, 0, m_itemIndices.size());
+
+    for (unsigned int position = 0; position < m_itemIndices.size(); ++position)
+        m_boundingBoxes[position] = boundingBoxes[m_itemIndices[position]];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void BoundingVolumeHierarchy::BuildNode(const unsigned int nodeIndex, const unsigned int begin, const unsigned int end)
+{
+    // ATTN Until the build completes, item boxes are held in their original order and found through the item indices
+    BoundingBox nodeBoundingBox, centreBoundingBox;
+
+    for (unsigned int position = begin; position < end; ++position)
+    {
+        const BoundingBox &boundingBox(m_boundingBoxes[m_itemIndices[position]]);
+        nodeBoundingBox.Extend(boundingBox);
+        centreBoundingBox.Extend(0.5f * (boundingBox.m_min[0] + boundingBox.m_max[0]), 0.5f * (boundingBox.m_min[1] + boundingBox.m_max[1]),
+            0.5f * (boundingBox.m_min[2] + boundingBox.m_max[2]));
+    }
+
+    m_nodes[nodeIndex].m_boundingBox = nodeBoundingBox;
+    m_nodes[nodeIndex].m_begin = begin;
+    m_nodes[nodeIndex].m_end = end;
+    m_nodes[nodeIndex].m_firstChild = 0;
+    m_nodes[nodeIndex].m_isLeaf = (end - begin <= MAX_ITEMS_PER_LEAF);
+
+    if (m_nodes[nodeIndex].m_isLeaf)
+        return;
+
+    // Split at the median item centre along the axis of largest spread of item centres
+    unsigned int splitAxis(0);
+
+    for (unsigned int axis = 1; axis < 3; ++axis)
+    {
+        if (centreBoundingBox.m_max[axis] - centreBoundingBox.m_min[axis] >
+            centreBoundingBox.m_max[splitAxis] - centreBoundingBox.m_min[splitAxis])
+        {
+            splitAxis = axis;
+        }
+    }
+
+    const unsigned int middle(begin + (end - begin) / 2);
+
+    std::nth_element(m_itemIndices.begin() + begin, m_itemIndices.begin() + middle, m_itemIndices.begin() + end,
+        [this, splitAxis](const unsigned int lhs, const unsigned int rhs)
+        {
+            return (m_boundingBoxes[lhs].m_min[splitAxis] + m_boundingBoxes[lhs].m_max[splitAxis] <
+                m_boundingBoxes[rhs].m_min[splitAxis] + m_boundingBoxes[rhs].m_max[splitAxis]);
+        });
+
+    const unsigned int firstChild(m_nodes.size());
+    m_nodes[nodeIndex].m_firstChild = firstChild;
+    m_nodes.resize(firstChild + 2);
+
+    this->BuildNode(firstChild, begin, middle);
+    this->BuildNode(firstChild + 1, middle, end);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+BoundingVolumeHierarchy::BoundingBox::BoundingBox() :
+    m_min{std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()},
+    m_max{-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max()},
+    m_toleranceScale(0.f)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void BoundingVolumeHierarchy::BoundingBox::Extend(const BoundingBox &rhs)
+{
+    for (unsigned int axis = 0; axis < 3; ++axis)
+    {
+        m_min[axis] = std::min(m_min[axis], rhs.m_min[axis]);
+        m_max[axis] = std::max(m_max[axis], rhs.m_max[axis]);
+    }
+
+    m_toleranceScale = std::max(m_toleranceScale, rhs.m_toleranceScale);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void BoundingVolumeHierarchy::BoundingBox::Extend(const float x, const float y, const float z)
+{
+    m_min[0] = std::min(m_min[0], x);
+    m_max[0] = std::max(m_max[0], x);
+    m_min[1] = std::min(m_min[1], y);
+    m_max[1] = std::max(m_max[1], y);
+    m_min[2] = std::min(m_min[2], z);
+    m_max[2] = std::max(m_max[2], z);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void BoundingVolumeHierarchy::BoundingBox::Pad()
+{
+    float scale(1.f);
+
+    for (unsigned int axis = 0; axis < 3; ++axis)
+        scale = std::max(scale, std::max(std::fabs(m_min[axis]), std::fabs(m_max[axis])));
+
+    const float padding(1.e-4f * scale);
+
+    for (unsigned int axis = 0; axis < 3; ++axis)
+    {
+        m_min[axis] -= padding;
+        m_max[axis] += padding;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool BoundingVolumeHierarchy::BoundingBox::Contains(const CartesianVector &positionVector, const float margin) const
+{
+    return ((positionVector.GetX() >= m_min[0] - margin) && (positionVector.GetX() <= m_max[0] + margin) &&
+        (positionVector.GetY() >= m_min[1] - margin) && (positionVector.GetY() <= m_max[1] + margin) &&
+        (positionVector.GetZ() >= m_min[2] - margin) && (positionVector.GetZ() <= m_max[2] + margin));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool BoundingVolumeHierarchy::BoundingBox::Overlaps(const BoundingBox &rhs, const float margin) const
+{
+    for (unsigned int axis = 0; axis < 3; ++axis)
+    {
+        if ((rhs.m_max[axis] < m_min[axis] - margin) || (rhs.m_min[axis] > m_max[axis] + margin))
+            return false;
+    }
+
+    return true;
+}
+
+} // namespace pandora
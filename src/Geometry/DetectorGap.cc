@@ -15,6 +15,31 @@ DetectorGap::~DetectorGap()
 {
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void DetectorGap::IsInGap(const FloatVector &xCoordinates, const FloatVector &yCoordinates, const FloatVector &zCoordinates,
+    const HitType hitType, const float gapTolerance, BoolVector &isInGapVector) const
+{
+    const unsigned int nPositions(DetectorGap::GetNPositions(xCoordinates, yCoordinates, zCoordinates));
+    isInGapVector.resize(nPositions);
+
+    for (unsigned int index = 0; index < nPositions; ++index)
+    {
+        const CartesianVector positionVector(xCoordinates[index], yCoordinates[index], zCoordinates[index]);
+        isInGapVector[index] = this->IsInGap(positionVector, hitType, gapTolerance);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int DetectorGap::GetNPositions(const FloatVector &xCoordinates, const FloatVector &yCoordinates, const FloatVector &zCoordinates)
+{
+    if ((xCoordinates.size() != yCoordinates.size()) || (xCoordinates.size() != zCoordinates.size()))
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+    return xCoordinates.size();
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -52,6 +77,42 @@ bool LineGap::IsInGap(const CartesianVector &positionVector, const HitType hitTy
     return false;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LineGap::IsInGap(const FloatVector &xCoordinates, const FloatVector &yCoordinates, const FloatVector &zCoordinates,
+    const HitType hitType, const float gapTolerance, BoolVector &isInGapVector) const
+{
+    if (!((TPC_VIEW_U == hitType) || (TPC_VIEW_V == hitType) || (TPC_VIEW_W == hitType) || (TPC_3D == hitType)))
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+    const unsigned int nPositions(DetectorGap::GetNPositions(xCoordinates, yCoordinates, zCoordinates));
+    isInGapVector.assign(nPositions, false);
+
+    const FloatVector *pCoordinates(nullptr);
+    float lowCoordinate(0.f), highCoordinate(0.f);
+
+    if (((TPC_VIEW_U == hitType) && (TPC_WIRE_GAP_VIEW_U == m_lineGapType)) ||
+        ((TPC_VIEW_V == hitType) && (TPC_WIRE_GAP_VIEW_V == m_lineGapType)) ||
+        ((TPC_VIEW_W == hitType) && (TPC_WIRE_GAP_VIEW_W == m_lineGapType)))
+    {
+        pCoordinates = &zCoordinates;
+        lowCoordinate = m_lineStartZ - gapTolerance;
+        highCoordinate = m_lineEndZ + gapTolerance;
+    }
+    else if (TPC_DRIFT_GAP == m_lineGapType)
+    {
+        pCoordinates = &xCoordinates;
+        lowCoordinate = m_lineStartX - gapTolerance;
+        highCoordinate = m_lineEndX + gapTolerance;
+    }
+
+    if (!pCoordinates)
+        return;
+
+    for (unsigned int index = 0; index < nPositions; ++index)
+        isInGapVector[index] = (((*pCoordinates)[index] > lowCoordinate) && ((*pCoordinates)[index] < highCoordinate));
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -90,6 +151,49 @@ bool BoxGap::IsInGap(const CartesianVector &positionVector, const HitType hitTyp
     return true;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void BoxGap::IsInGap(const FloatVector &xCoordinates, const FloatVector &yCoordinates, const FloatVector &zCoordinates,
+    const HitType hitType, const float gapTolerance, BoolVector &isInGapVector) const
+{
+    if ((TPC_VIEW_U == hitType) || (TPC_VIEW_V == hitType) || (TPC_VIEW_W == hitType))
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+    const unsigned int nPositions(DetectorGap::GetNPositions(xCoordinates, yCoordinates, zCoordinates));
+    isInGapVector.resize(nPositions);
+
+    const CartesianVector unit1(m_side1.GetUnitVector()), unit2(m_side2.GetUnitVector()), unit3(m_side3.GetUnitVector());
+    const float unit1X(unit1.GetX()), unit1Y(unit1.GetY()), unit1Z(unit1.GetZ());
+    const float unit2X(unit2.GetX()), unit2Y(unit2.GetY()), unit2Z(unit2.GetZ());
+    const float unit3X(unit3.GetX()), unit3Y(unit3.GetY()), unit3Z(unit3.GetZ());
+    const float max1(m_side1.GetMagnitude() + gapTolerance), max2(m_side2.GetMagnitude() + gapTolerance);
+    const float max3(m_side3.GetMagnitude() + gapTolerance);
+    const float vertexX(m_vertex.GetX()), vertexY(m_vertex.GetY()), vertexZ(m_vertex.GetZ());
+
+    // ATTN Branch-free form of the projection tests in the single position IsInGap, written to a block buffer so that it vectorises
+    unsigned char isInGapBlock[BLOCK_SIZE];
+
+    for (unsigned int begin = 0; begin < nPositions; begin += BLOCK_SIZE)
+    {
+        const unsigned int nBlockPositions((nPositions - begin < BLOCK_SIZE) ? nPositions - begin : BLOCK_SIZE);
+        const float *const pX(xCoordinates.data() + begin), *const pY(yCoordinates.data() + begin), *const pZ(zCoordinates.data() + begin);
+
+        for (unsigned int index = 0; index < nBlockPositions; ++index)
+        {
+            const float relativeX(pX[index] - vertexX), relativeY(pY[index] - vertexY), relativeZ(pZ[index] - vertexZ);
+            const float projection1((relativeX * unit1X) + (relativeY * unit1Y) + (relativeZ * unit1Z));
+            const float projection2((relativeX * unit2X) + (relativeY * unit2Y) + (relativeZ * unit2Z));
+            const float projection3((relativeX * unit3X) + (relativeY * unit3Y) + (relativeZ * unit3Z));
+
+            isInGapBlock[index] = !(projection1 < -gapTolerance) & !(projection1 > max1) & !(projection2 < -gapTolerance) &
+                !(projection2 > max2) & !(projection3 < -gapTolerance) & !(projection3 > max3);
+        }
+
+        for (unsigned int index = 0; index < nBlockPositions; ++index)
+            isInGapVector[begin + index] = (0 != isInGapBlock[index]);
+    }
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -101,14 +205,12 @@ ConcentricGap::ConcentricGap(const object_creation::Geometry::ConcentricGap::Par
     m_innerSymmetryOrder(parameters.m_innerSymmetryOrder.Get()),
     m_outerRCoordinate(parameters.m_outerRCoordinate.Get()),
     m_outerPhiCoordinate(parameters.m_outerPhiCoordinate.Get()),
-    m_outerSymmetryOrder(parameters.m_outerSymmetryOrder.Get())
+    m_outerSymmetryOrder(parameters.m_outerSymmetryOrder.Get()),
+    m_innerPolygon(m_innerRCoordinate, m_innerPhiCoordinate, m_innerSymmetryOrder),
+    m_outerPolygon(m_outerRCoordinate, m_outerPhiCoordinate, m_outerSymmetryOrder)
 {
     if ((0 == m_innerSymmetryOrder) || (0 == m_outerSymmetryOrder))
         throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
-
-    const float centralZCoordinate(0.5f * (m_maxZCoordinate + m_minZCoordinate));
-    this->GetPolygonVertices(m_innerRCoordinate, centralZCoordinate, m_innerPhiCoordinate, m_innerSymmetryOrder, m_innerVertexPointList);
-    this->GetPolygonVertices(m_outerRCoordinate, centralZCoordinate, m_outerPhiCoordinate, m_outerSymmetryOrder, m_outerVertexPointList);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -130,15 +232,13 @@ bool ConcentricGap::IsInGap(const CartesianVector &positionVector, const HitType
     if (r < m_innerRCoordinate)
         return false;
 
-    static const float pi(std::acos(-1.f));
-
-    if (r > m_outerRCoordinate / std::cos(pi / static_cast<float>(m_outerSymmetryOrder)))
+    if (r > m_outerPolygon.GetVertexRCoordinate())
         return false;
 
-    if (!this->IsIn2DPolygon(positionVector, m_outerVertexPointList, m_outerSymmetryOrder))
+    if (!m_outerPolygon.IsInside(x, y))
         return false;
 
-    if (this->IsIn2DPolygon(positionVector, m_innerVertexPointList, m_innerSymmetryOrder))
+    if (m_innerPolygon.IsInside(x, y))
         return false;
 
     return true;
@@ -146,63 +246,41 @@ bool ConcentricGap::IsInGap(const CartesianVector &positionVector, const HitType
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-void ConcentricGap::GetPolygonVertices(const float rCoordinate, const float zCoordinate, const float phiCoordinate,
-    const unsigned int symmetryOrder, VertexPointList &vertexPointList) const
+void ConcentricGap::IsInGap(const FloatVector &xCoordinates, const FloatVector &yCoordinates, const FloatVector &zCoordinates,
+    const HitType hitType, const float gapTolerance, BoolVector &isInGapVector) const
 {
-    if (0 == symmetryOrder)
+    if ((TPC_VIEW_U == hitType) || (TPC_VIEW_V == hitType) || (TPC_VIEW_W == hitType))
         throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
 
-    static const float pi(std::acos(-1.f));
-    const float firstVertexAngle(pi / static_cast<float>(symmetryOrder));
-    const float rMax(rCoordinate / std::cos(firstVertexAngle));
+    const unsigned int nPositions(DetectorGap::GetNPositions(xCoordinates, yCoordinates, zCoordinates));
+    isInGapVector.resize(nPositions);
 
-    for (unsigned int i = 0; i < symmetryOrder + 1; ++i)
-    {
-        const float phi = phiCoordinate + firstVertexAngle + (2.f * pi * static_cast<float>(i) / static_cast<float>(symmetryOrder));
-        const float sinPhi(std::sin(phi));
-        const float cosPhi(std::cos(phi));
-        vertexPointList.push_back(CartesianVector(sinPhi * rMax, cosPhi * rMax, zCoordinate));
-    }
-}
+    const float minZ(m_minZCoordinate - gapTolerance), maxZ(m_maxZCoordinate + gapTolerance);
+    const float maxR(m_outerPolygon.GetVertexRCoordinate());
 
-//------------------------------------------------------------------------------------------------------------------------------------------
+    // ATTN Branch-free form of the tests in the single position IsInGap, with the polygon tests made edge by edge across each block
+    unsigned char isInOuterPolygon[BLOCK_SIZE], isInInnerPolygon[BLOCK_SIZE], isInGapBlock[BLOCK_SIZE];
 
-bool ConcentricGap::IsIn2DPolygon(const CartesianVector &point, const VertexPointList &vertexPointList, const unsigned int symmetryOrder) const
-{
-    if (vertexPointList.size() != (symmetryOrder + 1))
-        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    for (unsigned int begin = 0; begin < nPositions; begin += BLOCK_SIZE)
+    {
+        const unsigned int nBlockPositions((nPositions - begin < BLOCK_SIZE) ? nPositions - begin : BLOCK_SIZE);
+        const float *const pX(xCoordinates.data() + begin), *const pY(yCoordinates.data() + begin), *const pZ(zCoordinates.data() + begin);
 
-    int windingNumber(0);
+        m_outerPolygon.IsInside(pX, pY, nBlockPositions, isInOuterPolygon);
+        m_innerPolygon.IsInside(pX, pY, nBlockPositions, isInInnerPolygon);
 
-    for (unsigned int i = 0; i < symmetryOrder; ++i)
-    {
-        if (vertexPointList[i].GetY() <= point.GetY())
-        {
-            if (vertexPointList[i + 1].GetY() > point.GetY())
-            {
-                // If point is left of edge, identify an upward crossing
-                if (((vertexPointList[i + 1].GetX() - vertexPointList[i].GetX()) * (point.GetY() - vertexPointList[i].GetY()) -
-                     (point.GetX() - vertexPointList[i].GetX()) * (vertexPointList[i + 1].GetY() - vertexPointList[i].GetY()) ) > 0.f)
-                {
-                    ++windingNumber;
-                }
-            }
-        }
-        else
+        for (unsigned int index = 0; index < nBlockPositions; ++index)
         {
-            if (vertexPointList[i + 1].GetY() <= point.GetY())
-            {
-                // If point is right of edge, identify a downward crossing
-                if (((vertexPointList[i + 1].GetX() - vertexPointList[i].GetX()) * (point.GetY() - vertexPointList[i].GetY()) -
-                     (point.GetX() - vertexPointList[i].GetX()) * (vertexPointList[i + 1].GetY() - vertexPointList[i].GetY()) ) < 0.f)
-                {
-                    --windingNumber;
-                }
-            }
+            const float x(pX[index]), y(pY[index]), z(pZ[index]);
+            const float r(std::sqrt(x * x + y * y));
+
+            isInGapBlock[index] = !(z < minZ) & !(z > maxZ) & !(r < m_innerRCoordinate) & !(r > maxR) &
+                (0 != isInOuterPolygon[index]) & (0 == isInInnerPolygon[index]);
         }
-    }
 
-    return (0 != windingNumber);
+        for (unsigned int index = 0; index < nBlockPositions; ++index)
+            isInGapVector[begin + index] = (0 != isInGapBlock[index]);
+    }
 }
 
 } // namespace pandora
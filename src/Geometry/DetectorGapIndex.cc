@@ -0,0 +1,361 @@
+/**
+ *  @file   PandoraSDK/src/Geometry/DetectorGapIndex.cc
+ * 
+ *  @brief  Implementation of the detector gap index class.
+ * 
+ *  $Log: $
+ */
+
+#include "Geometry/DetectorGap.h"
+#include "Geometry/DetectorGapIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <typeinfo>
+
+namespace pandora
+{
+
+const unsigned int DetectorGapIndex::POSITIONS_PER_BLOCK = 32;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+DetectorGapIndex::DetectorGapIndex(const DetectorGapList &detectorGapList) :
+    m_hasLineGaps(false),
+    m_hasVolumeGaps(false)
+{
+    BoundingVolumeHierarchy::BoundingBoxVector boundingBoxes;
+
+    for (const DetectorGap *const pDetectorGap : detectorGapList)
+    {
+        // ATTN Only gaps of exactly the sdk types are indexed, as derived types may override IsInGap
+        if (typeid(*pDetectorGap) == typeid(LineGap))
+        {
+            const LineGap *const pLineGap(static_cast<const LineGap*>(pDetectorGap));
+            m_hasLineGaps = true;
+
+            switch (pLineGap->GetLineGapType())
+            {
+            case TPC_WIRE_GAP_VIEW_U:
+                m_wireGapIntervals[0].AddInterval(pLineGap->GetLineStartZ(), pLineGap->GetLineEndZ());
+                break;
+            case TPC_WIRE_GAP_VIEW_V:
+                m_wireGapIntervals[1].AddInterval(pLineGap->GetLineStartZ(), pLineGap->GetLineEndZ());
+                break;
+            case TPC_WIRE_GAP_VIEW_W:
+                m_wireGapIntervals[2].AddInterval(pLineGap->GetLineStartZ(), pLineGap->GetLineEndZ());
+                break;
+            case TPC_DRIFT_GAP:
+                m_driftGapIntervals.AddInterval(pLineGap->GetLineStartX(), pLineGap->GetLineEndX());
+                break;
+            default:
+                m_otherGaps.push_back(pDetectorGap);
+                break;
+            }
+
+            continue;
+        }
+
+        BoundingBox boundingBox;
+        bool isBounded(false);
+
+        if (typeid(*pDetectorGap) == typeid(BoxGap))
+        {
+            m_hasVolumeGaps = true;
+            isBounded = DetectorGapIndex::GetBoundingBox(static_cast<const BoxGap*>(pDetectorGap), boundingBox);
+        }
+        else if (typeid(*pDetectorGap) == typeid(ConcentricGap))
+        {
+            m_hasVolumeGaps = true;
+            isBounded = DetectorGapIndex::GetBoundingBox(static_cast<const ConcentricGap*>(pDetectorGap), boundingBox);
+        }
+
+        if (!isBounded)
+        {
+            m_otherGaps.push_back(pDetectorGap);
+            continue;
+        }
+
+        boundingBox.Pad();
+        m_volumeGaps.push_back(pDetectorGap);
+        boundingBoxes.push_back(boundingBox);
+    }
+
+    for (IntervalTable &intervalTable : m_wireGapIntervals)
+        intervalTable.Build();
+
+    m_driftGapIntervals.Build();
+    m_volumeGapHierarchy = BoundingVolumeHierarchy(boundingBoxes);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool DetectorGapIndex::IsInGap(const CartesianVector &positionVector, const HitType hitType, const float gapTolerance) const
+{
+    this->CheckHitType(hitType);
+    const bool isTwoDView((TPC_VIEW_U == hitType) || (TPC_VIEW_V == hitType) || (TPC_VIEW_W == hitType));
+
+    if (isTwoDView && m_wireGapIntervals[hitType - TPC_VIEW_U].Contains(positionVector.GetZ(), gapTolerance))
+        return true;
+
+    if (m_driftGapIntervals.Contains(positionVector.GetX(), gapTolerance))
+        return true;
+
+    if (!m_volumeGapHierarchy.IsEmpty() && this->IsInVolumeGap(positionVector, hitType, gapTolerance))
+        return true;
+
+    for (const DetectorGap *const pDetectorGap : m_otherGaps)
+    {
+        if (pDetectorGap->IsInGap(positionVector, hitType, gapTolerance))
+            return true;
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void DetectorGapIndex::IsInGap(const FloatVector &xCoordinates, const FloatVector &yCoordinates, const FloatVector &zCoordinates,
+    const HitType hitType, const float gapTolerance, BoolVector &isInGapVector) const
+{
+    this->CheckHitType(hitType);
+
+    if ((xCoordinates.size() != yCoordinates.size()) || (xCoordinates.size() != zCoordinates.size()))
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+    const unsigned int nPositions(xCoordinates.size());
+    isInGapVector.assign(nPositions, false);
+
+    if (0 == nPositions)
+        return;
+
+    if (m_hasLineGaps)
+    {
+        const bool isTwoDView((TPC_VIEW_U == hitType) || (TPC_VIEW_V == hitType) || (TPC_VIEW_W == hitType));
+
+        for (unsigned int index = 0; index < nPositions; ++index)
+        {
+            isInGapVector[index] = (isTwoDView && m_wireGapIntervals[hitType - TPC_VIEW_U].Contains(zCoordinates[index], gapTolerance)) ||
+                m_driftGapIntervals.Contains(xCoordinates[index], gapTolerance);
+        }
+    }
+
+    // ATTN Buffers are shared by all gaps and blocks, so that the per block coordinates and per gap results are not reallocated each time
+    BoolVector isInThisGapVector;
+
+    if (!m_volumeGapHierarchy.IsEmpty())
+    {
+        // ATTN Positions are taken in blocks, so that each block is tested only against gaps whose bounding boxes overlap its own
+        if (nPositions <= POSITIONS_PER_BLOCK)
+        {
+            this->MarkPositionsInVolumeGaps(xCoordinates, yCoordinates, zCoordinates, hitType, gapTolerance, 0, isInThisGapVector,
+                isInGapVector);
+        }
+        else
+        {
+            FloatVector blockXCoordinates, blockYCoordinates, blockZCoordinates;
+            blockXCoordinates.reserve(POSITIONS_PER_BLOCK);
+            blockYCoordinates.reserve(POSITIONS_PER_BLOCK);
+            blockZCoordinates.reserve(POSITIONS_PER_BLOCK);
+
+            for (unsigned int begin = 0; begin < nPositions; begin += POSITIONS_PER_BLOCK)
+            {
+                const unsigned int end(std::min(begin + POSITIONS_PER_BLOCK, nPositions));
+                blockXCoordinates.assign(xCoordinates.begin() + begin, xCoordinates.begin() + end);
+                blockYCoordinates.assign(yCoordinates.begin() + begin, yCoordinates.begin() + end);
+                blockZCoordinates.assign(zCoordinates.begin() + begin, zCoordinates.begin() + end);
+                this->MarkPositionsInVolumeGaps(blockXCoordinates, blockYCoordinates, blockZCoordinates, hitType, gapTolerance, begin,
+                    isInThisGapVector, isInGapVector);
+            }
+        }
+    }
+
+    for (const DetectorGap *const pDetectorGap : m_otherGaps)
+    {
+        DetectorGapIndex::MarkPositionsInGap(pDetectorGap, xCoordinates, yCoordinates, zCoordinates, hitType, gapTolerance, 0,
+            isInThisGapVector, isInGapVector);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void DetectorGapIndex::CheckHitType(const HitType hitType) const
+{
+    const bool isTwoDView((TPC_VIEW_U == hitType) || (TPC_VIEW_V == hitType) || (TPC_VIEW_W == hitType));
+
+    if ((m_hasLineGaps && !(isTwoDView || (TPC_3D == hitType))) || (m_hasVolumeGaps && isTwoDView))
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void DetectorGapIndex::MarkPositionsInGap(const DetectorGap *const pDetectorGap, const FloatVector &xCoordinates,
+    const FloatVector &yCoordinates, const FloatVector &zCoordinates, const HitType hitType, const float gapTolerance,
+    const unsigned int offset, BoolVector &isInThisGapVector, BoolVector &isInGapVector)
+{
+    pDetectorGap->IsInGap(xCoordinates, yCoordinates, zCoordinates, hitType, gapTolerance, isInThisGapVector);
+
+    for (unsigned int index = 0; index < isInThisGapVector.size(); ++index)
+    {
+        if (isInThisGapVector[index])
+            isInGapVector[offset + index] = true;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool DetectorGapIndex::GetBoundingBox(const BoxGap *const pBoxGap, BoundingBox &boundingBox)
+{
+    // ATTN The gap is the intersection of three slabs, 0 <= n_i . (p - vertex) <= |side_i|, with n_i the unit side vectors
+    const CartesianVector *const sides[3] = {&pBoxGap->GetSide1(), &pBoxGap->GetSide2(), &pBoxGap->GetSide3()};
+    double normals[3][3], lengths[3];
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        lengths[i] = sides[i]->GetMagnitude();
+
+        if (lengths[i] < std::numeric_limits<float>::epsilon())
+            return false;
+
+        normals[i][0] = sides[i]->GetX() / lengths[i];
+        normals[i][1] = sides[i]->GetY() / lengths[i];
+        normals[i][2] = sides[i]->GetZ() / lengths[i];
+    }
+
+    // The gap corners are vertex + inverse(normals) . c, for c with components 0 or |side_i|
+    double inverse[3][3];
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            const unsigned int j1((j + 1) % 3), j2((j + 2) % 3), i1((i + 1) % 3), i2((i + 2) % 3);
+            inverse[i][j] = normals[j1][i1] * normals[j2][i2] - normals[j1][i2] * normals[j2][i1];
+        }
+    }
+
+    const double determinant(normals[0][0] * inverse[0][0] + normals[0][1] * inverse[1][0] + normals[0][2] * inverse[2][0]);
+
+    if (std::fabs(determinant) < 1.e-6)
+        return false;
+
+    const double vertex[3] = {pBoxGap->GetVertex().GetX(), pBoxGap->GetVertex().GetY(), pBoxGap->GetVertex().GetZ()};
+    boundingBox.m_toleranceScale = 0.f;
+
+    for (unsigned int axis = 0; axis < 3; ++axis)
+    {
+        double low(vertex[axis]), high(vertex[axis]), toleranceScale(0.);
+
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            const double coefficient(inverse[axis][i] / determinant);
+            (coefficient > 0. ? high : low) += coefficient * lengths[i];
+            toleranceScale += std::fabs(coefficient);
+        }
+
+        boundingBox.m_min[axis] = static_cast<float>(low);
+        boundingBox.m_max[axis] = static_cast<float>(high);
+        boundingBox.m_toleranceScale = std::max(boundingBox.m_toleranceScale, static_cast<float>(toleranceScale));
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool DetectorGapIndex::GetBoundingBox(const ConcentricGap *const pConcentricGap, BoundingBox &boundingBox)
+{
+    const unsigned int symmetryOrder(pConcentricGap->GetOuterSymmetryOrder());
+
+    if (symmetryOrder < 3)
+        return false;
+
+    // ATTN Matches the outer radius cut applied in ConcentricGap::IsInGap; the gap tolerance is applied only to z
+    static const float pi(std::acos(-1.f));
+    const float rMax(pConcentricGap->GetOuterRCoordinate() / std::cos(pi / static_cast<float>(symmetryOrder)));
+
+    boundingBox.m_min[0] = -rMax; boundingBox.m_max[0] = rMax;
+    boundingBox.m_min[1] = -rMax; boundingBox.m_max[1] = rMax;
+    boundingBox.m_min[2] = pConcentricGap->GetMinZCoordinate(); boundingBox.m_max[2] = pConcentricGap->GetMaxZCoordinate();
+    boundingBox.m_toleranceScale = 1.f;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool DetectorGapIndex::IsInVolumeGap(const CartesianVector &positionVector, const HitType hitType, const float gapTolerance) const
+{
+    // ATTN A negative tolerance need not shrink a gap box evenly along every axis, so the boxes are not shrunk before the exact gap test
+    return m_volumeGapHierarchy.VisitContaining(positionVector, std::max(gapTolerance, 0.f), [&](const unsigned int index)
+    {
+        return m_volumeGaps[index]->IsInGap(positionVector, hitType, gapTolerance);
+    });
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void DetectorGapIndex::MarkPositionsInVolumeGaps(const FloatVector &xCoordinates, const FloatVector &yCoordinates,
+    const FloatVector &zCoordinates, const HitType hitType, const float gapTolerance, const unsigned int offset,
+    BoolVector &isInThisGapVector, BoolVector &isInGapVector) const
+{
+    BoundingBox positionsBoundingBox;
+
+    for (unsigned int index = 0; index < xCoordinates.size(); ++index)
+        positionsBoundingBox.Extend(xCoordinates[index], yCoordinates[index], zCoordinates[index]);
+
+    m_volumeGapHierarchy.VisitOverlapping(positionsBoundingBox, std::max(gapTolerance, 0.f), [&](const unsigned int index)
+    {
+        DetectorGapIndex::MarkPositionsInGap(m_volumeGaps[index], xCoordinates, yCoordinates, zCoordinates, hitType, gapTolerance, offset,
+            isInThisGapVector, isInGapVector);
+    });
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void DetectorGapIndex::IntervalTable::AddInterval(const float start, const float end)
+{
+    m_starts.push_back(start);
+    m_ends.push_back(end);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void DetectorGapIndex::IntervalTable::Build()
+{
+    UIntVector order(m_starts.size());
+
+    for (unsigned int index = 0; index < order.size(); ++index)
+        order[index] = index;
+
+    std::sort(order.begin(), order.end(), [this](const unsigned int lhs, const unsigned int rhs) {return (m_starts[lhs] < m_starts[rhs]);});
+
+    const FloatVector starts(m_starts), ends(m_ends);
+    m_maxEnds.resize(order.size());
+
+    for (unsigned int index = 0; index < order.size(); ++index)
+    {
+        m_starts[index] = starts[order[index]];
+        m_ends[index] = ends[order[index]];
+        m_maxEnds[index] = (index > 0) ? std::max(m_maxEnds[index - 1], m_ends[index]) : m_ends[index];
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool DetectorGapIndex::IntervalTable::Contains(const float coordinate, const float gapTolerance) const
+{
+    // ATTN start - tolerance increases with start, so the intervals satisfying the start condition form a prefix of the table. Any of
+    // them satisfies the end condition if and only if the one with the largest end coordinate does.
+    const FloatVector::const_iterator endIter(std::partition_point(m_starts.begin(), m_starts.end(),
+        [coordinate, gapTolerance](const float start) {return (coordinate > start - gapTolerance);}));
+
+    if (m_starts.begin() == endIter)
+        return false;
+
+    return (coordinate < m_maxEnds[endIter - m_starts.begin() - 1] + gapTolerance);
+}
+
+} // namespace pandora
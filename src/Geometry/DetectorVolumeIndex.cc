@@ -0,0 +1,146 @@
+/**
+ *  @file   PandoraSDK/src/Geometry/DetectorVolumeIndex.cc
+ * 
+ *  @brief  Implementation of the detector volume index class.
+ * 
+ *  $Log: $
+ */
+
+#include "Geometry/DetectorVolumeIndex.h"
+#include "Geometry/LArTPC.h"
+#include "Geometry/SubDetector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace pandora
+{
+
+DetectorVolumeIndex::DetectorVolumeIndex(const LArTPCMap &larTPCMap, const SubDetectorMap &subDetectorMap)
+{
+    BoundingVolumeHierarchy::BoundingBoxVector larTPCBoundingBoxes, subDetectorBoundingBoxes;
+
+    for (const LArTPCMap::value_type &mapEntry : larTPCMap)
+    {
+        m_larTPCs.push_back(mapEntry.second);
+        larTPCBoundingBoxes.push_back(DetectorVolumeIndex::GetBoundingBox(mapEntry.second));
+    }
+
+    for (const SubDetectorMap::value_type &mapEntry : subDetectorMap)
+    {
+        BoundingBox boundingBox;
+
+        if (!DetectorVolumeIndex::GetBoundingBox(mapEntry.second, boundingBox))
+            continue;
+
+        m_subDetectors.push_back(mapEntry.second);
+        subDetectorBoundingBoxes.push_back(boundingBox);
+    }
+
+    m_larTPCHierarchy = BoundingVolumeHierarchy(larTPCBoundingBoxes);
+    m_subDetectorHierarchy = BoundingVolumeHierarchy(subDetectorBoundingBoxes);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const LArTPC *DetectorVolumeIndex::GetContainingLArTPC(const CartesianVector &positionVector, const float tolerance) const
+{
+    // ATTN The box test is final, so the tolerance is applied with its sign: a negative tolerance shrinks each box on every side
+    unsigned int firstIndex(std::numeric_limits<unsigned int>::max());
+
+    (void) m_larTPCHierarchy.VisitContaining(positionVector, tolerance, [&firstIndex](const unsigned int index)
+    {
+        firstIndex = std::min(firstIndex, index);
+        return false;
+    });
+
+    return ((firstIndex < m_larTPCs.size()) ? m_larTPCs[firstIndex] : nullptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void DetectorVolumeIndex::GetContainingLArTPCs(const CartesianVector &positionVector, const float tolerance,
+    LArTPCVector &larTPCVector) const
+{
+    UIntVector indices;
+
+    (void) m_larTPCHierarchy.VisitContaining(positionVector, tolerance, [&indices](const unsigned int index)
+    {
+        indices.push_back(index);
+        return false;
+    });
+
+    std::sort(indices.begin(), indices.end());
+    larTPCVector.clear();
+
+    for (const unsigned int index : indices)
+        larTPCVector.push_back(m_larTPCs[index]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const SubDetector *DetectorVolumeIndex::GetContainingSubDetector(const CartesianVector &positionVector, const float tolerance) const
+{
+    unsigned int firstIndex(std::numeric_limits<unsigned int>::max());
+
+    // ATTN A negative tolerance shrinks a sub detector by less along z than in the xy plane, so the boxes are not shrunk before the exact
+    // sub detector test
+    (void) m_subDetectorHierarchy.VisitContaining(positionVector, std::max(tolerance, 0.f), [&](const unsigned int index)
+    {
+        if ((index < firstIndex) && m_subDetectors[index]->IsInSubDetector(positionVector, tolerance))
+            firstIndex = index;
+
+        return false;
+    });
+
+    return ((firstIndex < m_subDetectors.size()) ? m_subDetectors[firstIndex] : nullptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+DetectorVolumeIndex::BoundingBox DetectorVolumeIndex::GetBoundingBox(const LArTPC *const pLArTPC)
+{
+    // ATTN The box is the containment definition itself, so it is not padded
+    const float centres[3] = {pLArTPC->GetCenterX(), pLArTPC->GetCenterY(), pLArTPC->GetCenterZ()};
+    const float widths[3] = {pLArTPC->GetWidthX(), pLArTPC->GetWidthY(), pLArTPC->GetWidthZ()};
+
+    BoundingBox boundingBox;
+
+    for (unsigned int axis = 0; axis < 3; ++axis)
+    {
+        boundingBox.m_min[axis] = centres[axis] - 0.5f * widths[axis];
+        boundingBox.m_max[axis] = centres[axis] + 0.5f * widths[axis];
+    }
+
+    boundingBox.m_toleranceScale = 1.f;
+    return boundingBox;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool DetectorVolumeIndex::GetBoundingBox(const SubDetector *const pSubDetector, BoundingBox &boundingBox)
+{
+    const unsigned int symmetryOrder(pSubDetector->GetOuterSymmetryOrder());
+
+    if ((1 == symmetryOrder) || (2 == symmetryOrder))
+        return false;
+
+    // ATTN A tolerance moves each outer edge outwards by the tolerance, and so the polygon vertices by the tolerance scaled up likewise
+    static const float pi(std::acos(-1.f));
+    const float vertexScale((0 == symmetryOrder) ? 1.f : 1.f / std::cos(pi / static_cast<float>(symmetryOrder)));
+    const float rMax(pSubDetector->GetOuterRCoordinate() * vertexScale);
+
+    const float innerZ(pSubDetector->GetInnerZCoordinate()), outerZ(pSubDetector->GetOuterZCoordinate());
+    const float maxZ(std::max(innerZ, outerZ)), minZ(pSubDetector->IsMirroredInZ() ? -maxZ : std::min(innerZ, outerZ));
+
+    boundingBox.m_min[0] = -rMax; boundingBox.m_max[0] = rMax;
+    boundingBox.m_min[1] = -rMax; boundingBox.m_max[1] = rMax;
+    boundingBox.m_min[2] = minZ; boundingBox.m_max[2] = maxZ;
+    boundingBox.m_toleranceScale = vertexScale;
+    boundingBox.Pad();
+
+    return true;
+}
+
+} // namespace pandora
@@ -0,0 +1,99 @@
+/**
+ *  @file   PandoraSDK/src/Geometry/RegularPolygon.cc
+ * 
+ *  @brief  Implementation of the regular polygon class.
+ * 
+ *  $Log: $
+ */
+
+#include "Geometry/RegularPolygon.h"
+
+#include <cmath>
+
+namespace pandora
+{
+
+RegularPolygon::RegularPolygon(const float rCoordinate, const float phiCoordinate, const unsigned int symmetryOrder) :
+    m_rCoordinate(rCoordinate),
+    m_vertexRCoordinate(rCoordinate),
+    m_phiCoordinate(phiCoordinate),
+    m_sectorsPerRadian(0.f),
+    m_symmetryOrder(symmetryOrder)
+{
+    if (m_symmetryOrder < 3)
+        return;
+
+    // ATTN Phi coordinates are measured from the y axis towards the x axis, so a unit vector at phi is (sin phi, cos phi)
+    static const float pi(std::acos(-1.f));
+    m_vertexRCoordinate = m_rCoordinate / std::cos(pi / static_cast<float>(m_symmetryOrder));
+    m_sectorsPerRadian = static_cast<float>(m_symmetryOrder) / (2.f * pi);
+
+    for (unsigned int i = 0; i < m_symmetryOrder; ++i)
+    {
+        const float phi(m_phiCoordinate + 2.f * pi * static_cast<float>(i) / static_cast<float>(m_symmetryOrder));
+        m_normalX.push_back(std::sin(phi));
+        m_normalY.push_back(std::cos(phi));
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool RegularPolygon::IsInside(const float x, const float y, const float tolerance) const
+{
+    const float rCoordinate(m_rCoordinate + tolerance);
+
+    if (0 == m_symmetryOrder)
+        return ((rCoordinate > 0.f) && (x * x + y * y < rCoordinate * rCoordinate));
+
+    if (m_symmetryOrder < 3)
+        return false;
+
+    // ATTN A non-finite point lies outside every edge; it also has no phi coordinate from which to find the edge facing it
+    if (!std::isfinite(x) || !std::isfinite(y))
+        return false;
+
+    // The nearest edge normal to the point phi coordinate; its neighbours are also tested, to allow for rounding near polygon vertices.
+    // The sector is reduced modulo the symmetry order before conversion to int, so that any polygon phi coordinate is in range.
+    const int nSectors(static_cast<int>(m_symmetryOrder));
+    const float sectorCoordinate(std::floor((std::atan2(x, y) - m_phiCoordinate) * m_sectorsPerRadian + 0.5f));
+    const int sector(static_cast<int>(std::fmod(sectorCoordinate, static_cast<float>(nSectors))));
+
+    for (const int offset : {-1, 0, 1})
+    {
+        const unsigned int index((sector + offset + 2 * nSectors) % nSectors);
+
+        if (!(x * m_normalX[index] + y * m_normalY[index] < rCoordinate))
+            return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void RegularPolygon::IsInside(const float *const pX, const float *const pY, const unsigned int nPoints,
+    unsigned char *const pIsInside) const
+{
+    if (0 == m_symmetryOrder)
+    {
+        const float rSquared(m_rCoordinate * m_rCoordinate);
+
+        for (unsigned int index = 0; index < nPoints; ++index)
+            pIsInside[index] = (pX[index] * pX[index] + pY[index] * pY[index] < rSquared);
+
+        return;
+    }
+
+    for (unsigned int index = 0; index < nPoints; ++index)
+        pIsInside[index] = (m_symmetryOrder >= 3);
+
+    for (unsigned int i = 0; i < m_normalX.size(); ++i)
+    {
+        const float normalX(m_normalX[i]), normalY(m_normalY[i]);
+
+        for (unsigned int index = 0; index < nPoints; ++index)
+            pIsInside[index] &= (pX[index] * normalX + pY[index] * normalY < m_rCoordinate);
+    }
+}
+
+} // namespace pandora
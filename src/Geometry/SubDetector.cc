@@ -8,6 +8,9 @@
 
 #include "Geometry/SubDetector.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace pandora
 {
 
@@ -23,7 +26,9 @@ SubDetector::SubDetector(const object_creation::Geometry::SubDetector::Parameter
     m_outerPhiCoordinate(inputParameters.m_outerPhiCoordinate.Get()),
     m_outerSymmetryOrder(inputParameters.m_outerSymmetryOrder.Get()),
     m_isMirroredInZ(inputParameters.m_isMirroredInZ.Get()),
-    m_nLayers(inputParameters.m_nLayers.Get())
+    m_nLayers(inputParameters.m_nLayers.Get()),
+    m_innerPolygon(m_innerRCoordinate, m_innerPhiCoordinate, m_innerSymmetryOrder),
+    m_outerPolygon(m_outerRCoordinate, m_outerPhiCoordinate, m_outerSymmetryOrder)
 {
     if ((m_innerRCoordinate < 0.f) || (m_outerRCoordinate < 0.f) || (m_isMirroredInZ && ((m_innerZCoordinate < 0.f) || (m_outerZCoordinate < 0.f))))
     {
@@ -50,4 +55,21 @@ SubDetector::~SubDetector()
 {
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool SubDetector::IsInSubDetector(const CartesianVector &positionVector, const float tolerance) const
+{
+    const float z(m_isMirroredInZ ? std::fabs(positionVector.GetZ()) : positionVector.GetZ());
+
+    const float minZ(std::min(m_innerZCoordinate, m_outerZCoordinate) - tolerance);
+    const float maxZ(std::max(m_innerZCoordinate, m_outerZCoordinate) + tolerance);
+
+    if ((z < minZ) || (z > maxZ))
+        return false;
+
+    const float x(positionVector.GetX()), y(positionVector.GetY());
+
+    return (m_outerPolygon.IsInside(x, y, tolerance) && !m_innerPolygon.IsInside(x, y, -tolerance));
+}
+
 } // namespace pandora
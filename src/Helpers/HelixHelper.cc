@@ -0,0 +1,110 @@
+/**
+ *  @file   PandoraSDK/src/Helpers/HelixHelper.cc
+ * 
+ *  @brief  Implementation of the helix helper class.
+ * 
+ *  $Log: $
+ */
+
+#include "Helpers/HelixHelper.h"
+#include "Helpers/ParallelHelper.h"
+
+#include "Objects/Helix.h"
+#include "Objects/Track.h"
+
+#include "Pandora/Pandora.h"
+#include "Pandora/PandoraSettings.h"
+
+#include <cmath>
+#include <limits>
+
+namespace pandora
+{
+
+StatusCode HelixHelper::GetClosestApproachPairs(const Pandora &pandora, const TrackList &trackList, const float maxHelixDistance,
+    HelixPairVector &helixPairVector)
+{
+    if (!helixPairVector.empty())
+        return STATUS_CODE_INVALID_PARAMETER;
+
+    TrackVector trackVector;
+    std::vector<const Helix*> helixVector;
+
+    for (const Track *const pTrack : trackList)
+    {
+        const CartesianVector &momentum(pTrack->GetTrackStateAtStart().GetMomentum());
+
+        // ATTN Helices are undefined for tracks without transverse momentum, using the same threshold as the helix constructor
+        const double px(momentum.GetX()), py(momentum.GetY());
+
+        if (std::sqrt(px * px + py * py) < std::numeric_limits<float>::epsilon())
+            continue;
+
+        trackVector.push_back(pTrack);
+        helixVector.push_back(&pTrack->GetHelixAtStart());
+    }
+
+    // ATTN Row i holds the pairs (i, j > i). Rows are processed in folded pairs (i, n - 1 - i), so each index has similar work
+    const size_t nTracks(trackVector.size());
+    std::vector<HelixPairVector> rowHelixPairs(nTracks);
+
+    const auto processRow = [&](const size_t i)
+    {
+        const Helix &helix1(*helixVector[i]);
+
+        for (size_t j = i + 1; j < nTracks; ++j)
+        {
+            const Helix &helix2(*helixVector[j]);
+
+            // ATTN Closest approach positions lie on the helix circles; allow for rounding in the full calculation
+            const float roundingTolerance(1.e-4f * (helix1.GetRadius() + helix2.GetRadius()));
+
+            if (HelixHelper::GetCircleSeparation(helix1, helix2) > maxHelixDistance + roundingTolerance)
+                continue;
+
+            CartesianVector positionOfClosestApproach(0.f, 0.f, 0.f), v0Momentum(0.f, 0.f, 0.f);
+            float helixDistance(std::numeric_limits<float>::max());
+
+            if (STATUS_CODE_SUCCESS != helix1.GetDistanceToHelix(&helix2, positionOfClosestApproach, v0Momentum, helixDistance))
+                continue;
+
+            if (helixDistance < maxHelixDistance)
+                rowHelixPairs[i].emplace_back(trackVector[i], trackVector[j], positionOfClosestApproach, v0Momentum, helixDistance);
+        }
+    };
+
+    ParallelHelper::ForEachIndex((nTracks + 1) / 2, pandora.GetSettings()->GetNumberOfThreads(), [&](const size_t index)
+    {
+        processRow(index);
+
+        if (nTracks - 1 - index != index)
+            processRow(nTracks - 1 - index);
+    });
+
+    for (const HelixPairVector &rowPairs : rowHelixPairs)
+        helixPairVector.insert(helixPairVector.end(), rowPairs.begin(), rowPairs.end());
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+float HelixHelper::GetCircleSeparation(const Helix &helix1, const Helix &helix2)
+{
+    const double dx(helix1.GetXCentre() - helix2.GetXCentre()), dy(helix1.GetYCentre() - helix2.GetYCentre());
+    const double distance(std::sqrt(dx * dx + dy * dy));
+    const double radius1(helix1.GetRadius()), radius2(helix2.GetRadius());
+
+    if (distance > radius1 + radius2)
+        return static_cast<float>(distance - radius1 - radius2);
+
+    if (distance + radius2 < radius1)
+        return static_cast<float>(radius1 - distance - radius2);
+
+    if (distance + radius1 < radius2)
+        return static_cast<float>(radius2 - distance - radius1);
+
+    return 0.f;
+}
+
+} // namespace pandora
@@ -7,15 +7,18 @@
  */
 
 #include "Helpers/MCParticleHelper.h"
+#include "Helpers/ParallelHelper.h"
 
 #include "Objects/CaloHit.h"
 #include "Objects/Cluster.h"
 #include "Objects/MCParticle.h"
+#include "Objects/ParticleFlowObject.h"
 #include "Objects/Track.h"
 
 #include "Pandora/PandoraInternal.h"
 
 #include <algorithm>
+#include <unordered_set>
 
 namespace pandora
 {
@@ -25,20 +28,14 @@ const MCParticle *MCParticleHelper::GetMainMCParticle(const T *const pT)
 {
     float bestWeight(0.f);
     const MCParticle *pBestMCParticle(nullptr);
-    const MCParticleWeightMap &hitMCParticleWeightMap(pT->GetMCParticleWeightMap());
 
-    MCParticleVector mcParticleVector;
-    for (const MCParticleWeightMap::value_type &mapEntry : hitMCParticleWeightMap) mcParticleVector.push_back(mapEntry.first);
-    std::sort(mcParticleVector.begin(), mcParticleVector.end(), PointerLessThan<MCParticle>());
-
-    for (const MCParticle *const pMCParticle : mcParticleVector)
+    // ATTN Mc particle weight map entries are held in deterministic order
+    for (const MCParticleWeightMap::value_type &mapEntry : pT->GetMCParticleWeightMap())
     {
-        const float weight(hitMCParticleWeightMap.at(pMCParticle));
-
-        if (weight > bestWeight)
+        if (mapEntry.second > bestWeight)
         {
-            bestWeight = weight;
-            pBestMCParticle = pMCParticle;
+            bestWeight = mapEntry.second;
+            pBestMCParticle = mapEntry.first;
         }
     }
 
@@ -49,67 +46,219 @@ const MCParticle *MCParticleHelper::GetMainMCParticle(const T *const pT)
 }
 
 template <>
-const MCParticle *MCParticleHelper::GetMainMCParticle(const CaloHitList *const pCaloHitList)
+void MCParticleHelper::AddMCParticleWeights(const CaloHitList *const pCaloHitList, MCParticleWeightMap &mcParticleWeightMap)
 {
-    MCParticleWeightMap mcParticleWeightMap;
-
     for (const CaloHit *const pCaloHit : *pCaloHitList)
     {
-        const MCParticleWeightMap &hitMCParticleWeightMap(pCaloHit->GetMCParticleWeightMap());
+        for (const MCParticleWeightMap::value_type &mapEntry : pCaloHit->GetMCParticleWeightMap())
+            mcParticleWeightMap[mapEntry.first] += mapEntry.second;
+    }
+}
+
+template <>
+void MCParticleHelper::AddMCParticleWeights(const Cluster *const pCluster, MCParticleWeightMap &mcParticleWeightMap)
+{
+    for (const OrderedCaloHitList::value_type &layerEntry : pCluster->GetOrderedCaloHitList())
+        MCParticleHelper::AddMCParticleWeights(layerEntry.second, mcParticleWeightMap);
+}
+
+template <>
+void MCParticleHelper::AddMCParticleWeights(const ClusterList *const pClusterList, MCParticleWeightMap &mcParticleWeightMap)
+{
+    for (const Cluster *const pCluster : *pClusterList)
+        MCParticleHelper::AddMCParticleWeights(pCluster, mcParticleWeightMap);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <>
+const MCParticle *MCParticleHelper::GetMainMCParticle(const CaloHitList *const pCaloHitList)
+{
+    TruthMatch truthMatch;
+    MCParticleHelper::AddMCParticleWeights(pCaloHitList, truthMatch.m_mcParticleWeightMap);
+    truthMatch.Finalize();
 
-        MCParticleVector mcParticleVector;
-        for (const MCParticleWeightMap::value_type &mapEntry : hitMCParticleWeightMap) mcParticleVector.push_back(mapEntry.first);
-        std::sort(mcParticleVector.begin(), mcParticleVector.end(), PointerLessThan<MCParticle>());
+    return truthMatch.GetMainMCParticle();
+}
+
+template <>
+const MCParticle *MCParticleHelper::GetMainMCParticle(const Cluster *const pCluster)
+{
+    TruthMatch truthMatch;
+    MCParticleHelper::AddMCParticleWeights(pCluster, truthMatch.m_mcParticleWeightMap);
+    truthMatch.Finalize();
+
+    return truthMatch.GetMainMCParticle();
+}
 
-        for (const MCParticle *const pMCParticle : mcParticleVector)
+template <>
+const MCParticle *MCParticleHelper::GetMainMCParticle(const ClusterList *const pClusterList)
+{
+    TruthMatch truthMatch;
+    MCParticleHelper::AddMCParticleWeights(pClusterList, truthMatch.m_mcParticleWeightMap);
+    truthMatch.Finalize();
+
+    return truthMatch.GetMainMCParticle();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+TruthMatch::TruthMatch() :
+    m_pMainMCParticle(nullptr),
+    m_mainMCParticleWeight(0.f),
+    m_totalWeight(0.f),
+    m_contentVersion(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const MCParticle *TruthMatch::GetMainMCParticle() const
+{
+    if (!m_pMainMCParticle)
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+
+    return m_pMainMCParticle;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void TruthMatch::Finalize()
+{
+    m_pMainMCParticle = nullptr;
+    m_mainMCParticleWeight = 0.f;
+    m_totalWeight = 0.f;
+
+    // ATTN Mc particle weight map entries are held in deterministic order, so ties are resolved consistently
+    for (const MCParticleWeightMap::value_type &mapEntry : m_mcParticleWeightMap)
+    {
+        m_totalWeight += mapEntry.second;
+
+        if (mapEntry.second > m_mainMCParticleWeight)
         {
-            const float weight(hitMCParticleWeightMap.at(pMCParticle));
-            mcParticleWeightMap[pMCParticle] += weight;
+            m_pMainMCParticle = mapEntry.first;
+            m_mainMCParticleWeight = mapEntry.second;
         }
     }
+}
 
-    float bestWeight(0.f);
-    const MCParticle *pBestMCParticle(nullptr);
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+TruthMatchCache::TruthMatchCache() :
+    m_nCacheHits(0),
+    m_nCacheMisses(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const TruthMatch &TruthMatchCache::GetTruthMatch(const Cluster *const pCluster)
+{
+    TruthMatch *const pTruthMatch(this->GetOutdatedEntry(pCluster));
+
+    if (pTruthMatch)
+        TruthMatchCache::CalculateTruthMatch(pCluster, *pTruthMatch);
 
-    MCParticleVector mcParticleVector;
-    for (const MCParticleWeightMap::value_type &mapEntry : mcParticleWeightMap) mcParticleVector.push_back(mapEntry.first);
-    std::sort(mcParticleVector.begin(), mcParticleVector.end(), PointerLessThan<MCParticle>());
+    return m_clusterToTruthMatchMap.at(pCluster);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
 
-    for (const MCParticle *const pCurrentMCParticle : mcParticleVector)
+void TruthMatchCache::GetTruthMatch(const ParticleFlowObject *const pPfo, TruthMatch &truthMatch)
+{
+    truthMatch.m_mcParticleWeightMap.clear();
+
+    for (const Cluster *const pCluster : pPfo->GetClusterList())
     {
-        const float currentWeight(mcParticleWeightMap.at(pCurrentMCParticle));
+        for (const MCParticleWeightMap::value_type &mapEntry : this->GetTruthMatch(pCluster).GetMCParticleWeightMap())
+            truthMatch.m_mcParticleWeightMap[mapEntry.first] += mapEntry.second;
+    }
+
+    truthMatch.m_contentVersion = 0;
+    truthMatch.Finalize();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
 
-        if (currentWeight > bestWeight)
+void TruthMatchCache::CalculateTruthMatches(const ClusterList &clusterList, const unsigned int nThreads)
+{
+    // ATTN Cache entries are created serially; unordered map element addresses then remain stable during parallel calculation
+    // ATTN A cluster may be listed more than once (e.g. shared between pfos); each entry must be calculated by a single worker, and
+    // repeated requests count as cache hits, as they would for successive calls to GetTruthMatch
+    std::vector<std::pair<const Cluster*, TruthMatch*> > outdatedEntries;
+    std::unordered_set<const Cluster*> requestedClusters;
+
+    for (const Cluster *const pCluster : clusterList)
+    {
+        if (!requestedClusters.insert(pCluster).second)
         {
-            pBestMCParticle = pCurrentMCParticle;
-            bestWeight = currentWeight;
+            ++m_nCacheHits;
+            continue;
         }
-    }
 
-    if (!pBestMCParticle)
-        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+        TruthMatch *const pTruthMatch(this->GetOutdatedEntry(pCluster));
 
-    return pBestMCParticle;
+        if (pTruthMatch)
+            outdatedEntries.emplace_back(pCluster, pTruthMatch);
+    }
+
+    ParallelHelper::ForEachIndex(outdatedEntries.size(), nThreads, [&outdatedEntries](const size_t index)
+    {
+        TruthMatchCache::CalculateTruthMatch(outdatedEntries[index].first, *outdatedEntries[index].second);
+    });
 }
 
-template <>
-const MCParticle *MCParticleHelper::GetMainMCParticle(const Cluster *const pCluster)
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void TruthMatchCache::CalculateTruthMatches(const PfoList &pfoList, const unsigned int nThreads, PfoToTruthMatchMap &pfoToTruthMatchMap)
 {
-    CaloHitList caloHitList;
-    pCluster->GetOrderedCaloHitList().FillCaloHitList(caloHitList);
+    ClusterList clusterList;
+
+    for (const ParticleFlowObject *const pPfo : pfoList)
+        clusterList.insert(clusterList.end(), pPfo->GetClusterList().begin(), pPfo->GetClusterList().end());
 
-    return MCParticleHelper::GetMainMCParticle(&caloHitList);
+    this->CalculateTruthMatches(clusterList, nThreads);
+
+    for (const ParticleFlowObject *const pPfo : pfoList)
+        this->GetTruthMatch(pPfo, pfoToTruthMatchMap[pPfo]);
 }
 
-template <>
-const MCParticle *MCParticleHelper::GetMainMCParticle(const ClusterList *const pClusterList)
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void TruthMatchCache::Clear()
 {
-    CaloHitList caloHitList;
+    m_clusterToTruthMatchMap.clear();
+    m_nCacheHits = 0;
+    m_nCacheMisses = 0;
+}
 
-    for (const Cluster *const pCluster : *pClusterList)
-        pCluster->GetOrderedCaloHitList().FillCaloHitList(caloHitList);
+//------------------------------------------------------------------------------------------------------------------------------------------
 
-    return MCParticleHelper::GetMainMCParticle(&caloHitList);
+TruthMatch *TruthMatchCache::GetOutdatedEntry(const Cluster *const pCluster)
+{
+    TruthMatch &truthMatch(m_clusterToTruthMatchMap[pCluster]);
+
+    // ATTN Content versions are unique across clusters, so entries for deleted clusters cannot be matched by reused addresses
+    if (truthMatch.m_contentVersion == pCluster->GetContentVersion())
+    {
+        ++m_nCacheHits;
+        return nullptr;
+    }
+
+    ++m_nCacheMisses;
+    return &truthMatch;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void TruthMatchCache::CalculateTruthMatch(const Cluster *const pCluster, TruthMatch &truthMatch)
+{
+    truthMatch.m_mcParticleWeightMap.clear();
+    MCParticleHelper::AddMCParticleWeights(pCluster, truthMatch.m_mcParticleWeightMap);
+    truthMatch.Finalize();
+    truthMatch.m_contentVersion = pCluster->GetContentVersion();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -6,6 +6,8 @@
  *  $Log: $
  */
 
+#include "Helpers/ParallelHelper.h"
+
 #include "Managers/CaloHitManager.h"
 #include "Managers/PluginManager.h"
 
@@ -15,6 +17,7 @@
 #include "Pandora/ObjectFactory.h"
 #include "Pandora/Pandora.h"
 #include "Pandora/PandoraInternal.h"
+#include "Pandora/PandoraSettings.h"
 
 #include "Plugins/PseudoLayerPlugin.h"
 
@@ -27,7 +30,9 @@ namespace pandora
 CaloHitManager::CaloHitManager(const Pandora *const pPandora) :
     InputObjectManager<CaloHit>(pPandora),
     m_nReclusteringProcesses(0),
-    m_pCurrentReclusterMetadata(nullptr)
+    m_pCurrentReclusterMetadata(nullptr),
+    m_pPseudoLayerCache(nullptr),
+    m_nRejectedCaloHits(0)
 {
     PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->CreateInitialLists());
 }
@@ -37,12 +42,14 @@ CaloHitManager::CaloHitManager(const Pandora *const pPandora) :
 CaloHitManager::~CaloHitManager()
 {
     (void) this->EraseAllContent();
+    delete m_pPseudoLayerCache;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 StatusCode CaloHitManager::Create(const object_creation::CaloHit::Parameters &parameters, const CaloHit *&pCaloHit,
-    const ObjectFactory<object_creation::CaloHit::Parameters, object_creation::CaloHit::Object> &factory)
+    const ObjectFactory<object_creation::CaloHit::Parameters, object_creation::CaloHit::Object> &factory,
+    const bool shouldDeferPseudoLayer)
 {
     pCaloHit = nullptr;
 
@@ -55,6 +62,13 @@ StatusCode CaloHitManager::Create(const object_creation::CaloHit::Parameters &pa
         if (!pCaloHit || (m_nameToListMap.end() == inputIter))
             throw StatusCodeException(STATUS_CODE_FAILURE);
 
+        if (shouldDeferPseudoLayer)
+        {
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->DeferPseudoLayer(parameters, pCaloHit));
+            inputIter->second->push_back(pCaloHit);
+            return STATUS_CODE_SUCCESS;
+        }
+
         // ATTN No longer require presence of pseudo layer plugin, accepting use of a single dummy value for all hits
         const unsigned int pseudoLayer(m_pPandora->GetPlugins()->HasPseudoLayerPlugin() ?
             m_pPandora->GetPlugins()->GetPseudoLayerPlugin()->GetPseudoLayer(pCaloHit->GetPositionVector()) : 0);
@@ -75,6 +89,159 @@ StatusCode CaloHitManager::Create(const object_creation::CaloHit::Parameters &pa
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+StatusCode CaloHitManager::DeferPseudoLayer(const object_creation::CaloHit::Parameters &parameters, const CaloHit *const pCaloHit)
+{
+    PseudoLayerCache *const pPseudoLayerCache(this->GetPseudoLayerCache());
+
+    if (!pPseudoLayerCache)
+    {
+        m_deferredPseudoLayerCaloHits.push_back(pCaloHit);
+        return STATUS_CODE_SUCCESS;
+    }
+
+    const PseudoLayerCache::CellKey cellKey(parameters);
+    unsigned int pseudoLayer(0);
+
+    if (pPseudoLayerCache->Find(cellKey, pseudoLayer))
+        return this->Modifiable(pCaloHit)->SetPseudoLayer(pseudoLayer);
+
+    m_deferredPseudoLayerCaloHits.push_back(pCaloHit);
+    m_deferredCellKeys.push_back(cellKey);
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+PseudoLayerCache *CaloHitManager::GetPseudoLayerCache()
+{
+    if (!m_pPandora->GetSettings()->ShouldCachePseudoLayers() || !m_pPandora->GetPlugins()->HasPseudoLayerPlugin())
+        return nullptr;
+
+    if (!m_pPseudoLayerCache)
+        m_pPseudoLayerCache = new PseudoLayerCache(m_pPandora->GetSettings()->GetPseudoLayerCacheMaxEntries());
+
+    return m_pPseudoLayerCache;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void CaloHitManager::ClearPseudoLayerCache()
+{
+    if (m_pPseudoLayerCache)
+        m_pPseudoLayerCache->Clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode CaloHitManager::CreateInputList()
+{
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->AssignDeferredPseudoLayers());
+
+    return InputObjectManager<CaloHit>::CreateInputList();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode CaloHitManager::AssignDeferredPseudoLayers()
+{
+    if (m_deferredPseudoLayerCaloHits.empty())
+        return STATUS_CODE_SUCCESS;
+
+    CaloHitVector caloHitVector;
+    caloHitVector.swap(m_deferredPseudoLayerCaloHits);
+
+    PseudoLayerCache::CellKeyVector cellKeyVector;
+    cellKeyVector.swap(m_deferredCellKeys);
+
+    // ATTN No longer require presence of pseudo layer plugin, accepting use of a single dummy value for all hits
+    const unsigned int nCaloHits(caloHitVector.size());
+    UIntVector pseudoLayers(nCaloHits, 0);
+    std::vector<StatusCode> statusCodes(nCaloHits, STATUS_CODE_SUCCESS);
+
+    if (m_pPandora->GetPlugins()->HasPseudoLayerPlugin())
+    {
+        const PseudoLayerPlugin *const pPseudoLayerPlugin(m_pPandora->GetPlugins()->GetPseudoLayerPlugin());
+        const unsigned int nThreads(pPseudoLayerPlugin->IsThreadSafe() ? m_pPandora->GetSettings()->GetNumberOfThreads() : 1);
+
+        CartesianPointVector positionVectors;
+        positionVectors.reserve(nCaloHits);
+
+        for (const CaloHit *const pCaloHit : caloHitVector)
+            positionVectors.push_back(pCaloHit->GetPositionVector());
+
+        ParallelHelper::ForEachBlock(nCaloHits, nThreads,
+            [pPseudoLayerPlugin, &positionVectors, &pseudoLayers, &statusCodes](const size_t, const size_t begin, const size_t end)
+            {
+                try
+                {
+                    pPseudoLayerPlugin->GetPseudoLayers(&positionVectors[begin], end - begin, &pseudoLayers[begin]);
+                    return;
+                }
+                catch (StatusCodeException &)
+                {
+                }
+
+                // ATTN If the block fails, its positions are retried one at a time, so that only the failing calo hits are rejected
+                for (size_t index = begin; index < end; ++index)
+                {
+                    try
+                    {
+                        pseudoLayers[index] = pPseudoLayerPlugin->GetPseudoLayer(positionVectors[index]);
+                    }
+                    catch (StatusCodeException &statusCodeException)
+                    {
+                        statusCodes[index] = statusCodeException.GetStatusCode();
+                    }
+                }
+            });
+    }
+
+    CaloHitSet rejectedCaloHits;
+
+    for (unsigned int iCaloHit = 0; iCaloHit < nCaloHits; ++iCaloHit)
+    {
+        const CaloHit *const pCaloHit(caloHitVector[iCaloHit]);
+
+        if (STATUS_CODE_SUCCESS == statusCodes[iCaloHit])
+            statusCodes[iCaloHit] = this->Modifiable(pCaloHit)->SetPseudoLayer(pseudoLayers[iCaloHit]);
+
+        if (STATUS_CODE_SUCCESS != statusCodes[iCaloHit])
+        {
+            std::cout << "Failed to assign calo hit pseudo layer: " << StatusCodeToString(statusCodes[iCaloHit]) << std::endl;
+            rejectedCaloHits.insert(pCaloHit);
+        }
+    }
+
+    // ATTN Cell keys are recorded only whilst pseudo layer caching is enabled, so may not cover all deferred calo hits
+    if (m_pPseudoLayerCache && (cellKeyVector.size() == nCaloHits))
+    {
+        for (unsigned int iCaloHit = 0; iCaloHit < nCaloHits; ++iCaloHit)
+        {
+            if (STATUS_CODE_SUCCESS == statusCodes[iCaloHit])
+                m_pPseudoLayerCache->Insert(cellKeyVector[iCaloHit], pseudoLayers[iCaloHit]);
+        }
+    }
+
+    if (!rejectedCaloHits.empty())
+    {
+        NameToListMap::iterator inputIter = m_nameToListMap.find(m_inputListName);
+
+        if (m_nameToListMap.end() == inputIter)
+            return STATUS_CODE_FAILURE;
+
+        inputIter->second->remove_if([&rejectedCaloHits](const CaloHit *const pCaloHit) {return (rejectedCaloHits.count(pCaloHit) > 0);});
+
+        for (const CaloHit *const pCaloHit : rejectedCaloHits)
+            delete pCaloHit;
+
+        m_nRejectedCaloHits += rejectedCaloHits.size();
+    }
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 StatusCode CaloHitManager::AlterMetadata(const CaloHit *const pCaloHit, const object_creation::CaloHit::Metadata &metadata) const
 {
     return this->Modifiable(pCaloHit)->AlterMetadata(metadata);
@@ -164,6 +331,9 @@ StatusCode CaloHitManager::EraseAllContent()
     m_nReclusteringProcesses = 0;
     m_pCurrentReclusterMetadata = nullptr;
     m_reclusterMetadataList.clear();
+    m_deferredPseudoLayerCaloHits.clear();
+    m_deferredCellKeys.clear();
+    m_nRejectedCaloHits = 0;
 
     return InputObjectManager<CaloHit>::EraseAllContent();
 }
@@ -418,7 +588,7 @@ StatusCode CaloHitManager::Update(const CaloHitMetadata &caloHitMetadata)
 
     CaloHitVector caloHitVector;
     for (const CaloHitUsageMap::value_type &mapEntry : caloHitUsageMap) caloHitVector.push_back(mapEntry.first);
-    std::sort(caloHitVector.begin(), caloHitVector.end(), PointerLessThan<CaloHit>());
+    SortByKey(caloHitVector);
 
     for (const CaloHit *const pCaloHit : caloHitVector)
     {
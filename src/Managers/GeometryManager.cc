@@ -7,6 +7,8 @@
  */
 
 #include "Geometry/DetectorGap.h"
+#include "Geometry/DetectorGapIndex.h"
+#include "Geometry/DetectorVolumeIndex.h"
 #include "Geometry/LArTPC.h"
 #include "Geometry/SubDetector.h"
 
@@ -20,9 +22,13 @@ namespace pandora
 {
 
 GeometryManager::GeometryManager(const Pandora *const pPandora) :
-    m_hitTypeToGranularityMap(this->GetDefaultHitTypeToGranularityMap()),
+    m_isDetectorGapIndexUpToDate(false),
+    m_isDetectorVolumeIndexUpToDate(false),
     m_pPandora(pPandora)
 {
+    m_subDetectorTypeTable.fill(nullptr);
+    m_subDetectorTypeCounts.fill(0);
+    this->ResetHitTypeGranularities();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -46,40 +52,84 @@ const SubDetector &GeometryManager::GetSubDetector(const std::string &subDetecto
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-const SubDetector &GeometryManager::GetSubDetector(const SubDetectorType subDetectorType) const
+const LArTPC &GeometryManager::GetLArTPC() const
 {
-    SubDetectorTypeMap::const_iterator iter = m_subDetectorTypeMap.find(subDetectorType);
+    if (1 != m_larTPCMap.size())
+        throw StatusCodeException(STATUS_CODE_OUT_OF_RANGE);
 
-    if (m_subDetectorTypeMap.end() == iter)
-        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+    return *(m_larTPCMap.begin()->second);
+}
 
-    if (m_subDetectorTypeMap.count(subDetectorType) != 1)
-        throw StatusCodeException(STATUS_CODE_OUT_OF_RANGE);
+//------------------------------------------------------------------------------------------------------------------------------------------
 
-    return *(iter->second);
+const LArTPC *GeometryManager::GetContainingLArTPC(const CartesianVector &positionVector, const float tolerance) const
+{
+    return this->GetDetectorVolumeIndex().GetContainingLArTPC(positionVector, tolerance);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-const LArTPC &GeometryManager::GetLArTPC() const
+void GeometryManager::GetContainingLArTPCBatch(const CartesianPointVector &positionVectors, const float tolerance,
+    LArTPCVector &larTPCVector) const
 {
-    if (1 != m_larTPCMap.size())
-        throw StatusCodeException(STATUS_CODE_OUT_OF_RANGE);
+    const DetectorVolumeIndex &detectorVolumeIndex(this->GetDetectorVolumeIndex());
+    larTPCVector.resize(positionVectors.size());
 
-    return *(m_larTPCMap.begin()->second);
+    for (unsigned int index = 0; index < positionVectors.size(); ++index)
+        larTPCVector[index] = detectorVolumeIndex.GetContainingLArTPC(positionVectors[index], tolerance);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void GeometryManager::GetContainingLArTPCs(const CartesianVector &positionVector, const float tolerance, LArTPCVector &larTPCVector) const
+{
+    this->GetDetectorVolumeIndex().GetContainingLArTPCs(positionVector, tolerance, larTPCVector);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-Granularity GeometryManager::GetHitTypeGranularity(const HitType hitType) const
+const SubDetector *GeometryManager::GetContainingSubDetector(const CartesianVector &positionVector, const float tolerance) const
 {
-    HitTypeToGranularityMap::const_iterator iter = m_hitTypeToGranularityMap.find(hitType);
+    return this->GetDetectorVolumeIndex().GetContainingSubDetector(positionVector, tolerance);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void GeometryManager::GetContainingSubDetectorBatch(const CartesianPointVector &positionVectors, const float tolerance,
+    SubDetectorVector &subDetectorVector) const
+{
+    const DetectorVolumeIndex &detectorVolumeIndex(this->GetDetectorVolumeIndex());
+    subDetectorVector.resize(positionVectors.size());
+
+    for (unsigned int index = 0; index < positionVectors.size(); ++index)
+        subDetectorVector[index] = detectorVolumeIndex.GetContainingSubDetector(positionVectors[index], tolerance);
+}
 
-    if (m_hitTypeToGranularityMap.end() != iter)
-        return iter->second;
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool GeometryManager::IsInGap(const CartesianVector &positionVector, const HitType hitType, const float gapTolerance) const
+{
+    return this->GetDetectorGapIndex().IsInGap(positionVector, hitType, gapTolerance);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void GeometryManager::IsInGap(const CartesianPointVector &positionVectors, const HitType hitType, const float gapTolerance,
+    BoolVector &isInGapVector) const
+{
+    const DetectorGapIndex &detectorGapIndex(this->GetDetectorGapIndex());
+    isInGapVector.resize(positionVectors.size());
 
-    std::cout << "GeometryManager: specified hitType must be registered with a specific granularity. See PandoraApi.h " << std::endl;
-    throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+    for (unsigned int index = 0; index < positionVectors.size(); ++index)
+        isInGapVector[index] = detectorGapIndex.IsInGap(positionVectors[index], hitType, gapTolerance);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void GeometryManager::IsInGap(const FloatVector &xCoordinates, const FloatVector &yCoordinates, const FloatVector &zCoordinates,
+    const HitType hitType, const float gapTolerance, BoolVector &isInGapVector) const
+{
+    this->GetDetectorGapIndex().IsInGap(xCoordinates, yCoordinates, zCoordinates, hitType, gapTolerance, isInGapVector);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -93,10 +143,18 @@ StatusCode GeometryManager::CreateSubDetector(const object_creation::Geometry::S
     {
         PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, factory.Create(parameters, pSubDetector));
 
+        const SubDetectorType subDetectorType(pSubDetector->GetSubDetectorType());
+
+        if (subDetectorType >= N_SUB_DETECTOR_TYPES)
+            throw StatusCodeException(STATUS_CODE_OUT_OF_RANGE);
+
         if (!m_subDetectorMap.insert(SubDetectorMap::value_type(pSubDetector->GetSubDetectorName(), pSubDetector)).second)
             throw StatusCodeException(STATUS_CODE_FAILURE);
 
-        m_subDetectorTypeMap.insert(SubDetectorTypeMap::value_type(pSubDetector->GetSubDetectorType(), pSubDetector));
+        m_subDetectorTypeTable[subDetectorType] = pSubDetector;
+        ++m_subDetectorTypeCounts[subDetectorType];
+
+        m_isDetectorVolumeIndexUpToDate = false;
     }
     catch (StatusCodeException &statusCodeException)
     {
@@ -122,6 +180,8 @@ StatusCode GeometryManager::CreateLArTPC(const object_creation::Geometry::LArTPC
 
         if (!m_larTPCMap.insert(LArTPCMap::value_type(pLArTPC->GetLArTPCVolumeId(), pLArTPC)).second)
             throw StatusCodeException(STATUS_CODE_FAILURE);
+
+        m_isDetectorVolumeIndexUpToDate = false;
     }
     catch (StatusCodeException &statusCodeException)
     {
@@ -149,6 +209,7 @@ StatusCode GeometryManager::CreateGap(const PARAMETERS &parameters, const Object
             return STATUS_CODE_FAILURE;
 
         m_detectorGapList.push_back(pDetectorGap);
+        m_isDetectorGapIndexUpToDate = false;
         return STATUS_CODE_SUCCESS;
     }
     catch (StatusCodeException &statusCodeException)
@@ -162,6 +223,42 @@ StatusCode GeometryManager::CreateGap(const PARAMETERS &parameters, const Object
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+const DetectorGapIndex &GeometryManager::GetDetectorGapIndex() const
+{
+    if (!m_isDetectorGapIndexUpToDate)
+    {
+        std::lock_guard<std::mutex> lock(m_detectorGapIndexMutex);
+
+        if (!m_isDetectorGapIndexUpToDate)
+        {
+            m_pDetectorGapIndex.reset(new DetectorGapIndex(m_detectorGapList));
+            m_isDetectorGapIndexUpToDate = true;
+        }
+    }
+
+    return *m_pDetectorGapIndex;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const DetectorVolumeIndex &GeometryManager::GetDetectorVolumeIndex() const
+{
+    if (!m_isDetectorVolumeIndexUpToDate)
+    {
+        std::lock_guard<std::mutex> lock(m_detectorVolumeIndexMutex);
+
+        if (!m_isDetectorVolumeIndexUpToDate)
+        {
+            m_pDetectorVolumeIndex.reset(new DetectorVolumeIndex(m_larTPCMap, m_subDetectorMap));
+            m_isDetectorVolumeIndexUpToDate = true;
+        }
+    }
+
+    return *m_pDetectorVolumeIndex;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 StatusCode GeometryManager::EraseAllContent()
 {
     for (const SubDetectorMap::value_type &mapEntry : m_subDetectorMap)
@@ -175,48 +272,42 @@ StatusCode GeometryManager::EraseAllContent()
 
     m_subDetectorMap.clear();
     m_larTPCMap.clear();
-    m_subDetectorTypeMap.clear();
+    m_subDetectorTypeTable.fill(nullptr);
+    m_subDetectorTypeCounts.fill(0);
     m_detectorGapList.clear();
-    m_hitTypeToGranularityMap.clear();
+    m_isGranularityRegistered.fill(false);
+
+    m_pDetectorGapIndex.reset();
+    m_isDetectorGapIndexUpToDate = false;
+    m_pDetectorVolumeIndex.reset();
+    m_isDetectorVolumeIndexUpToDate = false;
 
     return STATUS_CODE_SUCCESS;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-GeometryManager::HitTypeToGranularityMap GeometryManager::GetDefaultHitTypeToGranularityMap() const
+void GeometryManager::ResetHitTypeGranularities()
 {
-    HitTypeToGranularityMap hitTypeToGranularityMap;
+    m_granularityTable.fill(VERY_FINE);
+    m_isGranularityRegistered.fill(false);
 
-    if (!hitTypeToGranularityMap.insert(HitTypeToGranularityMap::value_type(TRACKER, VERY_FINE)).second ||
-        !hitTypeToGranularityMap.insert(HitTypeToGranularityMap::value_type(ECAL, FINE)).second ||
-        !hitTypeToGranularityMap.insert(HitTypeToGranularityMap::value_type(HCAL, COARSE)).second ||
-        !hitTypeToGranularityMap.insert(HitTypeToGranularityMap::value_type(MUON, VERY_COARSE)).second ||
-        !hitTypeToGranularityMap.insert(HitTypeToGranularityMap::value_type(TPC_VIEW_U, VERY_FINE)).second ||
-        !hitTypeToGranularityMap.insert(HitTypeToGranularityMap::value_type(TPC_VIEW_V, VERY_FINE)).second ||
-        !hitTypeToGranularityMap.insert(HitTypeToGranularityMap::value_type(TPC_VIEW_W, VERY_FINE)).second ||
-        !hitTypeToGranularityMap.insert(HitTypeToGranularityMap::value_type(TPC_3D, VERY_FINE)).second)
+    for (unsigned int hitType = 0; hitType < DEFAULT_HIT_TYPE_GRANULARITIES.size(); ++hitType)
     {
-        throw StatusCodeException(STATUS_CODE_FAILURE);
+        m_granularityTable[hitType] = DEFAULT_HIT_TYPE_GRANULARITIES[hitType];
+        m_isGranularityRegistered[hitType] = true;
     }
-
-    return hitTypeToGranularityMap;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 StatusCode GeometryManager::SetHitTypeGranularity(const HitType hitType, const Granularity granularity)
 {
-    HitTypeToGranularityMap::iterator iter = m_hitTypeToGranularityMap.find(hitType);
+    if (hitType >= N_HIT_TYPES)
+        return STATUS_CODE_OUT_OF_RANGE;
 
-    if (m_hitTypeToGranularityMap.end() != iter)
-    {
-        iter->second = granularity;
-    }
-    else
-    {
-        m_hitTypeToGranularityMap[hitType] = granularity;
-    }
+    m_granularityTable[hitType] = granularity;
+    m_isGranularityRegistered[hitType] = true;
 
     return STATUS_CODE_SUCCESS;
 }
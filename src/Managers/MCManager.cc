@@ -6,6 +6,8 @@
  *  $Log: $
  */
 
+#include "Helpers/ParallelHelper.h"
+
 #include "Managers/MCManager.h"
 
 #include "Objects/MCParticle.h"
@@ -17,6 +19,7 @@
 #include "Pandora/PdgTable.h"
 
 #include <algorithm>
+#include <limits>
 
 namespace pandora
 {
@@ -74,6 +77,7 @@ StatusCode MCManager::EraseAllContent()
     m_parentDaughterRelationMap.clear();
     m_caloHitToMCParticleMap.clear();
     m_trackToMCParticleMap.clear();
+    this->ClearMCParticleTree();
 
     return InputObjectManager<MCParticle>::EraseAllContent();
 }
@@ -91,17 +95,27 @@ StatusCode MCManager::SetMCParentDaughterRelationship(const Uid parentUid, const
 
 StatusCode MCManager::IdentifyPfoTargets()
 {
-    NameToListMap::const_iterator inputIter = m_nameToListMap.find(m_inputListName);
+    // ATTN Pfo target assignment never crosses between connected components of the mc hierarchy, so components are processed in
+    // parallel, whilst root particles within a component are processed serially, in input list order, to preserve the outcome
+    std::vector<UIntVector> rootIndicesPerComponent;
+    this->GetRootIndicesPerComponent(rootIndicesPerComponent);
 
-    if (m_nameToListMap.end() == inputIter)
-        return STATUS_CODE_FAILURE;
+    UIntVector selectionStamps(m_treeMCParticleVector.size(), 0);
 
-    for (const MCParticle *const pMCParticle : *inputIter->second)
+    try
     {
-        MCParticleSet mcPfoSet;
-
-        if (pMCParticle->IsRootParticle())
-            PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->ApplyPfoSelectionRules(pMCParticle, mcPfoSet));
+        ParallelHelper::ForEachIndex(rootIndicesPerComponent.size(), m_pPandora->GetSettings()->GetNumberOfThreads(),
+            [this, &rootIndicesPerComponent, &selectionStamps](const size_t componentIndex)
+            {
+                UIntVector indexStack;
+
+                for (const unsigned int rootIndex : rootIndicesPerComponent[componentIndex])
+                    this->ApplyPfoSelectionRules(rootIndex, selectionStamps, indexStack);
+            });
+    }
+    catch (StatusCodeException &statusCodeException)
+    {
+        return statusCodeException.GetStatusCode();
     }
 
     return STATUS_CODE_SUCCESS;
@@ -131,6 +145,9 @@ StatusCode MCManager::SelectPfoTargets()
 
     MCParticleList selectedMCPfoList;
 
+    if (shouldCollapseMCParticlesToPfoTarget)
+        this->ClearMCParticleTree();
+
     for (const MCParticle *const pMCParticle : *inputIter->second)
     {
         const bool isPfoTarget(pMCParticle->IsPfoTarget());
@@ -155,7 +172,36 @@ StatusCode MCManager::SelectPfoTargets()
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-StatusCode MCManager::ApplyPfoSelectionRules(const MCParticle *const pMCParticle, MCParticleSet &mcPfoSet) const
+void MCManager::ApplyPfoSelectionRules(const unsigned int rootIndex, UIntVector &selectionStamps, UIntVector &indexStack) const
+{
+    const unsigned int rootStamp(rootIndex + 1);
+    UIntVector traversalStack(1, rootIndex);
+
+    while (!traversalStack.empty())
+    {
+        const unsigned int index(traversalStack.back());
+        traversalStack.pop_back();
+
+        const MCParticle *const pMCParticle(m_treeMCParticleVector[index]);
+
+        // ATTN: Don't take particles from previously used decay chains; could happen because mc particles can have multiple parents.
+        if ((selectionStamps[index] != rootStamp) && this->PassesPfoSelectionCuts(pMCParticle))
+        {
+            this->SetPfoTargetInTree(index, pMCParticle, true, indexStack);
+            selectionStamps[index] = rootStamp;
+        }
+        else
+        {
+            // ATTN Daughters pushed in reverse order, to be visited in list order
+            for (unsigned int iDaughter = m_treeDaughterOffsets[index + 1]; iDaughter > m_treeDaughterOffsets[index]; --iDaughter)
+                traversalStack.push_back(m_treeDaughterIndices[iDaughter - 1]);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool MCManager::PassesPfoSelectionCuts(const MCParticle *const pMCParticle) const
 {
     const float selectionRadius(m_pPandora->GetSettings()->GetMCPfoSelectionRadius());
     const float selectionMomentum(m_pPandora->GetSettings()->GetMCPfoSelectionMomentum());
@@ -163,22 +209,67 @@ StatusCode MCManager::ApplyPfoSelectionRules(const MCParticle *const pMCParticle
 
     const int particleId(pMCParticle->GetParticleId());
 
-    // ATTN: Don't take particles from previously used decay chains; could happen because mc particles can have multiple parents.
-    if (!mcPfoSet.count(pMCParticle) &&
-        (pMCParticle->GetOuterRadius() > selectionRadius) &&
+    return ((pMCParticle->GetOuterRadius() > selectionRadius) &&
         (pMCParticle->GetInnerRadius() <= selectionRadius) &&
         (pMCParticle->GetMomentum().GetMagnitude() > selectionMomentum) &&
-        !((particleId == PROTON || particleId == NEUTRON) && (pMCParticle->GetEnergy() < selectionEnergyCutOffProtonsNeutrons)))
+        !((particleId == PROTON || particleId == NEUTRON) && (pMCParticle->GetEnergy() < selectionEnergyCutOffProtonsNeutrons)));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void MCManager::SetPfoTargetInTree(const unsigned int index, const MCParticle *const pPfoTarget, const bool onlyDaughters, UIntVector &indexStack) const
+{
+    indexStack.clear();
+
+    if (!onlyDaughters)
     {
-        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->SetPfoTargetInTree(pMCParticle, pMCParticle, true));
-        mcPfoSet.insert(pMCParticle);
+        indexStack.push_back(index);
     }
-    else
+    else if (!m_treeMCParticleVector[index]->IsPfoTargetSet())
     {
-        for (const MCParticle *const pDaughterMCParticle : pMCParticle->GetDaughterList())
-        {
-            PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->ApplyPfoSelectionRules(pDaughterMCParticle, mcPfoSet));
-        }
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->Modifiable(m_treeMCParticleVector[index])->SetPfoTarget(pPfoTarget));
+        indexStack.insert(indexStack.end(), m_treeDaughterIndices.begin() + m_treeDaughterOffsets[index],
+            m_treeDaughterIndices.begin() + m_treeDaughterOffsets[index + 1]);
+    }
+
+    while (!indexStack.empty())
+    {
+        const unsigned int currentIndex(indexStack.back());
+        indexStack.pop_back();
+
+        const MCParticle *const pMCParticle(m_treeMCParticleVector[currentIndex]);
+
+        if (pMCParticle->IsPfoTargetSet())
+            continue;
+
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->Modifiable(pMCParticle)->SetPfoTarget(pPfoTarget));
+
+        indexStack.insert(indexStack.end(), m_treeParentIndices.begin() + m_treeParentOffsets[currentIndex],
+            m_treeParentIndices.begin() + m_treeParentOffsets[currentIndex + 1]);
+        indexStack.insert(indexStack.end(), m_treeDaughterIndices.begin() + m_treeDaughterOffsets[currentIndex],
+            m_treeDaughterIndices.begin() + m_treeDaughterOffsets[currentIndex + 1]);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode MCManager::AddMCParticleRelationships()
+{
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->BuildMCParticleTree());
+
+    for (unsigned int index = 0; index < m_treeMCParticleVector.size(); ++index)
+    {
+        MCParticle *const pMCParticle(this->Modifiable(m_treeMCParticleVector[index]));
+
+        if (!pMCParticle->m_daughterList.empty() || !pMCParticle->m_parentList.empty())
+            return STATUS_CODE_ALREADY_INITIALIZED;
+
+        // ATTN Tree ranges are free from duplicates, so the mc particle lists can be filled without per-entry searches
+        for (unsigned int iDaughter = m_treeDaughterOffsets[index]; iDaughter < m_treeDaughterOffsets[index + 1]; ++iDaughter)
+            pMCParticle->m_daughterList.push_back(m_treeMCParticleVector[m_treeDaughterIndices[iDaughter]]);
+
+        for (unsigned int iParent = m_treeParentOffsets[index]; iParent < m_treeParentOffsets[index + 1]; ++iParent)
+            pMCParticle->m_parentList.push_back(m_treeMCParticleVector[m_treeParentIndices[iParent]]);
     }
 
     return STATUS_CODE_SUCCESS;
@@ -186,24 +277,73 @@ StatusCode MCManager::ApplyPfoSelectionRules(const MCParticle *const pMCParticle
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-StatusCode MCManager::SetPfoTargetInTree(const MCParticle *const pMCParticle, const MCParticle *const pPfoTarget, bool onlyDaughters) const
+StatusCode MCManager::BuildMCParticleTree()
 {
-    if (pMCParticle->IsPfoTargetSet())
-        return STATUS_CODE_SUCCESS;
+    this->ClearMCParticleTree();
 
-    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->Modifiable(pMCParticle)->SetPfoTarget(pPfoTarget));
+    const MCParticleList *pInputList(nullptr);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->GetList(m_inputListName, pInputList));
+
+    m_treeMCParticleVector.assign(pInputList->begin(), pInputList->end());
+    const unsigned int nMCParticles(m_treeMCParticleVector.size());
+
+    std::unordered_map<Uid, unsigned int> uidToIndexMap;
 
-    for (const MCParticle *const pDaughterMCParticle : pMCParticle->GetDaughterList())
+    for (unsigned int index = 0; index < nMCParticles; ++index)
+        uidToIndexMap.insert(std::unordered_map<Uid, unsigned int>::value_type(m_treeMCParticleVector[index]->GetUid(), index));
+
+    // Daughter ranges, in input list order of parents, with daughters ordered by sort key and then by input list order
+    const auto sortKeyLess([this](const unsigned int lhs, const unsigned int rhs) -> bool
     {
-       PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->SetPfoTargetInTree(pDaughterMCParticle, pPfoTarget));
-    }
+        const MCParticle *const pLhs(m_treeMCParticleVector[lhs]), *const pRhs(m_treeMCParticleVector[rhs]);
 
-    if (!onlyDaughters)
+        if (pLhs->GetSortKey() == pRhs->GetSortKey())
+            return (lhs < rhs);
+
+        return (pLhs->GetSortKey() < pRhs->GetSortKey());
+    });
+
+    UIntVector nParents(nMCParticles, 0);
+    m_treeDaughterOffsets.reserve(nMCParticles + 1);
+    m_treeDaughterIndices.reserve(m_parentDaughterRelationMap.size());
+
+    for (unsigned int index = 0; index < nMCParticles; ++index)
     {
-        for (const MCParticle *const pParentMCParticle : pMCParticle->GetParentList())
+        m_treeDaughterOffsets.push_back(m_treeDaughterIndices.size());
+        const auto range(m_parentDaughterRelationMap.equal_range(m_treeMCParticleVector[index]->GetUid()));
+
+        for (MCParticleRelationMap::const_iterator relIter = range.first; relIter != range.second; ++relIter)
         {
-            PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->SetPfoTargetInTree(pParentMCParticle, pPfoTarget));
+            const auto daughterIter(uidToIndexMap.find(relIter->second));
+
+            if (uidToIndexMap.end() != daughterIter)
+                m_treeDaughterIndices.push_back(daughterIter->second);
         }
+
+        const UIntVector::iterator rangeBegin(m_treeDaughterIndices.begin() + m_treeDaughterOffsets.back());
+        std::sort(rangeBegin, m_treeDaughterIndices.end());
+        m_treeDaughterIndices.erase(std::unique(rangeBegin, m_treeDaughterIndices.end()), m_treeDaughterIndices.end());
+        std::sort(rangeBegin, m_treeDaughterIndices.end(), sortKeyLess);
+
+        for (UIntVector::const_iterator iter = rangeBegin; iter != m_treeDaughterIndices.end(); ++iter)
+            ++nParents[*iter];
+    }
+
+    m_treeDaughterOffsets.push_back(m_treeDaughterIndices.size());
+
+    // Parent ranges, with parents in input list order
+    m_treeParentOffsets.assign(nMCParticles + 1, 0);
+
+    for (unsigned int index = 0; index < nMCParticles; ++index)
+        m_treeParentOffsets[index + 1] = m_treeParentOffsets[index] + nParents[index];
+
+    UIntVector fillPositions(m_treeParentOffsets.begin(), m_treeParentOffsets.end() - 1);
+    m_treeParentIndices.resize(m_treeDaughterIndices.size());
+
+    for (unsigned int index = 0; index < nMCParticles; ++index)
+    {
+        for (unsigned int iDaughter = m_treeDaughterOffsets[index]; iDaughter < m_treeDaughterOffsets[index + 1]; ++iDaughter)
+            m_treeParentIndices[fillPositions[m_treeDaughterIndices[iDaughter]]++] = index;
     }
 
     return STATUS_CODE_SUCCESS;
@@ -211,42 +351,66 @@ StatusCode MCManager::SetPfoTargetInTree(const MCParticle *const pMCParticle, co
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-StatusCode MCManager::AddMCParticleRelationships() const
+void MCManager::GetRootIndicesPerComponent(std::vector<UIntVector> &rootIndicesPerComponent) const
 {
-    if (m_parentDaughterRelationMap.empty())
-        return STATUS_CODE_SUCCESS;
+    const unsigned int nMCParticles(m_treeMCParticleVector.size());
 
-    const MCParticleList *pInputList(nullptr);
-    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->GetList(m_inputListName, pInputList));
+    // Union-find, with path halving, over the parent-daughter links
+    UIntVector representatives(nMCParticles);
 
-    for (const MCParticle *const pParentMCParticle : *pInputList)
+    for (unsigned int index = 0; index < nMCParticles; ++index)
+        representatives[index] = index;
+
+    const auto findRepresentative([&representatives](unsigned int index) -> unsigned int
     {
-        const auto range(m_parentDaughterRelationMap.equal_range(pParentMCParticle->GetUid()));
+        while (representatives[index] != index)
+        {
+            representatives[index] = representatives[representatives[index]];
+            index = representatives[index];
+        }
 
-        MCParticleList daughterList;
-        for (MCParticleRelationMap::const_iterator relIter = range.first; relIter != range.second; ++relIter)
+        return index;
+    });
+
+    for (unsigned int index = 0; index < nMCParticles; ++index)
+    {
+        for (unsigned int iDaughter = m_treeDaughterOffsets[index]; iDaughter < m_treeDaughterOffsets[index + 1]; ++iDaughter)
         {
-            UidToMCParticleMap::const_iterator daughterIter = m_uidToMCParticleMap.find(relIter->second);
+            const unsigned int parentRep(findRepresentative(index)), daughterRep(findRepresentative(m_treeDaughterIndices[iDaughter]));
 
-            if ((m_uidToMCParticleMap.end() != daughterIter) && (daughterList.end() == std::find(daughterList.begin(), daughterList.end(), daughterIter->second)))
-                daughterList.push_back(daughterIter->second);
+            if (parentRep != daughterRep)
+                representatives[std::max(parentRep, daughterRep)] = std::min(parentRep, daughterRep);
         }
-        daughterList.sort(PointerLessThan<MCParticle>());
+    }
 
-        for (const MCParticle *const pDaughterMCParticle : daughterList)
-        {
-            const StatusCode firstStatusCode(this->Modifiable(pParentMCParticle)->AddDaughter(pDaughterMCParticle));
-            const StatusCode secondStatusCode(this->Modifiable(pDaughterMCParticle)->AddParent(pParentMCParticle));
+    UIntVector componentIndices(nMCParticles, std::numeric_limits<unsigned int>::max());
+
+    for (unsigned int index = 0; index < nMCParticles; ++index)
+    {
+        if (m_treeParentOffsets[index] != m_treeParentOffsets[index + 1])
+            continue;
 
-            if (firstStatusCode != secondStatusCode)
-                return STATUS_CODE_FAILURE;
+        unsigned int &componentIndex(componentIndices[findRepresentative(index)]);
 
-            if ((firstStatusCode != STATUS_CODE_SUCCESS) && (firstStatusCode != STATUS_CODE_ALREADY_PRESENT))
-                return firstStatusCode;
+        if (std::numeric_limits<unsigned int>::max() == componentIndex)
+        {
+            componentIndex = rootIndicesPerComponent.size();
+            rootIndicesPerComponent.push_back(UIntVector());
         }
+
+        rootIndicesPerComponent[componentIndex].push_back(index);
     }
+}
 
-    return STATUS_CODE_SUCCESS;
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void MCManager::ClearMCParticleTree()
+{
+    m_treeMCParticleVector.clear();
+    m_treeDaughterOffsets.clear();
+    m_treeDaughterIndices.clear();
+    m_treeParentOffsets.clear();
+    m_treeParentIndices.clear();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -265,6 +429,7 @@ StatusCode MCManager::RemoveAllMCParticleRelationships()
     m_parentDaughterRelationMap.clear();
     m_caloHitToMCParticleMap.clear();
     m_trackToMCParticleMap.clear();
+    this->ClearMCParticleTree();
 
     return STATUS_CODE_SUCCESS;
 }
@@ -351,7 +516,7 @@ StatusCode MCManager::CreateUidToPfoTargetsMap(UidToMCParticleWeightMap &uidToMC
             continue;
 
         MCParticleList mcParticleList(mcParticleSet.begin(), mcParticleSet.end());
-        mcParticleList.sort(PointerLessThan<MCParticle>());
+        SortByKey(mcParticleList);
         MCParticleWeightMap &mcParticleWeightMap(uidToMCParticleWeightMap[relationEntry.first]);
 
         for (const MCParticle *const pMCParticle : mcParticleList)
@@ -112,7 +112,7 @@ StatusCode CaloHitMetadata::Update(const CaloHitMetadata &caloHitMetadata)
 
     CaloHitVector caloHitVector;
     for (const CaloHitUsageMap::value_type &mapEntry : caloHitUsageMap) caloHitVector.push_back(mapEntry.first);
-    std::sort(caloHitVector.begin(), caloHitVector.end(), PointerLessThan<CaloHit>());
+    SortByKey(caloHitVector);
 
     for (const CaloHit *const pCaloHit : caloHitVector)
     {
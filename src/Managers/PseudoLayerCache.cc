@@ -0,0 +1,89 @@
+/**
+ *  @file   PandoraSDK/src/Managers/PseudoLayerCache.cc
+ * 
+ *  @brief  Implementation of the pseudo layer cache class.
+ * 
+ *  $Log: $
+ */
+
+#include "Managers/PseudoLayerCache.h"
+
+#include <cstring>
+
+namespace pandora
+{
+
+PseudoLayerCache::CellKey::CellKey(const object_creation::CaloHit::Parameters &parameters)
+{
+    // ATTN The hit type is stored with a flag distinguishing user-supplied cell ids from layer and position bit patterns
+    const bool hasCellId(parameters.m_cellId.IsInitialized());
+    m_words[0] = (static_cast<std::uint32_t>(parameters.m_hitType.Get()) << 1) | (hasCellId ? 1 : 0);
+
+    if (hasCellId)
+    {
+        const std::uint64_t cellId(parameters.m_cellId.Get());
+        m_words[1] = static_cast<std::uint32_t>(cellId >> 32);
+        m_words[2] = static_cast<std::uint32_t>(cellId);
+        m_words[3] = 0;
+        m_words[4] = 0;
+    }
+    else
+    {
+        const CartesianVector &positionVector(parameters.m_positionVector.Get());
+        const float x(positionVector.GetX()), y(positionVector.GetY()), z(positionVector.GetZ());
+        m_words[1] = parameters.m_layer.Get();
+        std::memcpy(&m_words[2], &x, sizeof(std::uint32_t));
+        std::memcpy(&m_words[3], &y, sizeof(std::uint32_t));
+        std::memcpy(&m_words[4], &z, sizeof(std::uint32_t));
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+PseudoLayerCache::PseudoLayerCache(const unsigned int maxNEntries) :
+    m_maxNEntries(maxNEntries),
+    m_nCacheHits(0),
+    m_nCacheMisses(0),
+    m_nFlushes(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool PseudoLayerCache::Find(const CellKey &cellKey, unsigned int &pseudoLayer)
+{
+    CellKeyToPseudoLayerMap::const_iterator iter(m_cellKeyToPseudoLayerMap.find(cellKey));
+
+    if (m_cellKeyToPseudoLayerMap.end() == iter)
+    {
+        ++m_nCacheMisses;
+        return false;
+    }
+
+    ++m_nCacheHits;
+    pseudoLayer = iter->second;
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void PseudoLayerCache::Insert(const CellKey &cellKey, const unsigned int pseudoLayer)
+{
+    if ((m_cellKeyToPseudoLayerMap.size() >= m_maxNEntries) && !m_cellKeyToPseudoLayerMap.count(cellKey))
+    {
+        m_cellKeyToPseudoLayerMap.clear();
+        ++m_nFlushes;
+    }
+
+    m_cellKeyToPseudoLayerMap[cellKey] = pseudoLayer;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void PseudoLayerCache::Clear()
+{
+    m_cellKeyToPseudoLayerMap.clear();
+}
+
+} // namespace pandora
@@ -11,6 +11,7 @@
 #include "Objects/Track.h"
 
 #include "Pandora/ObjectFactory.h"
+#include "Pandora/Pandora.h"
 #include "Pandora/PandoraInternal.h"
 
 #include <algorithm>
@@ -50,6 +51,7 @@ StatusCode TrackManager::Create(const object_creation::Track::Parameters &parame
         if (!m_uidToTrackMap.insert(UidToTrackMap::value_type(pTrack->GetParentAddress(), pTrack)).second)
             throw StatusCodeException(STATUS_CODE_ALREADY_PRESENT);
 
+        this->Modifiable(pTrack)->SetPluginManager(m_pPandora->GetPlugins());
         inputIter->second->push_back(pTrack);
         return STATUS_CODE_SUCCESS;
     }
@@ -9,10 +9,15 @@
 #include "Objects/CaloHit.h"
 
 #include <cmath>
+#include <limits>
 
 namespace pandora
 {
 
+const unsigned int CaloHit::UNSET_PSEUDO_LAYER(std::numeric_limits<unsigned int>::max());
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 void CaloHit::GetCellCorners(CartesianPointVector &cartesianPointVector) const
 {
     if (RECTANGULAR == this->GetCellGeometry())
@@ -31,51 +36,22 @@ void CaloHit::GetCellCorners(CartesianPointVector &cartesianPointVector) const
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-bool CaloHit::operator< (const CaloHit &rhs) const
-{
-    const CartesianVector deltaPosition(rhs.GetPositionVector() - this->GetPositionVector());
-
-    if (std::fabs(deltaPosition.GetZ()) > std::numeric_limits<float>::epsilon())
-        return (deltaPosition.GetZ() > std::numeric_limits<float>::epsilon());
-
-    if (std::fabs(deltaPosition.GetX()) > std::numeric_limits<float>::epsilon())
-        return (deltaPosition.GetX() > std::numeric_limits<float>::epsilon());
-
-    if (std::fabs(deltaPosition.GetY()) > std::numeric_limits<float>::epsilon())
-        return (deltaPosition.GetY() > std::numeric_limits<float>::epsilon());
-
-    return (this->GetInputEnergy() > rhs.GetInputEnergy());
-}
-
-//------------------------------------------------------------------------------------------------------------------------------------------
-
 CaloHit::CaloHit(const object_creation::CaloHit::Parameters &parameters) :
     m_positionVector(parameters.m_positionVector.Get()),
-    m_x0(0.f),
-    m_expectedDirection(parameters.m_expectedDirection.Get().GetUnitVector()),
-    m_cellNormalVector(parameters.m_cellNormalVector.Get().GetUnitVector()),
-    m_cellGeometry(parameters.m_cellGeometry.Get()),
-    m_cellSize0(parameters.m_cellSize0.Get()),
-    m_cellSize1(parameters.m_cellSize1.Get()),
-    m_cellThickness(parameters.m_cellThickness.Get()),
-    m_nCellRadiationLengths(parameters.m_nCellRadiationLengths.Get()),
-    m_nCellInteractionLengths(parameters.m_nCellInteractionLengths.Get()),
-    m_time(parameters.m_time.Get()),
     m_inputEnergy(parameters.m_inputEnergy.Get()),
     m_mipEquivalentEnergy(parameters.m_mipEquivalentEnergy.Get()),
     m_electromagneticEnergy(parameters.m_electromagneticEnergy.Get()),
     m_hadronicEnergy(parameters.m_hadronicEnergy.Get()),
-    m_isDigital(parameters.m_isDigital.Get()),
-    m_hitType(parameters.m_hitType.Get()),
-    m_hitRegion(parameters.m_hitRegion.Get()),
-    m_layer(parameters.m_layer.Get()),
-    m_isInOuterSamplingLayer(parameters.m_isInOuterSamplingLayer.Get()),
+    m_weight(1.f),
     m_cellLengthScale(0.f),
+    m_pseudoLayer(UNSET_PSEUDO_LAYER),
+    m_hitType(parameters.m_hitType.Get()),
+    m_isDigital(parameters.m_isDigital.Get()),
     m_isPossibleMip(false),
     m_isIsolated(false),
     m_isAvailable(true),
-    m_weight(1.f),
-    m_pParentAddress(parameters.m_pParentAddress.Get())
+    m_sortKey(m_positionVector.GetX(), m_positionVector.GetY(), m_positionVector.GetZ(), m_inputEnergy),
+    m_pColdData(new ColdData(parameters))
 {
     m_cellLengthScale = this->CalculateCellLengthScale();
 }
@@ -84,35 +60,22 @@ CaloHit::CaloHit(const object_creation::CaloHit::Parameters &parameters) :
 
 CaloHit::CaloHit(const object_creation::CaloHitFragment::Parameters &parameters) :
     m_positionVector(parameters.m_pOriginalCaloHit->m_positionVector),
-    m_x0(parameters.m_pOriginalCaloHit->m_x0),
-    m_expectedDirection(parameters.m_pOriginalCaloHit->m_expectedDirection),
-    m_cellNormalVector(parameters.m_pOriginalCaloHit->m_cellNormalVector),
-    m_cellGeometry(parameters.m_pOriginalCaloHit->m_cellGeometry),
-    m_cellSize0(parameters.m_pOriginalCaloHit->m_cellSize0),
-    m_cellSize1(parameters.m_pOriginalCaloHit->m_cellSize1),
-    m_cellThickness(parameters.m_pOriginalCaloHit->m_cellThickness),
-    m_nCellRadiationLengths(parameters.m_pOriginalCaloHit->m_nCellRadiationLengths),
-    m_nCellInteractionLengths(parameters.m_pOriginalCaloHit->m_nCellInteractionLengths),
-    m_time(parameters.m_pOriginalCaloHit->m_time),
     m_inputEnergy(parameters.m_weight.Get() * parameters.m_pOriginalCaloHit->m_inputEnergy),
     m_mipEquivalentEnergy(parameters.m_weight.Get() * parameters.m_pOriginalCaloHit->m_mipEquivalentEnergy),
     m_electromagneticEnergy(parameters.m_weight.Get() * parameters.m_pOriginalCaloHit->m_electromagneticEnergy),
     m_hadronicEnergy(parameters.m_weight.Get() * parameters.m_pOriginalCaloHit->m_hadronicEnergy),
-    m_isDigital(parameters.m_pOriginalCaloHit->m_isDigital),
-    m_hitType(parameters.m_pOriginalCaloHit->m_hitType),
-    m_hitRegion(parameters.m_pOriginalCaloHit->m_hitRegion),
-    m_layer(parameters.m_pOriginalCaloHit->m_layer),
-    m_pseudoLayer(parameters.m_pOriginalCaloHit->m_pseudoLayer),
-    m_isInOuterSamplingLayer(parameters.m_pOriginalCaloHit->m_isInOuterSamplingLayer),
+    m_weight(parameters.m_weight.Get() * parameters.m_pOriginalCaloHit->m_weight),
     m_cellLengthScale(parameters.m_pOriginalCaloHit->m_cellLengthScale),
+    m_pseudoLayer(parameters.m_pOriginalCaloHit->m_pseudoLayer),
+    m_hitType(parameters.m_pOriginalCaloHit->m_hitType),
+    m_isDigital(parameters.m_pOriginalCaloHit->m_isDigital),
     m_isPossibleMip(parameters.m_pOriginalCaloHit->m_isPossibleMip),
     m_isIsolated(parameters.m_pOriginalCaloHit->m_isIsolated),
     m_isAvailable(parameters.m_pOriginalCaloHit->m_isAvailable),
-    m_weight(parameters.m_weight.Get() * parameters.m_pOriginalCaloHit->m_weight),
-    m_mcParticleWeightMap(parameters.m_pOriginalCaloHit->m_mcParticleWeightMap),
-    m_pParentAddress(parameters.m_pOriginalCaloHit->m_pParentAddress)
+    m_sortKey(m_positionVector.GetX(), m_positionVector.GetY(), m_positionVector.GetZ(), m_inputEnergy),
+    m_pColdData(new ColdData(*parameters.m_pOriginalCaloHit->m_pColdData))
 {
-    for (MCParticleWeightMap::value_type &mapEntry : m_mcParticleWeightMap)
+    for (MCParticleWeightMap::value_type &mapEntry : m_pColdData->m_mcParticleWeightMap)
         mapEntry.second = mapEntry.second * parameters.m_weight.Get();
 }
 
@@ -128,9 +91,10 @@ StatusCode CaloHit::AlterMetadata(const object_creation::CaloHit::Metadata &meta
 {
     if (metadata.m_x0.IsInitialized())
     {
-        const float oldX0(m_x0);
-        m_x0 = metadata.m_x0.Get();
-        m_positionVector += CartesianVector(m_x0 - oldX0, 0.f, 0.f);
+        const float oldX0(m_pColdData->m_x0);
+        m_pColdData->m_x0 = metadata.m_x0.Get();
+        m_positionVector += CartesianVector(m_pColdData->m_x0 - oldX0, 0.f, 0.f);
+        m_sortKey = SortKey(m_positionVector.GetX(), m_positionVector.GetY(), m_positionVector.GetZ(), m_inputEnergy);
     }
 
     if (metadata.m_isPossibleMip.IsInitialized())
@@ -146,10 +110,10 @@ StatusCode CaloHit::AlterMetadata(const object_creation::CaloHit::Metadata &meta
 
 StatusCode CaloHit::SetPseudoLayer(const unsigned int pseudoLayer)
 {
-    m_pseudoLayer = pseudoLayer;
-    if (!m_pseudoLayer.IsInitialized())
+    if (UNSET_PSEUDO_LAYER == pseudoLayer)
         return STATUS_CODE_NOT_INITIALIZED;
 
+    m_pseudoLayer = pseudoLayer;
     return STATUS_CODE_SUCCESS;
 }
 
@@ -157,14 +121,14 @@ StatusCode CaloHit::SetPseudoLayer(const unsigned int pseudoLayer)
 
 void CaloHit::SetMCParticleWeightMap(const MCParticleWeightMap &mcParticleWeightMap)
 {
-    m_mcParticleWeightMap = mcParticleWeightMap;
+    m_pColdData->m_mcParticleWeightMap = mcParticleWeightMap;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 void CaloHit::RemoveMCParticles()
 {
-    m_mcParticleWeightMap.clear();
+    m_pColdData->m_mcParticleWeightMap.clear();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -267,4 +231,25 @@ void CaloHit::GetPointingCellCorners(CartesianPointVector &cartesianPointVector)
     cartesianPointVector.push_back(CartesianVector(rMaxAtThetaMin * sinThetaMin * cosPhiMax, rMaxAtThetaMin * sinThetaMin * sinPhiMax, rMaxAtThetaMin * cosThetaMin));
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+CaloHit::ColdData::ColdData(const object_creation::CaloHit::Parameters &parameters) :
+    m_x0(0.f),
+    m_expectedDirection(parameters.m_expectedDirection.Get().GetUnitVector()),
+    m_cellNormalVector(parameters.m_cellNormalVector.Get().GetUnitVector()),
+    m_cellGeometry(parameters.m_cellGeometry.Get()),
+    m_cellSize0(parameters.m_cellSize0.Get()),
+    m_cellSize1(parameters.m_cellSize1.Get()),
+    m_cellThickness(parameters.m_cellThickness.Get()),
+    m_nCellRadiationLengths(parameters.m_nCellRadiationLengths.Get()),
+    m_nCellInteractionLengths(parameters.m_nCellInteractionLengths.Get()),
+    m_time(parameters.m_time.Get()),
+    m_hitRegion(parameters.m_hitRegion.Get()),
+    m_layer(parameters.m_layer.Get()),
+    m_isInOuterSamplingLayer(parameters.m_isInOuterSamplingLayer.Get()),
+    m_pParentAddress(parameters.m_pParentAddress.Get())
+{
+}
+
 } // namespace pandora
@@ -20,6 +20,7 @@
 #include "Plugins/ShowerProfilePlugin.h"
 
 #include <algorithm>
+#include <atomic>
 
 namespace pandora
 {
@@ -36,12 +37,10 @@ const Track *Cluster::GetTrackSeed() const
 
 const CartesianVector Cluster::GetCentroid(const unsigned int pseudoLayer) const
 {
-    PointByPseudoLayerMap::const_iterator pointValueIter = m_sumXYZByPseudoLayer.find(pseudoLayer);
-
-    if (m_sumXYZByPseudoLayer.end() == pointValueIter)
+    if ((pseudoLayer < m_pseudoLayerSumsOffset) || (pseudoLayer - m_pseudoLayerSumsOffset >= m_pseudoLayerSums.size()))
         throw StatusCodeException(STATUS_CODE_FAILURE);
 
-    const SimplePoint &mypoint = pointValueIter->second;
+    const PseudoLayerSums &mypoint = m_pseudoLayerSums[pseudoLayer - m_pseudoLayerSumsOffset];
 
     if (0 == mypoint.m_nHits)
         throw StatusCodeException(STATUS_CODE_FAILURE);
@@ -239,10 +238,12 @@ Cluster::Cluster(const object_creation::Cluster::Parameters &parameters) :
     m_isolatedHadronicEnergy(0),
     m_particleId(UNKNOWN_PARTICLE_TYPE),
     m_pTrackSeed(parameters.m_pTrack.IsInitialized() ? parameters.m_pTrack.Get() : nullptr),
+    m_pseudoLayerSumsOffset(0),
     m_initialDirection(0.f, 0.f, 0.f),
     m_isDirectionUpToDate(false),
     m_isFitUpToDate(false),
-    m_isAvailable(true)
+    m_isAvailable(true),
+    m_contentVersion(Cluster::GetNewContentVersion())
 {
     if (parameters.m_caloHitList.empty() && parameters.m_isolatedCaloHitList.empty() && !parameters.m_pTrack.IsInitialized())
         throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
@@ -287,6 +288,7 @@ StatusCode Cluster::AlterMetadata(const object_creation::Cluster::Metadata &meta
 
 StatusCode Cluster::AddCaloHit(const CaloHit *const pCaloHit)
 {
+    const unsigned int hitTypeIndex(Cluster::GetHitTypeIndex(pCaloHit->GetHitType()));
     PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, m_orderedCaloHitList.Add(pCaloHit));
 
     this->ResetOutdatedProperties();
@@ -307,24 +309,14 @@ StatusCode Cluster::AddCaloHit(const CaloHit *const pCaloHit)
     m_hadronicEnergy += pCaloHit->GetHadronicEnergy();
 
     const unsigned int pseudoLayer(pCaloHit->GetPseudoLayer());
-    OrderedCaloHitList::const_iterator iter = m_orderedCaloHitList.find(pseudoLayer);
 
-    if ((m_orderedCaloHitList.end() != iter) && (iter->second->size() > 1))
-    {
-        SimplePoint &mypoint = m_sumXYZByPseudoLayer[pseudoLayer];
-        mypoint.m_xyzPositionSums[0] += x;
-        mypoint.m_xyzPositionSums[1] += y;
-        mypoint.m_xyzPositionSums[2] += z;
-        ++mypoint.m_nHits;
-    }
-    else
-    {
-        SimplePoint &mypoint = m_sumXYZByPseudoLayer[pseudoLayer];
-        mypoint.m_xyzPositionSums[0] = x;
-        mypoint.m_xyzPositionSums[1] = y;
-        mypoint.m_xyzPositionSums[2] = z;
-        mypoint.m_nHits = 1;
-    }
+    PseudoLayerSums &mypoint = this->GetPseudoLayerSums(pseudoLayer);
+    mypoint.m_xyzPositionSums[0] += x;
+    mypoint.m_xyzPositionSums[1] += y;
+    mypoint.m_xyzPositionSums[2] += z;
+    ++mypoint.m_nHits;
+    mypoint.m_hitTypeEnergySums[hitTypeIndex] += pCaloHit->GetHadronicEnergy();
+    ++mypoint.m_hitTypeNHits[hitTypeIndex];
 
     if (!m_innerPseudoLayer.IsInitialized() || (pseudoLayer < m_innerPseudoLayer.Get()))
         m_innerPseudoLayer = pseudoLayer;
@@ -362,18 +354,31 @@ StatusCode Cluster::RemoveCaloHit(const CaloHit *const pCaloHit)
     m_hadronicEnergy -= pCaloHit->GetHadronicEnergy();
 
     const unsigned int pseudoLayer(pCaloHit->GetPseudoLayer());
+    const unsigned int hitTypeIndex(Cluster::GetHitTypeIndex(pCaloHit->GetHitType()));
+
+    // ATTN Sums for emptied pseudo layers and hit types are reset exactly, rather than left with rounding residuals
+    PseudoLayerSums &mypoint = this->GetPseudoLayerSums(pseudoLayer);
 
     if (m_orderedCaloHitList.end() != m_orderedCaloHitList.find(pseudoLayer))
     {
-        SimplePoint &mypoint = m_sumXYZByPseudoLayer[pseudoLayer];
         mypoint.m_xyzPositionSums[0] -= x;
         mypoint.m_xyzPositionSums[1] -= y;
         mypoint.m_xyzPositionSums[2] -= z;
         --mypoint.m_nHits;
+
+        if (0 == --mypoint.m_hitTypeNHits[hitTypeIndex])
+        {
+            mypoint.m_hitTypeEnergySums[hitTypeIndex] = 0.;
+        }
+        else
+        {
+            mypoint.m_hitTypeEnergySums[hitTypeIndex] -= pCaloHit->GetHadronicEnergy();
+        }
     }
     else
     {
-        m_sumXYZByPseudoLayer.erase(pseudoLayer);
+        mypoint = PseudoLayerSums();
+        this->TrimPseudoLayerSums();
     }
 
     if (pseudoLayer <= m_innerPseudoLayer.Get())
@@ -393,6 +398,8 @@ StatusCode Cluster::AddIsolatedCaloHit(const CaloHit *const pCaloHit)
         return STATUS_CODE_ALREADY_PRESENT;
 
     m_isolatedCaloHitList.push_back(pCaloHit);
+    m_contentVersion = Cluster::GetNewContentVersion();
+
     const float electromagneticEnergy(pCaloHit->GetElectromagneticEnergy());
     const float hadronicEnergy(pCaloHit->GetHadronicEnergy());
 
@@ -414,6 +421,7 @@ StatusCode Cluster::RemoveIsolatedCaloHit(const CaloHit *const pCaloHit)
         return STATUS_CODE_NOT_FOUND;
 
     m_isolatedCaloHitList.erase(iter);
+    m_contentVersion = Cluster::GetNewContentVersion();
 
     const float electromagneticEnergy(pCaloHit->GetElectromagneticEnergy());
     const float hadronicEnergy(pCaloHit->GetHadronicEnergy());
@@ -464,30 +472,20 @@ void Cluster::UpdateLayerHitTypeCache(const unsigned int pseudoLayer, InputHitTy
     if ((m_orderedCaloHitList.end() == listIter) || (listIter->second->empty()))
         throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
 
-    HitTypeToEnergyMap hitTypeToEnergyMap;
+    const PseudoLayerSums &layerSums(m_pseudoLayerSums.at(pseudoLayer - m_pseudoLayerSumsOffset));
+    float highestEnergy(0.f);
 
-    for (const CaloHit *const pCaloHit : *listIter->second)
+    for (unsigned int hitTypeIndex = 0; hitTypeIndex < N_HIT_TYPES; ++hitTypeIndex)
     {
-        HitTypeToEnergyMap::iterator mapIter = hitTypeToEnergyMap.find(pCaloHit->GetHitType());
-
-        if (hitTypeToEnergyMap.end() != mapIter)
-        {
-            mapIter->second += pCaloHit->GetHadronicEnergy();
+        if (0 == layerSums.m_hitTypeNHits[hitTypeIndex])
             continue;
-        }
-
-        if (!hitTypeToEnergyMap.insert(HitTypeToEnergyMap::value_type(pCaloHit->GetHitType(), pCaloHit->GetHadronicEnergy())).second)
-            throw StatusCodeException(STATUS_CODE_FAILURE);
-    }
 
-    float highestEnergy(0.f);
+        const float hitTypeEnergy(static_cast<float>(layerSums.m_hitTypeEnergySums[hitTypeIndex]));
 
-    for (HitTypeToEnergyMap::value_type &mapEntry : hitTypeToEnergyMap)
-    {
-        if (mapEntry.second > highestEnergy)
+        if (hitTypeEnergy > highestEnergy)
         {
-            layerHitType = mapEntry.first;
-            highestEnergy = mapEntry.second;
+            layerHitType = static_cast<HitType>(hitTypeIndex);
+            highestEnergy = hitTypeEnergy;
         }
     }
 }
@@ -573,7 +571,8 @@ StatusCode Cluster::ResetProperties()
     m_nPossibleMipHits = 0;
     m_nCaloHitsInOuterLayer = 0;
 
-    m_sumXYZByPseudoLayer.clear();
+    m_pseudoLayerSums.clear();
+    m_pseudoLayerSumsOffset = 0;
 
     m_electromagneticEnergy = 0;
     m_hadronicEnergy = 0;
@@ -606,6 +605,65 @@ void Cluster::ResetOutdatedProperties()
     m_outerLayerHitType.Reset();
     m_xMin.Reset();
     m_xMax.Reset();
+    m_contentVersion = Cluster::GetNewContentVersion();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+Cluster::PseudoLayerSums &Cluster::GetPseudoLayerSums(const unsigned int pseudoLayer)
+{
+    if (m_pseudoLayerSums.empty())
+    {
+        m_pseudoLayerSumsOffset = pseudoLayer;
+        m_pseudoLayerSums.resize(1);
+    }
+    else if (pseudoLayer < m_pseudoLayerSumsOffset)
+    {
+        m_pseudoLayerSums.insert(m_pseudoLayerSums.begin(), m_pseudoLayerSumsOffset - pseudoLayer, PseudoLayerSums());
+        m_pseudoLayerSumsOffset = pseudoLayer;
+    }
+    else if (pseudoLayer - m_pseudoLayerSumsOffset >= m_pseudoLayerSums.size())
+    {
+        m_pseudoLayerSums.resize(pseudoLayer - m_pseudoLayerSumsOffset + 1);
+    }
+
+    return m_pseudoLayerSums[pseudoLayer - m_pseudoLayerSumsOffset];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void Cluster::TrimPseudoLayerSums()
+{
+    while (!m_pseudoLayerSums.empty() && (0 == m_pseudoLayerSums.back().m_nHits))
+        m_pseudoLayerSums.pop_back();
+
+    PseudoLayerSumsVector::iterator firstIter(m_pseudoLayerSums.begin());
+
+    while ((m_pseudoLayerSums.end() != firstIter) && (0 == firstIter->m_nHits))
+        ++firstIter;
+
+    m_pseudoLayerSumsOffset += static_cast<unsigned int>(firstIter - m_pseudoLayerSums.begin());
+    m_pseudoLayerSums.erase(m_pseudoLayerSums.begin(), firstIter);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int Cluster::GetHitTypeIndex(const HitType hitType)
+{
+    const unsigned int hitTypeIndex(static_cast<unsigned int>(hitType));
+
+    if (hitTypeIndex >= N_HIT_TYPES)
+        throw StatusCodeException(STATUS_CODE_OUT_OF_RANGE);
+
+    return hitTypeIndex;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+uint64_t Cluster::GetNewContentVersion()
+{
+    static std::atomic<uint64_t> contentVersion(0);
+    return ++contentVersion;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -637,27 +695,23 @@ StatusCode Cluster::AddHitsFromSecondCluster(const Cluster *const pCluster)
     m_hadronicEnergy += pCluster->GetHadronicEnergy();
 
     // Loop over pseudo layers in second cluster
-    for (const OrderedCaloHitList::value_type &layerEntry : orderedCaloHitList)
+    for (unsigned int index = 0; index < pCluster->m_pseudoLayerSums.size(); ++index)
     {
-        const unsigned int pseudoLayer(layerEntry.first);
-        OrderedCaloHitList::const_iterator currentIter = m_orderedCaloHitList.find(pseudoLayer);
+        const PseudoLayerSums &theirpoint = pCluster->m_pseudoLayerSums[index];
 
-        SimplePoint &mypoint = m_sumXYZByPseudoLayer[pseudoLayer];
-        const SimplePoint &theirpoint = pCluster->m_sumXYZByPseudoLayer.at(pseudoLayer);
+        if (0 == theirpoint.m_nHits)
+            continue;
 
-        if ((m_orderedCaloHitList.end() != currentIter) && (currentIter->second->size() > 1))
-        {
-            mypoint.m_xyzPositionSums[0] += theirpoint.m_xyzPositionSums[0];
-            mypoint.m_xyzPositionSums[1] += theirpoint.m_xyzPositionSums[1];
-            mypoint.m_xyzPositionSums[2] += theirpoint.m_xyzPositionSums[2];
-            mypoint.m_nHits += theirpoint.m_nHits;
-        }
-        else
+        PseudoLayerSums &mypoint = this->GetPseudoLayerSums(pCluster->m_pseudoLayerSumsOffset + index);
+        mypoint.m_xyzPositionSums[0] += theirpoint.m_xyzPositionSums[0];
+        mypoint.m_xyzPositionSums[1] += theirpoint.m_xyzPositionSums[1];
+        mypoint.m_xyzPositionSums[2] += theirpoint.m_xyzPositionSums[2];
+        mypoint.m_nHits += theirpoint.m_nHits;
+
+        for (unsigned int hitTypeIndex = 0; hitTypeIndex < N_HIT_TYPES; ++hitTypeIndex)
         {
-            mypoint.m_xyzPositionSums[0] = theirpoint.m_xyzPositionSums[0];
-            mypoint.m_xyzPositionSums[1] = theirpoint.m_xyzPositionSums[1];
-            mypoint.m_xyzPositionSums[2] = theirpoint.m_xyzPositionSums[2];
-            mypoint.m_nHits = theirpoint.m_nHits;
+            mypoint.m_hitTypeEnergySums[hitTypeIndex] += theirpoint.m_hitTypeEnergySums[hitTypeIndex];
+            mypoint.m_hitTypeNHits[hitTypeIndex] += theirpoint.m_hitTypeNHits[hitTypeIndex];
         }
     }
 
@@ -701,4 +755,15 @@ void Cluster::RemoveTrackSeed()
     this->UpdateInitialDirectionCache();
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+Cluster::PseudoLayerSums::PseudoLayerSums() :
+    m_xyzPositionSums{0., 0., 0.},
+    m_nHits(0),
+    m_hitTypeEnergySums{},
+    m_hitTypeNHits{}
+{
+}
+
 } // namespace pandora
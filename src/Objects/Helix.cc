@@ -157,26 +157,8 @@ StatusCode Helix::GetPointInXY(const float x0, const float y0, const float ax, c
     const float phi2(std::atan2(yy2 - m_yCentre, xx2 - m_xCentre));
     const float phi0(std::atan2(referencePoint.GetY() - m_yCentre, referencePoint.GetX() - m_xCentre));
 
-    float dphi1(phi1 - phi0);
-    float dphi2(phi2 - phi0);
-
-    if (dphi1 < 0 && m_charge < 0)
-    {
-        dphi1 = dphi1 + TWO_PI;
-    }
-    else if (dphi1 > 0 && m_charge > 0)
-    {
-        dphi1 = dphi1 - TWO_PI;
-    }
-
-    if (dphi2 < 0 && m_charge < 0)
-    {
-        dphi2 = dphi2 + TWO_PI;
-    }
-    else if (dphi2 > 0 && m_charge > 0)
-    {
-        dphi2 = dphi2 - TWO_PI;
-    }
+    const float dphi1(Helix::GetDeltaPhi(phi1, phi0, m_charge));
+    const float dphi2(Helix::GetDeltaPhi(phi2, phi0, m_charge));
 
     // Calculate generic time
     tt1 = -m_charge * dphi1 * m_radius / m_pxy;
@@ -250,26 +232,8 @@ StatusCode Helix::GetPointOnCircle(const float radius, const CartesianVector &re
     const float phi2(std::atan2(yy2 - m_yCentre, xx2 - m_xCentre));
     const float phi0(std::atan2(referencePoint.GetY() - m_yCentre, referencePoint.GetX() - m_xCentre));
 
-    float dphi1(phi1 - phi0);
-    float dphi2(phi2 - phi0);
-
-    if (dphi1 < 0 && m_charge < 0)
-    {
-        dphi1 = dphi1 + TWO_PI;
-    }
-    else if (dphi1 > 0 && m_charge > 0)
-    {
-        dphi1 = dphi1 - TWO_PI;
-    }
-
-    if (dphi2 < 0 && m_charge < 0)
-    {
-        dphi2 = dphi2 + TWO_PI;
-    }
-    else if (dphi2 > 0 && m_charge > 0)
-    {
-        dphi2 = dphi2 - TWO_PI;
-    }
+    const float dphi1(Helix::GetDeltaPhi(phi1, phi0, m_charge));
+    const float dphi2(Helix::GetDeltaPhi(phi2, phi0, m_charge));
 
     // Calculate generic time
     const float tt1(-m_charge * dphi1 * m_radius / m_pxy);
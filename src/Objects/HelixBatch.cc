@@ -0,0 +1,330 @@
+/**
+ *  @file   PandoraSDK/src/Objects/HelixBatch.cc
+ * 
+ *  @brief  Implementation of the helix batch class.
+ * 
+ *  $Log: $
+ */
+
+#include "Objects/HelixBatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace pandora
+{
+
+const float HelixBatch::TWO_PI = static_cast<float>(2. * std::acos(-1.0));
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+HelixBatch::HelixBatch()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+HelixBatch::HelixBatch(const std::vector<Helix> &helixVector)
+{
+    this->Reserve(helixVector.size());
+
+    for (const Helix &helix : helixVector)
+        this->AddHelix(helix);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void HelixBatch::AddHelix(const Helix &helix)
+{
+    const CartesianVector &referencePoint(helix.GetReferencePoint());
+    const float xCentre(helix.GetXCentre()), yCentre(helix.GetYCentre());
+
+    m_xCentre.push_back(xCentre);
+    m_yCentre.push_back(yCentre);
+    m_radius.push_back(helix.GetRadius());
+    m_charge.push_back(helix.GetCharge());
+    m_pxy.push_back(helix.GetPxy());
+    m_pz.push_back(helix.GetMomentum().GetZ());
+    m_tanLambda.push_back(helix.GetTanLambda());
+    m_referenceZ.push_back(referencePoint.GetZ());
+    m_phiReference.push_back(std::atan2(referencePoint.GetY() - yCentre, referencePoint.GetX() - xCentre));
+    m_distCentreToIP.push_back(std::sqrt(xCentre * xCentre + yCentre * yCentre));
+    m_phiCentre.push_back(std::atan2(yCentre, xCentre));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void HelixBatch::Reserve(const unsigned int nHelices)
+{
+    for (FloatVector *const pFloatVector : {&m_xCentre, &m_yCentre, &m_radius, &m_charge, &m_pxy, &m_pz, &m_tanLambda, &m_referenceZ,
+        &m_phiReference, &m_distCentreToIP, &m_phiCentre})
+    {
+        pFloatVector->reserve(nHelices);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void HelixBatch::GetPointsInXY(const float x0, const float y0, const float ax, const float ay, CartesianPointVector &intersectionPoints,
+    FloatVector &genericTimes, StatusCodeVector &statusCodes) const
+{
+    const unsigned int nHelices(this->GetNHelices());
+    intersectionPoints.assign(nHelices, CartesianVector(0.f, 0.f, 0.f));
+    genericTimes.assign(nHelices, 0.f);
+    statusCodes.assign(nHelices, STATUS_CODE_SUCCESS);
+
+    const float AA(std::sqrt(ax * ax + ay * ay));
+
+    if (AA <= 0)
+    {
+        statusCodes.assign(nHelices, STATUS_CODE_FAILURE);
+        return;
+    }
+
+    // ATTN Candidate intersections are evaluated for every helix in branch-free passes; helices without an intersection are fixed up last
+    FloatVector determinants(nHelices), xx1(nHelices), yy1(nHelices), xx2(nHelices), yy2(nHelices);
+
+    for (unsigned int i = 0; i < nHelices; ++i)
+    {
+        const float xCentre(m_xCentre[i]), yCentre(m_yCentre[i]), radius(m_radius[i]);
+
+        const float BB((ax * (x0 - xCentre) + ay * (y0 - yCentre)) / AA);
+        const float CC(((x0 - xCentre) * (x0 - xCentre) + (y0 - yCentre) * (y0 - yCentre) - radius * radius) / AA);
+
+        const float DET(BB * BB - CC);
+        const float sqrtDET(std::sqrt(std::max(DET, 0.f)));
+
+        const float t1(-BB + sqrtDET);
+        const float t2(-BB - sqrtDET);
+
+        determinants[i] = DET;
+        xx1[i] = x0 + t1 * ax;
+        yy1[i] = y0 + t1 * ay;
+        xx2[i] = x0 + t2 * ax;
+        yy2[i] = y0 + t2 * ay;
+    }
+
+    for (unsigned int i = 0; i < nHelices; ++i)
+    {
+        if (determinants[i] < 0)
+            statusCodes[i] = STATUS_CODE_NOT_FOUND;
+    }
+
+    const unsigned int nNegativeTimes(this->SelectFirstIntersections(xx1, yy1, xx2, yy2, statusCodes, genericTimes));
+
+    for (unsigned int i = 0; i < nHelices; ++i)
+    {
+        if (STATUS_CODE_SUCCESS == statusCodes[i])
+            intersectionPoints[i].SetValues(xx1[i], yy1[i], m_referenceZ[i] + genericTimes[i] * m_pz[i]);
+    }
+
+    if (nNegativeTimes > 0)
+        std::cout << "HelixBatch:: GetPointsInXY, warning - negative generic time for " << nNegativeTimes << " helices" << std::endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void HelixBatch::GetPointsInZ(const float zPlane, CartesianPointVector &intersectionPoints, FloatVector &genericTimes,
+    StatusCodeVector &statusCodes) const
+{
+    const unsigned int nHelices(this->GetNHelices());
+    intersectionPoints.assign(nHelices, CartesianVector(0.f, 0.f, 0.f));
+    genericTimes.assign(nHelices, 0.f);
+    statusCodes.assign(nHelices, STATUS_CODE_SUCCESS);
+
+    FloatVector phis(nHelices);
+
+    for (unsigned int i = 0; i < nHelices; ++i)
+    {
+        genericTimes[i] = (zPlane - m_referenceZ[i]) / m_pz[i];
+        phis[i] = m_phiReference[i] - m_charge[i] * m_pxy[i] * genericTimes[i] / m_radius[i];
+    }
+
+    for (unsigned int i = 0; i < nHelices; ++i)
+    {
+        if (std::fabs(m_pz[i]) < std::numeric_limits<float>::epsilon())
+        {
+            genericTimes[i] = 0.f;
+            statusCodes[i] = STATUS_CODE_NOT_FOUND;
+            continue;
+        }
+
+        const float phi(phis[i]);
+        intersectionPoints[i].SetValues(m_xCentre[i] + m_radius[i] * std::cos(phi), m_yCentre[i] + m_radius[i] * std::sin(phi), zPlane);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void HelixBatch::GetPointsOnCircle(const float radius, CartesianPointVector &intersectionPoints, FloatVector &genericTimes,
+    StatusCodeVector &statusCodes) const
+{
+    const unsigned int nHelices(this->GetNHelices());
+    intersectionPoints.assign(nHelices, CartesianVector(0.f, 0.f, 0.f));
+    genericTimes.assign(nHelices, 0.f);
+    statusCodes.assign(nHelices, STATUS_CODE_SUCCESS);
+
+    // ATTN Candidate intersections are evaluated for every helix in branch-free passes; helices without an intersection are fixed up last
+    FloatVector phiStars(nHelices), xx1(nHelices), yy1(nHelices), xx2(nHelices), yy2(nHelices);
+
+    for (unsigned int i = 0; i < nHelices; ++i)
+    {
+        const float distCenterToIP(m_distCentreToIP[i]), helixRadius(m_radius[i]);
+
+        const float phiStar(0.5f * (radius * radius + distCenterToIP * distCenterToIP - helixRadius * helixRadius) /
+            std::max(1.e-20f, radius * distCenterToIP));
+
+        phiStars[i] = (phiStar > 1.f) ? 0.9999999f : ((phiStar < -1.f) ? -0.9999999f : phiStar);
+    }
+
+    for (unsigned int i = 0; i < nHelices; ++i)
+    {
+        const float phiStar(std::acos(phiStars[i]));
+
+        xx1[i] = radius * std::cos(m_phiCentre[i] + phiStar);
+        yy1[i] = radius * std::sin(m_phiCentre[i] + phiStar);
+        xx2[i] = radius * std::cos(m_phiCentre[i] - phiStar);
+        yy2[i] = radius * std::sin(m_phiCentre[i] - phiStar);
+    }
+
+    for (unsigned int i = 0; i < nHelices; ++i)
+    {
+        const float distCenterToIP(m_distCentreToIP[i]), helixRadius(m_radius[i]);
+
+        if (((distCenterToIP + helixRadius) < radius) || ((helixRadius + radius) < distCenterToIP))
+            statusCodes[i] = STATUS_CODE_NOT_FOUND;
+    }
+
+    const unsigned int nNegativeTimes(this->SelectFirstIntersections(xx1, yy1, xx2, yy2, statusCodes, genericTimes));
+
+    for (unsigned int i = 0; i < nHelices; ++i)
+    {
+        if (STATUS_CODE_SUCCESS == statusCodes[i])
+            intersectionPoints[i].SetValues(xx1[i], yy1[i], m_referenceZ[i] + genericTimes[i] * m_pz[i]);
+    }
+
+    if (nNegativeTimes > 0)
+        std::cout << "HelixBatch:: GetPointsOnCircle, warning - negative generic time for " << nNegativeTimes << " helices" << std::endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int HelixBatch::SelectFirstIntersections(FloatVector &xx1, FloatVector &yy1, const FloatVector &xx2, const FloatVector &yy2,
+    const StatusCodeVector &statusCodes, FloatVector &genericTimes) const
+{
+    const unsigned int nHelices(this->GetNHelices());
+    FloatVector phi1(nHelices), phi2(nHelices);
+
+    for (unsigned int i = 0; i < nHelices; ++i)
+    {
+        phi1[i] = std::atan2(yy1[i] - m_yCentre[i], xx1[i] - m_xCentre[i]);
+        phi2[i] = std::atan2(yy2[i] - m_yCentre[i], xx2[i] - m_xCentre[i]);
+    }
+
+    unsigned int nNegativeTimes(0);
+
+    for (unsigned int i = 0; i < nHelices; ++i)
+    {
+        const float charge(m_charge[i]);
+        const float dphi1(Helix::GetDeltaPhi(phi1[i], m_phiReference[i], charge));
+        const float dphi2(Helix::GetDeltaPhi(phi2[i], m_phiReference[i], charge));
+
+        // Calculate generic time
+        const float tt1(-charge * dphi1 * m_radius[i] / m_pxy[i]);
+        const float tt2(-charge * dphi2 * m_radius[i] / m_pxy[i]);
+
+        const bool isFound(STATUS_CODE_SUCCESS == statusCodes[i]);
+        nNegativeTimes += ((isFound && ((tt1 < 0.f) || (tt2 < 0.f))) ? 1 : 0);
+
+        const bool isFirst(tt1 < tt2);
+        genericTimes[i] = isFound ? (isFirst ? tt1 : tt2) : 0.f;
+        xx1[i] = isFirst ? xx1[i] : xx2[i];
+        yy1[i] = isFirst ? yy1[i] : yy2[i];
+    }
+
+    return nNegativeTimes;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void HelixBatch::GetDistancesToPoint(const CartesianVector &point, CartesianPointVector &distances, FloatVector &genericTimes) const
+{
+    const unsigned int nHelices(this->GetNHelices());
+    distances.assign(nHelices, CartesianVector(0.f, 0.f, 0.f));
+    genericTimes.assign(nHelices, 0.f);
+
+    for (unsigned int i = 0; i < nHelices; ++i)
+        this->GetDistanceToPoint(i, point.GetX(), point.GetY(), point.GetZ(), distances[i], genericTimes[i]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void HelixBatch::GetDistancesToPoints(const unsigned int helixIndex, const CartesianPointVector &points, CartesianPointVector &distances,
+    FloatVector &genericTimes) const
+{
+    if (helixIndex >= this->GetNHelices())
+        throw StatusCodeException(STATUS_CODE_OUT_OF_RANGE);
+
+    const unsigned int nPoints(points.size());
+    distances.assign(nPoints, CartesianVector(0.f, 0.f, 0.f));
+    genericTimes.assign(nPoints, 0.f);
+
+    for (unsigned int i = 0; i < nPoints; ++i)
+        this->GetDistanceToPoint(helixIndex, points[i].GetX(), points[i].GetY(), points[i].GetZ(), distances[i], genericTimes[i]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void HelixBatch::GetDistanceToPoint(const unsigned int index, const float pointX, const float pointY, const float pointZ,
+    CartesianVector &distance, float &genericTime) const
+{
+    const float xCentre(m_xCentre[index]), yCentre(m_yCentre[index]), radius(m_radius[index]), charge(m_charge[index]);
+    const float tanLambda(m_tanLambda[index]), referenceZ(m_referenceZ[index]), phi0(m_phiReference[index]);
+
+    const float phi(std::atan2(pointY - yCentre, pointX - xCentre));
+
+    int nCircles = 0;
+    if (std::fabs(tanLambda * radius) > 1.e-20)
+    {
+        const float xCircles((phi0 - phi - charge * (pointZ - referenceZ) / (tanLambda * radius)) / TWO_PI);
+
+        int n1, n2;
+        if (xCircles >= std::numeric_limits<float>::epsilon())
+        {
+            n1 = static_cast<int>(xCircles);
+            n2 = n1 + 1;
+        }
+        else
+        {
+            n1 = static_cast<int>(xCircles) - 1;
+            n2 = n1 + 1;
+        }
+
+        nCircles = ((std::fabs(n1 - xCircles) < std::fabs(n2 - xCircles) ? n1 : n2));
+    }
+
+    const float dPhi(TWO_PI * (static_cast<float>(nCircles)) + phi - phi0);
+    const float zOnHelix(referenceZ - charge * radius * tanLambda * dPhi);
+
+    const float distX(std::fabs(xCentre - pointX));
+    const float distY(std::fabs(yCentre - pointY));
+    const float distZ(std::fabs(zOnHelix - pointZ));
+
+    float distXY(std::sqrt(distX * distX + distY * distY));
+    distXY = std::fabs(distXY - radius);
+
+    distance.SetValues(distXY, distZ, std::sqrt(distXY * distXY + distZ * distZ));
+
+    if (std::fabs(m_pz[index]) > 0)
+    {
+        genericTime = (zOnHelix - referenceZ) / m_pz[index];
+    }
+    else
+    {
+        genericTime = charge * radius * dPhi / m_pxy[index];
+    }
+}
+
+} // namespace pandora
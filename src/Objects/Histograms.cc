@@ -12,10 +12,14 @@
 
 #include "Pandora/StatusCodes.h"
 
+#include "Persistency/BinaryFileReader.h"
+#include "Persistency/BinaryFileWriter.h"
+
 #include "Xml/tinyxml.h"
 
 #include <cmath>
 #include <limits>
+#include <numeric>
 
 namespace pandora
 {
@@ -33,6 +37,8 @@ Histogram::Histogram(const unsigned int nBinsX, const float xLow, const float xH
     // ATTN Protect against cast to int wrapping to negative numbers if there are very many bins
     if (static_cast<int>((m_xHigh - m_xLow) / m_xBinWidth) < 0)
         throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+    m_binContents.assign(static_cast<unsigned int>(m_nBinsX) + 2, 0.f);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -66,19 +72,44 @@ Histogram::Histogram(const TiXmlHandle *const pXmlHandle, const std::string &xml
     if (orderedBinContents.size() != static_cast<unsigned int>(m_nBinsX) + 2)
         throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
 
-    for (int binX = this->GetUnderflowBinNumber(), endBinX = this->GetOverflowBinNumber(); binX <= endBinX; ++binX)
-    {
-        const float value(orderedBinContents[binX + 1]);
+    m_binContents = orderedBinContents;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
 
-        if (std::fabs(value) > std::numeric_limits<float>::epsilon())
-            m_histogramMap[binX] = value;
+Histogram::Histogram(BinaryFileReader &fileReader, const std::string &histogramName) :
+    m_nBinsX(0),
+    m_xLow(0.f),
+    m_xHigh(0.f)
+{
+    std::string fileHistogramName;
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileReader.ReadVariable(fileHistogramName));
+
+    if (histogramName != fileHistogramName)
+    {
+        std::cout << "Construct Histogram from binary file: expected histogram with name " << histogramName << ", found " << fileHistogramName << std::endl;
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
     }
+
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileReader.ReadVariable(m_nBinsX));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileReader.ReadVariable(m_xLow));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileReader.ReadVariable(m_xHigh));
+
+    if ((0 >= m_nBinsX) || (m_xHigh - m_xLow < std::numeric_limits<float>::epsilon()))
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+    m_xBinWidth = (m_xHigh - m_xLow) / static_cast<float>(m_nBinsX);
+
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileReader.ReadVariable(m_binContents));
+
+    if (m_binContents.size() != static_cast<unsigned int>(m_nBinsX) + 2)
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 Histogram::Histogram(const Histogram &rhs) :
-    m_histogramMap(rhs.m_histogramMap),
+    m_binContents(rhs.m_binContents),
     m_nBinsX(rhs.m_nBinsX),
     m_xLow(rhs.m_xLow),
     m_xHigh(rhs.m_xHigh),
@@ -90,12 +121,10 @@ Histogram::Histogram(const Histogram &rhs) :
 
 float Histogram::GetBinContent(const int binX) const
 {
-    HistogramMap::const_iterator iter = m_histogramMap.find(binX);
-
-    if (m_histogramMap.end() == iter)
+    if ((binX < this->GetUnderflowBinNumber()) || (binX > this->GetOverflowBinNumber()))
         return 0.f;
 
-    return iter->second;
+    return m_binContents[this->GetBinIndex(binX)];
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -120,19 +149,13 @@ int Histogram::GetBinNumber(const float valueX) const
 
 float Histogram::GetCumulativeSum(const int xLowBin, const int xHighBin) const
 {
-    float sumEntries(0.f);
+    const int xBinBegin(std::max(this->GetUnderflowBinNumber(), xLowBin)), xBinEnd(std::min(xHighBin, this->GetOverflowBinNumber()));
 
-    for (int xBin = std::max(this->GetUnderflowBinNumber(), xLowBin), xBinEnd = std::min(xHighBin, this->GetOverflowBinNumber()); xBin <= xBinEnd; ++xBin)
-    {
-        HistogramMap::const_iterator iterX = m_histogramMap.find(xBin);
-
-        if (m_histogramMap.end() == iterX)
-            continue;
-
-        sumEntries += iterX->second;
-    }
+    if (xBinBegin > xBinEnd)
+        return 0.f;
 
-    return sumEntries;
+    const FloatVector::const_iterator beginIter(m_binContents.begin() + this->GetBinIndex(xBinBegin));
+    return std::accumulate(beginIter, beginIter + (xBinEnd - xBinBegin + 1), 0.f);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -144,17 +167,12 @@ void Histogram::GetMaximum(const int xLowBin, const int xHighBin, float &maximum
 
     for (int xBin = std::max(this->GetUnderflowBinNumber(), xLowBin), xBinEnd = std::min(xHighBin, this->GetOverflowBinNumber()); xBin <= xBinEnd; ++xBin)
     {
-        HistogramMap::const_iterator iterX = m_histogramMap.find(xBin);
-
-        if (m_histogramMap.end() == iterX)
-            continue;
-
-        const float binContents(iterX->second);
+        const float binContents(m_binContents[this->GetBinIndex(xBin)]);
 
         if (binContents > maximumValue)
         {
             maximumValue = binContents;
-            maximumBinX = iterX->first;
+            maximumBinX = xBin;
         }
     }
 }
@@ -168,13 +186,8 @@ float Histogram::GetMeanX(const int xLowBin, const int xHighBin) const
 
     for (int xBin = std::max(this->GetMinBinNumber(), xLowBin), xBinEnd = std::min(xHighBin, this->GetMaxBinNumber()); xBin <= xBinEnd; ++xBin)
     {
-        HistogramMap::const_iterator iterX = m_histogramMap.find(xBin);
-
-        if (m_histogramMap.end() == iterX)
-            continue;
-
-        const float binCenter(firstBinCenter + (m_xBinWidth * static_cast<float>(iterX->first)));
-        const float binContents(iterX->second);
+        const float binCenter(firstBinCenter + (m_xBinWidth * static_cast<float>(xBin)));
+        const float binContents(m_binContents[this->GetBinIndex(xBin)]);
 
         sumEntries += binContents;
         sumXEntries += binContents * binCenter;
@@ -195,13 +208,8 @@ float Histogram::GetStandardDeviationX(const int xLowBin, const int xHighBin) co
 
     for (int xBin = std::max(this->GetMinBinNumber(), xLowBin), xBinEnd = std::min(xHighBin, this->GetMaxBinNumber()); xBin <= xBinEnd; ++xBin)
     {
-        HistogramMap::const_iterator iterX = m_histogramMap.find(xBin);
-
-        if (m_histogramMap.end() == iterX)
-            continue;
-
-        const float binCenter(firstBinCenter + (m_xBinWidth * static_cast<float>(iterX->first)));
-        const float binContents(iterX->second);
+        const float binCenter(firstBinCenter + (m_xBinWidth * static_cast<float>(xBin)));
+        const float binContents(m_binContents[this->GetBinIndex(xBin)]);
 
         sumEntries += binContents;
         sumXEntries += binContents * binCenter;
@@ -224,36 +232,45 @@ void Histogram::SetBinContent(const int binX, const float value)
     if ((binX < this->GetUnderflowBinNumber()) || (binX > this->GetOverflowBinNumber()))
         throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
 
-    m_histogramMap[binX] = value;
+    m_binContents[this->GetBinIndex(binX)] = value;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 void Histogram::Fill(const float valueX, const float weight)
 {
+    // ATTN Nan values cannot be assigned a bin, so are ignored; infinite values are assigned to the underflow or overflow bin
+    if (std::isnan(valueX))
+        return;
+
     const int binX(this->GetBinNumber(valueX));
+    m_binContents[this->GetBinIndex(binX)] += weight;
+}
 
-    HistogramMap::iterator iter = m_histogramMap.find(binX);
+//------------------------------------------------------------------------------------------------------------------------------------------
 
-    if (m_histogramMap.end() != iter)
-    {
-        iter->second += weight;
-    }
-    else
-    {
-        if (!m_histogramMap.insert(HistogramMap::value_type(binX, weight)).second)
-            throw StatusCodeException(STATUS_CODE_FAILURE);
-    }
+void Histogram::Scale(const float scaleFactor)
+{
+    for (float &binContents : m_binContents)
+        binContents *= scaleFactor;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-void Histogram::Scale(const float scaleFactor)
+void Histogram::Add(const Histogram &rhs, const float scaleFactor)
 {
-    for (HistogramMap::value_type &mapEntry : m_histogramMap)
-    {
-        mapEntry.second = (mapEntry.second * scaleFactor);
-    }
+    if ((m_nBinsX != rhs.m_nBinsX) || (m_xLow != rhs.m_xLow) || (m_xHigh != rhs.m_xHigh))
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+    for (unsigned int index = 0, nBins = m_binContents.size(); index < nBins; ++index)
+        m_binContents[index] += scaleFactor * rhs.m_binContents[index];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void Histogram::Reset()
+{
+    std::fill(m_binContents.begin(), m_binContents.end(), 0.f);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -275,9 +292,9 @@ void Histogram::WriteToXml(TiXmlDocument *const pTiXmlDocument, const std::strin
     pHistogramElement->LinkEndChild(pXHighElement);
 
     std::string binContentsString;
-    for (int binX = this->GetUnderflowBinNumber(), endBinX = this->GetOverflowBinNumber(); binX <= endBinX; ++binX)
+    for (const float binContents : m_binContents)
     {
-        binContentsString += TypeToString(this->GetBinContent(binX)) + " ";
+        binContentsString += TypeToString(binContents) + " ";
     }
 
     TiXmlElement *const pBinContentsElement = new TiXmlElement("BinContents");
@@ -287,11 +304,23 @@ void Histogram::WriteToXml(TiXmlDocument *const pTiXmlDocument, const std::strin
     pTiXmlDocument->LinkEndChild(pHistogramElement);
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void Histogram::WriteToBinary(BinaryFileWriter &fileWriter, const std::string &histogramName) const
+{
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileWriter.WriteVariable(histogramName));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileWriter.WriteVariable(m_nBinsX));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileWriter.WriteVariable(m_xLow));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileWriter.WriteVariable(m_xHigh));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileWriter.WriteVariable(m_binContents));
+}
+
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 TwoDHistogram::TwoDHistogram(const unsigned int nBinsX, const float xLow, const float xHigh, const unsigned int nBinsY, const float yLow,
         const float yHigh) :
+    m_isSummedAreaTableUpToDate(false),
     m_nBinsX(nBinsX),
     m_xLow(xLow),
     m_xHigh(xHigh),
@@ -308,11 +337,14 @@ TwoDHistogram::TwoDHistogram(const unsigned int nBinsX, const float xLow, const
     // ATTN Protect against cast to int wrapping to negative numbers if there are very many bins
     if ((static_cast<int>((m_xHigh - m_xLow) / m_xBinWidth) < 0) || (static_cast<int>((m_yHigh - m_yLow) / m_yBinWidth) < 0))
         throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+    m_binContents.assign((static_cast<unsigned int>(m_nBinsX) + 2) * (static_cast<unsigned int>(m_nBinsY) + 2), 0.f);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 TwoDHistogram::TwoDHistogram(const TiXmlHandle *const pXmlHandle, const std::string &xmlElementName) :
+    m_isSummedAreaTableUpToDate(false),
     m_nBinsX(0),
     m_xLow(0.f),
     m_xHigh(0.f),
@@ -354,30 +386,66 @@ TwoDHistogram::TwoDHistogram(const TiXmlHandle *const pXmlHandle, const std::str
     if (histogramEntryList.size() != static_cast<unsigned int>(m_nBinsY) + 2)
         throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
 
-    for (int binY = this->GetUnderflowBinNumberY(), endBinY = this->GetOverflowBinNumberY(); binY <= endBinY; ++binY)
-    {
-        const FloatVector &orderedBinContents(histogramEntryList[binY + 1]);
+    m_binContents.reserve((static_cast<unsigned int>(m_nBinsX) + 2) * (static_cast<unsigned int>(m_nBinsY) + 2));
 
+    for (const FloatVector &orderedBinContents : histogramEntryList)
+    {
         if (orderedBinContents.size() != static_cast<unsigned int>(m_nBinsX) + 2)
             throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
 
-        for (int binX = this->GetUnderflowBinNumberX(), endBinX = this->GetOverflowBinNumberX(); binX <= endBinX; ++binX)
-        {
-            const float value(orderedBinContents[binX + 1]);
-            if (std::fabs(value) > std::numeric_limits<float>::epsilon())
-            {
-                m_yxHistogramMap[binY][binX] = value;
-                m_xyHistogramMap[binX][binY] = value;
-            }
-        }
+        m_binContents.insert(m_binContents.end(), orderedBinContents.begin(), orderedBinContents.end());
     }
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+TwoDHistogram::TwoDHistogram(BinaryFileReader &fileReader, const std::string &histogramName) :
+    m_isSummedAreaTableUpToDate(false),
+    m_nBinsX(0),
+    m_xLow(0.f),
+    m_xHigh(0.f),
+    m_nBinsY(0),
+    m_yLow(0.f),
+    m_yHigh(0.f)
+{
+    std::string fileHistogramName;
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileReader.ReadVariable(fileHistogramName));
+
+    if (histogramName != fileHistogramName)
+    {
+        std::cout << "Construct Histogram from binary file: expected histogram with name " << histogramName << ", found " << fileHistogramName << std::endl;
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+    }
+
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileReader.ReadVariable(m_nBinsX));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileReader.ReadVariable(m_xLow));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileReader.ReadVariable(m_xHigh));
+
+    if ((0 >= m_nBinsX) || (m_xHigh - m_xLow < std::numeric_limits<float>::epsilon()))
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+    m_xBinWidth = (m_xHigh - m_xLow) / static_cast<float>(m_nBinsX);
+
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileReader.ReadVariable(m_nBinsY));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileReader.ReadVariable(m_yLow));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileReader.ReadVariable(m_yHigh));
+
+    if ((0 >= m_nBinsY) || (m_yHigh - m_yLow < std::numeric_limits<float>::epsilon()))
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+    m_yBinWidth = (m_yHigh - m_yLow) / static_cast<float>(m_nBinsY);
+
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileReader.ReadVariable(m_binContents));
+
+    if (m_binContents.size() != (static_cast<unsigned int>(m_nBinsX) + 2) * (static_cast<unsigned int>(m_nBinsY) + 2))
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 TwoDHistogram::TwoDHistogram(const TwoDHistogram &rhs) :
-    m_xyHistogramMap(rhs.m_xyHistogramMap),
-    m_yxHistogramMap(rhs.m_yxHistogramMap),
+    m_binContents(rhs.m_binContents),
+    m_isSummedAreaTableUpToDate(false),
     m_nBinsX(rhs.m_nBinsX),
     m_xLow(rhs.m_xLow),
     m_xHigh(rhs.m_xHigh),
@@ -391,19 +459,33 @@ TwoDHistogram::TwoDHistogram(const TwoDHistogram &rhs) :
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-float TwoDHistogram::GetBinContent(const int binX, const int binY) const
+TwoDHistogram &TwoDHistogram::operator=(const TwoDHistogram &rhs)
 {
-    TwoDHistogramMap::const_iterator iterX = m_xyHistogramMap.find(binX);
+    if (this != &rhs)
+    {
+        m_binContents = rhs.m_binContents;
+        m_isSummedAreaTableUpToDate = false;
+        m_nBinsX = rhs.m_nBinsX;
+        m_xLow = rhs.m_xLow;
+        m_xHigh = rhs.m_xHigh;
+        m_xBinWidth = rhs.m_xBinWidth;
+        m_nBinsY = rhs.m_nBinsY;
+        m_yLow = rhs.m_yLow;
+        m_yHigh = rhs.m_yHigh;
+        m_yBinWidth = rhs.m_yBinWidth;
+    }
 
-    if (m_xyHistogramMap.end() == iterX)
-        return 0.f;
+    return *this;
+}
 
-    HistogramMap::const_iterator iterXY = iterX->second.find(binY);
+//------------------------------------------------------------------------------------------------------------------------------------------
 
-    if (iterX->second.end() == iterXY)
+float TwoDHistogram::GetBinContent(const int binX, const int binY) const
+{
+    if ((binX < this->GetUnderflowBinNumberX()) || (binX > this->GetOverflowBinNumberX()) || (binY < this->GetUnderflowBinNumberY()) || (binY > this->GetOverflowBinNumberY()))
         return 0.f;
 
-    return iterXY->second;
+    return m_binContents[this->GetBinIndex(binX, binY)];
 }
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -444,27 +526,22 @@ int TwoDHistogram::GetBinNumberY(const float valueY) const
 
 float TwoDHistogram::GetCumulativeSum(const int xLowBin, const int xHighBin, const int yLowBin, const int yHighBin) const
 {
-    float sumEntries(0.f);
+    const int xBinBegin(std::max(this->GetUnderflowBinNumberX(), xLowBin)), xBinEnd(std::min(xHighBin, this->GetOverflowBinNumberX()));
+    const int yBinBegin(std::max(this->GetUnderflowBinNumberY(), yLowBin)), yBinEnd(std::min(yHighBin, this->GetOverflowBinNumberY()));
 
-    for (int yBin = std::max(this->GetUnderflowBinNumberY(), yLowBin), yBinEnd = std::min(yHighBin, this->GetOverflowBinNumberY()); yBin <= yBinEnd; ++yBin)
-    {
-        TwoDHistogramMap::const_iterator iterY = m_yxHistogramMap.find(yBin);
-
-        if (m_yxHistogramMap.end() == iterY)
-            continue;
-
-        for (int xBin = std::max(this->GetUnderflowBinNumberX(), xLowBin), xBinEnd = std::min(xHighBin, this->GetOverflowBinNumberX()); xBin <= xBinEnd; ++xBin)
-        {
-            HistogramMap::const_iterator iterX = iterY->second.find(xBin);
-
-            if (iterY->second.end() == iterX)
-                continue;
+    if ((xBinBegin > xBinEnd) || (yBinBegin > yBinEnd))
+        return 0.f;
 
-            sumEntries += iterX->second;
-        }
-    }
+    // ATTN Table entry (i, j) holds the sum of bin contents with x index < i and y index < j, in rows of (nBinsX + 3) entries
+    const SummedAreaTable &summedAreaTable(this->GetSummedAreaTable());
+    const unsigned int rowLength(static_cast<unsigned int>(m_nBinsX) + 3);
+    const unsigned int xBegin(static_cast<unsigned int>(xBinBegin - this->GetUnderflowBinNumberX()));
+    const unsigned int xEnd(static_cast<unsigned int>(xBinEnd - this->GetUnderflowBinNumberX()) + 1);
+    const unsigned int yBegin(static_cast<unsigned int>(yBinBegin - this->GetUnderflowBinNumberY()));
+    const unsigned int yEnd(static_cast<unsigned int>(yBinEnd - this->GetUnderflowBinNumberY()) + 1);
 
-    return sumEntries;
+    return static_cast<float>(summedAreaTable[yEnd * rowLength + xEnd] - summedAreaTable[yBegin * rowLength + xEnd] -
+        summedAreaTable[yEnd * rowLength + xBegin] + summedAreaTable[yBegin * rowLength + xBegin]);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -475,27 +552,24 @@ void TwoDHistogram::GetMaximum(const int xLowBin, const int xHighBin, const int
     maximumValue = 0.f;
     maximumBinX = this->GetUnderflowBinNumberX(); maximumBinY = this->GetUnderflowBinNumberY();
 
+    const int xBinBegin(std::max(this->GetUnderflowBinNumberX(), xLowBin)), xBinEnd(std::min(xHighBin, this->GetOverflowBinNumberX()));
+
+    if (xBinBegin > xBinEnd)
+        return;
+
     for (int yBin = std::max(this->GetUnderflowBinNumberY(), yLowBin), yBinEnd = std::min(yHighBin, this->GetOverflowBinNumberY()); yBin <= yBinEnd; ++yBin)
     {
-        TwoDHistogramMap::const_iterator iterY = m_yxHistogramMap.find(yBin);
-
-        if (m_yxHistogramMap.end() == iterY)
-            continue;
+        const float *const pRow(&m_binContents[this->GetBinIndex(xBinBegin, yBin)]);
 
-        for (int xBin = std::max(this->GetUnderflowBinNumberX(), xLowBin), xBinEnd = std::min(xHighBin, this->GetOverflowBinNumberX()); xBin <= xBinEnd; ++xBin)
+        for (int xBin = xBinBegin; xBin <= xBinEnd; ++xBin)
         {
-            HistogramMap::const_iterator iterX = iterY->second.find(xBin);
-
-            if (iterY->second.end() == iterX)
-                continue;
-
-            const float binContents(iterX->second);
+            const float binContents(pRow[xBin - xBinBegin]);
 
             if (binContents > maximumValue)
             {
                 maximumValue = binContents;
-                maximumBinX = iterX->first;
-                maximumBinY = iterY->first;
+                maximumBinX = xBin;
+                maximumBinY = yBin;
             }
         }
     }
@@ -510,20 +584,10 @@ float TwoDHistogram::GetMeanX(const int xLowBin, const int xHighBin, const int y
 
     for (int yBin = std::max(this->GetMinBinNumberY(), yLowBin), yBinEnd = std::min(yHighBin, this->GetMaxBinNumberY()); yBin <= yBinEnd; ++yBin)
     {
-        TwoDHistogramMap::const_iterator iterY = m_yxHistogramMap.find(yBin);
-
-        if (m_yxHistogramMap.end() == iterY)
-            continue;
-
         for (int xBin = std::max(this->GetMinBinNumberX(), xLowBin), xBinEnd = std::min(xHighBin, this->GetMaxBinNumberX()); xBin <= xBinEnd; ++xBin)
         {
-            HistogramMap::const_iterator iterX = iterY->second.find(xBin);
-
-            if (iterY->second.end() == iterX)
-                continue;
-
-            const float binXCenter(firstBinXCenter + (m_xBinWidth * static_cast<float>(iterX->first)));
-            const float binContents(iterX->second);
+            const float binXCenter(firstBinXCenter + (m_xBinWidth * static_cast<float>(xBin)));
+            const float binContents(m_binContents[this->GetBinIndex(xBin, yBin)]);
 
             sumEntries += binContents;
             sumXEntries += binContents * binXCenter;
@@ -545,20 +609,10 @@ float TwoDHistogram::GetStandardDeviationX(const int xLowBin, const int xHighBin
 
     for (int yBin = std::max(this->GetMinBinNumberY(), yLowBin), yBinEnd = std::min(yHighBin, this->GetMaxBinNumberY()); yBin <= yBinEnd; ++yBin)
     {
-        TwoDHistogramMap::const_iterator iterY = m_yxHistogramMap.find(yBin);
-
-        if (m_yxHistogramMap.end() == iterY)
-            continue;
-
         for (int xBin = std::max(this->GetMinBinNumberX(), xLowBin), xBinEnd = std::min(xHighBin, this->GetMaxBinNumberX()); xBin <= xBinEnd; ++xBin)
         {
-            HistogramMap::const_iterator iterX = iterY->second.find(xBin);
-
-            if (iterY->second.end() == iterX)
-                continue;
-
-            const float binXCenter(firstBinXCenter + (m_xBinWidth * static_cast<float>(iterX->first)));
-            const float binContents(iterX->second);
+            const float binXCenter(firstBinXCenter + (m_xBinWidth * static_cast<float>(xBin)));
+            const float binContents(m_binContents[this->GetBinIndex(xBin, yBin)]);
 
             sumEntries += binContents;
             sumXEntries += binContents * binXCenter;
@@ -582,22 +636,13 @@ float TwoDHistogram::GetMeanY(const int xLowBin, const int xHighBin, const int y
     float sumEntries(0.f), sumYEntries(0.f);
     const float firstBinYCenter(m_yLow + (0.5f * m_yBinWidth));
 
-    for (int xBin = std::max(this->GetMinBinNumberX(), xLowBin), xBinEnd = std::min(xHighBin, this->GetMaxBinNumberX()); xBin <= xBinEnd; ++xBin)
+    for (int yBin = std::max(this->GetMinBinNumberY(), yLowBin), yBinEnd = std::min(yHighBin, this->GetMaxBinNumberY()); yBin <= yBinEnd; ++yBin)
     {
-        TwoDHistogramMap::const_iterator iterX = m_xyHistogramMap.find(xBin);
-
-        if (m_xyHistogramMap.end() == iterX)
-            continue;
+        const float binYCenter(firstBinYCenter + (m_yBinWidth * static_cast<float>(yBin)));
 
-        for (int yBin = std::max(this->GetMinBinNumberY(), yLowBin), yBinEnd = std::min(yHighBin, this->GetMaxBinNumberY()); yBin <= yBinEnd; ++yBin)
+        for (int xBin = std::max(this->GetMinBinNumberX(), xLowBin), xBinEnd = std::min(xHighBin, this->GetMaxBinNumberX()); xBin <= xBinEnd; ++xBin)
         {
-            HistogramMap::const_iterator iterY = iterX->second.find(yBin);
-
-            if (iterX->second.end() == iterY)
-                continue;
-
-            const float binYCenter(firstBinYCenter + (m_yBinWidth * static_cast<float>(iterY->first)));
-            const float binContents(iterY->second);
+            const float binContents(m_binContents[this->GetBinIndex(xBin, yBin)]);
 
             sumEntries += binContents;
             sumYEntries += binContents * binYCenter;
@@ -617,22 +662,13 @@ float TwoDHistogram::GetStandardDeviationY(const int xLowBin, const int xHighBin
     float sumEntries(0.f), sumYEntries(0.f), sumYYEntries(0.f);
     const float firstBinYCenter(m_yLow + (0.5f * m_yBinWidth));
 
-    for (int xBin = std::max(this->GetMinBinNumberX(), xLowBin), xBinEnd = std::min(xHighBin, this->GetMaxBinNumberX()); xBin <= xBinEnd; ++xBin)
+    for (int yBin = std::max(this->GetMinBinNumberY(), yLowBin), yBinEnd = std::min(yHighBin, this->GetMaxBinNumberY()); yBin <= yBinEnd; ++yBin)
     {
-        TwoDHistogramMap::const_iterator iterX = m_xyHistogramMap.find(xBin);
+        const float binYCenter(firstBinYCenter + (m_yBinWidth * static_cast<float>(yBin)));
 
-        if (m_xyHistogramMap.end() == iterX)
-            continue;
-
-        for (int yBin = std::max(this->GetMinBinNumberY(), yLowBin), yBinEnd = std::min(yHighBin, this->GetMaxBinNumberY()); yBin <= yBinEnd; ++yBin)
+        for (int xBin = std::max(this->GetMinBinNumberX(), xLowBin), xBinEnd = std::min(xHighBin, this->GetMaxBinNumberX()); xBin <= xBinEnd; ++xBin)
         {
-            HistogramMap::const_iterator iterY = iterX->second.find(yBin);
-
-            if (iterX->second.end() == iterY)
-                continue;
-
-            const float binYCenter(firstBinYCenter + (m_yBinWidth * static_cast<float>(iterY->first)));
-            const float binContents(iterY->second);
+            const float binContents(m_binContents[this->GetBinIndex(xBin, yBin)]);
 
             sumEntries += binContents;
             sumYEntries += binContents * binYCenter;
@@ -656,52 +692,56 @@ void TwoDHistogram::SetBinContent(const int binX, const int binY, const float va
     if ((binX < this->GetUnderflowBinNumberX()) || (binX > this->GetOverflowBinNumberX()) || (binY < this->GetUnderflowBinNumberY()) || (binY > this->GetOverflowBinNumberY()))
         throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
 
-    m_xyHistogramMap[binX][binY] = value;
-    m_yxHistogramMap[binY][binX] = value;
+    m_binContents[this->GetBinIndex(binX, binY)] = value;
+    m_isSummedAreaTableUpToDate = false;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 void TwoDHistogram::Fill(const float valueX, const float valueY, const float weight)
 {
+    // ATTN Nan values cannot be assigned a bin, so are ignored; infinite values are assigned to the underflow or overflow bins
+    if (std::isnan(valueX) || std::isnan(valueY))
+        return;
+
     const int binX(this->GetBinNumberX(valueX));
     const int binY(this->GetBinNumberY(valueY));
+    m_binContents[this->GetBinIndex(binX, binY)] += weight;
+    m_isSummedAreaTableUpToDate = false;
+}
 
-    HistogramMap &yHistogramMap(m_xyHistogramMap[binX]);
-    HistogramMap::iterator iter = yHistogramMap.find(binY);
+//------------------------------------------------------------------------------------------------------------------------------------------
 
-    if (yHistogramMap.end() != iter)
-    {
-        iter->second += weight;
-    }
-    else
-    {
-        if (!yHistogramMap.insert(HistogramMap::value_type(binY, weight)).second)
-            throw StatusCodeException(STATUS_CODE_FAILURE);
-    }
+void TwoDHistogram::Scale(const float scaleFactor)
+{
+    for (float &binContents : m_binContents)
+        binContents *= scaleFactor;
 
-    m_yxHistogramMap[binY][binX] = yHistogramMap[binY];
+    m_isSummedAreaTableUpToDate = false;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-void TwoDHistogram::Scale(const float scaleFactor)
+void TwoDHistogram::Add(const TwoDHistogram &rhs, const float scaleFactor)
 {
-    for (TwoDHistogramMap::value_type &mapEntryX : m_xyHistogramMap)
+    if ((m_nBinsX != rhs.m_nBinsX) || (m_xLow != rhs.m_xLow) || (m_xHigh != rhs.m_xHigh) ||
+        (m_nBinsY != rhs.m_nBinsY) || (m_yLow != rhs.m_yLow) || (m_yHigh != rhs.m_yHigh))
     {
-        for (HistogramMap::value_type &mapEntryY : mapEntryX.second)
-        {
-            mapEntryY.second = (mapEntryY.second * scaleFactor);
-        }
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
     }
 
-    for (TwoDHistogramMap::value_type &mapEntryY : m_yxHistogramMap)
-    {
-        for (HistogramMap::value_type &mapEntryX : mapEntryY.second)
-        {
-            mapEntryX.second = (mapEntryX.second * scaleFactor);
-        }
-    }
+    for (unsigned int index = 0, nBins = m_binContents.size(); index < nBins; ++index)
+        m_binContents[index] += scaleFactor * rhs.m_binContents[index];
+
+    m_isSummedAreaTableUpToDate = false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void TwoDHistogram::Reset()
+{
+    std::fill(m_binContents.begin(), m_binContents.end(), 0.f);
+    m_isSummedAreaTableUpToDate = false;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -755,4 +795,52 @@ void TwoDHistogram::WriteToXml(TiXmlDocument *const pTiXmlDocument, const std::s
     pTiXmlDocument->LinkEndChild(pHistogramElement);
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void TwoDHistogram::WriteToBinary(BinaryFileWriter &fileWriter, const std::string &histogramName) const
+{
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileWriter.WriteVariable(histogramName));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileWriter.WriteVariable(m_nBinsX));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileWriter.WriteVariable(m_xLow));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileWriter.WriteVariable(m_xHigh));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileWriter.WriteVariable(m_nBinsY));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileWriter.WriteVariable(m_yLow));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileWriter.WriteVariable(m_yHigh));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, fileWriter.WriteVariable(m_binContents));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const TwoDHistogram::SummedAreaTable &TwoDHistogram::GetSummedAreaTable() const
+{
+    if (m_isSummedAreaTableUpToDate)
+        return m_summedAreaTable;
+
+    std::lock_guard<std::mutex> lock(m_summedAreaTableMutex);
+
+    if (m_isSummedAreaTableUpToDate)
+        return m_summedAreaTable;
+
+    const unsigned int nColumns(static_cast<unsigned int>(m_nBinsX) + 2), nRows(static_cast<unsigned int>(m_nBinsY) + 2);
+    const unsigned int rowLength(nColumns + 1);
+    m_summedAreaTable.assign(rowLength * (nRows + 1), 0.);
+
+    for (unsigned int iRow = 0; iRow < nRows; ++iRow)
+    {
+        const float *const pBinContents(&m_binContents[iRow * nColumns]);
+        const double *const pPreviousRow(&m_summedAreaTable[iRow * rowLength]);
+        double *const pRow(&m_summedAreaTable[(iRow + 1) * rowLength]);
+        double rowSum(0.);
+
+        for (unsigned int iColumn = 0; iColumn < nColumns; ++iColumn)
+        {
+            rowSum += static_cast<double>(pBinContents[iColumn]);
+            pRow[iColumn + 1] = pPreviousRow[iColumn + 1] + rowSum;
+        }
+    }
+
+    m_isSummedAreaTableUpToDate = true;
+    return m_summedAreaTable;
+}
+
 } // namespace pandora
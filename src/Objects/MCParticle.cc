@@ -23,24 +23,6 @@ const MCParticle *MCParticle::GetPfoTarget() const
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-bool MCParticle::operator< (const MCParticle &rhs) const
-{
-    const CartesianVector deltaPosition(rhs.GetVertex() - this->GetVertex());
-
-    if (std::fabs(deltaPosition.GetZ()) > std::numeric_limits<float>::epsilon())
-        return (deltaPosition.GetZ() > std::numeric_limits<float>::epsilon());
-
-    if (std::fabs(deltaPosition.GetX()) > std::numeric_limits<float>::epsilon())
-        return (deltaPosition.GetX() > std::numeric_limits<float>::epsilon());
-
-    if (std::fabs(deltaPosition.GetY()) > std::numeric_limits<float>::epsilon())
-        return (deltaPosition.GetY() > std::numeric_limits<float>::epsilon());
-
-    return (this->GetEnergy() > rhs.GetEnergy());
-}
-
-//------------------------------------------------------------------------------------------------------------------------------------------
-
 MCParticle::MCParticle(const object_creation::MCParticle::Parameters &parameters) :
     m_uid(parameters.m_pParentAddress.Get()),
     m_energy(parameters.m_energy.Get()),
@@ -51,6 +33,7 @@ MCParticle::MCParticle(const object_creation::MCParticle::Parameters &parameters
     m_outerRadius(parameters.m_endpoint.Get().GetMagnitude()),
     m_particleId(parameters.m_particleId.Get()),
     m_mcParticleType(parameters.m_mcParticleType.Get()),
+    m_sortKey(m_vertex.GetX(), m_vertex.GetY(), m_vertex.GetZ(), m_energy),
     m_pPfoTarget(nullptr)
 {
 }
@@ -6,6 +6,7 @@
  *  $Log: $
  */
 
+#include "Objects/CaloHit.h"
 #include "Objects/Cluster.h"
 #include "Objects/OrderedCaloHitList.h"
 #include "Objects/ParticleFlowObject.h"
@@ -24,11 +25,12 @@ ParticleFlowObject::ParticleFlowObject(const object_creation::ParticleFlowObject
     m_momentum(parameters.m_momentum.Get()),
     m_trackList(parameters.m_trackList),
     m_clusterList(parameters.m_clusterList),
-    m_vertexList(parameters.m_vertexList),
-    m_propertiesMap(parameters.m_propertiesToAdd)
+    m_vertexList(parameters.m_vertexList)
 {
-    if (!parameters.m_propertiesToRemove.empty())
+    if (!parameters.m_propertiesToRemove.empty() || !parameters.m_propertyIdsToRemove.empty())
         throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->UpdateProperties(parameters));
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -41,8 +43,9 @@ ParticleFlowObject::~ParticleFlowObject()
 
 StatusCode ParticleFlowObject::AlterMetadata(const object_creation::ParticleFlowObject::Metadata &metadata)
 {
-    if (!metadata.m_propertiesToAdd.empty() || !metadata.m_propertiesToRemove.empty())
-        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->UpdatePropertiesMap(metadata));
+    if (!metadata.m_propertiesToAdd.empty() || !metadata.m_propertiesToRemove.empty() ||
+        !metadata.m_propertyIdsToAdd.empty() || !metadata.m_propertyIdsToRemove.empty())
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->UpdateProperties(metadata));
 
     if (metadata.m_particleId.IsInitialized())
         m_particleId = metadata.m_particleId.Get();
@@ -64,11 +67,35 @@ StatusCode ParticleFlowObject::AlterMetadata(const object_creation::ParticleFlow
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+PropertiesMap ParticleFlowObject::GetPropertiesMap() const
+{
+    PropertiesMap propertiesMap;
+
+    for (const PropertyVector::value_type &entry : m_properties)
+        propertiesMap[PropertyRegistry::GetPropertyName(entry.first)] = entry.second;
+
+    return propertiesMap;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+float ParticleFlowObject::GetProperty(const PropertyId propertyId) const
+{
+    const PropertyVector::const_iterator iter(this->FindProperty(propertyId));
+
+    if ((m_properties.end() == iter) || (propertyId != iter->first))
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+
+    return iter->second;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 TrackAddressList ParticleFlowObject::GetTrackAddressList() const
 {
     TrackAddressList trackAddressList;
 
-    for (const Track *const pTrack : m_trackList)
+    for (const Track *const pTrack : m_trackList.GetList())
     {
         trackAddressList.push_back(pTrack->GetParentAddress());
     }
@@ -80,25 +107,50 @@ TrackAddressList ParticleFlowObject::GetTrackAddressList() const
 
 ClusterAddressList ParticleFlowObject::GetClusterAddressList() const
 {
-    ClusterAddressList clusterAddressList;
+    // ATTN Built on each request, as calo hits can move between clusters without any change to the pfo itself
+    const ClusterList &clusterList(m_clusterList.GetList());
+    ClusterAddressList clusterAddressList(clusterList.size());
+    ClusterAddressList::iterator addressListIter(clusterAddressList.begin());
 
-    for (const Cluster *const pCluster : m_clusterList)
-    {
-        CaloHitAddressList caloHitAddressList;
+    for (const Cluster *const pCluster : clusterList)
+        ParticleFlowObject::FillCaloHitAddressList(pCluster, *addressListIter++);
 
-        OrderedCaloHitList orderedCaloHitList(pCluster->GetOrderedCaloHitList());
-        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, orderedCaloHitList.Add(pCluster->GetIsolatedCaloHitList()));
+    return clusterAddressList;
+}
 
-        for (const OrderedCaloHitList::value_type &layerEntry : orderedCaloHitList)
-        {
-            for (const CaloHit *const pCaloHit : *layerEntry.second)
-                caloHitAddressList.push_back(pCaloHit->GetParentAddress());
-        }
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ParticleFlowObject::FillCaloHitAddressList(const Cluster *const pCluster, CaloHitAddressList &caloHitAddressList)
+{
+    caloHitAddressList.clear();
+    caloHitAddressList.reserve(pCluster->GetNCaloHits() + pCluster->GetIsolatedCaloHitList().size());
+
+    // Isolated hits follow the other hits in the same pseudo layer, retaining their relative order
+    typedef std::pair<unsigned int, const CaloHit*> LayerAndHit;
+    std::vector<LayerAndHit> isolatedHits;
+
+    for (const CaloHit *const pCaloHit : pCluster->GetIsolatedCaloHitList())
+        isolatedHits.push_back(LayerAndHit(pCaloHit->GetPseudoLayer(), pCaloHit));
 
-        clusterAddressList.push_back(caloHitAddressList);
+    std::stable_sort(isolatedHits.begin(), isolatedHits.end(),
+        [](const LayerAndHit &lhs, const LayerAndHit &rhs) -> bool { return (lhs.first < rhs.first); });
+
+    std::vector<LayerAndHit>::const_iterator isolatedIter(isolatedHits.begin());
+
+    for (const OrderedCaloHitList::value_type &layerEntry : pCluster->GetOrderedCaloHitList())
+    {
+        for (; (isolatedHits.end() != isolatedIter) && (isolatedIter->first < layerEntry.first); ++isolatedIter)
+            caloHitAddressList.push_back(isolatedIter->second->GetParentAddress());
+
+        for (const CaloHit *const pCaloHit : *layerEntry.second)
+            caloHitAddressList.push_back(pCaloHit->GetParentAddress());
+
+        for (; (isolatedHits.end() != isolatedIter) && (isolatedIter->first == layerEntry.first); ++isolatedIter)
+            caloHitAddressList.push_back(isolatedIter->second->GetParentAddress());
     }
 
-    return clusterAddressList;
+    for (; isolatedHits.end() != isolatedIter; ++isolatedIter)
+        caloHitAddressList.push_back(isolatedIter->second->GetParentAddress());
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -106,31 +158,19 @@ ClusterAddressList ParticleFlowObject::GetClusterAddressList() const
 template <>
 StatusCode ParticleFlowObject::AddToPfo(const Cluster *const pCluster)
 {
-    if (m_clusterList.end() != std::find(m_clusterList.begin(), m_clusterList.end(), pCluster))
-        return STATUS_CODE_ALREADY_PRESENT;
-
-    m_clusterList.push_back(pCluster);
-    return STATUS_CODE_SUCCESS;
+    return m_clusterList.Add(pCluster);
 }
 
 template <>
 StatusCode ParticleFlowObject::AddToPfo(const Track *const pTrack)
 {
-    if (m_trackList.end() != std::find(m_trackList.begin(), m_trackList.end(), pTrack))
-        return STATUS_CODE_ALREADY_PRESENT;
-
-    m_trackList.push_back(pTrack);
-    return STATUS_CODE_SUCCESS;
+    return m_trackList.Add(pTrack);
 }
 
 template <>
 StatusCode ParticleFlowObject::AddToPfo(const Vertex *const pVertex)
 {
-    if (m_vertexList.end() != std::find(m_vertexList.begin(), m_vertexList.end(), pVertex))
-        return STATUS_CODE_ALREADY_PRESENT;
-
-    m_vertexList.push_back(pVertex);
-    return STATUS_CODE_SUCCESS;
+    return m_vertexList.Add(pVertex);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -138,37 +178,19 @@ StatusCode ParticleFlowObject::AddToPfo(const Vertex *const pVertex)
 template <>
 StatusCode ParticleFlowObject::RemoveFromPfo(const Cluster *const pCluster)
 {
-    ClusterList::iterator iter = std::find(m_clusterList.begin(), m_clusterList.end(), pCluster);
-
-    if (m_clusterList.end() == iter)
-        return STATUS_CODE_NOT_FOUND;
-
-    m_clusterList.erase(iter);
-    return STATUS_CODE_SUCCESS;
+    return m_clusterList.Remove(pCluster);
 }
 
 template <>
 StatusCode ParticleFlowObject::RemoveFromPfo(const Track *const pTrack)
 {
-    TrackList::iterator iter = std::find(m_trackList.begin(), m_trackList.end(), pTrack);
-
-    if (m_trackList.end() == iter)
-        return STATUS_CODE_NOT_FOUND;
-
-    m_trackList.erase(iter);
-    return STATUS_CODE_SUCCESS;
+    return m_trackList.Remove(pTrack);
 }
 
 template <>
 StatusCode ParticleFlowObject::RemoveFromPfo(const Vertex *const pVertex)
 {
-    VertexList::iterator iter = std::find(m_vertexList.begin(), m_vertexList.end(), pVertex);
-
-    if (m_vertexList.end() == iter)
-        return STATUS_CODE_NOT_FOUND;
-
-    m_vertexList.erase(iter);
-    return STATUS_CODE_SUCCESS;
+    return m_vertexList.Remove(pVertex);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -178,11 +200,7 @@ StatusCode ParticleFlowObject::AddParent(const ParticleFlowObject *const pPfo)
     if (!pPfo)
         return STATUS_CODE_INVALID_PARAMETER;
 
-    if (m_parentPfoList.end() != std::find(m_parentPfoList.begin(), m_parentPfoList.end(), pPfo))
-        return STATUS_CODE_ALREADY_PRESENT;
-
-    m_parentPfoList.push_back(pPfo);
-    return STATUS_CODE_SUCCESS;
+    return m_parentPfoList.Add(pPfo);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -192,59 +210,191 @@ StatusCode ParticleFlowObject::AddDaughter(const ParticleFlowObject *const pPfo)
     if (!pPfo)
         return STATUS_CODE_INVALID_PARAMETER;
 
-    if (m_daughterPfoList.end() != std::find(m_daughterPfoList.begin(), m_daughterPfoList.end(), pPfo))
-        return STATUS_CODE_ALREADY_PRESENT;
-
-    m_daughterPfoList.push_back(pPfo);
-    return STATUS_CODE_SUCCESS;
+    return m_daughterPfoList.Add(pPfo);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 StatusCode ParticleFlowObject::RemoveParent(const ParticleFlowObject *const pPfo)
 {
-    PfoList::iterator iter = std::find(m_parentPfoList.begin(), m_parentPfoList.end(), pPfo);
+    return m_parentPfoList.Remove(pPfo);
+}
 
-    if (m_parentPfoList.end() == iter)
-        return STATUS_CODE_NOT_FOUND;
+//------------------------------------------------------------------------------------------------------------------------------------------
 
-    m_parentPfoList.erase(iter);
-    return STATUS_CODE_SUCCESS;
+StatusCode ParticleFlowObject::RemoveDaughter(const ParticleFlowObject *const pPfo)
+{
+    return m_daughterPfoList.Remove(pPfo);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-StatusCode ParticleFlowObject::RemoveDaughter(const ParticleFlowObject *const pPfo)
+StatusCode ParticleFlowObject::UpdateProperties(const object_creation::ParticleFlowObject::Metadata &metadata)
 {
-    PfoList::iterator iter = std::find(m_daughterPfoList.begin(), m_daughterPfoList.end(), pPfo);
+    PropertyVector propertiesToAdd;
+    PropertyIdVector propertyIdsToRemove;
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->GetPropertyChanges(metadata, propertiesToAdd, propertyIdsToRemove));
+
+    for (const PropertyId propertyId : propertyIdsToRemove)
+    {
+        const PropertyVector::const_iterator iter(this->FindProperty(propertyId));
 
-    if (m_daughterPfoList.end() == iter)
-        return STATUS_CODE_NOT_FOUND;
+        if ((m_properties.end() != iter) && (propertyId == iter->first))
+            m_properties.erase(iter);
+    }
+
+    for (const PropertyVector::value_type &entryToAdd : propertiesToAdd)
+    {
+        const PropertyVector::const_iterator iter(this->FindProperty(entryToAdd.first));
+
+        if ((m_properties.end() != iter) && (entryToAdd.first == iter->first))
+        {
+            m_properties[iter - m_properties.begin()].second = entryToAdd.second;
+        }
+        else
+        {
+            m_properties.insert(iter, entryToAdd);
+        }
+    }
 
-    m_daughterPfoList.erase(iter);
     return STATUS_CODE_SUCCESS;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-StatusCode ParticleFlowObject::UpdatePropertiesMap(const object_creation::ParticleFlowObject::Metadata &metadata)
+StatusCode ParticleFlowObject::GetPropertyChanges(const object_creation::ParticleFlowObject::Metadata &metadata,
+    PropertyVector &propertiesToAdd, PropertyIdVector &propertyIdsToRemove) const
 {
+    // ATTN Names are looked up without registration; a name that has never been registered cannot be a property of any pfo
+    propertyIdsToRemove.reserve(metadata.m_propertiesToRemove.size() + metadata.m_propertyIdsToRemove.size());
+
     for (const std::string &propertyName : metadata.m_propertiesToRemove)
     {
-        if (metadata.m_propertiesToAdd.count(propertyName))
+        PropertyId propertyId(0);
+
+        if (!PropertyRegistry::FindPropertyId(propertyName, propertyId))
+            return STATUS_CODE_NOT_FOUND;
+
+        propertyIdsToRemove.push_back(propertyId);
+    }
+
+    for (const PropertyId propertyId : metadata.m_propertyIdsToRemove)
+    {
+        if (!PropertyRegistry::IsRegistered(propertyId))
             return STATUS_CODE_INVALID_PARAMETER;
 
-        if (!m_propertiesMap.count(propertyName))
+        propertyIdsToRemove.push_back(propertyId);
+    }
+
+    for (const PropertyId propertyId : propertyIdsToRemove)
+    {
+        if (!this->HasProperty(propertyId))
             return STATUS_CODE_NOT_FOUND;
     }
 
-    for (const std::string &propertyName : metadata.m_propertiesToRemove)
-        m_propertiesMap.erase(propertyName);
+    const auto isRemoved([&propertyIdsToRemove](const PropertyId propertyId) -> bool
+    {
+        return (propertyIdsToRemove.end() != std::find(propertyIdsToRemove.begin(), propertyIdsToRemove.end(), propertyId));
+    });
+
+    PropertiesMap propertiesToRegister;
+    propertiesToAdd.reserve(metadata.m_propertiesToAdd.size() + metadata.m_propertyIdsToAdd.size());
 
     for (const PropertiesMap::value_type &entryToAdd : metadata.m_propertiesToAdd)
-        m_propertiesMap[entryToAdd.first] = entryToAdd.second;
+    {
+        PropertyId propertyId(0);
+
+        if (!PropertyRegistry::FindPropertyId(entryToAdd.first, propertyId))
+        {
+            propertiesToRegister.insert(entryToAdd);
+            continue;
+        }
+
+        if (isRemoved(propertyId))
+            return STATUS_CODE_INVALID_PARAMETER;
+
+        propertiesToAdd.push_back(PropertyVector::value_type(propertyId, entryToAdd.second));
+    }
+
+    for (const PropertyVector::value_type &entryToAdd : metadata.m_propertyIdsToAdd)
+    {
+        if (!PropertyRegistry::IsRegistered(entryToAdd.first) || isRemoved(entryToAdd.first))
+            return STATUS_CODE_INVALID_PARAMETER;
+    }
+
+    // Register new names only once all changes are known to be valid, then apply named properties ahead of those given by id
+    for (const PropertiesMap::value_type &entryToRegister : propertiesToRegister)
+    {
+        const PropertyId propertyId(PropertyRegistry::GetPropertyId(entryToRegister.first));
+        propertiesToAdd.push_back(PropertyVector::value_type(propertyId, entryToRegister.second));
+    }
+
+    propertiesToAdd.insert(propertiesToAdd.end(), metadata.m_propertyIdsToAdd.begin(), metadata.m_propertyIdsToAdd.end());
 
     return STATUS_CODE_SUCCESS;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+PropertyId PropertyRegistry::GetPropertyId(const std::string &propertyName)
+{
+    PropertyRegistry &registry(PropertyRegistry::GetInstance());
+    std::lock_guard<std::mutex> lock(registry.m_mutex);
+
+    const auto insertResult(registry.m_nameToIdMap.insert(NameToIdMap::value_type(propertyName, registry.m_propertyNames.size())));
+
+    if (insertResult.second)
+        registry.m_propertyNames.push_back(propertyName);
+
+    return insertResult.first->second;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const std::string &PropertyRegistry::GetPropertyName(const PropertyId propertyId)
+{
+    PropertyRegistry &registry(PropertyRegistry::GetInstance());
+    std::lock_guard<std::mutex> lock(registry.m_mutex);
+
+    if (propertyId >= registry.m_propertyNames.size())
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+
+    return registry.m_propertyNames[propertyId];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool PropertyRegistry::FindPropertyId(const std::string &propertyName, PropertyId &propertyId)
+{
+    PropertyRegistry &registry(PropertyRegistry::GetInstance());
+    std::lock_guard<std::mutex> lock(registry.m_mutex);
+
+    const NameToIdMap::const_iterator iter(registry.m_nameToIdMap.find(propertyName));
+
+    if (registry.m_nameToIdMap.end() == iter)
+        return false;
+
+    propertyId = iter->second;
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool PropertyRegistry::IsRegistered(const PropertyId propertyId)
+{
+    PropertyRegistry &registry(PropertyRegistry::GetInstance());
+    std::lock_guard<std::mutex> lock(registry.m_mutex);
+
+    return (propertyId < registry.m_propertyNames.size());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+PropertyRegistry &PropertyRegistry::GetInstance()
+{
+    static PropertyRegistry registry;
+    return registry;
+}
+
 } // namespace pandora
@@ -6,8 +6,13 @@
  *  $Log: $
  */
 
+#include "Managers/PluginManager.h"
+
+#include "Objects/Helix.h"
 #include "Objects/Track.h"
 
+#include "Plugins/BFieldPlugin.h"
+
 #include <algorithm>
 #include <cmath>
 
@@ -42,6 +47,23 @@ bool Track::operator< (const Track &rhs) const
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+const Helix &Track::GetHelix(const TrackState &trackState, std::once_flag &onceFlag, std::unique_ptr<const Helix> &pHelix) const
+{
+    // ATTN If the helix cannot be built, the exception propagates and the next request tries again
+    std::call_once(onceFlag, [&]()
+    {
+        if (!m_pPluginManager)
+            throw StatusCodeException(STATUS_CODE_NOT_INITIALIZED);
+
+        const float bField(m_pPluginManager->GetBFieldPlugin()->GetBField(CartesianVector(0.f, 0.f, 0.f)));
+        pHelix.reset(new Helix(trackState.GetPosition(), trackState.GetMomentum(), static_cast<float>(m_charge), bField));
+    });
+
+    return *pHelix;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 Track::Track(const object_creation::Track::Parameters &parameters) :
     m_d0(parameters.m_d0.Get()),
     m_z0(parameters.m_z0.Get()),
@@ -60,7 +82,8 @@ Track::Track(const object_creation::Track::Parameters &parameters) :
     m_canFormClusterlessPfo(parameters.m_canFormClusterlessPfo.Get()),
     m_pAssociatedCluster(nullptr),
     m_pParentAddress(parameters.m_pParentAddress.Get()),
-    m_isAvailable(true)
+    m_isAvailable(true),
+    m_pPluginManager(nullptr)
 {
     // Consistency checks
     if (m_energyAtDca < std::numeric_limits<float>::epsilon())
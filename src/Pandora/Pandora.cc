@@ -99,8 +99,9 @@ Pandora::~Pandora()
 
 StatusCode Pandora::PrepareEvent()
 {
-    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, m_pPandoraImpl->PrepareMCParticles());
+    // ATTN Calo hits are prepared first, so that any rejected during pseudo layer assignment are never matched to mc particles
     PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, m_pPandoraImpl->PrepareCaloHits());
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, m_pPandoraImpl->PrepareMCParticles());
     PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, m_pPandoraImpl->PrepareTracks());
 
     return STATUS_CODE_SUCCESS;
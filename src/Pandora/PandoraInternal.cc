@@ -0,0 +1,47 @@
+/**
+ *  @file   PandoraSDK/src/Pandora/PandoraInternal.cc
+ * 
+ *  @brief  Implementation of the out-of-line members of pandora internal helper classes.
+ * 
+ *  $Log: $
+ */
+
+#include "Objects/MCParticle.h"
+
+#include "Pandora/PandoraInternal.h"
+
+#include <algorithm>
+
+namespace pandora
+{
+
+std::pair<MCParticleWeightMap::iterator, bool> MCParticleWeightMap::insert(const value_type &value)
+{
+    iterator existingIter(this->find(value.first));
+
+    if (this->end() != existingIter)
+        return std::pair<iterator, bool>(existingIter, false);
+
+    // ATTN Entries sharing an equivalent mc particle ordering are kept in insertion order
+    const PointerLessThan<MCParticle> lessThan;
+    const unsigned int index(std::upper_bound(this->begin(), this->end(), value,
+        [&lessThan](const value_type &lhs, const value_type &rhs) {return lessThan(lhs.first, rhs.first);}) - this->begin());
+
+    if (m_heapEntries.empty() && (m_size < N_LOCAL_ENTRIES))
+    {
+        std::copy_backward(m_localEntries + index, m_localEntries + m_size, m_localEntries + m_size + 1);
+        m_localEntries[index] = value;
+    }
+    else
+    {
+        if (m_heapEntries.empty())
+            m_heapEntries.assign(m_localEntries, m_localEntries + m_size);
+
+        m_heapEntries.insert(m_heapEntries.begin() + index, value);
+    }
+
+    ++m_size;
+    return std::pair<iterator, bool>(this->begin() + index, true);
+}
+
+} // namespace pandora
@@ -25,6 +25,9 @@ PandoraSettings::PandoraSettings(const Pandora *const pPandora) :
     m_mcPfoSelectionMomentum(0.01f),
     m_mcPfoSelectionLowEnergyNPCutOff(1.2f),
     m_gapTolerance(0.f),
+    m_nThreads(1),
+    m_shouldCachePseudoLayers(false),
+    m_pseudoLayerCacheMaxEntries(1000000),
     m_pPandora(pPandora)
 {
 }
@@ -102,6 +105,24 @@ StatusCode PandoraSettings::ReadGlobalSettings(const TiXmlHandle *const pXmlHand
     PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(*pXmlHandle,
         "MCPfoSelectionProtonNeutronEnergyCutOff", m_mcPfoSelectionLowEnergyNPCutOff));
 
+    m_nThreads = 1;
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(*pXmlHandle,
+        "NumberOfThreads", m_nThreads));
+
+    if (0 == m_nThreads)
+        return STATUS_CODE_INVALID_PARAMETER;
+
+    m_shouldCachePseudoLayers = false;
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(*pXmlHandle,
+        "ShouldCachePseudoLayers", m_shouldCachePseudoLayers));
+
+    m_pseudoLayerCacheMaxEntries = 1000000;
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(*pXmlHandle,
+        "PseudoLayerCacheMaxEntries", m_pseudoLayerCacheMaxEntries));
+
+    if (0 == m_pseudoLayerCacheMaxEntries)
+        return STATUS_CODE_INVALID_PARAMETER;
+
     return STATUS_CODE_SUCCESS;
 }
 
@@ -13,19 +13,28 @@
 
 #include "Persistency/BinaryFileReader.h"
 
+#include <algorithm>
+
 namespace pandora
 {
 
 BinaryFileReader::BinaryFileReader(const pandora::Pandora &pandora, const std::string &fileName) :
     FileReader(pandora, fileName),
     m_containerPosition(0),
-    m_containerSize(0)
+    m_containerSize(0),
+    m_fileSize(0)
 {
     m_fileType = BINARY;
-    m_fileStream.open(fileName.c_str(), std::ios::in | std::ios::binary);
+    m_fileStream.open(fileName.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
 
     if (!m_fileStream.is_open() || !m_fileStream.good())
         throw StatusCodeException(STATUS_CODE_FAILURE);
+
+    m_fileSize = m_fileStream.tellg();
+    m_fileStream.seekg(0, std::ios::beg);
+
+    if (!m_fileStream.good())
+        throw StatusCodeException(STATUS_CODE_FAILURE);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -810,4 +819,17 @@ StatusCode BinaryFileReader::ReadRelationship(bool checkComponentId)
     return STATUS_CODE_SUCCESS;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::streamoff BinaryFileReader::GetNRemainingBytes()
+{
+    const std::ifstream::pos_type currentPosition(m_fileStream.tellg());
+    const std::ifstream::pos_type containerEndPosition(m_containerPosition + m_containerSize);
+
+    if ((currentPosition >= m_containerPosition) && (currentPosition < containerEndPosition))
+        return (containerEndPosition - currentPosition);
+
+    return std::max(static_cast<std::streamoff>(m_fileSize - currentPosition), static_cast<std::streamoff>(0));
+}
+
 } // namespace pandora
@@ -10,6 +10,7 @@
 
 #include "Persistency/EventReadingAlgorithm.h"
 #include "Persistency/BinaryFileReader.h"
+#include "Persistency/GeometrySnapshot.h"
 #include "Persistency/XmlFileReader.h"
 
 #include <algorithm>
@@ -47,6 +48,11 @@ StatusCode EventReadingAlgorithm::Initialize()
             XmlFileReader fileReader(this->GetPandora(), m_geometryFileName);
             PANDORA_RETURN_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, fileReader.ReadGeometry());
         }
+        else if (GEOMETRY_SNAPSHOT == geometryFileType)
+        {
+            const GeometrySnapshot geometrySnapshot(m_geometryFileName);
+            PANDORA_RETURN_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, geometrySnapshot.CreateGeometry(this->GetPandora()));
+        }
         else
         {
             return STATUS_CODE_FAILURE;
@@ -145,6 +151,10 @@ FileType EventReadingAlgorithm::GetFileType(const std::string &fileName) const
     {
         return BINARY;
     }
+    else if (std::string(".pndrgeo") == fileExtension)
+    {
+        return GEOMETRY_SNAPSHOT;
+    }
     else
     {
         std::cout << "EventReadingAlgorithm: Unknown file type specified " << fileName << std::endl;
@@ -10,6 +10,7 @@
 
 #include "Persistency/EventWritingAlgorithm.h"
 #include "Persistency/BinaryFileWriter.h"
+#include "Persistency/GeometrySnapshot.h"
 #include "Persistency/XmlFileWriter.h"
 
 using namespace pandora;
@@ -52,6 +53,11 @@ StatusCode EventWritingAlgorithm::Initialize()
             XmlFileWriter geometryFileWriter(this->GetPandora(), m_geometryFileName, fileMode);
             PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, geometryFileWriter.WriteGeometry());
         }
+        else if (GEOMETRY_SNAPSHOT == m_geometryFileType)
+        {
+            // ATTN A snapshot holds a single geometry, so always replaces any existing file
+            PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, GeometrySnapshot::Write(this->GetPandora(), m_geometryFileName));
+        }
         else
         {
             return STATUS_CODE_FAILURE;
@@ -124,6 +130,10 @@ StatusCode EventWritingAlgorithm::ReadSettings(const TiXmlHandle xmlHandle)
         {
             m_geometryFileType = BINARY;
         }
+        else if (std::string(".pndrgeo") == fileExtension)
+        {
+            m_geometryFileType = GEOMETRY_SNAPSHOT;
+        }
         else
         {
             std::cout << "EventReadingAlgorithm: Unknown geometry file type specified " << std::endl;
@@ -212,16 +212,11 @@ StatusCode FileWriter::WriteCaloHitToMCParticleRelationship(const CaloHit *const
     if (EVENT_CONTAINER != m_containerId)
         return STATUS_CODE_FAILURE;
 
-    const MCParticleWeightMap &mcParticleWeightMap(pCaloHit->GetMCParticleWeightMap());
-
-    MCParticleVector mcParticleVector;
-    for (const MCParticleWeightMap::value_type &mapEntry : mcParticleWeightMap) mcParticleVector.push_back(mapEntry.first);
-    std::sort(mcParticleVector.begin(), mcParticleVector.end(), PointerLessThan<MCParticle>());
-
-    for (const MCParticle *const pMCParticle : mcParticleVector)
+    // ATTN Mc particle weight map entries are held in deterministic order
+    for (const MCParticleWeightMap::value_type &mapEntry : pCaloHit->GetMCParticleWeightMap())
     {
         PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->WriteRelationship(CALO_HIT_TO_MC_RELATIONSHIP, pCaloHit->GetParentAddress(),
-            pMCParticle->GetUid(), mcParticleWeightMap.at(pMCParticle)));
+            mapEntry.first->GetUid(), mapEntry.second));
     }
 
     return STATUS_CODE_SUCCESS;
@@ -234,16 +229,11 @@ StatusCode FileWriter::WriteTrackToMCParticleRelationship(const Track *const pTr
     if (EVENT_CONTAINER != m_containerId)
         return STATUS_CODE_FAILURE;
 
-    const MCParticleWeightMap &mcParticleWeightMap(pTrack->GetMCParticleWeightMap());
-
-    MCParticleVector mcParticleVector;
-    for (const MCParticleWeightMap::value_type &mapEntry : mcParticleWeightMap) mcParticleVector.push_back(mapEntry.first);
-    std::sort(mcParticleVector.begin(), mcParticleVector.end(), PointerLessThan<MCParticle>());
-
-    for (const MCParticle *const pMCParticle : mcParticleVector)
+    // ATTN Mc particle weight map entries are held in deterministic order
+    for (const MCParticleWeightMap::value_type &mapEntry : pTrack->GetMCParticleWeightMap())
     {
         PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->WriteRelationship(TRACK_TO_MC_RELATIONSHIP, pTrack->GetParentAddress(),
-            pMCParticle->GetUid(), mcParticleWeightMap.at(pMCParticle)));
+            mapEntry.first->GetUid(), mapEntry.second));
     }
 
     return STATUS_CODE_SUCCESS;
@@ -0,0 +1,426 @@
+/**
+ *  @file   PandoraSDK/src/Persistency/GeometrySnapshot.cc
+ * 
+ *  @brief  Implementation of the geometry snapshot class.
+ * 
+ *  $Log: $
+ */
+
+#include "Api/PandoraApi.h"
+
+#include "Geometry/DetectorGap.h"
+#include "Geometry/LArTPC.h"
+#include "Geometry/SubDetector.h"
+
+#include "Managers/GeometryManager.h"
+
+#include "Persistency/GeometrySnapshot.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pandora
+{
+
+const unsigned int GeometrySnapshot::FORMAT_VERSION = 1;
+const char GeometrySnapshot::MAGIC[8] = {'P', 'N', 'D', 'R', 'G', 'E', 'O', '\0'};
+const uint32_t GeometrySnapshot::BYTE_ORDER_MARK = 0x01020304;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+GeometrySnapshot::GeometrySnapshot(const std::string &fileName) :
+    m_pData(nullptr),
+    m_dataSize(0)
+{
+    const int fileDescriptor(open(fileName.c_str(), O_RDONLY));
+
+    if (fileDescriptor < 0)
+    {
+        std::cout << "GeometrySnapshot: cannot open file " << fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+    }
+
+    struct stat fileStatus;
+
+    if ((0 != fstat(fileDescriptor, &fileStatus)) || (fileStatus.st_size < static_cast<off_t>(sizeof(HeaderRecord))))
+    {
+        close(fileDescriptor);
+        std::cout << "GeometrySnapshot: " << fileName << " is not a geometry snapshot file" << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    const size_t dataSize(static_cast<size_t>(fileStatus.st_size));
+    void *const pMapping(mmap(nullptr, dataSize, PROT_READ, MAP_SHARED, fileDescriptor, 0));
+    close(fileDescriptor);
+
+    if (MAP_FAILED == pMapping)
+    {
+        std::cout << "GeometrySnapshot: cannot map file " << fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    m_pData = static_cast<const char*>(pMapping);
+    m_dataSize = dataSize;
+
+    try
+    {
+        this->Validate();
+    }
+    catch (StatusCodeException &)
+    {
+        std::cout << "GeometrySnapshot: " << fileName << " is not a valid geometry snapshot file of format version " << FORMAT_VERSION
+                  << std::endl;
+        munmap(const_cast<char*>(m_pData), m_dataSize);
+        throw;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+GeometrySnapshot::~GeometrySnapshot()
+{
+    munmap(const_cast<char*>(m_pData), m_dataSize);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode GeometrySnapshot::Write(const Pandora &pandora, const std::string &fileName)
+{
+    const GeometryManager *const pGeometryManager(pandora.GetGeometry());
+
+    std::vector<SubDetectorRecord> subDetectorRecords;
+    std::vector<LayerRecord> layerRecords;
+    std::string stringTable;
+
+    for (const SubDetectorMap::value_type &mapEntry : pGeometryManager->GetSubDetectorMap())
+    {
+        const SubDetector *const pSubDetector(mapEntry.second);
+        const SubDetector::SubDetectorLayerVector &subDetectorLayerVector(pSubDetector->GetSubDetectorLayerVector());
+
+        if (subDetectorLayerVector.size() != pSubDetector->GetNLayers())
+            return STATUS_CODE_FAILURE;
+
+        SubDetectorRecord subDetectorRecord;
+        subDetectorRecord.m_nameOffset = stringTable.size();
+        subDetectorRecord.m_nameLength = pSubDetector->GetSubDetectorName().size();
+        subDetectorRecord.m_subDetectorType = pSubDetector->GetSubDetectorType();
+        subDetectorRecord.m_innerRCoordinate = pSubDetector->GetInnerRCoordinate();
+        subDetectorRecord.m_innerZCoordinate = pSubDetector->GetInnerZCoordinate();
+        subDetectorRecord.m_innerPhiCoordinate = pSubDetector->GetInnerPhiCoordinate();
+        subDetectorRecord.m_innerSymmetryOrder = pSubDetector->GetInnerSymmetryOrder();
+        subDetectorRecord.m_outerRCoordinate = pSubDetector->GetOuterRCoordinate();
+        subDetectorRecord.m_outerZCoordinate = pSubDetector->GetOuterZCoordinate();
+        subDetectorRecord.m_outerPhiCoordinate = pSubDetector->GetOuterPhiCoordinate();
+        subDetectorRecord.m_outerSymmetryOrder = pSubDetector->GetOuterSymmetryOrder();
+        subDetectorRecord.m_isMirroredInZ = pSubDetector->IsMirroredInZ();
+        subDetectorRecord.m_firstLayer = layerRecords.size();
+        subDetectorRecord.m_nLayers = pSubDetector->GetNLayers();
+        subDetectorRecords.push_back(subDetectorRecord);
+        stringTable += pSubDetector->GetSubDetectorName();
+
+        for (const SubDetector::SubDetectorLayer &subDetectorLayer : subDetectorLayerVector)
+        {
+            LayerRecord layerRecord;
+            layerRecord.m_closestDistanceToIp = subDetectorLayer.GetClosestDistanceToIp();
+            layerRecord.m_nRadiationLengths = subDetectorLayer.GetNRadiationLengths();
+            layerRecord.m_nInteractionLengths = subDetectorLayer.GetNInteractionLengths();
+            layerRecords.push_back(layerRecord);
+        }
+    }
+
+    std::vector<LArTPCRecord> larTPCRecords;
+
+    for (const LArTPCMap::value_type &mapEntry : pGeometryManager->GetLArTPCMap())
+    {
+        const LArTPC *const pLArTPC(mapEntry.second);
+
+        LArTPCRecord larTPCRecord;
+        larTPCRecord.m_larTPCVolumeId = pLArTPC->GetLArTPCVolumeId();
+        larTPCRecord.m_centerX = pLArTPC->GetCenterX();
+        larTPCRecord.m_centerY = pLArTPC->GetCenterY();
+        larTPCRecord.m_centerZ = pLArTPC->GetCenterZ();
+        larTPCRecord.m_widthX = pLArTPC->GetWidthX();
+        larTPCRecord.m_widthY = pLArTPC->GetWidthY();
+        larTPCRecord.m_widthZ = pLArTPC->GetWidthZ();
+        larTPCRecord.m_wirePitchU = pLArTPC->GetWirePitchU();
+        larTPCRecord.m_wirePitchV = pLArTPC->GetWirePitchV();
+        larTPCRecord.m_wirePitchW = pLArTPC->GetWirePitchW();
+        larTPCRecord.m_wireAngleU = pLArTPC->GetWireAngleU();
+        larTPCRecord.m_wireAngleV = pLArTPC->GetWireAngleV();
+        larTPCRecord.m_wireAngleW = pLArTPC->GetWireAngleW();
+        larTPCRecord.m_sigmaUVW = pLArTPC->GetSigmaUVW();
+        larTPCRecord.m_isDriftInPositiveX = pLArTPC->IsDriftInPositiveX();
+        larTPCRecords.push_back(larTPCRecord);
+    }
+
+    std::vector<LineGapRecord> lineGapRecords;
+    std::vector<BoxGapRecord> boxGapRecords;
+    std::vector<ConcentricGapRecord> concentricGapRecords;
+
+    for (const DetectorGap *const pDetectorGap : pGeometryManager->GetDetectorGapList())
+    {
+        const LineGap *const pLineGap(dynamic_cast<const LineGap*>(pDetectorGap));
+        const BoxGap *const pBoxGap(dynamic_cast<const BoxGap*>(pDetectorGap));
+        const ConcentricGap *const pConcentricGap(dynamic_cast<const ConcentricGap*>(pDetectorGap));
+
+        if (nullptr != pLineGap)
+        {
+            LineGapRecord lineGapRecord;
+            lineGapRecord.m_lineGapType = pLineGap->GetLineGapType();
+            lineGapRecord.m_lineStartX = pLineGap->GetLineStartX();
+            lineGapRecord.m_lineEndX = pLineGap->GetLineEndX();
+            lineGapRecord.m_lineStartZ = pLineGap->GetLineStartZ();
+            lineGapRecord.m_lineEndZ = pLineGap->GetLineEndZ();
+            lineGapRecords.push_back(lineGapRecord);
+        }
+        else if (nullptr != pBoxGap)
+        {
+            const CartesianVector *const vectors[4] = {&pBoxGap->GetVertex(), &pBoxGap->GetSide1(), &pBoxGap->GetSide2(),
+                &pBoxGap->GetSide3()};
+
+            BoxGapRecord boxGapRecord;
+            float *const values[4] = {boxGapRecord.m_vertex, boxGapRecord.m_side1, boxGapRecord.m_side2, boxGapRecord.m_side3};
+
+            for (unsigned int iVector = 0; iVector < 4; ++iVector)
+            {
+                values[iVector][0] = vectors[iVector]->GetX();
+                values[iVector][1] = vectors[iVector]->GetY();
+                values[iVector][2] = vectors[iVector]->GetZ();
+            }
+
+            boxGapRecords.push_back(boxGapRecord);
+        }
+        else if (nullptr != pConcentricGap)
+        {
+            ConcentricGapRecord concentricGapRecord;
+            concentricGapRecord.m_minZCoordinate = pConcentricGap->GetMinZCoordinate();
+            concentricGapRecord.m_maxZCoordinate = pConcentricGap->GetMaxZCoordinate();
+            concentricGapRecord.m_innerRCoordinate = pConcentricGap->GetInnerRCoordinate();
+            concentricGapRecord.m_innerPhiCoordinate = pConcentricGap->GetInnerPhiCoordinate();
+            concentricGapRecord.m_innerSymmetryOrder = pConcentricGap->GetInnerSymmetryOrder();
+            concentricGapRecord.m_outerRCoordinate = pConcentricGap->GetOuterRCoordinate();
+            concentricGapRecord.m_outerPhiCoordinate = pConcentricGap->GetOuterPhiCoordinate();
+            concentricGapRecord.m_outerSymmetryOrder = pConcentricGap->GetOuterSymmetryOrder();
+            concentricGapRecords.push_back(concentricGapRecord);
+        }
+        else
+        {
+            return STATUS_CODE_FAILURE;
+        }
+    }
+
+    const char *const sectionData[N_SECTIONS] = {reinterpret_cast<const char*>(subDetectorRecords.data()),
+        reinterpret_cast<const char*>(layerRecords.data()), reinterpret_cast<const char*>(larTPCRecords.data()),
+        reinterpret_cast<const char*>(lineGapRecords.data()), reinterpret_cast<const char*>(boxGapRecords.data()),
+        reinterpret_cast<const char*>(concentricGapRecords.data()), stringTable.data()};
+    const size_t nSectionRecords[N_SECTIONS] = {subDetectorRecords.size(), layerRecords.size(), larTPCRecords.size(),
+        lineGapRecords.size(), boxGapRecords.size(), concentricGapRecords.size(), stringTable.size()};
+    const size_t sectionRecordSizes[N_SECTIONS] = {sizeof(SubDetectorRecord), sizeof(LayerRecord), sizeof(LArTPCRecord),
+        sizeof(LineGapRecord), sizeof(BoxGapRecord), sizeof(ConcentricGapRecord), sizeof(char)};
+
+    HeaderRecord headerRecord;
+    std::memset(&headerRecord, 0, sizeof(HeaderRecord));
+    std::memcpy(headerRecord.m_magic, MAGIC, sizeof(MAGIC));
+    headerRecord.m_version = FORMAT_VERSION;
+    headerRecord.m_byteOrderMark = BYTE_ORDER_MARK;
+
+    std::vector<char> buffer(sizeof(HeaderRecord), 0);
+
+    for (unsigned int section = 0; section < N_SECTIONS; ++section)
+    {
+        if (nSectionRecords[section] > std::numeric_limits<uint32_t>::max())
+            return STATUS_CODE_OUT_OF_RANGE;
+
+        buffer.resize((buffer.size() + 7) & ~static_cast<size_t>(7), 0);
+        headerRecord.m_sections[section].m_offset = buffer.size();
+        headerRecord.m_sections[section].m_nRecords = nSectionRecords[section];
+        headerRecord.m_sections[section].m_recordSize = sectionRecordSizes[section];
+        buffer.insert(buffer.end(), sectionData[section], sectionData[section] + nSectionRecords[section] * sectionRecordSizes[section]);
+    }
+
+    headerRecord.m_fileSize = buffer.size();
+    std::memcpy(buffer.data(), &headerRecord, sizeof(HeaderRecord));
+
+    // ATTN Write to a temporary file and rename, so that processes mapping an existing snapshot never see a partially written file
+    const std::string temporaryFileName(fileName + ".tmp");
+    std::ofstream fileStream(temporaryFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    fileStream.write(buffer.data(), buffer.size());
+    fileStream.close();
+
+    if (!fileStream.good() || (0 != std::rename(temporaryFileName.c_str(), fileName.c_str())))
+    {
+        std::cout << "GeometrySnapshot: cannot write file " << fileName << std::endl;
+        std::remove(temporaryFileName.c_str());
+        return STATUS_CODE_FAILURE;
+    }
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode GeometrySnapshot::CreateGeometry(const Pandora &pandora) const
+{
+    const SubDetectorRecord *const pSubDetectorRecords(this->GetSubDetectorRecords());
+    const LayerRecord *const pLayerRecords(this->GetLayerRecords());
+
+    for (unsigned int iRecord = 0, nRecords = this->GetNSubDetectorRecords(); iRecord < nRecords; ++iRecord)
+    {
+        const SubDetectorRecord &subDetectorRecord(pSubDetectorRecords[iRecord]);
+
+        PandoraApi::Geometry::SubDetector::Parameters parameters;
+        parameters.m_subDetectorName = this->GetSubDetectorName(subDetectorRecord);
+        parameters.m_subDetectorType = static_cast<SubDetectorType>(subDetectorRecord.m_subDetectorType);
+        parameters.m_innerRCoordinate = subDetectorRecord.m_innerRCoordinate;
+        parameters.m_innerZCoordinate = subDetectorRecord.m_innerZCoordinate;
+        parameters.m_innerPhiCoordinate = subDetectorRecord.m_innerPhiCoordinate;
+        parameters.m_innerSymmetryOrder = subDetectorRecord.m_innerSymmetryOrder;
+        parameters.m_outerRCoordinate = subDetectorRecord.m_outerRCoordinate;
+        parameters.m_outerZCoordinate = subDetectorRecord.m_outerZCoordinate;
+        parameters.m_outerPhiCoordinate = subDetectorRecord.m_outerPhiCoordinate;
+        parameters.m_outerSymmetryOrder = subDetectorRecord.m_outerSymmetryOrder;
+        parameters.m_isMirroredInZ = (0 != subDetectorRecord.m_isMirroredInZ);
+        parameters.m_nLayers = subDetectorRecord.m_nLayers;
+
+        for (unsigned int iLayer = 0; iLayer < subDetectorRecord.m_nLayers; ++iLayer)
+        {
+            const LayerRecord &layerRecord(pLayerRecords[subDetectorRecord.m_firstLayer + iLayer]);
+
+            PandoraApi::Geometry::LayerParameters layerParameters;
+            layerParameters.m_closestDistanceToIp = layerRecord.m_closestDistanceToIp;
+            layerParameters.m_nRadiationLengths = layerRecord.m_nRadiationLengths;
+            layerParameters.m_nInteractionLengths = layerRecord.m_nInteractionLengths;
+            parameters.m_layerParametersVector.push_back(layerParameters);
+        }
+
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::Geometry::SubDetector::Create(pandora, parameters));
+    }
+
+    const LArTPCRecord *const pLArTPCRecords(this->GetLArTPCRecords());
+
+    for (unsigned int iRecord = 0, nRecords = this->GetNLArTPCRecords(); iRecord < nRecords; ++iRecord)
+    {
+        const LArTPCRecord &larTPCRecord(pLArTPCRecords[iRecord]);
+
+        PandoraApi::Geometry::LArTPC::Parameters parameters;
+        parameters.m_larTPCVolumeId = larTPCRecord.m_larTPCVolumeId;
+        parameters.m_centerX = larTPCRecord.m_centerX;
+        parameters.m_centerY = larTPCRecord.m_centerY;
+        parameters.m_centerZ = larTPCRecord.m_centerZ;
+        parameters.m_widthX = larTPCRecord.m_widthX;
+        parameters.m_widthY = larTPCRecord.m_widthY;
+        parameters.m_widthZ = larTPCRecord.m_widthZ;
+        parameters.m_wirePitchU = larTPCRecord.m_wirePitchU;
+        parameters.m_wirePitchV = larTPCRecord.m_wirePitchV;
+        parameters.m_wirePitchW = larTPCRecord.m_wirePitchW;
+        parameters.m_wireAngleU = larTPCRecord.m_wireAngleU;
+        parameters.m_wireAngleV = larTPCRecord.m_wireAngleV;
+        parameters.m_wireAngleW = larTPCRecord.m_wireAngleW;
+        parameters.m_sigmaUVW = larTPCRecord.m_sigmaUVW;
+        parameters.m_isDriftInPositiveX = (0 != larTPCRecord.m_isDriftInPositiveX);
+
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::Geometry::LArTPC::Create(pandora, parameters));
+    }
+
+    const LineGapRecord *const pLineGapRecords(this->GetLineGapRecords());
+
+    for (unsigned int iRecord = 0, nRecords = this->GetNLineGapRecords(); iRecord < nRecords; ++iRecord)
+    {
+        const LineGapRecord &lineGapRecord(pLineGapRecords[iRecord]);
+
+        PandoraApi::Geometry::LineGap::Parameters parameters;
+        parameters.m_lineGapType = static_cast<LineGapType>(lineGapRecord.m_lineGapType);
+        parameters.m_lineStartX = lineGapRecord.m_lineStartX;
+        parameters.m_lineEndX = lineGapRecord.m_lineEndX;
+        parameters.m_lineStartZ = lineGapRecord.m_lineStartZ;
+        parameters.m_lineEndZ = lineGapRecord.m_lineEndZ;
+
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::Geometry::LineGap::Create(pandora, parameters));
+    }
+
+    const BoxGapRecord *const pBoxGapRecords(this->GetBoxGapRecords());
+
+    for (unsigned int iRecord = 0, nRecords = this->GetNBoxGapRecords(); iRecord < nRecords; ++iRecord)
+    {
+        const BoxGapRecord &boxGapRecord(pBoxGapRecords[iRecord]);
+
+        PandoraApi::Geometry::BoxGap::Parameters parameters;
+        parameters.m_vertex = CartesianVector(boxGapRecord.m_vertex[0], boxGapRecord.m_vertex[1], boxGapRecord.m_vertex[2]);
+        parameters.m_side1 = CartesianVector(boxGapRecord.m_side1[0], boxGapRecord.m_side1[1], boxGapRecord.m_side1[2]);
+        parameters.m_side2 = CartesianVector(boxGapRecord.m_side2[0], boxGapRecord.m_side2[1], boxGapRecord.m_side2[2]);
+        parameters.m_side3 = CartesianVector(boxGapRecord.m_side3[0], boxGapRecord.m_side3[1], boxGapRecord.m_side3[2]);
+
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::Geometry::BoxGap::Create(pandora, parameters));
+    }
+
+    const ConcentricGapRecord *const pConcentricGapRecords(this->GetConcentricGapRecords());
+
+    for (unsigned int iRecord = 0, nRecords = this->GetNConcentricGapRecords(); iRecord < nRecords; ++iRecord)
+    {
+        const ConcentricGapRecord &concentricGapRecord(pConcentricGapRecords[iRecord]);
+
+        PandoraApi::Geometry::ConcentricGap::Parameters parameters;
+        parameters.m_minZCoordinate = concentricGapRecord.m_minZCoordinate;
+        parameters.m_maxZCoordinate = concentricGapRecord.m_maxZCoordinate;
+        parameters.m_innerRCoordinate = concentricGapRecord.m_innerRCoordinate;
+        parameters.m_innerPhiCoordinate = concentricGapRecord.m_innerPhiCoordinate;
+        parameters.m_innerSymmetryOrder = concentricGapRecord.m_innerSymmetryOrder;
+        parameters.m_outerRCoordinate = concentricGapRecord.m_outerRCoordinate;
+        parameters.m_outerPhiCoordinate = concentricGapRecord.m_outerPhiCoordinate;
+        parameters.m_outerSymmetryOrder = concentricGapRecord.m_outerSymmetryOrder;
+
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::Geometry::ConcentricGap::Create(pandora, parameters));
+    }
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void GeometrySnapshot::Validate() const
+{
+    const HeaderRecord *const pHeaderRecord(reinterpret_cast<const HeaderRecord*>(m_pData));
+
+    if ((0 != std::memcmp(pHeaderRecord->m_magic, MAGIC, sizeof(MAGIC))) || (BYTE_ORDER_MARK != pHeaderRecord->m_byteOrderMark) ||
+        (FORMAT_VERSION != pHeaderRecord->m_version) || (m_dataSize != pHeaderRecord->m_fileSize))
+    {
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    const size_t sectionRecordSizes[N_SECTIONS] = {sizeof(SubDetectorRecord), sizeof(LayerRecord), sizeof(LArTPCRecord),
+        sizeof(LineGapRecord), sizeof(BoxGapRecord), sizeof(ConcentricGapRecord), sizeof(char)};
+
+    for (unsigned int section = 0; section < N_SECTIONS; ++section)
+    {
+        const SectionRecord &sectionRecord(pHeaderRecord->m_sections[section]);
+
+        if ((sectionRecordSizes[section] != sectionRecord.m_recordSize) || (0 != sectionRecord.m_offset % 8) ||
+            (sectionRecord.m_offset < sizeof(HeaderRecord)) || (sectionRecord.m_offset > m_dataSize) ||
+            (static_cast<uint64_t>(sectionRecord.m_nRecords) * sectionRecord.m_recordSize > m_dataSize - sectionRecord.m_offset))
+        {
+            throw StatusCodeException(STATUS_CODE_FAILURE);
+        }
+    }
+
+    const SubDetectorRecord *const pSubDetectorRecords(this->GetSubDetectorRecords());
+
+    for (unsigned int iRecord = 0, nRecords = this->GetNSubDetectorRecords(); iRecord < nRecords; ++iRecord)
+    {
+        const SubDetectorRecord &subDetectorRecord(pSubDetectorRecords[iRecord]);
+
+        if ((static_cast<uint64_t>(subDetectorRecord.m_nameOffset) + subDetectorRecord.m_nameLength > this->GetNRecords(STRING_SECTION)) ||
+            (static_cast<uint64_t>(subDetectorRecord.m_firstLayer) + subDetectorRecord.m_nLayers > this->GetNLayerRecords()))
+        {
+            throw StatusCodeException(STATUS_CODE_FAILURE);
+        }
+    }
+}
+
+} // namespace pandora
@@ -0,0 +1,53 @@
+/**
+ *  @file   PandoraSDK/src/Plugins/BFieldPlugin.cc
+ * 
+ *  @brief  Implementation of the bfield plugin interface class.
+ * 
+ *  $Log: $
+ */
+
+#include "Objects/CartesianVector.h"
+
+#include "Plugins/BFieldPlugin.h"
+
+#include "Xml/tinyxml.h"
+
+namespace pandora
+{
+
+void BFieldPlugin::GetBFields(const CartesianVector *const pPositionVectors, const unsigned int nPositions, float *const pBFields) const
+{
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+        pBFields[iPosition] = this->GetBField(pPositionVectors[iPosition]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode BFieldPlugin::RegisterPluginDetails(BFieldPlugin &bFieldPlugin, const Pandora *const pPandora, const std::string &type,
+    const std::string &instanceName)
+{
+    return bFieldPlugin.RegisterDetails(pPandora, type, instanceName);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode BFieldPlugin::ReadPluginSettings(BFieldPlugin &bFieldPlugin, const TiXmlHandle xmlHandle)
+{
+    return bFieldPlugin.ReadSettings(xmlHandle);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode BFieldPlugin::InitializePlugin(BFieldPlugin &bFieldPlugin)
+{
+    return bFieldPlugin.Initialize();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode BFieldPlugin::ResetPlugin(BFieldPlugin &bFieldPlugin)
+{
+    return bFieldPlugin.Reset();
+}
+
+} // namespace pandora
@@ -0,0 +1,278 @@
+/**
+ *  @file   PandoraSDK/src/Plugins/GriddedBFieldPlugin.cc
+ * 
+ *  @brief  Implementation of the gridded bfield plugin class.
+ * 
+ *  $Log: $
+ */
+
+#include "Helpers/XmlHelper.h"
+
+#include "Plugins/GriddedBFieldPlugin.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace pandora
+{
+
+GriddedBFieldPlugin::GriddedBFieldPlugin(BFieldPlugin *const pBFieldPlugin) :
+    m_pBFieldPlugin(pBFieldPlugin),
+    m_gridMinimum(-10000.f, -10000.f, -10000.f),
+    m_gridMaximum(10000.f, 10000.f, 10000.f),
+    m_nPointsX(41),
+    m_nPointsY(41),
+    m_nPointsZ(41),
+    m_inverseSpacingX(0.f),
+    m_inverseSpacingY(0.f),
+    m_inverseSpacingZ(0.f),
+    m_maxNAccuracyTestPoints(10000),
+    m_shouldDisplayAccuracy(false),
+    m_nAccuracyTestPoints(0),
+    m_maxAbsoluteDeviation(0.f),
+    m_meanAbsoluteDeviation(0.f)
+{
+    if (!m_pBFieldPlugin)
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+GriddedBFieldPlugin::~GriddedBFieldPlugin()
+{
+    delete m_pBFieldPlugin;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+float GriddedBFieldPlugin::GetBField(const CartesianVector &positionVector) const
+{
+    if (m_gridBFields.empty() || !this->IsInGrid(positionVector))
+        return m_pBFieldPlugin->GetBField(positionVector);
+
+    return this->Interpolate(positionVector);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void GriddedBFieldPlugin::GetBFields(const CartesianVector *const pPositionVectors, const unsigned int nPositions,
+    float *const pBFields) const
+{
+    // ATTN Positions outside the grid are gathered and passed to the underlying plugin in a single batch
+    CartesianPointVector outsidePositions;
+    UIntVector outsideIndices;
+
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+    {
+        const CartesianVector &positionVector(pPositionVectors[iPosition]);
+
+        if (!m_gridBFields.empty() && this->IsInGrid(positionVector))
+        {
+            pBFields[iPosition] = this->Interpolate(positionVector);
+        }
+        else
+        {
+            outsidePositions.push_back(positionVector);
+            outsideIndices.push_back(iPosition);
+        }
+    }
+
+    if (outsidePositions.empty())
+        return;
+
+    FloatVector outsideBFields(outsidePositions.size(), 0.f);
+    m_pBFieldPlugin->GetBFields(outsidePositions.data(), outsidePositions.size(), outsideBFields.data());
+
+    for (unsigned int iOutside = 0, nOutside = outsideIndices.size(); iOutside < nOutside; ++iOutside)
+        pBFields[outsideIndices[iOutside]] = outsideBFields[iOutside];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode GriddedBFieldPlugin::ReadSettings(const TiXmlHandle xmlHandle)
+{
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle,
+        "GridMinimum", m_gridMinimum));
+
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle,
+        "GridMaximum", m_gridMaximum));
+
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle,
+        "NGridPointsX", m_nPointsX));
+
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle,
+        "NGridPointsY", m_nPointsY));
+
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle,
+        "NGridPointsZ", m_nPointsZ));
+
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle,
+        "MaxNAccuracyTestPoints", m_maxNAccuracyTestPoints));
+
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle,
+        "ShouldDisplayAccuracy", m_shouldDisplayAccuracy));
+
+    if ((m_nPointsX < 2) || (m_nPointsY < 2) || (m_nPointsZ < 2) || (m_gridMaximum.GetX() <= m_gridMinimum.GetX()) ||
+        (m_gridMaximum.GetY() <= m_gridMinimum.GetY()) || (m_gridMaximum.GetZ() <= m_gridMinimum.GetZ()))
+    {
+        std::cout << "GriddedBFieldPlugin: grid requires at least two points along each axis and a positive extent" << std::endl;
+        return STATUS_CODE_INVALID_PARAMETER;
+    }
+
+    // ATTN The grid is indexed by unsigned int, so its total number of points must be representable as an unsigned int
+    if ((m_nPointsX > std::numeric_limits<unsigned int>::max() / m_nPointsY) ||
+        (m_nPointsX * m_nPointsY > std::numeric_limits<unsigned int>::max() / m_nPointsZ))
+    {
+        std::cout << "GriddedBFieldPlugin: total number of grid points exceeds the maximum unsigned int value" << std::endl;
+        return STATUS_CODE_INVALID_PARAMETER;
+    }
+
+    // ATTN Underlying plugin settings are nested within the gridded plugin settings
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_ALREADY_PRESENT, !=,
+        BFieldPlugin::RegisterPluginDetails(*m_pBFieldPlugin, &this->GetPandora(), this->GetType(), "UnderlyingBFieldPlugin"));
+
+    TiXmlElement *const pUnderlyingXmlElement(xmlHandle.FirstChild("UnderlyingBFieldPlugin").Element());
+
+    if (nullptr != pUnderlyingXmlElement)
+    {
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, BFieldPlugin::ReadPluginSettings(*m_pBFieldPlugin,
+            TiXmlHandle(pUnderlyingXmlElement)));
+    }
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode GriddedBFieldPlugin::Initialize()
+{
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_ALREADY_PRESENT, !=,
+        BFieldPlugin::RegisterPluginDetails(*m_pBFieldPlugin, &this->GetPandora(), this->GetType(), "UnderlyingBFieldPlugin"));
+
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, BFieldPlugin::InitializePlugin(*m_pBFieldPlugin));
+
+    m_inverseSpacingX = static_cast<float>(m_nPointsX - 1) / (m_gridMaximum.GetX() - m_gridMinimum.GetX());
+    m_inverseSpacingY = static_cast<float>(m_nPointsY - 1) / (m_gridMaximum.GetY() - m_gridMinimum.GetY());
+    m_inverseSpacingZ = static_cast<float>(m_nPointsZ - 1) / (m_gridMaximum.GetZ() - m_gridMinimum.GetZ());
+
+    try
+    {
+        this->SampleGrid();
+        this->MeasureAccuracy();
+    }
+    catch (StatusCodeException &statusCodeException)
+    {
+        m_gridBFields.clear();
+        return statusCodeException.GetStatusCode();
+    }
+
+    if (m_shouldDisplayAccuracy)
+    {
+        std::cout << "GriddedBFieldPlugin: " << m_gridBFields.size() << " grid points, " << m_nAccuracyTestPoints
+                  << " accuracy test points, max absolute deviation " << m_maxAbsoluteDeviation << " T, mean absolute deviation "
+                  << m_meanAbsoluteDeviation << " T" << std::endl;
+    }
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode GriddedBFieldPlugin::Reset()
+{
+    return BFieldPlugin::ResetPlugin(*m_pBFieldPlugin);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void GriddedBFieldPlugin::SampleGrid()
+{
+    CartesianPointVector gridPositions;
+    gridPositions.reserve(m_nPointsX * m_nPointsY * m_nPointsZ);
+
+    for (unsigned int zIndex = 0; zIndex < m_nPointsZ; ++zIndex)
+    {
+        for (unsigned int yIndex = 0; yIndex < m_nPointsY; ++yIndex)
+        {
+            for (unsigned int xIndex = 0; xIndex < m_nPointsX; ++xIndex)
+                gridPositions.push_back(this->GetGridPosition(xIndex, yIndex, zIndex));
+        }
+    }
+
+    FloatVector gridBFields(gridPositions.size(), 0.f);
+    m_pBFieldPlugin->GetBFields(gridPositions.data(), gridPositions.size(), gridBFields.data());
+    m_gridBFields.swap(gridBFields);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void GriddedBFieldPlugin::MeasureAccuracy()
+{
+    const unsigned int nCellsX(m_nPointsX - 1), nCellsY(m_nPointsY - 1), nCellsZ(m_nPointsZ - 1);
+    const unsigned long long nCells(static_cast<unsigned long long>(nCellsX) * nCellsY * nCellsZ);
+    const unsigned int nTestPoints(static_cast<unsigned int>(std::min<unsigned long long>(nCells, m_maxNAccuracyTestPoints)));
+
+    CartesianPointVector testPositions;
+    testPositions.reserve(nTestPoints);
+
+    for (unsigned int iTestPoint = 0; iTestPoint < nTestPoints; ++iTestPoint)
+    {
+        const unsigned long long cellIndex((iTestPoint * nCells) / nTestPoints);
+        const unsigned int xIndex(cellIndex % nCellsX), yIndex((cellIndex / nCellsX) % nCellsY), zIndex(cellIndex / nCellsX / nCellsY);
+        testPositions.push_back(this->GetGridPosition(xIndex + 0.5f, yIndex + 0.5f, zIndex + 0.5f));
+    }
+
+    FloatVector underlyingBFields(testPositions.size(), 0.f);
+    m_pBFieldPlugin->GetBFields(testPositions.data(), testPositions.size(), underlyingBFields.data());
+
+    double sumAbsoluteDeviation(0.);
+    m_maxAbsoluteDeviation = 0.f;
+
+    for (unsigned int iTestPoint = 0; iTestPoint < nTestPoints; ++iTestPoint)
+    {
+        const float absoluteDeviation(std::fabs(this->Interpolate(testPositions[iTestPoint]) - underlyingBFields[iTestPoint]));
+        m_maxAbsoluteDeviation = std::max(m_maxAbsoluteDeviation, absoluteDeviation);
+        sumAbsoluteDeviation += absoluteDeviation;
+    }
+
+    m_nAccuracyTestPoints = nTestPoints;
+    m_meanAbsoluteDeviation = (nTestPoints > 0) ? static_cast<float>(sumAbsoluteDeviation / nTestPoints) : 0.f;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+CartesianVector GriddedBFieldPlugin::GetGridPosition(const float xIndex, const float yIndex, const float zIndex) const
+{
+    return CartesianVector(m_gridMinimum.GetX() + xIndex / m_inverseSpacingX, m_gridMinimum.GetY() + yIndex / m_inverseSpacingY,
+        m_gridMinimum.GetZ() + zIndex / m_inverseSpacingZ);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+float GriddedBFieldPlugin::Interpolate(const CartesianVector &positionVector) const
+{
+    const float u((positionVector.GetX() - m_gridMinimum.GetX()) * m_inverseSpacingX);
+    const float v((positionVector.GetY() - m_gridMinimum.GetY()) * m_inverseSpacingY);
+    const float w((positionVector.GetZ() - m_gridMinimum.GetZ()) * m_inverseSpacingZ);
+
+    // ATTN Positions on the upper grid boundary are assigned to the last cell along the relevant axis
+    const unsigned int xIndex(std::min(static_cast<unsigned int>(u), m_nPointsX - 2));
+    const unsigned int yIndex(std::min(static_cast<unsigned int>(v), m_nPointsY - 2));
+    const unsigned int zIndex(std::min(static_cast<unsigned int>(w), m_nPointsZ - 2));
+    const float fx(u - xIndex), fy(v - yIndex), fz(w - zIndex);
+
+    const unsigned int strideY(m_nPointsX), strideZ(m_nPointsX * m_nPointsY);
+    const float *const pCorner(&m_gridBFields[zIndex * strideZ + yIndex * strideY + xIndex]);
+
+    const float b00(pCorner[0] + fx * (pCorner[1] - pCorner[0]));
+    const float b10(pCorner[strideY] + fx * (pCorner[strideY + 1] - pCorner[strideY]));
+    const float b01(pCorner[strideZ] + fx * (pCorner[strideZ + 1] - pCorner[strideZ]));
+    const float b11(pCorner[strideZ + strideY] + fx * (pCorner[strideZ + strideY + 1] - pCorner[strideZ + strideY]));
+
+    const float b0(b00 + fy * (b10 - b00)), b1(b01 + fy * (b11 - b01));
+    return (b0 + fz * (b1 - b0));
+}
+
+} // namespace pandora
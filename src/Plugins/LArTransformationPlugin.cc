@@ -0,0 +1,146 @@
+/**
+ *  @file   PandoraSDK/src/Plugins/LArTransformationPlugin.cc
+ * 
+ *  @brief  Implementation of the lar transformation plugin interface class.
+ * 
+ *  $Log: $
+ */
+
+#include "Plugins/LArTransformationPlugin.h"
+
+namespace pandora
+{
+
+void LArTransformationPlugin::UVtoWBatch(const double *const pU, const double *const pV, const unsigned int nPositions,
+    double *const pW) const
+{
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+        pW[iPosition] = this->UVtoW(pU[iPosition], pV[iPosition]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArTransformationPlugin::VWtoUBatch(const double *const pV, const double *const pW, const unsigned int nPositions,
+    double *const pU) const
+{
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+        pU[iPosition] = this->VWtoU(pV[iPosition], pW[iPosition]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArTransformationPlugin::WUtoVBatch(const double *const pW, const double *const pU, const unsigned int nPositions,
+    double *const pV) const
+{
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+        pV[iPosition] = this->WUtoV(pW[iPosition], pU[iPosition]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArTransformationPlugin::UVtoYBatch(const double *const pU, const double *const pV, const unsigned int nPositions,
+    double *const pY) const
+{
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+        pY[iPosition] = this->UVtoY(pU[iPosition], pV[iPosition]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArTransformationPlugin::UVtoZBatch(const double *const pU, const double *const pV, const unsigned int nPositions,
+    double *const pZ) const
+{
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+        pZ[iPosition] = this->UVtoZ(pU[iPosition], pV[iPosition]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArTransformationPlugin::UWtoYBatch(const double *const pU, const double *const pW, const unsigned int nPositions,
+    double *const pY) const
+{
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+        pY[iPosition] = this->UWtoY(pU[iPosition], pW[iPosition]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArTransformationPlugin::UWtoZBatch(const double *const pU, const double *const pW, const unsigned int nPositions,
+    double *const pZ) const
+{
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+        pZ[iPosition] = this->UWtoZ(pU[iPosition], pW[iPosition]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArTransformationPlugin::VWtoYBatch(const double *const pV, const double *const pW, const unsigned int nPositions,
+    double *const pY) const
+{
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+        pY[iPosition] = this->VWtoY(pV[iPosition], pW[iPosition]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArTransformationPlugin::VWtoZBatch(const double *const pV, const double *const pW, const unsigned int nPositions,
+    double *const pZ) const
+{
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+        pZ[iPosition] = this->VWtoZ(pV[iPosition], pW[iPosition]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArTransformationPlugin::YZtoUBatch(const double *const pY, const double *const pZ, const unsigned int nPositions,
+    double *const pU) const
+{
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+        pU[iPosition] = this->YZtoU(pY[iPosition], pZ[iPosition]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArTransformationPlugin::YZtoVBatch(const double *const pY, const double *const pZ, const unsigned int nPositions,
+    double *const pV) const
+{
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+        pV[iPosition] = this->YZtoV(pY[iPosition], pZ[iPosition]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArTransformationPlugin::YZtoWBatch(const double *const pY, const double *const pZ, const unsigned int nPositions,
+    double *const pW) const
+{
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+        pW[iPosition] = this->YZtoW(pY[iPosition], pZ[iPosition]);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArTransformationPlugin::GetMinChiSquaredYZBatch(const double *const pU, const double *const pV, const double *const pW,
+    const unsigned int nPositions, const double sigmaU, const double sigmaV, const double sigmaW, double *const pY, double *const pZ,
+    double *const pChiSquared) const
+{
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+    {
+        this->GetMinChiSquaredYZ(pU[iPosition], pV[iPosition], pW[iPosition], sigmaU, sigmaV, sigmaW, pY[iPosition], pZ[iPosition],
+            pChiSquared[iPosition]);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArTransformationPlugin::GetMinChiSquaredYZBatch(const double *const pU, const double *const pV, const double *const pW,
+    const double *const pUFit, const double *const pVFit, const double *const pWFit, const unsigned int nPositions, const double sigmaU,
+    const double sigmaV, const double sigmaW, const double sigmaFit, double *const pY, double *const pZ, double *const pChiSquared) const
+{
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+    {
+        this->GetMinChiSquaredYZ(pU[iPosition], pV[iPosition], pW[iPosition], sigmaU, sigmaV, sigmaW, pUFit[iPosition], pVFit[iPosition],
+            pWFit[iPosition], sigmaFit, pY[iPosition], pZ[iPosition], pChiSquared[iPosition]);
+    }
+}
+
+} // namespace pandora
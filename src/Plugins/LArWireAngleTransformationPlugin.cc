@@ -0,0 +1,365 @@
+/**
+ *  @file   PandoraSDK/src/Plugins/LArWireAngleTransformationPlugin.cc
+ * 
+ *  @brief  Implementation of the lar wire angle transformation plugin class.
+ * 
+ *  $Log: $
+ */
+
+#include "Geometry/LArTPC.h"
+
+#include "Helpers/XmlHelper.h"
+
+#include "Managers/GeometryManager.h"
+
+#include "Pandora/Pandora.h"
+
+#include "Plugins/LArWireAngleTransformationPlugin.h"
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace pandora
+{
+
+LArWireAngleTransformationPlugin::LArWireAngleTransformationPlugin() :
+    m_shouldUseLArTPCWireAngles(true),
+    m_thetaU(0.),
+    m_thetaV(0.),
+    m_thetaW(0.),
+    m_sinTheta{0., 0., 0.},
+    m_cosTheta{1., 1., 1.}
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::GetMinChiSquaredYZ(const double u, const double v, const double w, const double sigmaU,
+    const double sigmaV, const double sigmaW, double &y, double &z, double &chiSquared) const
+{
+    MinChiSquaredSolution solution;
+    this->GetMinChiSquaredSolution(sigmaU, sigmaV, sigmaW, 0., solution);
+    this->EvaluateMinChiSquaredYZ(solution, {u, v, w}, {0., 0., 0.}, y, z, chiSquared);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::GetMinChiSquaredYZ(const double u, const double v, const double w, const double sigmaU,
+    const double sigmaV, const double sigmaW, const double uFit, const double vFit, const double wFit, const double sigmaFit, double &y,
+    double &z, double &chiSquared) const
+{
+    if (sigmaFit <= 0.)
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+    MinChiSquaredSolution solution;
+    this->GetMinChiSquaredSolution(sigmaU, sigmaV, sigmaW, sigmaFit, solution);
+    this->EvaluateMinChiSquaredYZ(solution, {u, v, w}, {uFit, vFit, wFit}, y, z, chiSquared);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::UVtoWBatch(const double *const pU, const double *const pV, const unsigned int nPositions,
+    double *const pW) const
+{
+    m_uvToW.Evaluate(pU, pV, nPositions, pW);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::VWtoUBatch(const double *const pV, const double *const pW, const unsigned int nPositions,
+    double *const pU) const
+{
+    m_vwToU.Evaluate(pV, pW, nPositions, pU);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::WUtoVBatch(const double *const pW, const double *const pU, const unsigned int nPositions,
+    double *const pV) const
+{
+    m_wuToV.Evaluate(pW, pU, nPositions, pV);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::UVtoYBatch(const double *const pU, const double *const pV, const unsigned int nPositions,
+    double *const pY) const
+{
+    m_uvToY.Evaluate(pU, pV, nPositions, pY);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::UVtoZBatch(const double *const pU, const double *const pV, const unsigned int nPositions,
+    double *const pZ) const
+{
+    m_uvToZ.Evaluate(pU, pV, nPositions, pZ);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::UWtoYBatch(const double *const pU, const double *const pW, const unsigned int nPositions,
+    double *const pY) const
+{
+    m_uwToY.Evaluate(pU, pW, nPositions, pY);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::UWtoZBatch(const double *const pU, const double *const pW, const unsigned int nPositions,
+    double *const pZ) const
+{
+    m_uwToZ.Evaluate(pU, pW, nPositions, pZ);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::VWtoYBatch(const double *const pV, const double *const pW, const unsigned int nPositions,
+    double *const pY) const
+{
+    m_vwToY.Evaluate(pV, pW, nPositions, pY);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::VWtoZBatch(const double *const pV, const double *const pW, const unsigned int nPositions,
+    double *const pZ) const
+{
+    m_vwToZ.Evaluate(pV, pW, nPositions, pZ);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::YZtoUBatch(const double *const pY, const double *const pZ, const unsigned int nPositions,
+    double *const pU) const
+{
+    m_yzToU.Evaluate(pY, pZ, nPositions, pU);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::YZtoVBatch(const double *const pY, const double *const pZ, const unsigned int nPositions,
+    double *const pV) const
+{
+    m_yzToV.Evaluate(pY, pZ, nPositions, pV);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::YZtoWBatch(const double *const pY, const double *const pZ, const unsigned int nPositions,
+    double *const pW) const
+{
+    m_yzToW.Evaluate(pY, pZ, nPositions, pW);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::GetMinChiSquaredYZBatch(const double *const pU, const double *const pV, const double *const pW,
+    const unsigned int nPositions, const double sigmaU, const double sigmaV, const double sigmaW, double *const pY, double *const pZ,
+    double *const pChiSquared) const
+{
+    MinChiSquaredSolution solution;
+    this->GetMinChiSquaredSolution(sigmaU, sigmaV, sigmaW, 0., solution);
+
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+    {
+        this->EvaluateMinChiSquaredYZ(solution, {pU[iPosition], pV[iPosition], pW[iPosition]}, {0., 0., 0.}, pY[iPosition], pZ[iPosition],
+            pChiSquared[iPosition]);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::GetMinChiSquaredYZBatch(const double *const pU, const double *const pV, const double *const pW,
+    const double *const pUFit, const double *const pVFit, const double *const pWFit, const unsigned int nPositions, const double sigmaU,
+    const double sigmaV, const double sigmaW, const double sigmaFit, double *const pY, double *const pZ, double *const pChiSquared) const
+{
+    if (sigmaFit <= 0.)
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+    MinChiSquaredSolution solution;
+    this->GetMinChiSquaredSolution(sigmaU, sigmaV, sigmaW, sigmaFit, solution);
+
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+    {
+        this->EvaluateMinChiSquaredYZ(solution, {pU[iPosition], pV[iPosition], pW[iPosition]},
+            {pUFit[iPosition], pVFit[iPosition], pWFit[iPosition]}, pY[iPosition], pZ[iPosition], pChiSquared[iPosition]);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode LArWireAngleTransformationPlugin::ReadSettings(const TiXmlHandle xmlHandle)
+{
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle,
+        "ShouldUseLArTPCWireAngles", m_shouldUseLArTPCWireAngles));
+
+    if (!m_shouldUseLArTPCWireAngles)
+    {
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "WireAngleU", m_thetaU));
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "WireAngleV", m_thetaV));
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "WireAngleW", m_thetaW));
+    }
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode LArWireAngleTransformationPlugin::Initialize()
+{
+    if (m_shouldUseLArTPCWireAngles)
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, this->GetLArTPCWireAngles());
+
+    const double thetas[3] = {m_thetaU, m_thetaV, m_thetaW};
+
+    for (unsigned int iView = 0; iView < 3; ++iView)
+    {
+        m_sinTheta[iView] = std::sin(thetas[iView]);
+        m_cosTheta[iView] = std::cos(thetas[iView]);
+    }
+
+    m_yzToU = LinearCombination(-m_sinTheta[0], m_cosTheta[0]);
+    m_yzToV = LinearCombination(-m_sinTheta[1], m_cosTheta[1]);
+    m_yzToW = LinearCombination(-m_sinTheta[2], m_cosTheta[2]);
+
+    // ATTN The (w,u) and (u,w) pairs each provide only some of the required transforms
+    LinearCombination wuToY, wuToZ, uwToV;
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, GetWirePairCoefficients(m_thetaU, m_thetaV, m_thetaW, m_uvToW, m_uvToY, m_uvToZ));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, GetWirePairCoefficients(m_thetaV, m_thetaW, m_thetaU, m_vwToU, m_vwToY, m_vwToZ));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, GetWirePairCoefficients(m_thetaW, m_thetaU, m_thetaV, m_wuToV, wuToY, wuToZ));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, GetWirePairCoefficients(m_thetaU, m_thetaW, m_thetaV, uwToV, m_uwToY, m_uwToZ));
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode LArWireAngleTransformationPlugin::GetLArTPCWireAngles()
+{
+    const LArTPCMap &larTPCMap(this->GetPandora().GetGeometry()->GetLArTPCMap());
+
+    if (larTPCMap.empty())
+    {
+        std::cout << "LArWireAngleTransformationPlugin: no lar tpcs registered, specify wire angles in plugin settings" << std::endl;
+        return STATUS_CODE_NOT_INITIALIZED;
+    }
+
+    const LArTPC *const pFirstLArTPC(larTPCMap.begin()->second);
+
+    for (const LArTPCMap::value_type &mapEntry : larTPCMap)
+    {
+        const LArTPC *const pLArTPC(mapEntry.second);
+
+        if ((pLArTPC->GetWireAngleU() != pFirstLArTPC->GetWireAngleU()) || (pLArTPC->GetWireAngleV() != pFirstLArTPC->GetWireAngleV()) ||
+            (pLArTPC->GetWireAngleW() != pFirstLArTPC->GetWireAngleW()))
+        {
+            std::cout << "LArWireAngleTransformationPlugin: lar tpcs have differing wire angles" << std::endl;
+            return STATUS_CODE_INVALID_PARAMETER;
+        }
+    }
+
+    m_thetaU = pFirstLArTPC->GetWireAngleU();
+    m_thetaV = pFirstLArTPC->GetWireAngleV();
+    m_thetaW = pFirstLArTPC->GetWireAngleW();
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode LArWireAngleTransformationPlugin::GetWirePairCoefficients(const double thetaA, const double thetaB, const double thetaC,
+    LinearCombination &abToC, LinearCombination &abToY, LinearCombination &abToZ)
+{
+    const double sinAB(std::sin(thetaA - thetaB));
+
+    if (std::fabs(sinAB) < std::numeric_limits<double>::epsilon())
+    {
+        std::cout << "LArWireAngleTransformationPlugin: wire angles must differ for each pair of views" << std::endl;
+        return STATUS_CODE_INVALID_PARAMETER;
+    }
+
+    const double sinA(std::sin(thetaA)), cosA(std::cos(thetaA)), sinB(std::sin(thetaB)), cosB(std::cos(thetaB));
+
+    abToY = LinearCombination(-cosB / sinAB, cosA / sinAB);
+    abToZ = LinearCombination(-sinB / sinAB, sinA / sinAB);
+    abToC = LinearCombination(std::sin(thetaC - thetaB) / sinAB, std::sin(thetaA - thetaC) / sinAB);
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::GetMinChiSquaredSolution(const double sigmaU, const double sigmaV, const double sigmaW,
+    const double sigmaFit, MinChiSquaredSolution &solution) const
+{
+    if ((sigmaU <= 0.) || (sigmaV <= 0.) || (sigmaW <= 0.) || (sigmaFit < 0.))
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+    const double sigmas[3] = {sigmaU, sigmaV, sigmaW};
+    solution.m_fitWeight = (sigmaFit > 0.) ? 1. / (sigmaFit * sigmaFit) : 0.;
+
+    // Normal equations for the (y,z) position, with each view predicting -y * sin(theta) + z * cos(theta)
+    double sumSinSin(0.), sumSinCos(0.), sumCosCos(0.);
+
+    for (unsigned int iView = 0; iView < 3; ++iView)
+    {
+        solution.m_weights[iView] = 1. / (sigmas[iView] * sigmas[iView]);
+        const double totalWeight(solution.m_weights[iView] + solution.m_fitWeight);
+        sumSinSin += totalWeight * m_sinTheta[iView] * m_sinTheta[iView];
+        sumSinCos += totalWeight * m_sinTheta[iView] * m_cosTheta[iView];
+        sumCosCos += totalWeight * m_cosTheta[iView] * m_cosTheta[iView];
+    }
+
+    const double determinant(sumSinSin * sumCosCos - sumSinCos * sumSinCos);
+
+    if (std::fabs(determinant) < std::numeric_limits<double>::epsilon())
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+
+    for (unsigned int iView = 0; iView < 3; ++iView)
+    {
+        solution.m_yCoefficients[iView] = (-sumCosCos * m_sinTheta[iView] + sumSinCos * m_cosTheta[iView]) / determinant;
+        solution.m_zCoefficients[iView] = (-sumSinCos * m_sinTheta[iView] + sumSinSin * m_cosTheta[iView]) / determinant;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::EvaluateMinChiSquaredYZ(const MinChiSquaredSolution &solution, const double (&coordinates)[3],
+    const double (&fitCoordinates)[3], double &y, double &z, double &chiSquared) const
+{
+    y = 0.;
+    z = 0.;
+
+    for (unsigned int iView = 0; iView < 3; ++iView)
+    {
+        const double weightedSum(solution.m_weights[iView] * coordinates[iView] + solution.m_fitWeight * fitCoordinates[iView]);
+        y += solution.m_yCoefficients[iView] * weightedSum;
+        z += solution.m_zCoefficients[iView] * weightedSum;
+    }
+
+    chiSquared = 0.;
+
+    for (unsigned int iView = 0; iView < 3; ++iView)
+    {
+        const double prediction(z * m_cosTheta[iView] - y * m_sinTheta[iView]);
+        const double deltaCoordinate(prediction - coordinates[iView]), deltaFit(prediction - fitCoordinates[iView]);
+        chiSquared += solution.m_weights[iView] * deltaCoordinate * deltaCoordinate + solution.m_fitWeight * deltaFit * deltaFit;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void LArWireAngleTransformationPlugin::LinearCombination::Evaluate(const double *const pA, const double *const pB,
+    const unsigned int nPositions, double *const pOutput) const
+{
+    // ATTN Coefficients are copied to locals so that the loop body is a simple, vectorisable multiply-add over contiguous arrays
+    const double alpha(m_alpha), beta(m_beta);
+
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+        pOutput[iPosition] = alpha * pA[iPosition] + beta * pB[iPosition];
+}
+
+} // namespace pandora
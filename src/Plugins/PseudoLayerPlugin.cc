@@ -0,0 +1,23 @@
+/**
+ *  @file   PandoraSDK/src/Plugins/PseudoLayerPlugin.cc
+ * 
+ *  @brief  Implementation of the pseudo layer plugin interface class.
+ * 
+ *  $Log: $
+ */
+
+#include "Objects/CartesianVector.h"
+
+#include "Plugins/PseudoLayerPlugin.h"
+
+namespace pandora
+{
+
+void PseudoLayerPlugin::GetPseudoLayers(const CartesianVector *const pPositionVectors, const unsigned int nPositions,
+    unsigned int *const pPseudoLayers) const
+{
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+        pPseudoLayers[iPosition] = this->GetPseudoLayer(pPositionVectors[iPosition]);
+}
+
+} // namespace pandora
@@ -0,0 +1,181 @@
+/**
+ *  @file   PandoraSDK/test/CaloHitTest.cc
+ * 
+ *  @brief  Test that calo hits, their fragments and their metadata report the properties with which they were created.
+ * 
+ *  $Log: $
+ */
+
+#include "Pandora/AlgorithmHeaders.h"
+
+#include "TestHelper.h"
+
+#include <random>
+
+using namespace pandora;
+using namespace pandora_test;
+
+/**
+ *  @brief  Check that a calo hit reports the properties given in its parameters, scaled by a weight for a calo hit fragment
+ * 
+ *  @param  pCaloHit the address of the calo hit
+ *  @param  parameters the parameters with which the calo hit, or its original calo hit, was created
+ *  @param  weight the calo hit weight
+ */
+void CheckCaloHit(const CaloHit *const pCaloHit, const PandoraApi::CaloHit::Parameters &parameters, const float weight)
+{
+    PANDORA_TEST_CHECK(pCaloHit->GetPositionVector() == parameters.m_positionVector.Get());
+    PANDORA_TEST_CHECK(pCaloHit->GetX0() == 0.f);
+    PANDORA_TEST_CHECK(pCaloHit->GetExpectedDirection() == parameters.m_expectedDirection.Get().GetUnitVector());
+    PANDORA_TEST_CHECK(pCaloHit->GetCellNormalVector() == parameters.m_cellNormalVector.Get().GetUnitVector());
+    PANDORA_TEST_CHECK(pCaloHit->GetCellGeometry() == parameters.m_cellGeometry.Get());
+    PANDORA_TEST_CHECK(pCaloHit->GetCellSize0() == parameters.m_cellSize0.Get());
+    PANDORA_TEST_CHECK(pCaloHit->GetCellSize1() == parameters.m_cellSize1.Get());
+    PANDORA_TEST_CHECK(pCaloHit->GetCellThickness() == parameters.m_cellThickness.Get());
+    PANDORA_TEST_CHECK(pCaloHit->GetNCellRadiationLengths() == parameters.m_nCellRadiationLengths.Get());
+    PANDORA_TEST_CHECK(pCaloHit->GetNCellInteractionLengths() == parameters.m_nCellInteractionLengths.Get());
+    PANDORA_TEST_CHECK(pCaloHit->GetTime() == parameters.m_time.Get());
+    PANDORA_TEST_CHECK(pCaloHit->IsDigital() == parameters.m_isDigital.Get());
+    PANDORA_TEST_CHECK(pCaloHit->GetHitType() == parameters.m_hitType.Get());
+    PANDORA_TEST_CHECK(pCaloHit->GetHitRegion() == parameters.m_hitRegion.Get());
+    PANDORA_TEST_CHECK(pCaloHit->GetLayer() == parameters.m_layer.Get());
+    PANDORA_TEST_CHECK(pCaloHit->IsInOuterSamplingLayer() == parameters.m_isInOuterSamplingLayer.Get());
+    PANDORA_TEST_CHECK(pCaloHit->GetParentAddress() == parameters.m_pParentAddress.Get());
+    PANDORA_TEST_CHECK(TestHelper::IsClose(pCaloHit->GetWeight(), weight, 1.e-6));
+    PANDORA_TEST_CHECK(TestHelper::IsClose(pCaloHit->GetInputEnergy(), weight * parameters.m_inputEnergy.Get(), 1.e-6));
+    PANDORA_TEST_CHECK(TestHelper::IsClose(pCaloHit->GetMipEquivalentEnergy(), weight * parameters.m_mipEquivalentEnergy.Get(), 1.e-6));
+    PANDORA_TEST_CHECK(TestHelper::IsClose(pCaloHit->GetElectromagneticEnergy(), weight * parameters.m_electromagneticEnergy.Get(), 1.e-6));
+    PANDORA_TEST_CHECK(TestHelper::IsClose(pCaloHit->GetHadronicEnergy(), weight * parameters.m_hadronicEnergy.Get(), 1.e-6));
+
+    if (RECTANGULAR == parameters.m_cellGeometry.Get())
+    {
+        PANDORA_TEST_CHECK(TestHelper::IsClose(pCaloHit->GetCellLengthScale(), std::sqrt(parameters.m_cellSize0.Get() *
+            parameters.m_cellSize1.Get()), 1.e-6));
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test calo hit properties, for input calo hits, calo hit fragments and calo hits with altered metadata
+ */
+void TestCaloHits()
+{
+    std::mt19937 generator(26);
+    std::uniform_real_distribution<float> distribution(0.f, 1.f);
+    const unsigned int nCaloHits(200);
+    std::vector<PandoraApi::CaloHit::Parameters> parametersVector;
+    int mcParticleAddress(0);
+
+    // The parent address identifies the parameters for each calo hit, so the parameters vector must not be reallocated
+    parametersVector.reserve(nCaloHits);
+
+    for (unsigned int iCaloHit = 0; iCaloHit < nCaloHits; ++iCaloHit)
+    {
+        parametersVector.push_back(TestHelper::GetCaloHitParameters(CartesianVector(1000.f * distribution(generator),
+            1000.f * distribution(generator), 1000.f * distribution(generator)), (0 == iCaloHit % 2) ? ECAL : HCAL, nullptr));
+
+        PandoraApi::CaloHit::Parameters &parameters(parametersVector.back());
+        parameters.m_expectedDirection = CartesianVector(distribution(generator), distribution(generator), 1.f).GetUnitVector();
+        parameters.m_cellNormalVector = CartesianVector(distribution(generator), 1.f, distribution(generator)).GetUnitVector();
+        parameters.m_cellGeometry = (0 == iCaloHit % 3) ? POINTING : RECTANGULAR;
+        parameters.m_cellSize0 = 1.f + distribution(generator);
+        parameters.m_cellSize1 = 2.f + distribution(generator);
+        parameters.m_cellThickness = 3.f + distribution(generator);
+        parameters.m_nCellRadiationLengths = 4.f + distribution(generator);
+        parameters.m_nCellInteractionLengths = 5.f + distribution(generator);
+        parameters.m_time = 6.f + distribution(generator);
+        parameters.m_inputEnergy = 7.f + distribution(generator);
+        parameters.m_mipEquivalentEnergy = 8.f + distribution(generator);
+        parameters.m_electromagneticEnergy = 9.f + distribution(generator);
+        parameters.m_hadronicEnergy = 10.f + distribution(generator);
+        parameters.m_isDigital = (0 == iCaloHit % 5);
+        parameters.m_hitRegion = (0 == iCaloHit % 7) ? ENDCAP : BARREL;
+        parameters.m_layer = iCaloHit % 11;
+        parameters.m_isInOuterSamplingLayer = (0 == iCaloHit % 13);
+        parameters.m_pParentAddress = &parameters;
+    }
+
+    const Pandora *const pPandora(TestHelper::CreatePandora([&](const Algorithm &algorithm) -> StatusCode
+    {
+        const CaloHitList *pCaloHitList(nullptr);
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::GetCurrentList(algorithm, pCaloHitList));
+        PANDORA_TEST_CHECK(nCaloHits == pCaloHitList->size());
+
+        for (const CaloHit *const pCaloHit : *pCaloHitList)
+        {
+            const PandoraApi::CaloHit::Parameters &parameters(
+                *static_cast<const PandoraApi::CaloHit::Parameters *>(pCaloHit->GetParentAddress()));
+            CheckCaloHit(pCaloHit, parameters, 1.f);
+
+            const MCParticleWeightMap &mcParticleWeightMap(pCaloHit->GetMCParticleWeightMap());
+            PANDORA_TEST_CHECK((1 == mcParticleWeightMap.size()) && (0.5f == mcParticleWeightMap.begin()->second));
+            PANDORA_TEST_CHECK(!pCaloHit->IsPossibleMip() && !pCaloHit->IsIsolated());
+            PANDORA_TEST_CHECK(PandoraContentApi::IsAvailable(algorithm, pCaloHit));
+        }
+
+        // Fragments copy the original calo hit cold data, scaling the mc particle weights
+        const CaloHit *const pOriginalCaloHit(pCaloHitList->front());
+        const PandoraApi::CaloHit::Parameters &originalParameters(
+            *static_cast<const PandoraApi::CaloHit::Parameters *>(pOriginalCaloHit->GetParentAddress()));
+
+        const CaloHit *pDaughterCaloHit1(nullptr), *pDaughterCaloHit2(nullptr);
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::Fragment(algorithm, pOriginalCaloHit, 0.25f, pDaughterCaloHit1,
+            pDaughterCaloHit2));
+        CheckCaloHit(pDaughterCaloHit1, originalParameters, 0.25f);
+        CheckCaloHit(pDaughterCaloHit2, originalParameters, 0.75f);
+        PANDORA_TEST_CHECK(0.125f == pDaughterCaloHit1->GetMCParticleWeightMap().begin()->second);
+        PANDORA_TEST_CHECK(0.375f == pDaughterCaloHit2->GetMCParticleWeightMap().begin()->second);
+
+        // Merging the fragments restores the original calo hit properties
+        const CaloHit *pMergedCaloHit(nullptr);
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::MergeFragments(algorithm, pDaughterCaloHit1, pDaughterCaloHit2,
+            pMergedCaloHit));
+        CheckCaloHit(pMergedCaloHit, originalParameters, 1.f);
+        PANDORA_TEST_CHECK(0.5f == pMergedCaloHit->GetMCParticleWeightMap().begin()->second);
+
+        // Altering the metadata of one calo hit does not affect the others
+        PandoraContentApi::CaloHit::Metadata metadata;
+        metadata.m_x0 = 5.f;
+        metadata.m_isPossibleMip = true;
+        metadata.m_isIsolated = true;
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::CaloHit::AlterMetadata(algorithm, pMergedCaloHit, metadata));
+
+        PANDORA_TEST_CHECK(5.f == pMergedCaloHit->GetX0());
+        PANDORA_TEST_CHECK(pMergedCaloHit->GetPositionVector() == originalParameters.m_positionVector.Get() +
+            CartesianVector(5.f, 0.f, 0.f));
+        PANDORA_TEST_CHECK(pMergedCaloHit->IsPossibleMip() && pMergedCaloHit->IsIsolated());
+
+        for (const CaloHit *const pCaloHit : *pCaloHitList)
+        {
+            if (pCaloHit != pMergedCaloHit)
+                PANDORA_TEST_CHECK((0.f == pCaloHit->GetX0()) && !pCaloHit->IsPossibleMip() && !pCaloHit->IsIsolated());
+        }
+
+        return STATUS_CODE_SUCCESS;
+    }));
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::MCParticle::Create(*pPandora, TestHelper::GetMCParticleParameters(22, 10.f,
+        CartesianVector(0.f, 0.f, 0.f), &mcParticleAddress)));
+
+    for (const PandoraApi::CaloHit::Parameters &parameters : parametersVector)
+    {
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::CaloHit::Create(*pPandora, parameters));
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetCaloHitToMCParticleRelationship(*pPandora,
+            parameters.m_pParentAddress.Get(), &mcParticleAddress, 0.5f));
+    }
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::ProcessEvent(*pPandora));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Reset(*pPandora));
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    TestCaloHits();
+
+    return TestHelper::Finish("CaloHitTest");
+}
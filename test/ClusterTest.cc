@@ -0,0 +1,218 @@
+/**
+ *  @file   PandoraSDK/test/ClusterTest.cc
+ * 
+ *  @brief  Test the cluster pseudo layer centroids and typical layer hit types against sums recalculated from the cluster calo hits,
+ *          as calo hits are added, removed and merged.
+ * 
+ *  $Log: $
+ */
+
+#include "Pandora/AlgorithmHeaders.h"
+
+#include "TestHelper.h"
+#include "TestPlugins.h"
+
+#include <random>
+
+using namespace pandora;
+using namespace pandora_test;
+
+/**
+ *  @brief  Check the pseudo layer range, centroids and typical layer hit types of a cluster against its calo hits
+ * 
+ *  @param  pCluster the address of the cluster
+ */
+void CheckCluster(const Cluster *const pCluster)
+{
+    const OrderedCaloHitList &orderedCaloHitList(pCluster->GetOrderedCaloHitList());
+    PANDORA_TEST_CHECK(!orderedCaloHitList.empty());
+
+    if (orderedCaloHitList.empty())
+        return;
+
+    const unsigned int innerPseudoLayer(orderedCaloHitList.begin()->first), outerPseudoLayer(orderedCaloHitList.rbegin()->first);
+    PANDORA_TEST_CHECK((innerPseudoLayer == pCluster->GetInnerPseudoLayer()) && (outerPseudoLayer == pCluster->GetOuterPseudoLayer()));
+
+    for (unsigned int pseudoLayer = innerPseudoLayer; pseudoLayer <= outerPseudoLayer; ++pseudoLayer)
+    {
+        OrderedCaloHitList::const_iterator layerIter(orderedCaloHitList.find(pseudoLayer));
+
+        if (orderedCaloHitList.end() == layerIter)
+        {
+            PANDORA_TEST_CHECK(STATUS_CODE_FAILURE == TestHelper::GetStatusCode([&]() -> StatusCode
+            {
+                pCluster->GetCentroid(pseudoLayer);
+                return STATUS_CODE_SUCCESS;
+            }));
+            continue;
+        }
+
+        double xSum(0.), ySum(0.), zSum(0.);
+
+        for (const CaloHit *const pCaloHit : *layerIter->second)
+        {
+            xSum += pCaloHit->GetPositionVector().GetX();
+            ySum += pCaloHit->GetPositionVector().GetY();
+            zSum += pCaloHit->GetPositionVector().GetZ();
+        }
+
+        const double nHits(static_cast<double>(layerIter->second->size()));
+        const CartesianVector centroid(pCluster->GetCentroid(pseudoLayer));
+        PANDORA_TEST_CHECK(TestHelper::IsClose(centroid.GetX(), xSum / nHits, 1.e-5) &&
+            TestHelper::IsClose(centroid.GetY(), ySum / nHits, 1.e-5) && TestHelper::IsClose(centroid.GetZ(), zSum / nHits, 1.e-5));
+    }
+
+    for (const unsigned int pseudoLayer : {innerPseudoLayer - 1, outerPseudoLayer + 1})
+    {
+        PANDORA_TEST_CHECK(STATUS_CODE_FAILURE == TestHelper::GetStatusCode([&]() -> StatusCode
+        {
+            pCluster->GetCentroid(pseudoLayer);
+            return STATUS_CODE_SUCCESS;
+        }));
+    }
+
+    // The typical layer hit type has the highest summed hadronic energy, the lowest hit type winning ties
+    for (const unsigned int pseudoLayer : {innerPseudoLayer, outerPseudoLayer})
+    {
+        double hitTypeEnergies[N_HIT_TYPES] = {};
+
+        for (const CaloHit *const pCaloHit : *orderedCaloHitList.find(pseudoLayer)->second)
+            hitTypeEnergies[pCaloHit->GetHitType()] += pCaloHit->GetHadronicEnergy();
+
+        unsigned int expectedHitType(0);
+
+        for (unsigned int hitType = 1; hitType < N_HIT_TYPES; ++hitType)
+        {
+            if (hitTypeEnergies[hitType] > hitTypeEnergies[expectedHitType])
+                expectedHitType = hitType;
+        }
+
+        const HitType layerHitType((pseudoLayer == innerPseudoLayer) ? pCluster->GetInnerLayerHitType() : pCluster->GetOuterLayerHitType());
+        PANDORA_TEST_CHECK(expectedHitType == static_cast<unsigned int>(layerHitType));
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Cluster the input calo hits randomly, then check the clusters as calo hits are moved between them and clusters are merged
+ * 
+ *  @param  algorithm the calling algorithm
+ * 
+ *  @return the status code
+ */
+StatusCode CheckClusters(const Algorithm &algorithm)
+{
+    const CaloHitList *pCaloHitList(nullptr);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::GetCurrentList(algorithm, pCaloHitList));
+
+    std::mt19937 generator(40);
+    const unsigned int nClusters(20);
+    std::vector<CaloHitList> clusterCaloHitLists(nClusters);
+
+    for (const CaloHit *const pCaloHit : *pCaloHitList)
+        clusterCaloHitLists[generator() % nClusters].push_back(pCaloHit);
+
+    const ClusterList *pClusterList(nullptr);
+    std::string clusterListName;
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::CreateTemporaryListAndSetCurrent(algorithm, pClusterList,
+        clusterListName));
+
+    ClusterVector clusterVector;
+
+    for (const CaloHitList &caloHitList : clusterCaloHitLists)
+    {
+        PandoraContentApi::Cluster::Parameters parameters;
+        parameters.m_caloHitList = caloHitList;
+
+        const Cluster *pCluster(nullptr);
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::Cluster::Create(algorithm, parameters, pCluster));
+        clusterVector.push_back(pCluster);
+        CheckCluster(pCluster);
+    }
+
+    // Move calo hits between clusters, so that inner and outer pseudo layers are emptied and extended, then merge clusters
+    for (unsigned int iMove = 0; iMove < 2000; ++iMove)
+    {
+        const Cluster *const pSourceCluster(clusterVector[generator() % clusterVector.size()]);
+        const Cluster *const pTargetCluster(clusterVector[generator() % clusterVector.size()]);
+
+        if ((pSourceCluster == pTargetCluster) || (pSourceCluster->GetNCaloHits() < 2))
+            continue;
+
+        // Calo hits are taken preferentially from the inner and outer pseudo layers of the source cluster
+        const OrderedCaloHitList &orderedCaloHitList(pSourceCluster->GetOrderedCaloHitList());
+        const CaloHitList &layerCaloHitList((0 == generator() % 2) ? *orderedCaloHitList.begin()->second :
+            (0 == generator() % 2) ? *orderedCaloHitList.rbegin()->second : *std::next(orderedCaloHitList.begin(),
+            generator() % orderedCaloHitList.size())->second);
+        const CaloHit *const pCaloHit(layerCaloHitList.front());
+
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::RemoveFromCluster(algorithm, pSourceCluster, pCaloHit));
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::AddToCluster(algorithm, pTargetCluster, pCaloHit));
+
+        // Access the typical layer hit types before the next change, so that their invalidation is checked too
+        if (0 == iMove % 50)
+        {
+            for (const Cluster *const pCluster : clusterVector)
+                CheckCluster(pCluster);
+        }
+    }
+
+    while (clusterVector.size() > 1)
+    {
+        const Cluster *const pClusterToDelete(clusterVector.back());
+        clusterVector.pop_back();
+        const Cluster *const pClusterToEnlarge(clusterVector[generator() % clusterVector.size()]);
+
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::MergeAndDeleteClusters(algorithm, pClusterToEnlarge,
+            pClusterToDelete));
+        CheckCluster(pClusterToEnlarge);
+    }
+
+    PANDORA_TEST_CHECK(pCaloHitList->size() == clusterVector.front()->GetNCaloHits());
+    PANDORA_TEST_CHECK(clusterVector.front()->GetOuterPseudoLayer() > clusterVector.front()->GetInnerPseudoLayer() + 10);
+
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::SaveList<Cluster>(algorithm, clusterListName, "TestClusters"));
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test the cluster pseudo layer sums, for calo hits of several hit types spread over many pseudo layers
+ */
+void TestClusters()
+{
+    const Pandora *const pPandora(TestHelper::CreatePandora(CheckClusters));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetPseudoLayerPlugin(*pPandora, new TestPseudoLayerPlugin(10.f)));
+
+    std::mt19937 generator(41);
+    std::uniform_real_distribution<float> distribution(-100.f, 100.f);
+    const std::vector<HitType> hitTypes{TRACKER, ECAL, HCAL, MUON, HIT_CUSTOM};
+    const unsigned int nCaloHits(1000);
+    std::vector<int> caloHitAddresses(nCaloHits);
+
+    for (unsigned int iCaloHit = 0; iCaloHit < nCaloHits; ++iCaloHit)
+    {
+        // Hadronic energies are multiples of 0.25, so that ties between hit types are exact
+        PandoraApi::CaloHit::Parameters parameters(TestHelper::GetCaloHitParameters(CartesianVector(distribution(generator),
+            distribution(generator), distribution(generator)), hitTypes[generator() % hitTypes.size()], &caloHitAddresses[iCaloHit]));
+        parameters.m_hadronicEnergy = 0.25f * (1 + generator() % 4);
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::CaloHit::Create(*pPandora, parameters));
+    }
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::ProcessEvent(*pPandora));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Reset(*pPandora));
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    TestClusters();
+
+    return TestHelper::Finish("ClusterTest");
+}
@@ -0,0 +1,259 @@
+/**
+ *  @file   PandoraSDK/test/DetectorGapIndexTest.cc
+ * 
+ *  @brief  Test of the detector gap index, comparing indexed gap queries with tests against each gap in turn.
+ * 
+ *  $Log: $
+ */
+
+#include "Api/PandoraApi.h"
+
+#include "Geometry/DetectorGap.h"
+
+#include "Managers/GeometryManager.h"
+
+#include "TestHelper.h"
+
+#include <random>
+
+using namespace pandora;
+using namespace pandora_test;
+
+/**
+ *  @brief  Whether a position lies within any gap, testing each gap in turn
+ * 
+ *  @param  pandora the pandora instance
+ *  @param  positionVector the position vector
+ *  @param  hitType the hit type
+ *  @param  gapTolerance the gap tolerance
+ * 
+ *  @return boolean
+ */
+bool IsInAnyGap(const Pandora &pandora, const CartesianVector &positionVector, const HitType hitType, const float gapTolerance)
+{
+    for (const DetectorGap *const pDetectorGap : pandora.GetGeometry()->GetDetectorGapList())
+    {
+        if (pDetectorGap->IsInGap(positionVector, hitType, gapTolerance))
+            return true;
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Compare the indexed gap queries, single position and batch, with tests against each gap in turn
+ * 
+ *  @param  pandora the pandora instance
+ *  @param  xCoordinates the position x coordinates
+ *  @param  yCoordinates the position y coordinates
+ *  @param  zCoordinates the position z coordinates
+ *  @param  hitType the hit type
+ *  @param  gapTolerance the gap tolerance
+ */
+void CompareWithScalar(const Pandora &pandora, const FloatVector &xCoordinates, const FloatVector &yCoordinates,
+    const FloatVector &zCoordinates, const HitType hitType, const float gapTolerance)
+{
+    const GeometryManager *const pGeometryManager(pandora.GetGeometry());
+
+    BoolVector isInGapVector;
+    pGeometryManager->IsInGap(xCoordinates, yCoordinates, zCoordinates, hitType, gapTolerance, isInGapVector);
+    PANDORA_TEST_CHECK(isInGapVector.size() == xCoordinates.size());
+
+    CartesianPointVector positionVectors;
+
+    for (unsigned int index = 0; index < xCoordinates.size(); ++index)
+        positionVectors.emplace_back(xCoordinates[index], yCoordinates[index], zCoordinates[index]);
+
+    BoolVector isInGapPointVector;
+    pGeometryManager->IsInGap(positionVectors, hitType, gapTolerance, isInGapPointVector);
+    PANDORA_TEST_CHECK(isInGapPointVector.size() == positionVectors.size());
+
+    for (unsigned int index = 0; (index < positionVectors.size()) && (index < isInGapVector.size()); ++index)
+    {
+        const bool isInGap(IsInAnyGap(pandora, positionVectors[index], hitType, gapTolerance));
+        PANDORA_TEST_CHECK(isInGap == isInGapVector[index]);
+        PANDORA_TEST_CHECK(isInGap == isInGapPointVector[index]);
+        PANDORA_TEST_CHECK(isInGap == pGeometryManager->IsInGap(positionVectors[index], hitType, gapTolerance));
+    }
+
+    for (const DetectorGap *const pDetectorGap : pGeometryManager->GetDetectorGapList())
+    {
+        BoolVector isInThisGapVector;
+        pDetectorGap->IsInGap(xCoordinates, yCoordinates, zCoordinates, hitType, gapTolerance, isInThisGapVector);
+        PANDORA_TEST_CHECK(isInThisGapVector.size() == positionVectors.size());
+
+        for (unsigned int index = 0; (index < positionVectors.size()) && (index < isInThisGapVector.size()); ++index)
+            PANDORA_TEST_CHECK(isInThisGapVector[index] == pDetectorGap->IsInGap(positionVectors[index], hitType, gapTolerance));
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test the line gap interval tables
+ */
+void TestLineGaps()
+{
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+
+    const Pandora *const pPandora(new Pandora());
+    const LineGapType lineGapTypes[4] = {TPC_WIRE_GAP_VIEW_U, TPC_WIRE_GAP_VIEW_V, TPC_WIRE_GAP_VIEW_W, TPC_DRIFT_GAP};
+
+    for (unsigned int iGap = 0; iGap < 400; ++iGap)
+    {
+        const float startX(1000.f * distribution(generator)), startZ(1000.f * distribution(generator));
+
+        PandoraApi::Geometry::LineGap::Parameters parameters;
+        parameters.m_lineGapType = lineGapTypes[iGap % 4];
+        parameters.m_lineStartX = startX;
+        parameters.m_lineEndX = startX + 3.f * (1.f + distribution(generator));
+        parameters.m_lineStartZ = startZ;
+        parameters.m_lineEndZ = startZ + 2.f * (1.f + distribution(generator));
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Geometry::LineGap::Create(*pPandora, parameters));
+    }
+
+    FloatVector xCoordinates, yCoordinates, zCoordinates;
+
+    for (unsigned int iPosition = 0; iPosition < 2001; ++iPosition)
+    {
+        xCoordinates.push_back(1000.f * distribution(generator));
+        yCoordinates.push_back(0.f);
+        zCoordinates.push_back(1000.f * distribution(generator));
+    }
+
+    for (const float gapTolerance : {0.f, 0.5f, 3.f, -0.5f})
+    {
+        for (const HitType hitType : {TPC_VIEW_U, TPC_VIEW_V, TPC_VIEW_W, TPC_3D})
+            CompareWithScalar(*pPandora, xCoordinates, yCoordinates, zCoordinates, hitType, gapTolerance);
+    }
+
+    // Line gaps reject calorimeter hit types, as does the scalar query, and the coordinate arrays must have equal sizes
+    BoolVector isInGapVector;
+    PANDORA_TEST_CHECK(STATUS_CODE_INVALID_PARAMETER == TestHelper::GetStatusCode([&]() -> StatusCode
+    {
+        pPandora->GetGeometry()->IsInGap(CartesianVector(xCoordinates.front(), 0.f, zCoordinates.front()), ECAL, 0.f);
+        return STATUS_CODE_SUCCESS;
+    }));
+    PANDORA_TEST_CHECK(STATUS_CODE_INVALID_PARAMETER == TestHelper::GetStatusCode([&]() -> StatusCode
+    {
+        pPandora->GetGeometry()->IsInGap(xCoordinates, yCoordinates, zCoordinates, ECAL, 0.f, isInGapVector);
+        return STATUS_CODE_SUCCESS;
+    }));
+
+    const FloatVector shortYCoordinates(3, 0.f);
+    PANDORA_TEST_CHECK(STATUS_CODE_INVALID_PARAMETER == TestHelper::GetStatusCode([&]() -> StatusCode
+    {
+        pPandora->GetGeometry()->IsInGap(xCoordinates, shortYCoordinates, zCoordinates, TPC_3D, 0.f, isInGapVector);
+        return STATUS_CODE_SUCCESS;
+    }));
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test the box and concentric gap bounding volume hierarchy
+ */
+void TestVolumeGaps()
+{
+    std::mt19937 generator(2);
+    std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+
+    const Pandora *const pPandora(new Pandora());
+
+    for (unsigned int iGap = 0; iGap < 200; ++iGap)
+    {
+        CartesianVector side1(distribution(generator), distribution(generator), distribution(generator));
+        CartesianVector side2(distribution(generator), distribution(generator), distribution(generator));
+        side1 = side1.GetUnitVector();
+        side2 = (side2 - side1 * side1.GetDotProduct(side2)).GetUnitVector();
+        CartesianVector side3(side1.GetCrossProduct(side2));
+
+        // Include skewed and degenerate boxes, which the batch and indexed queries must treat as the scalar query does
+        if (0 == iGap % 3)
+        {
+            side2 = (side2 + side1 * 0.5f).GetUnitVector();
+            side3 = (side3 + side2 * 0.3f).GetUnitVector();
+        }
+
+        if (0 == iGap % 50)
+        {
+            side1 = CartesianVector(1.f, 0.f, 0.f);
+            side2 = side1;
+            side3 = CartesianVector(0.f, 0.f, 1.f);
+        }
+
+        PandoraApi::Geometry::BoxGap::Parameters parameters;
+        parameters.m_vertex = CartesianVector(400.f * distribution(generator), 400.f * distribution(generator),
+            400.f * distribution(generator));
+        parameters.m_side1 = side1 * (20.f + 50.f * (1.f + distribution(generator)));
+        parameters.m_side2 = side2 * (20.f + 50.f * (1.f + distribution(generator)));
+        parameters.m_side3 = side3 * (5.f + 5.f * (1.f + distribution(generator)));
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Geometry::BoxGap::Create(*pPandora, parameters));
+    }
+
+    for (unsigned int iGap = 0; iGap < 20; ++iGap)
+    {
+        const float minZ(400.f * distribution(generator)), innerR(200.f + 100.f * distribution(generator));
+
+        PandoraApi::Geometry::ConcentricGap::Parameters parameters;
+        parameters.m_minZCoordinate = minZ;
+        parameters.m_maxZCoordinate = minZ + 30.f;
+        parameters.m_innerRCoordinate = innerR;
+        parameters.m_innerPhiCoordinate = distribution(generator);
+        parameters.m_innerSymmetryOrder = 1 + iGap % 12;
+        parameters.m_outerRCoordinate = innerR + 50.f;
+        parameters.m_outerPhiCoordinate = distribution(generator);
+        parameters.m_outerSymmetryOrder = (7 == iGap) ? 2 : 3 + iGap % 9;
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Geometry::ConcentricGap::Create(*pPandora, parameters));
+    }
+
+    FloatVector xCoordinates, yCoordinates, zCoordinates;
+
+    for (unsigned int iPosition = 0; iPosition < 3001; ++iPosition)
+    {
+        xCoordinates.push_back(450.f * distribution(generator));
+        yCoordinates.push_back(450.f * distribution(generator));
+        zCoordinates.push_back(450.f * distribution(generator));
+    }
+
+    for (const float gapTolerance : {0.f, 2.f, 10.f, -2.f, -20.f})
+    {
+        for (const HitType hitType : {TPC_3D, ECAL})
+            CompareWithScalar(*pPandora, xCoordinates, yCoordinates, zCoordinates, hitType, gapTolerance);
+    }
+
+    // Compact trajectories, spanning several of the position blocks tested together against the hierarchy
+    for (unsigned int iTrajectory = 0; iTrajectory < 50; ++iTrajectory)
+    {
+        const CartesianVector start(400.f * distribution(generator), 400.f * distribution(generator), 400.f * distribution(generator));
+        const CartesianVector step(distribution(generator), distribution(generator), distribution(generator));
+        FloatVector trajectoryXCoordinates, trajectoryYCoordinates, trajectoryZCoordinates;
+
+        for (unsigned int iPosition = 0; iPosition < 200; ++iPosition)
+        {
+            const CartesianVector position(start + step * static_cast<float>(iPosition));
+            trajectoryXCoordinates.push_back(position.GetX());
+            trajectoryYCoordinates.push_back(position.GetY());
+            trajectoryZCoordinates.push_back(position.GetZ());
+        }
+
+        CompareWithScalar(*pPandora, trajectoryXCoordinates, trajectoryYCoordinates, trajectoryZCoordinates, ECAL, 1.f);
+    }
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    TestLineGaps();
+    TestVolumeGaps();
+
+    return TestHelper::Finish("DetectorGapIndexTest");
+}
@@ -0,0 +1,216 @@
+/**
+ *  @file   PandoraSDK/test/DetectorVolumeIndexTest.cc
+ * 
+ *  @brief  Test of the detector volume index, comparing indexed lar tpc and sub detector containment queries with brute force searches.
+ * 
+ *  $Log: $
+ */
+
+#include "Api/PandoraApi.h"
+
+#include "Geometry/LArTPC.h"
+#include "Geometry/SubDetector.h"
+
+#include "Managers/GeometryManager.h"
+
+#include "TestHelper.h"
+
+#include <random>
+
+using namespace pandora;
+using namespace pandora_test;
+
+/**
+ *  @brief  Get the lar tpcs whose boxes, expanded by a tolerance, contain a position, testing each lar tpc in turn
+ * 
+ *  @param  pandora the pandora instance
+ *  @param  positionVector the position vector
+ *  @param  tolerance the tolerance
+ *  @param  larTPCVector to receive the containing lar tpcs, in order of volume id
+ */
+void GetContainingLArTPCs(const Pandora &pandora, const CartesianVector &positionVector, const float tolerance, LArTPCVector &larTPCVector)
+{
+    larTPCVector.clear();
+
+    for (const LArTPCMap::value_type &mapEntry : pandora.GetGeometry()->GetLArTPCMap())
+    {
+        const LArTPC *const pLArTPC(mapEntry.second);
+        const float halfWidthX(0.5f * pLArTPC->GetWidthX() + tolerance), halfWidthY(0.5f * pLArTPC->GetWidthY() + tolerance);
+        const float halfWidthZ(0.5f * pLArTPC->GetWidthZ() + tolerance);
+
+        const float centerX(pLArTPC->GetCenterX()), centerY(pLArTPC->GetCenterY()), centerZ(pLArTPC->GetCenterZ());
+
+        if ((positionVector.GetX() >= centerX - halfWidthX) && (positionVector.GetX() <= centerX + halfWidthX) &&
+            (positionVector.GetY() >= centerY - halfWidthY) && (positionVector.GetY() <= centerY + halfWidthY) &&
+            (positionVector.GetZ() >= centerZ - halfWidthZ) && (positionVector.GetZ() <= centerZ + halfWidthZ))
+        {
+            larTPCVector.push_back(pLArTPC);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test the lar tpc bounding volume hierarchy against a brute force search
+ */
+void TestLArTPCs()
+{
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+
+    const Pandora *const pPandora(new Pandora());
+    const GeometryManager *const pGeometryManager(pPandora->GetGeometry());
+
+    // ATTN Volume ids decrease along the grid, so that the lowest volume id is not simply the first lar tpc created
+    unsigned int volumeId(1000);
+
+    for (unsigned int i = 0; i < 10; ++i)
+    {
+        for (unsigned int j = 0; j < 5; ++j)
+        {
+            for (unsigned int k = 0; k < 12; ++k)
+            {
+                const CartesianVector center(-1000.f + 200.f * i, -500.f + 200.f * j, 200.f * k);
+                PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Geometry::LArTPC::Create(*pPandora,
+                    TestHelper::GetLArTPCParameters(volumeId--, center, 200.f)));
+            }
+        }
+    }
+
+    CartesianPointVector positionVectors;
+
+    for (unsigned int iPosition = 0; iPosition < 20000; ++iPosition)
+    {
+        positionVectors.emplace_back(1200.f * distribution(generator), 700.f * distribution(generator),
+            1300.f + 1400.f * distribution(generator));
+    }
+
+    // Positions on the shared faces of adjacent lar tpcs
+    for (unsigned int iPosition = 0; iPosition < 2000; ++iPosition)
+        positionVectors.emplace_back(-1100.f + 200.f * (iPosition % 12), 100.f * distribution(generator), 100.f * (iPosition % 30));
+
+    for (const float tolerance : {0.f, 1.f, 20.f, -1.f, -20.f})
+    {
+        LArTPCVector batchLArTPCVector;
+        pGeometryManager->GetContainingLArTPCBatch(positionVectors, tolerance, batchLArTPCVector);
+        PANDORA_TEST_CHECK(batchLArTPCVector.size() == positionVectors.size());
+
+        for (unsigned int index = 0; (index < positionVectors.size()) && (index < batchLArTPCVector.size()); ++index)
+        {
+            LArTPCVector bruteForceLArTPCVector, indexedLArTPCVector;
+            GetContainingLArTPCs(*pPandora, positionVectors[index], tolerance, bruteForceLArTPCVector);
+            pGeometryManager->GetContainingLArTPCs(positionVectors[index], tolerance, indexedLArTPCVector);
+
+            const LArTPC *const pFirstLArTPC(bruteForceLArTPCVector.empty() ? nullptr : bruteForceLArTPCVector.front());
+            PANDORA_TEST_CHECK(bruteForceLArTPCVector == indexedLArTPCVector);
+            PANDORA_TEST_CHECK(pFirstLArTPC == pGeometryManager->GetContainingLArTPC(positionVectors[index], tolerance));
+            PANDORA_TEST_CHECK(pFirstLArTPC == batchLArTPCVector[index]);
+        }
+    }
+
+    // A negative tolerance shrinks the lar tpc boxes, and a tolerance beyond the half width leaves no position contained
+    PANDORA_TEST_CHECK(nullptr != pGeometryManager->GetContainingLArTPC(CartesianVector(-1095.f, 0.f, 0.f)));
+    PANDORA_TEST_CHECK(nullptr == pGeometryManager->GetContainingLArTPC(CartesianVector(-1095.f, 0.f, 0.f), -10.f));
+    PANDORA_TEST_CHECK(nullptr != pGeometryManager->GetContainingLArTPC(CartesianVector(-1105.f, 0.f, 0.f), 10.f));
+    PANDORA_TEST_CHECK(nullptr == pGeometryManager->GetContainingLArTPC(CartesianVector(-1000.f, -500.f, 0.f), -150.f));
+
+    // The index is rebuilt to include lar tpcs created after the first query
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Geometry::LArTPC::Create(*pPandora,
+        TestHelper::GetLArTPCParameters(5000, CartesianVector(5000.f, 0.f, 0.f), 10.f)));
+    const LArTPC *const pLArTPC(pGeometryManager->GetContainingLArTPC(CartesianVector(5000.f, 0.f, 0.f)));
+    PANDORA_TEST_CHECK(pLArTPC && (5000 == pLArTPC->GetLArTPCVolumeId()));
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test the sub detector bounding volume hierarchy against SubDetector::IsInSubDetector for each sub detector in turn
+ */
+void TestSubDetectors()
+{
+    std::mt19937 generator(4);
+    std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+
+    const Pandora *const pPandora(new Pandora());
+    const GeometryManager *const pGeometryManager(pPandora->GetGeometry());
+
+    const auto createSubDetector = [pPandora](PandoraApi::Geometry::SubDetector::Parameters parameters, const bool isMirroredInZ)
+    {
+        parameters.m_isMirroredInZ = isMirroredInZ;
+        return PandoraApi::Geometry::SubDetector::Create(*pPandora, parameters);
+    };
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == createSubDetector(TestHelper::GetSubDetectorParameters("Tracker", INNER_TRACKER,
+        0.f, 0.f, 0, 1800.f, 2300.f, 0), true));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == createSubDetector(TestHelper::GetSubDetectorParameters("ECalBarrel", ECAL_BARREL,
+        1800.f, 0.f, 8, 2000.f, 2400.f, 8), true));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == createSubDetector(TestHelper::GetSubDetectorParameters("ECalEndCap", ECAL_ENDCAP,
+        300.f, 2400.f, 4, 2000.f, 2600.f, 8), true));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == createSubDetector(TestHelper::GetSubDetectorParameters("HCalBarrel", HCAL_BARREL,
+        2100.f, 0.f, 16, 3300.f, 2600.f, 12), true));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == createSubDetector(TestHelper::GetSubDetectorParameters("HCalEndCap", HCAL_ENDCAP,
+        300.f, 2650.f, 12, 3300.f, 3800.f, 12), true));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == createSubDetector(TestHelper::GetSubDetectorParameters("MuonBarrel", MUON_BARREL,
+        3500.f, -4000.f, 12, 5000.f, 4000.f, 12), false));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == createSubDetector(TestHelper::GetSubDetectorParameters("Degenerate", SUB_DETECTOR_OTHER,
+        0.f, 0.f, 0, 100.f, 10.f, 2), false));
+
+    // Sub detector types beyond the end of the type table are rejected
+    const SubDetectorType badSubDetectorType(static_cast<SubDetectorType>(SUB_DETECTOR_OTHER + 1));
+    PANDORA_TEST_CHECK(STATUS_CODE_OUT_OF_RANGE == createSubDetector(TestHelper::GetSubDetectorParameters("BadType", badSubDetectorType,
+        0.f, 0.f, 0, 1.f, 1.f, 0), false));
+    PANDORA_TEST_CHECK(0 == pGeometryManager->GetSubDetectorMap().count("BadType"));
+
+    CartesianPointVector positionVectors;
+
+    for (unsigned int iPosition = 0; iPosition < 30000; ++iPosition)
+        positionVectors.emplace_back(5200.f * distribution(generator), 5200.f * distribution(generator), 4500.f * distribution(generator));
+
+    for (const float tolerance : {0.f, 1.f, 25.f, 150.f, -10.f, -150.f})
+    {
+        SubDetectorVector batchSubDetectorVector;
+        pGeometryManager->GetContainingSubDetectorBatch(positionVectors, tolerance, batchSubDetectorVector);
+        PANDORA_TEST_CHECK(batchSubDetectorVector.size() == positionVectors.size());
+
+        for (unsigned int index = 0; (index < positionVectors.size()) && (index < batchSubDetectorVector.size()); ++index)
+        {
+            const SubDetector *pFirstSubDetector(nullptr);
+
+            for (const SubDetectorMap::value_type &mapEntry : pGeometryManager->GetSubDetectorMap())
+            {
+                if (mapEntry.second->IsInSubDetector(positionVectors[index], tolerance))
+                {
+                    pFirstSubDetector = mapEntry.second;
+                    break;
+                }
+            }
+
+            PANDORA_TEST_CHECK(pFirstSubDetector == pGeometryManager->GetContainingSubDetector(positionVectors[index], tolerance));
+            PANDORA_TEST_CHECK(pFirstSubDetector == batchSubDetectorVector[index]);
+        }
+    }
+
+    // A tolerance extends the sub detector beyond its outer edge, and away from its inner edge
+    const SubDetector *const pECalBarrel(&pGeometryManager->GetSubDetector("ECalBarrel"));
+    PANDORA_TEST_CHECK(!pECalBarrel->IsInSubDetector(CartesianVector(0.f, 2005.f, 0.f)));
+    PANDORA_TEST_CHECK(pECalBarrel->IsInSubDetector(CartesianVector(0.f, 2005.f, 0.f), 10.f));
+    PANDORA_TEST_CHECK(!pECalBarrel->IsInSubDetector(CartesianVector(0.f, 1795.f, 0.f)));
+    PANDORA_TEST_CHECK(pECalBarrel->IsInSubDetector(CartesianVector(0.f, 1795.f, 0.f), 20.f));
+    PANDORA_TEST_CHECK(pECalBarrel->IsInSubDetector(CartesianVector(0.f, 1815.f, 0.f)));
+    PANDORA_TEST_CHECK(!pECalBarrel->IsInSubDetector(CartesianVector(0.f, 1815.f, 0.f), -10.f));
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    TestLArTPCs();
+    TestSubDetectors();
+
+    return TestHelper::Finish("DetectorVolumeIndexTest");
+}
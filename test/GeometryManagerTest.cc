@@ -0,0 +1,119 @@
+/**
+ *  @file   PandoraSDK/test/GeometryManagerTest.cc
+ * 
+ *  @brief  Test the geometry manager hit type granularity and sub detector type tables, including their default entries and the
+ *          handling of hit and sub detector types beyond the ends of the tables.
+ * 
+ *  $Log: $
+ */
+
+#include "Api/PandoraApi.h"
+
+#include "Geometry/SubDetector.h"
+
+#include "Managers/GeometryManager.h"
+
+#include "TestHelper.h"
+
+using namespace pandora;
+using namespace pandora_test;
+
+/**
+ *  @brief  Get the status code from a hit type granularity query
+ * 
+ *  @param  pandora the pandora instance
+ *  @param  hitType the hit type
+ *  @param  granularity to receive the granularity
+ * 
+ *  @return the status code
+ */
+StatusCode GetHitTypeGranularity(const Pandora &pandora, const HitType hitType, Granularity &granularity)
+{
+    return TestHelper::GetStatusCode([&]() -> StatusCode
+    {
+        granularity = pandora.GetGeometry()->GetHitTypeGranularity(hitType);
+        return STATUS_CODE_SUCCESS;
+    });
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test the hit type granularity table, whose entries for all hit types but HIT_CUSTOM have defaults
+ */
+void TestHitTypeGranularities()
+{
+    const Pandora *const pPandora(new Pandora());
+    Granularity granularity(VERY_FINE);
+
+    PANDORA_TEST_CHECK(N_HIT_TYPES == GeometryManager::DEFAULT_HIT_TYPE_GRANULARITIES.size() + 1);
+
+    for (unsigned int hitType = 0; hitType < GeometryManager::DEFAULT_HIT_TYPE_GRANULARITIES.size(); ++hitType)
+    {
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == GetHitTypeGranularity(*pPandora, static_cast<HitType>(hitType), granularity));
+        PANDORA_TEST_CHECK(GeometryManager::DEFAULT_HIT_TYPE_GRANULARITIES[hitType] == granularity);
+    }
+
+    PANDORA_TEST_CHECK(STATUS_CODE_NOT_FOUND == GetHitTypeGranularity(*pPandora, HIT_CUSTOM, granularity));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetHitTypeGranularity(*pPandora, HIT_CUSTOM, COARSE));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == GetHitTypeGranularity(*pPandora, HIT_CUSTOM, granularity));
+    PANDORA_TEST_CHECK(COARSE == granularity);
+
+    // A registered granularity replaces the default, without changing the other entries
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetHitTypeGranularity(*pPandora, ECAL, VERY_COARSE));
+    PANDORA_TEST_CHECK((STATUS_CODE_SUCCESS == GetHitTypeGranularity(*pPandora, ECAL, granularity)) && (VERY_COARSE == granularity));
+    PANDORA_TEST_CHECK((STATUS_CODE_SUCCESS == GetHitTypeGranularity(*pPandora, HCAL, granularity)) &&
+        (GeometryManager::DEFAULT_HIT_TYPE_GRANULARITIES[HCAL] == granularity));
+
+    // Hit types beyond the end of the table are rejected
+    const HitType badHitType(static_cast<HitType>(N_HIT_TYPES));
+    PANDORA_TEST_CHECK(STATUS_CODE_OUT_OF_RANGE == PandoraApi::SetHitTypeGranularity(*pPandora, badHitType, FINE));
+    PANDORA_TEST_CHECK(STATUS_CODE_NOT_FOUND == GetHitTypeGranularity(*pPandora, badHitType, granularity));
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test the sub detector type table, which holds a sub detector for each type created exactly once
+ */
+void TestSubDetectorTypes()
+{
+    const Pandora *const pPandora(new Pandora());
+    const GeometryManager *const pGeometryManager(pPandora->GetGeometry());
+
+    const auto getSubDetectorStatusCode = [pGeometryManager](const SubDetectorType subDetectorType)
+    {
+        return TestHelper::GetStatusCode([&]() -> StatusCode
+        {
+            pGeometryManager->GetSubDetector(subDetectorType);
+            return STATUS_CODE_SUCCESS;
+        });
+    };
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Geometry::SubDetector::Create(*pPandora,
+        TestHelper::GetSubDetectorParameters("ECalBarrel", ECAL_BARREL, 1800.f, 0.f, 8, 2000.f, 2400.f, 8)));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Geometry::SubDetector::Create(*pPandora,
+        TestHelper::GetSubDetectorParameters("Muon1", MUON_BARREL, 3500.f, 0.f, 12, 4000.f, 4000.f, 12)));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Geometry::SubDetector::Create(*pPandora,
+        TestHelper::GetSubDetectorParameters("Muon2", MUON_BARREL, 4500.f, 0.f, 12, 5000.f, 4000.f, 12)));
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == getSubDetectorStatusCode(ECAL_BARREL));
+    PANDORA_TEST_CHECK(&pGeometryManager->GetSubDetector("ECalBarrel") == &pGeometryManager->GetSubDetector(ECAL_BARREL));
+    PANDORA_TEST_CHECK(STATUS_CODE_NOT_FOUND == getSubDetectorStatusCode(HCAL_BARREL));
+    PANDORA_TEST_CHECK(STATUS_CODE_OUT_OF_RANGE == getSubDetectorStatusCode(MUON_BARREL));
+    PANDORA_TEST_CHECK(STATUS_CODE_NOT_FOUND == getSubDetectorStatusCode(static_cast<SubDetectorType>(SUB_DETECTOR_OTHER + 1)));
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    TestHitTypeGranularities();
+    TestSubDetectorTypes();
+
+    return TestHelper::Finish("GeometryManagerTest");
+}
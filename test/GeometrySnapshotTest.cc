@@ -0,0 +1,382 @@
+/**
+ *  @file   PandoraSDK/test/GeometrySnapshotTest.cc
+ * 
+ *  @brief  Test of the geometry snapshot, comparing a geometry recreated from a snapshot file with the original geometry.
+ * 
+ *  $Log: $
+ */
+
+#include "Api/PandoraApi.h"
+
+#include "Geometry/DetectorGap.h"
+#include "Geometry/LArTPC.h"
+#include "Geometry/SubDetector.h"
+
+#include "Managers/GeometryManager.h"
+
+#include "Persistency/GeometrySnapshot.h"
+
+#include "TestHelper.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+using namespace pandora;
+using namespace pandora_test;
+
+/**
+ *  @brief  Create sub detectors, lar tpcs and detector gaps of each type
+ * 
+ *  @param  pandora the pandora instance
+ */
+void CreateGeometry(const Pandora &pandora)
+{
+    std::mt19937 generator(4);
+    std::uniform_real_distribution<float> distribution(0.f, 1000.f);
+
+    const std::string subDetectorNames[4] = {"ECal", "HCal", "Muon", "Tracker"};
+    const SubDetectorType subDetectorTypes[4] = {ECAL_BARREL, HCAL_BARREL, MUON_BARREL, INNER_TRACKER};
+
+    for (unsigned int iSubDetector = 0; iSubDetector < 4; ++iSubDetector)
+    {
+        PandoraApi::Geometry::SubDetector::Parameters parameters;
+        parameters.m_subDetectorName = subDetectorNames[iSubDetector];
+        parameters.m_subDetectorType = subDetectorTypes[iSubDetector];
+        parameters.m_innerRCoordinate = 100.f * iSubDetector;
+        parameters.m_innerZCoordinate = 3.f * iSubDetector;
+        parameters.m_innerPhiCoordinate = 0.1f * iSubDetector;
+        parameters.m_innerSymmetryOrder = 8;
+        parameters.m_outerRCoordinate = 100.f * iSubDetector + 90.f;
+        parameters.m_outerZCoordinate = 7.f * iSubDetector + 1.f;
+        parameters.m_outerPhiCoordinate = 0.2f;
+        parameters.m_outerSymmetryOrder = 4 * iSubDetector;
+        parameters.m_isMirroredInZ = (1 == iSubDetector % 2);
+        parameters.m_nLayers = 10 * iSubDetector;
+
+        for (unsigned int iLayer = 0; iLayer < 10 * iSubDetector; ++iLayer)
+        {
+            PandoraApi::Geometry::LayerParameters layerParameters;
+            layerParameters.m_closestDistanceToIp = iLayer + 0.5f;
+            layerParameters.m_nRadiationLengths = 0.1f * iLayer;
+            layerParameters.m_nInteractionLengths = 0.01f * iLayer;
+            parameters.m_layerParametersVector.push_back(layerParameters);
+        }
+
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Geometry::SubDetector::Create(pandora, parameters));
+    }
+
+    for (unsigned int iLArTPC = 0; iLArTPC < 500; ++iLArTPC)
+    {
+        PandoraApi::Geometry::LArTPC::Parameters parameters;
+        parameters.m_larTPCVolumeId = 7 * iLArTPC;
+        parameters.m_centerX = distribution(generator);
+        parameters.m_centerY = distribution(generator);
+        parameters.m_centerZ = distribution(generator);
+        parameters.m_widthX = distribution(generator);
+        parameters.m_widthY = 2.f;
+        parameters.m_widthZ = 3.f;
+        parameters.m_wirePitchU = 3.f;
+        parameters.m_wirePitchV = 3.1f;
+        parameters.m_wirePitchW = 3.2f;
+        parameters.m_wireAngleU = 0.5f;
+        parameters.m_wireAngleV = -0.5f;
+        parameters.m_wireAngleW = 0.f;
+        parameters.m_sigmaUVW = 1.f;
+        parameters.m_isDriftInPositiveX = (1 == iLArTPC % 2);
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Geometry::LArTPC::Create(pandora, parameters));
+    }
+
+    const LineGapType lineGapTypes[4] = {TPC_WIRE_GAP_VIEW_U, TPC_WIRE_GAP_VIEW_V, TPC_WIRE_GAP_VIEW_W, TPC_DRIFT_GAP};
+
+    for (unsigned int iGap = 0; iGap < 1000; ++iGap)
+    {
+        PandoraApi::Geometry::LineGap::Parameters parameters;
+        parameters.m_lineGapType = lineGapTypes[iGap % 4];
+        parameters.m_lineStartX = distribution(generator);
+        parameters.m_lineEndX = parameters.m_lineStartX.Get() + 1.f;
+        parameters.m_lineStartZ = distribution(generator);
+        parameters.m_lineEndZ = parameters.m_lineStartZ.Get() + 2.f;
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Geometry::LineGap::Create(pandora, parameters));
+
+        if (0 != iGap % 50)
+            continue;
+
+        PandoraApi::Geometry::BoxGap::Parameters boxGapParameters;
+        boxGapParameters.m_vertex = CartesianVector(distribution(generator), 1.f, 2.f);
+        boxGapParameters.m_side1 = CartesianVector(1.f, 0.f, 0.f);
+        boxGapParameters.m_side2 = CartesianVector(0.f, 2.f, 0.f);
+        boxGapParameters.m_side3 = CartesianVector(0.f, 0.f, 3.f);
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Geometry::BoxGap::Create(pandora, boxGapParameters));
+
+        PandoraApi::Geometry::ConcentricGap::Parameters concentricGapParameters;
+        concentricGapParameters.m_minZCoordinate = -distribution(generator);
+        concentricGapParameters.m_maxZCoordinate = 5.f;
+        concentricGapParameters.m_innerRCoordinate = 10.f;
+        concentricGapParameters.m_innerPhiCoordinate = 0.1f;
+        concentricGapParameters.m_innerSymmetryOrder = 8;
+        concentricGapParameters.m_outerRCoordinate = 20.f;
+        concentricGapParameters.m_outerPhiCoordinate = 0.2f;
+        concentricGapParameters.m_outerSymmetryOrder = 12;
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Geometry::ConcentricGap::Create(pandora, concentricGapParameters));
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Get the detector gaps of a given type, in order of creation
+ * 
+ *  @param  pandora the pandora instance
+ * 
+ *  @return the detector gaps of the given type
+ */
+template <typename T>
+std::vector<const T *> GetDetectorGaps(const Pandora &pandora)
+{
+    std::vector<const T *> detectorGaps;
+
+    for (const DetectorGap *const pDetectorGap : pandora.GetGeometry()->GetDetectorGapList())
+    {
+        const T *const pT(dynamic_cast<const T *>(pDetectorGap));
+
+        if (pT)
+            detectorGaps.push_back(pT);
+    }
+
+    return detectorGaps;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Compare the geometries of two pandora instances
+ * 
+ *  @param  lhs the first pandora instance
+ *  @param  rhs the second pandora instance
+ */
+void CompareGeometry(const Pandora &lhs, const Pandora &rhs)
+{
+    const GeometryManager *const pLhsGeometry(lhs.GetGeometry()), *const pRhsGeometry(rhs.GetGeometry());
+    PANDORA_TEST_CHECK(pLhsGeometry->GetSubDetectorMap().size() == pRhsGeometry->GetSubDetectorMap().size());
+
+    for (const SubDetectorMap::value_type &mapEntry : pLhsGeometry->GetSubDetectorMap())
+    {
+        const SubDetectorMap::const_iterator iter(pRhsGeometry->GetSubDetectorMap().find(mapEntry.first));
+        PANDORA_TEST_CHECK(pRhsGeometry->GetSubDetectorMap().end() != iter);
+
+        if (pRhsGeometry->GetSubDetectorMap().end() == iter)
+            continue;
+
+        const SubDetector *const pLhs(mapEntry.second), *const pRhs(iter->second);
+        PANDORA_TEST_CHECK(pLhs->GetSubDetectorType() == pRhs->GetSubDetectorType());
+        PANDORA_TEST_CHECK(pLhs->GetInnerRCoordinate() == pRhs->GetInnerRCoordinate());
+        PANDORA_TEST_CHECK(pLhs->GetInnerZCoordinate() == pRhs->GetInnerZCoordinate());
+        PANDORA_TEST_CHECK(pLhs->GetInnerPhiCoordinate() == pRhs->GetInnerPhiCoordinate());
+        PANDORA_TEST_CHECK(pLhs->GetInnerSymmetryOrder() == pRhs->GetInnerSymmetryOrder());
+        PANDORA_TEST_CHECK(pLhs->GetOuterRCoordinate() == pRhs->GetOuterRCoordinate());
+        PANDORA_TEST_CHECK(pLhs->GetOuterZCoordinate() == pRhs->GetOuterZCoordinate());
+        PANDORA_TEST_CHECK(pLhs->GetOuterPhiCoordinate() == pRhs->GetOuterPhiCoordinate());
+        PANDORA_TEST_CHECK(pLhs->GetOuterSymmetryOrder() == pRhs->GetOuterSymmetryOrder());
+        PANDORA_TEST_CHECK(pLhs->IsMirroredInZ() == pRhs->IsMirroredInZ());
+        PANDORA_TEST_CHECK(pLhs->GetNLayers() == pRhs->GetNLayers());
+
+        const SubDetector::SubDetectorLayerVector &lhsLayers(pLhs->GetSubDetectorLayerVector());
+        const SubDetector::SubDetectorLayerVector &rhsLayers(pRhs->GetSubDetectorLayerVector());
+        PANDORA_TEST_CHECK(lhsLayers.size() == rhsLayers.size());
+
+        for (unsigned int iLayer = 0; (iLayer < lhsLayers.size()) && (iLayer < rhsLayers.size()); ++iLayer)
+        {
+            PANDORA_TEST_CHECK(lhsLayers[iLayer].GetClosestDistanceToIp() == rhsLayers[iLayer].GetClosestDistanceToIp());
+            PANDORA_TEST_CHECK(lhsLayers[iLayer].GetNRadiationLengths() == rhsLayers[iLayer].GetNRadiationLengths());
+            PANDORA_TEST_CHECK(lhsLayers[iLayer].GetNInteractionLengths() == rhsLayers[iLayer].GetNInteractionLengths());
+        }
+    }
+
+    PANDORA_TEST_CHECK(pLhsGeometry->GetLArTPCMap().size() == pRhsGeometry->GetLArTPCMap().size());
+
+    for (const LArTPCMap::value_type &mapEntry : pLhsGeometry->GetLArTPCMap())
+    {
+        const LArTPCMap::const_iterator iter(pRhsGeometry->GetLArTPCMap().find(mapEntry.first));
+        PANDORA_TEST_CHECK(pRhsGeometry->GetLArTPCMap().end() != iter);
+
+        if (pRhsGeometry->GetLArTPCMap().end() == iter)
+            continue;
+
+        const LArTPC *const pLhs(mapEntry.second), *const pRhs(iter->second);
+        PANDORA_TEST_CHECK(pLhs->GetLArTPCVolumeId() == pRhs->GetLArTPCVolumeId());
+        PANDORA_TEST_CHECK(pLhs->GetCenterX() == pRhs->GetCenterX());
+        PANDORA_TEST_CHECK(pLhs->GetCenterY() == pRhs->GetCenterY());
+        PANDORA_TEST_CHECK(pLhs->GetCenterZ() == pRhs->GetCenterZ());
+        PANDORA_TEST_CHECK(pLhs->GetWidthX() == pRhs->GetWidthX());
+        PANDORA_TEST_CHECK(pLhs->GetWidthY() == pRhs->GetWidthY());
+        PANDORA_TEST_CHECK(pLhs->GetWidthZ() == pRhs->GetWidthZ());
+        PANDORA_TEST_CHECK(pLhs->GetWirePitchU() == pRhs->GetWirePitchU());
+        PANDORA_TEST_CHECK(pLhs->GetWirePitchV() == pRhs->GetWirePitchV());
+        PANDORA_TEST_CHECK(pLhs->GetWirePitchW() == pRhs->GetWirePitchW());
+        PANDORA_TEST_CHECK(pLhs->GetWireAngleU() == pRhs->GetWireAngleU());
+        PANDORA_TEST_CHECK(pLhs->GetWireAngleV() == pRhs->GetWireAngleV());
+        PANDORA_TEST_CHECK(pLhs->GetWireAngleW() == pRhs->GetWireAngleW());
+        PANDORA_TEST_CHECK(pLhs->GetSigmaUVW() == pRhs->GetSigmaUVW());
+        PANDORA_TEST_CHECK(pLhs->IsDriftInPositiveX() == pRhs->IsDriftInPositiveX());
+    }
+
+    PANDORA_TEST_CHECK(pLhsGeometry->GetDetectorGapList().size() == pRhsGeometry->GetDetectorGapList().size());
+
+    const std::vector<const LineGap *> lhsLineGaps(GetDetectorGaps<LineGap>(lhs)), rhsLineGaps(GetDetectorGaps<LineGap>(rhs));
+    PANDORA_TEST_CHECK(lhsLineGaps.size() == rhsLineGaps.size());
+
+    for (unsigned int iGap = 0; (iGap < lhsLineGaps.size()) && (iGap < rhsLineGaps.size()); ++iGap)
+    {
+        PANDORA_TEST_CHECK(lhsLineGaps[iGap]->GetLineGapType() == rhsLineGaps[iGap]->GetLineGapType());
+        PANDORA_TEST_CHECK(lhsLineGaps[iGap]->GetLineStartX() == rhsLineGaps[iGap]->GetLineStartX());
+        PANDORA_TEST_CHECK(lhsLineGaps[iGap]->GetLineEndX() == rhsLineGaps[iGap]->GetLineEndX());
+        PANDORA_TEST_CHECK(lhsLineGaps[iGap]->GetLineStartZ() == rhsLineGaps[iGap]->GetLineStartZ());
+        PANDORA_TEST_CHECK(lhsLineGaps[iGap]->GetLineEndZ() == rhsLineGaps[iGap]->GetLineEndZ());
+    }
+
+    const std::vector<const BoxGap *> lhsBoxGaps(GetDetectorGaps<BoxGap>(lhs)), rhsBoxGaps(GetDetectorGaps<BoxGap>(rhs));
+    PANDORA_TEST_CHECK(lhsBoxGaps.size() == rhsBoxGaps.size());
+
+    for (unsigned int iGap = 0; (iGap < lhsBoxGaps.size()) && (iGap < rhsBoxGaps.size()); ++iGap)
+    {
+        PANDORA_TEST_CHECK(lhsBoxGaps[iGap]->GetVertex() == rhsBoxGaps[iGap]->GetVertex());
+        PANDORA_TEST_CHECK(lhsBoxGaps[iGap]->GetSide1() == rhsBoxGaps[iGap]->GetSide1());
+        PANDORA_TEST_CHECK(lhsBoxGaps[iGap]->GetSide2() == rhsBoxGaps[iGap]->GetSide2());
+        PANDORA_TEST_CHECK(lhsBoxGaps[iGap]->GetSide3() == rhsBoxGaps[iGap]->GetSide3());
+    }
+
+    const std::vector<const ConcentricGap *> lhsConcentricGaps(GetDetectorGaps<ConcentricGap>(lhs));
+    const std::vector<const ConcentricGap *> rhsConcentricGaps(GetDetectorGaps<ConcentricGap>(rhs));
+    PANDORA_TEST_CHECK(lhsConcentricGaps.size() == rhsConcentricGaps.size());
+
+    for (unsigned int iGap = 0; (iGap < lhsConcentricGaps.size()) && (iGap < rhsConcentricGaps.size()); ++iGap)
+    {
+        PANDORA_TEST_CHECK(lhsConcentricGaps[iGap]->GetMinZCoordinate() == rhsConcentricGaps[iGap]->GetMinZCoordinate());
+        PANDORA_TEST_CHECK(lhsConcentricGaps[iGap]->GetMaxZCoordinate() == rhsConcentricGaps[iGap]->GetMaxZCoordinate());
+        PANDORA_TEST_CHECK(lhsConcentricGaps[iGap]->GetInnerRCoordinate() == rhsConcentricGaps[iGap]->GetInnerRCoordinate());
+        PANDORA_TEST_CHECK(lhsConcentricGaps[iGap]->GetInnerPhiCoordinate() == rhsConcentricGaps[iGap]->GetInnerPhiCoordinate());
+        PANDORA_TEST_CHECK(lhsConcentricGaps[iGap]->GetInnerSymmetryOrder() == rhsConcentricGaps[iGap]->GetInnerSymmetryOrder());
+        PANDORA_TEST_CHECK(lhsConcentricGaps[iGap]->GetOuterRCoordinate() == rhsConcentricGaps[iGap]->GetOuterRCoordinate());
+        PANDORA_TEST_CHECK(lhsConcentricGaps[iGap]->GetOuterPhiCoordinate() == rhsConcentricGaps[iGap]->GetOuterPhiCoordinate());
+        PANDORA_TEST_CHECK(lhsConcentricGaps[iGap]->GetOuterSymmetryOrder() == rhsConcentricGaps[iGap]->GetOuterSymmetryOrder());
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Get the status code raised when mapping a geometry snapshot file
+ * 
+ *  @param  fileName the name of the geometry snapshot file
+ * 
+ *  @return the status code, success if the file was mapped and validated
+ */
+StatusCode GetOpenStatusCode(const std::string &fileName)
+{
+    return TestHelper::GetStatusCode([&]() -> StatusCode
+    {
+        const GeometrySnapshot geometrySnapshot(fileName);
+        return STATUS_CODE_SUCCESS;
+    });
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test the geometry snapshot write and read round trip
+ * 
+ *  @param  fileName the name of the geometry snapshot file
+ */
+void TestRoundTrip(const std::string &fileName)
+{
+    const Pandora *const pOriginalPandora(new Pandora());
+    CreateGeometry(*pOriginalPandora);
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == GeometrySnapshot::Write(*pOriginalPandora, fileName));
+
+    const Pandora *const pPandora(new Pandora());
+    {
+        const GeometrySnapshot geometrySnapshot(fileName);
+        PANDORA_TEST_CHECK(1 == geometrySnapshot.GetVersion());
+        PANDORA_TEST_CHECK(4 == geometrySnapshot.GetNSubDetectorRecords());
+        PANDORA_TEST_CHECK(60 == geometrySnapshot.GetNLayerRecords());
+        PANDORA_TEST_CHECK(500 == geometrySnapshot.GetNLArTPCRecords());
+        PANDORA_TEST_CHECK(1000 == geometrySnapshot.GetNLineGapRecords());
+        PANDORA_TEST_CHECK(20 == geometrySnapshot.GetNBoxGapRecords());
+        PANDORA_TEST_CHECK(20 == geometrySnapshot.GetNConcentricGapRecords());
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == geometrySnapshot.CreateGeometry(*pPandora));
+    }
+
+    CompareGeometry(*pOriginalPandora, *pPandora);
+
+    // A snapshot of the recreated geometry is identical to the original snapshot
+    const std::string rewrittenFileName(fileName + ".rewritten");
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == GeometrySnapshot::Write(*pPandora, rewrittenFileName));
+
+    std::ifstream file(fileName, std::ios::binary), rewrittenFile(rewrittenFileName, std::ios::binary);
+    const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const std::string rewrittenContents((std::istreambuf_iterator<char>(rewrittenFile)), std::istreambuf_iterator<char>());
+    PANDORA_TEST_CHECK(!contents.empty() && (contents == rewrittenContents));
+    std::remove(rewrittenFileName.c_str());
+
+    delete pOriginalPandora;
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test that corrupt geometry snapshot files are rejected
+ * 
+ *  @param  fileName the name of a valid geometry snapshot file
+ */
+void TestCorruptFiles(const std::string &fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    PANDORA_TEST_CHECK(contents.size() > 16);
+
+    if (contents.size() <= 16)
+        return;
+
+    const std::string corruptFileName(fileName + ".corrupt");
+
+    TestHelper::WriteFile(corruptFileName, contents);
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == GetOpenStatusCode(corruptFileName));
+
+    TestHelper::WriteFile(corruptFileName, contents.substr(0, contents.size() - 1));
+    PANDORA_TEST_CHECK(STATUS_CODE_FAILURE == GetOpenStatusCode(corruptFileName));
+
+    TestHelper::WriteFile(corruptFileName, contents.substr(0, 10));
+    PANDORA_TEST_CHECK(STATUS_CODE_FAILURE == GetOpenStatusCode(corruptFileName));
+
+    TestHelper::WriteFile(corruptFileName, std::string());
+    PANDORA_TEST_CHECK(STATUS_CODE_FAILURE == GetOpenStatusCode(corruptFileName));
+
+    std::string badMagicContents(contents);
+    badMagicContents[0] = 'X';
+    TestHelper::WriteFile(corruptFileName, badMagicContents);
+    PANDORA_TEST_CHECK(STATUS_CODE_FAILURE == GetOpenStatusCode(corruptFileName));
+
+    std::string badVersionContents(contents);
+    badVersionContents[8] = 2;
+    TestHelper::WriteFile(corruptFileName, badVersionContents);
+    PANDORA_TEST_CHECK(STATUS_CODE_FAILURE == GetOpenStatusCode(corruptFileName));
+
+    std::remove(corruptFileName.c_str());
+    PANDORA_TEST_CHECK(STATUS_CODE_NOT_FOUND == GetOpenStatusCode(corruptFileName));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    const std::string fileName("GeometrySnapshotTest.pndrgeo");
+
+    TestRoundTrip(fileName);
+    TestCorruptFiles(fileName);
+    std::remove(fileName.c_str());
+
+    return TestHelper::Finish("GeometrySnapshotTest");
+}
@@ -0,0 +1,260 @@
+/**
+ *  @file   PandoraSDK/test/GriddedBFieldPluginTest.cc
+ * 
+ *  @brief  Test of the gridded bfield plugin, comparing interpolated bfield values with those of the underlying bfield plugin.
+ * 
+ *  $Log: $
+ */
+
+#include "Api/PandoraApi.h"
+
+#include "Helpers/XmlHelper.h"
+
+#include "Managers/PluginManager.h"
+
+#include "Plugins/GriddedBFieldPlugin.h"
+
+#include "TestHelper.h"
+
+#include <random>
+
+using namespace pandora;
+using namespace pandora_test;
+
+/**
+ *  @brief  UnderlyingBFieldPlugin class, a smoothly varying bfield for the gridded bfield plugin to sample
+ */
+class UnderlyingBFieldPlugin : public BFieldPlugin
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    UnderlyingBFieldPlugin();
+
+    float GetBField(const CartesianVector &positionVector) const;
+
+private:
+    StatusCode ReadSettings(const TiXmlHandle xmlHandle);
+
+    float       m_scale;        ///< The bfield scale, units Tesla
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+UnderlyingBFieldPlugin::UnderlyingBFieldPlugin() :
+    m_scale(1.f)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+float UnderlyingBFieldPlugin::GetBField(const CartesianVector &positionVector) const
+{
+    const float rCoordinate(std::sqrt(positionVector.GetX() * positionVector.GetX() + positionVector.GetY() * positionVector.GetY()));
+    return m_scale * (1.f + 0.1f * std::sin(0.002f * positionVector.GetZ())) / (1.f + std::exp((rCoordinate - 900.f) / 200.f));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode UnderlyingBFieldPlugin::ReadSettings(const TiXmlHandle xmlHandle)
+{
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle,
+        "Scale", m_scale));
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Get the position of a grid node, or of a cell midpoint for half-integer indices
+ * 
+ *  @param  gridMinimum the grid corner with the minimum coordinates
+ *  @param  gridMaximum the grid corner with the maximum coordinates
+ *  @param  nGridPoints the number of grid points in x, y and z
+ *  @param  xIndex the x index
+ *  @param  yIndex the y index
+ *  @param  zIndex the z index
+ * 
+ *  @return the position
+ */
+CartesianVector GetGridPosition(const CartesianVector &gridMinimum, const CartesianVector &gridMaximum, const unsigned int nGridPoints[3],
+    const float xIndex, const float yIndex, const float zIndex)
+{
+    const CartesianVector gridSize(gridMaximum - gridMinimum);
+
+    return CartesianVector(gridMinimum.GetX() + xIndex * gridSize.GetX() / static_cast<float>(nGridPoints[0] - 1),
+        gridMinimum.GetY() + yIndex * gridSize.GetY() / static_cast<float>(nGridPoints[1] - 1),
+        gridMinimum.GetZ() + zIndex * gridSize.GetZ() / static_cast<float>(nGridPoints[2] - 1));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Get the xml settings for a gridded bfield plugin, whose underlying plugin has a scale of two Tesla
+ * 
+ *  @param  nPointsX the number of grid points along x
+ *  @param  nPointsY the number of grid points along y
+ *  @param  nPointsZ the number of grid points along z
+ * 
+ *  @return the xml settings
+ */
+std::string GetGriddedSettings(const unsigned int nPointsX, const unsigned int nPointsY, const unsigned int nPointsZ)
+{
+    return ("<pandora>\n"
+        "    <BFieldPlugin>\n"
+        "        <GridMinimum>-1000. -800. -1200.</GridMinimum>\n"
+        "        <GridMaximum>1000. 800. 1200.</GridMaximum>\n"
+        "        <NGridPointsX>" + std::to_string(nPointsX) + "</NGridPointsX>\n"
+        "        <NGridPointsY>" + std::to_string(nPointsY) + "</NGridPointsY>\n"
+        "        <NGridPointsZ>" + std::to_string(nPointsZ) + "</NGridPointsZ>\n"
+        "        <UnderlyingBFieldPlugin>\n"
+        "            <Scale>2.</Scale>\n"
+        "        </UnderlyingBFieldPlugin>\n"
+        "    </BFieldPlugin>\n"
+        "</pandora>\n");
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test the gridded bfield plugin against the underlying bfield plugin
+ */
+void TestGriddedBField()
+{
+    const Pandora *const pPandora(new Pandora());
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetBFieldPlugin(*pPandora, new GriddedBFieldPlugin(new UnderlyingBFieldPlugin)));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == TestHelper::ReadSettings(*pPandora, GetGriddedSettings(11, 9, 7)));
+
+    const GriddedBFieldPlugin *const pGriddedBFieldPlugin(
+        dynamic_cast<const GriddedBFieldPlugin *>(pPandora->GetPlugins()->GetBFieldPlugin()));
+    PANDORA_TEST_CHECK(nullptr != pGriddedBFieldPlugin);
+
+    if (!pGriddedBFieldPlugin)
+    {
+        delete pPandora;
+        return;
+    }
+
+    // The reference plugin has the settings given to the underlying plugin in the xml file
+    const Pandora *const pReferencePandora(new Pandora());
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetBFieldPlugin(*pReferencePandora, new UnderlyingBFieldPlugin));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == TestHelper::ReadSettings(*pReferencePandora,
+        "<pandora><BFieldPlugin><Scale>2.</Scale></BFieldPlugin></pandora>\n"));
+
+    const BFieldPlugin *const pUnderlyingBFieldPlugin(pReferencePandora->GetPlugins()->GetBFieldPlugin());
+    const CartesianVector &gridMinimum(pGriddedBFieldPlugin->GetGridMinimum()), &gridMaximum(pGriddedBFieldPlugin->GetGridMaximum());
+    const unsigned int nGridPoints[3] = {11, 9, 7};
+
+    PANDORA_TEST_CHECK(gridMinimum == CartesianVector(-1000.f, -800.f, -1200.f));
+    PANDORA_TEST_CHECK(gridMaximum == CartesianVector(1000.f, 800.f, 1200.f));
+    PANDORA_TEST_CHECK(11 * 9 * 7 == pGriddedBFieldPlugin->GetNGridPoints());
+
+    // At the grid nodes, the interpolated bfield is the sampled underlying bfield
+    for (unsigned int xIndex = 0; xIndex < nGridPoints[0]; ++xIndex)
+    {
+        for (unsigned int yIndex = 0; yIndex < nGridPoints[1]; ++yIndex)
+        {
+            for (unsigned int zIndex = 0; zIndex < nGridPoints[2]; ++zIndex)
+            {
+                const CartesianVector positionVector(GetGridPosition(gridMinimum, gridMaximum, nGridPoints, xIndex, yIndex, zIndex));
+                PANDORA_TEST_CHECK(pGriddedBFieldPlugin->IsInGrid(positionVector));
+                PANDORA_TEST_CHECK(TestHelper::IsClose(pGriddedBFieldPlugin->GetBField(positionVector),
+                    pUnderlyingBFieldPlugin->GetBField(positionVector), 1.e-5));
+            }
+        }
+    }
+
+    // At the cell midpoints, trilinear interpolation gives the mean of the bfield values at the eight cell corners
+    for (unsigned int xIndex = 0; xIndex + 1 < nGridPoints[0]; ++xIndex)
+    {
+        for (unsigned int yIndex = 0; yIndex + 1 < nGridPoints[1]; ++yIndex)
+        {
+            for (unsigned int zIndex = 0; zIndex + 1 < nGridPoints[2]; ++zIndex)
+            {
+                double cornerBFieldSum(0.);
+
+                for (unsigned int iCorner = 0; iCorner < 8; ++iCorner)
+                {
+                    cornerBFieldSum += pUnderlyingBFieldPlugin->GetBField(GetGridPosition(gridMinimum, gridMaximum, nGridPoints,
+                        xIndex + (iCorner & 1), yIndex + ((iCorner >> 1) & 1), zIndex + ((iCorner >> 2) & 1)));
+                }
+
+                const CartesianVector positionVector(GetGridPosition(gridMinimum, gridMaximum, nGridPoints, xIndex + 0.5f, yIndex + 0.5f,
+                    zIndex + 0.5f));
+                PANDORA_TEST_CHECK(TestHelper::IsClose(pGriddedBFieldPlugin->GetBField(positionVector), cornerBFieldSum / 8.,
+                    1.e-5));
+            }
+        }
+    }
+
+    // The batch query matches the single position query, and outside the grid both give the underlying bfield
+    std::mt19937 generator(5);
+    std::uniform_real_distribution<float> distribution(-1.5f, 1.5f);
+    CartesianPointVector positionVectors;
+
+    for (unsigned int iPosition = 0; iPosition < 20000; ++iPosition)
+    {
+        positionVectors.emplace_back(1000.f * distribution(generator), 800.f * distribution(generator), 1200.f * distribution(generator));
+    }
+
+    positionVectors.push_back(gridMinimum);
+    positionVectors.push_back(gridMaximum);
+
+    FloatVector bFields(positionVectors.size(), 0.f);
+    pGriddedBFieldPlugin->GetBFields(positionVectors.data(), positionVectors.size(), bFields.data());
+
+    for (unsigned int index = 0; index < positionVectors.size(); ++index)
+    {
+        const CartesianVector &positionVector(positionVectors[index]);
+        const float bField(pGriddedBFieldPlugin->GetBField(positionVector));
+        PANDORA_TEST_CHECK(bField == bFields[index]);
+
+        if (!pGriddedBFieldPlugin->IsInGrid(positionVector))
+            PANDORA_TEST_CHECK(bField == pUnderlyingBFieldPlugin->GetBField(positionVector));
+    }
+
+    delete pPandora;
+    delete pReferencePandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test that grids with too few points along an axis, or too many points in total to be indexed, are rejected
+ */
+void TestInvalidGrids()
+{
+    const unsigned int nPointsArray[][3] = {{1, 9, 7}, {11, 0, 7}, {65536, 65536, 2}, {2, 65536, 65536}, {4096, 4096, 4096}};
+
+    // ATTN Pandora reports any failure in reading settings as STATUS_CODE_FAILURE. Unrejected, the largest grids would be sampled at
+    // an index wrapped around the unsigned int range, or exhaust the available memory.
+    for (const auto &nPoints : nPointsArray)
+    {
+        const Pandora *const pPandora(new Pandora());
+        GriddedBFieldPlugin *const pGriddedBFieldPlugin(new GriddedBFieldPlugin(new UnderlyingBFieldPlugin));
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetBFieldPlugin(*pPandora, pGriddedBFieldPlugin));
+        PANDORA_TEST_CHECK(STATUS_CODE_FAILURE == TestHelper::ReadSettings(*pPandora,
+            GetGriddedSettings(nPoints[0], nPoints[1], nPoints[2])));
+        PANDORA_TEST_CHECK(0 == pGriddedBFieldPlugin->GetNGridPoints());
+        delete pPandora;
+    }
+
+    // An underlying plugin is required
+    PANDORA_TEST_CHECK(STATUS_CODE_INVALID_PARAMETER == TestHelper::GetStatusCode([]() -> StatusCode
+    {
+        const GriddedBFieldPlugin griddedBFieldPlugin(nullptr);
+        return STATUS_CODE_SUCCESS;
+    }));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    TestGriddedBField();
+    TestInvalidGrids();
+
+    return TestHelper::Finish("GriddedBFieldPluginTest");
+}
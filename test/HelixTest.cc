@@ -0,0 +1,444 @@
+/**
+ *  @file   PandoraSDK/test/HelixTest.cc
+ * 
+ *  @brief  Test the helix batch propagation and distance calculations against the corresponding helix member functions, and test the
+ *          cached track helices and the closest approach search over all pairs of tracks against helices built directly.
+ * 
+ *  $Log: $
+ */
+
+#include "Pandora/AlgorithmHeaders.h"
+
+#include "Objects/HelixBatch.h"
+
+#include "TestHelper.h"
+#include "TestPlugins.h"
+
+#include <iostream>
+#include <random>
+#include <sstream>
+
+using namespace pandora;
+using namespace pandora_test;
+
+/**
+ *  @brief  Get a random value, uniformly distributed in a specified range
+ * 
+ *  @param  low the low edge of the range
+ *  @param  high the high edge of the range
+ *  @param  generator the random number generator
+ * 
+ *  @return the random value
+ */
+float GetRandomValue(const float low, const float high, std::mt19937 &generator)
+{
+    return std::uniform_real_distribution<float>(low, high)(generator);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Get random helices, including helices with no longitudinal momentum and helices of both charges
+ * 
+ *  @param  nHelices the number of helices
+ *  @param  generator the random number generator
+ * 
+ *  @return the helices
+ */
+std::vector<Helix> GetRandomHelices(const unsigned int nHelices, std::mt19937 &generator)
+{
+    std::vector<Helix> helixVector;
+
+    for (unsigned int iHelix = 0; iHelix < nHelices; ++iHelix)
+    {
+        const CartesianVector position(GetRandomValue(-100.f, 100.f, generator), GetRandomValue(-100.f, 100.f, generator),
+            GetRandomValue(-200.f, 200.f, generator));
+        const float pxy(GetRandomValue(0.1f, 5.f, generator)), phi(GetRandomValue(-3.f, 3.f, generator));
+        const float pz((0 == iHelix % 10) ? 0.f : GetRandomValue(-5.f, 5.f, generator));
+
+        helixVector.emplace_back(position, CartesianVector(pxy * std::cos(phi), pxy * std::sin(phi), pz), (0 == iHelix % 2) ? 1.f : -1.f,
+            3.5f);
+    }
+
+    return helixVector;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Check the results of a batch propagation against the scalar results for each helix
+ * 
+ *  @param  helixVector the helices
+ *  @param  intersectionPoints the batch intersection points
+ *  @param  genericTimes the batch generic times
+ *  @param  statusCodes the batch status codes
+ *  @param  scalarFunction the function propagating a single helix
+ */
+template <typename FUNCTION>
+void CheckPropagation(const std::vector<Helix> &helixVector, const CartesianPointVector &intersectionPoints,
+    const FloatVector &genericTimes, const HelixBatch::StatusCodeVector &statusCodes, const FUNCTION &scalarFunction)
+{
+    PANDORA_TEST_CHECK((helixVector.size() == intersectionPoints.size()) && (helixVector.size() == genericTimes.size()) &&
+        (helixVector.size() == statusCodes.size()));
+
+    for (unsigned int iHelix = 0; iHelix < helixVector.size(); ++iHelix)
+    {
+        CartesianVector intersectionPoint(0.f, 0.f, 0.f);
+        float genericTime(0.f);
+        const StatusCode statusCode(scalarFunction(helixVector[iHelix], intersectionPoint, genericTime));
+        PANDORA_TEST_CHECK(statusCode == statusCodes[iHelix]);
+
+        if ((statusCode != statusCodes[iHelix]) || (STATUS_CODE_SUCCESS != statusCode))
+            continue;
+
+        PANDORA_TEST_CHECK(TestHelper::IsClose(genericTime, genericTimes[iHelix], 1.e-5));
+        PANDORA_TEST_CHECK(TestHelper::IsClose(intersectionPoint.GetX(), intersectionPoints[iHelix].GetX(), 1.e-5) &&
+            TestHelper::IsClose(intersectionPoint.GetY(), intersectionPoints[iHelix].GetY(), 1.e-5) &&
+            TestHelper::IsClose(intersectionPoint.GetZ(), intersectionPoints[iHelix].GetZ(), 1.e-5));
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Check the distances of closest approach calculated by a batch against the scalar results
+ * 
+ *  @param  helix the helix
+ *  @param  point the point
+ *  @param  distance the batch distance
+ *  @param  genericTime the batch generic time
+ */
+void CheckDistance(const Helix &helix, const CartesianVector &point, const CartesianVector &distance, const float genericTime)
+{
+    CartesianVector expectedDistance(0.f, 0.f, 0.f);
+    float expectedGenericTime(0.f);
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == helix.GetDistanceToPoint(point, expectedDistance, expectedGenericTime));
+
+    PANDORA_TEST_CHECK(TestHelper::IsClose(expectedGenericTime, genericTime, 1.e-5));
+    PANDORA_TEST_CHECK(TestHelper::IsClose(expectedDistance.GetX(), distance.GetX(), 1.e-5) &&
+        TestHelper::IsClose(expectedDistance.GetY(), distance.GetY(), 1.e-5) &&
+        TestHelper::IsClose(expectedDistance.GetZ(), distance.GetZ(), 1.e-5));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test the helix batch against the helix member functions, for planes and cylinders that some helices do not reach
+ */
+void TestHelixBatch()
+{
+    std::mt19937 generator(37);
+    const std::vector<Helix> helixVector(GetRandomHelices(500, generator));
+    const HelixBatch helixBatch(helixVector);
+    PANDORA_TEST_CHECK(helixVector.size() == helixBatch.GetNHelices());
+
+    CartesianPointVector intersectionPoints;
+    FloatVector genericTimes;
+    HelixBatch::StatusCodeVector statusCodes;
+
+    // Planes parallel to the z axis, including a plane with no normal vector
+    const std::vector<std::vector<float>> xyPlanes{{0.f, 0.f, 1.f, 0.f}, {50.f, -20.f, 0.3f, 0.7f}, {-150.f, 150.f, -1.f, 1.f},
+        {300.f, 0.f, 1.f, 0.f}, {0.f, 0.f, 0.f, 0.f}};
+
+    for (const FloatVector &plane : xyPlanes)
+    {
+        helixBatch.GetPointsInXY(plane[0], plane[1], plane[2], plane[3], intersectionPoints, genericTimes, statusCodes);
+        CheckPropagation(helixVector, intersectionPoints, genericTimes, statusCodes,
+            [&](const Helix &helix, CartesianVector &intersectionPoint, float &genericTime)
+        {
+            return helix.GetPointInXY(plane[0], plane[1], plane[2], plane[3], helix.GetReferencePoint(), intersectionPoint, genericTime);
+        });
+    }
+
+    // Planes perpendicular to the z axis, which helices with no longitudinal momentum do not reach
+    for (const float zPlane : {-250.f, 0.f, 400.f})
+    {
+        helixBatch.GetPointsInZ(zPlane, intersectionPoints, genericTimes, statusCodes);
+        CheckPropagation(helixVector, intersectionPoints, genericTimes, statusCodes,
+            [&](const Helix &helix, CartesianVector &intersectionPoint, float &genericTime)
+        {
+            return helix.GetPointInZ(zPlane, helix.GetReferencePoint(), intersectionPoint, genericTime);
+        });
+    }
+
+    // Cylinders that helices cross, and cylinders beyond or within the reach of some helices
+    for (const float radius : {5.f, 80.f, 150.f, 350.f})
+    {
+        helixBatch.GetPointsOnCircle(radius, intersectionPoints, genericTimes, statusCodes);
+        CheckPropagation(helixVector, intersectionPoints, genericTimes, statusCodes,
+            [&](const Helix &helix, CartesianVector &intersectionPoint, float &genericTime)
+        {
+            return helix.GetPointOnCircle(radius, helix.GetReferencePoint(), intersectionPoint, genericTime);
+        });
+    }
+
+    // Distances of closest approach, for each helix to a point and for a single helix to many points
+    CartesianPointVector points, distances;
+
+    for (unsigned int iPoint = 0; iPoint < 20; ++iPoint)
+    {
+        points.emplace_back(GetRandomValue(-200.f, 200.f, generator), GetRandomValue(-200.f, 200.f, generator),
+            GetRandomValue(-300.f, 300.f, generator));
+    }
+
+    for (const CartesianVector &point : points)
+    {
+        helixBatch.GetDistancesToPoint(point, distances, genericTimes);
+        PANDORA_TEST_CHECK((helixVector.size() == distances.size()) && (helixVector.size() == genericTimes.size()));
+
+        for (unsigned int iHelix = 0; iHelix < helixVector.size(); ++iHelix)
+            CheckDistance(helixVector[iHelix], point, distances[iHelix], genericTimes[iHelix]);
+    }
+
+    for (const unsigned int helixIndex : {0u, 1u, 250u, 499u})
+    {
+        helixBatch.GetDistancesToPoints(helixIndex, points, distances, genericTimes);
+        PANDORA_TEST_CHECK((points.size() == distances.size()) && (points.size() == genericTimes.size()));
+
+        for (unsigned int iPoint = 0; iPoint < points.size(); ++iPoint)
+            CheckDistance(helixVector[helixIndex], points[iPoint], distances[iPoint], genericTimes[iPoint]);
+    }
+
+    PANDORA_TEST_CHECK(STATUS_CODE_OUT_OF_RANGE == TestHelper::GetStatusCode([&]() -> StatusCode
+    {
+        helixBatch.GetDistancesToPoints(helixBatch.GetNHelices(), points, distances, genericTimes);
+        return STATUS_CODE_SUCCESS;
+    }));
+
+    // An empty batch
+    const HelixBatch emptyHelixBatch;
+    emptyHelixBatch.GetPointsOnCircle(80.f, intersectionPoints, genericTimes, statusCodes);
+    PANDORA_TEST_CHECK(intersectionPoints.empty() && genericTimes.empty() && statusCodes.empty());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test that helices without an intersection have a zero generic time, and are not reported as having negative generic times
+ */
+void TestHelixBatchNotFound()
+{
+    std::mt19937 generator(38);
+    const std::vector<Helix> helixVector(GetRandomHelices(100, generator));
+    const HelixBatch helixBatch(helixVector);
+
+    CartesianPointVector intersectionPoints;
+    FloatVector genericTimes;
+    HelixBatch::StatusCodeVector statusCodes;
+
+    std::ostringstream outputStream;
+    std::streambuf *const pCoutBuffer(std::cout.rdbuf(outputStream.rdbuf()));
+    helixBatch.GetPointsOnCircle(10000.f, intersectionPoints, genericTimes, statusCodes);
+    helixBatch.GetPointsInXY(10000.f, 0.f, 0.f, 1.f, intersectionPoints, genericTimes, statusCodes);
+    std::cout.rdbuf(pCoutBuffer);
+
+    PANDORA_TEST_CHECK(outputStream.str().empty());
+
+    for (unsigned int iHelix = 0; iHelix < helixVector.size(); ++iHelix)
+        PANDORA_TEST_CHECK((STATUS_CODE_NOT_FOUND == statusCodes[iHelix]) && (0.f == genericTimes[iHelix]));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Check the closest approach pairs for the current track list against an exhaustive search over all pairs of tracks
+ * 
+ *  @param  algorithm the calling algorithm
+ *  @param  bField the bfield, units Tesla
+ * 
+ *  @return the status code
+ */
+StatusCode CheckClosestApproachPairs(const Algorithm &algorithm, const float bField)
+{
+    const TrackList *pTrackList(nullptr);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::GetCurrentList(algorithm, pTrackList));
+
+    // Helices rebuilt for each track, skipping the tracks without transverse momentum
+    TrackVector trackVector;
+    std::vector<Helix> helixVector;
+
+    for (const Track *const pTrack : *pTrackList)
+    {
+        const TrackState &trackState(pTrack->GetTrackStateAtStart());
+        const double px(trackState.GetMomentum().GetX()), py(trackState.GetMomentum().GetY());
+
+        if (std::sqrt(px * px + py * py) >= std::numeric_limits<float>::epsilon())
+        {
+            trackVector.push_back(pTrack);
+            helixVector.emplace_back(trackState.GetPosition(), trackState.GetMomentum(), static_cast<float>(pTrack->GetCharge()), bField);
+        }
+    }
+
+    PANDORA_TEST_CHECK((trackVector.size() > 0) && (trackVector.size() < pTrackList->size()));
+
+    for (const float maxHelixDistance : {1.f, 10.f, 50.f})
+    {
+        HelixPairVector helixPairVector;
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, HelixHelper::GetClosestApproachPairs(algorithm.GetPandora(), *pTrackList,
+            maxHelixDistance, helixPairVector));
+
+        HelixPairVector::const_iterator pairIter(helixPairVector.begin());
+
+        for (unsigned int i = 0; i < trackVector.size(); ++i)
+        {
+            for (unsigned int j = i + 1; j < trackVector.size(); ++j)
+            {
+                CartesianVector positionOfClosestApproach(0.f, 0.f, 0.f), v0Momentum(0.f, 0.f, 0.f);
+                float helixDistance(std::numeric_limits<float>::max());
+
+                // ATTN Helix distances can be undefined for very small helices, and such pairs must not be returned
+                if ((STATUS_CODE_SUCCESS != helixVector[i].GetDistanceToHelix(&helixVector[j], positionOfClosestApproach, v0Momentum,
+                    helixDistance)) || !(helixDistance < maxHelixDistance))
+                {
+                    continue;
+                }
+
+                PANDORA_TEST_CHECK(helixPairVector.end() != pairIter);
+
+                if (helixPairVector.end() == pairIter)
+                    return STATUS_CODE_SUCCESS;
+
+                const HelixPair &helixPair(*(pairIter++));
+                PANDORA_TEST_CHECK((trackVector[i] == helixPair.GetTrack1()) && (trackVector[j] == helixPair.GetTrack2()));
+                PANDORA_TEST_CHECK(TestHelper::IsClose(helixDistance, helixPair.GetHelixDistance(), 1.e-5));
+                PANDORA_TEST_CHECK(positionOfClosestApproach == helixPair.GetPositionOfClosestApproach());
+                PANDORA_TEST_CHECK(v0Momentum == helixPair.GetV0Momentum());
+            }
+        }
+
+        PANDORA_TEST_CHECK(helixPairVector.end() == pairIter);
+        PANDORA_TEST_CHECK(!helixPairVector.empty() || (maxHelixDistance < 10.f));
+
+        PANDORA_TEST_CHECK(STATUS_CODE_INVALID_PARAMETER == HelixHelper::GetClosestApproachPairs(algorithm.GetPandora(), *pTrackList,
+            maxHelixDistance, helixPairVector));
+    }
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Whether two helices have identical parameters
+ * 
+ *  @param  lhs the first helix
+ *  @param  rhs the second helix
+ * 
+ *  @return boolean
+ */
+bool IsIdentical(const Helix &lhs, const Helix &rhs)
+{
+    return ((lhs.GetReferencePoint() == rhs.GetReferencePoint()) && (lhs.GetMomentum() == rhs.GetMomentum()) &&
+        (lhs.GetCharge() == rhs.GetCharge()) && (lhs.GetPhi0() == rhs.GetPhi0()) && (lhs.GetD0() == rhs.GetD0()) &&
+        (lhs.GetZ0() == rhs.GetZ0()) && (lhs.GetOmega() == rhs.GetOmega()) && (lhs.GetTanLambda() == rhs.GetTanLambda()) &&
+        (lhs.GetXCentre() == rhs.GetXCentre()) && (lhs.GetYCentre() == rhs.GetYCentre()) && (lhs.GetRadius() == rhs.GetRadius()));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Check that the cached track helices are built once, for each track state, and match helices built directly
+ * 
+ *  @param  algorithm the calling algorithm
+ *  @param  bField the bfield, units Tesla
+ * 
+ *  @return the status code
+ */
+StatusCode CheckTrackHelices(const Algorithm &algorithm, const float bField)
+{
+    const TrackList *pTrackList(nullptr);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::GetCurrentList(algorithm, pTrackList));
+
+    for (const Track *const pTrack : *pTrackList)
+    {
+        const float charge(static_cast<float>(pTrack->GetCharge()));
+        const CartesianVector &momentum(pTrack->GetTrackStateAtStart().GetMomentum());
+
+        if (std::fabs(momentum.GetX()) + std::fabs(momentum.GetY()) > 0.f)
+        {
+            PANDORA_TEST_CHECK(&pTrack->GetHelixAtStart() == &pTrack->GetHelixAtStart());
+            PANDORA_TEST_CHECK(&pTrack->GetHelixAtStart() != &pTrack->GetHelixAtEnd());
+
+            const TrackState &startState(pTrack->GetTrackStateAtStart()), &endState(pTrack->GetTrackStateAtEnd());
+            const TrackState &calorimeterState(pTrack->GetTrackStateAtCalorimeter());
+            PANDORA_TEST_CHECK(IsIdentical(pTrack->GetHelixAtStart(), Helix(startState.GetPosition(), startState.GetMomentum(), charge,
+                bField)));
+            PANDORA_TEST_CHECK(IsIdentical(pTrack->GetHelixAtEnd(), Helix(endState.GetPosition(), endState.GetMomentum(), charge, bField)));
+            PANDORA_TEST_CHECK(IsIdentical(pTrack->GetHelixAtCalorimeter(), Helix(calorimeterState.GetPosition(),
+                calorimeterState.GetMomentum(), charge, bField)));
+        }
+        else
+        {
+            // The construction is attempted again on each request, failing each time
+            for (unsigned int iRepeat = 0; iRepeat < 2; ++iRepeat)
+            {
+                PANDORA_TEST_CHECK(STATUS_CODE_INVALID_PARAMETER == TestHelper::GetStatusCode([&]() -> StatusCode
+                {
+                    pTrack->GetHelixAtStart();
+                    return STATUS_CODE_SUCCESS;
+                }));
+            }
+        }
+    }
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test the cached track helices and the closest approach search over all pairs of tracks, for tracks from a few nearby
+ *          vertices
+ * 
+ *  @param  nThreads the number of threads
+ */
+void TestClosestApproachPairs(const unsigned int nThreads)
+{
+    const float bField(3.5f);
+    const Pandora *const pPandora(TestHelper::CreatePandora([&](const Algorithm &algorithm) -> StatusCode
+    {
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, CheckTrackHelices(algorithm, bField));
+        return CheckClosestApproachPairs(algorithm, bField);
+    }, nThreads));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetBFieldPlugin(*pPandora, new TestBFieldPlugin(bField)));
+
+    std::mt19937 generator(38);
+    const unsigned int nTracks(300);
+    std::vector<int> trackAddresses(nTracks);
+
+    for (unsigned int iTrack = 0; iTrack < nTracks; ++iTrack)
+    {
+        const float vertexPhi(0.5f * static_cast<float>(generator() % 12));
+        const CartesianVector vertex(500.f * std::cos(vertexPhi), 500.f * std::sin(vertexPhi), 0.f);
+        const CartesianVector position(vertex + CartesianVector(GetRandomValue(-5.f, 5.f, generator), GetRandomValue(-5.f, 5.f, generator),
+            GetRandomValue(-5.f, 5.f, generator)));
+
+        // Some tracks without transverse momentum, for which no helix is defined, and some with very small transverse momentum
+        const float pxy((0 == iTrack % 25) ? 0.f : (1 == iTrack % 25) ? 1.e-4f : GetRandomValue(0.2f, 10.f, generator));
+        const float phi(GetRandomValue(-3.f, 3.f, generator));
+        const CartesianVector momentum(pxy * std::cos(phi), pxy * std::sin(phi), GetRandomValue(-5.f, 5.f, generator));
+
+        PandoraApi::Track::Parameters parameters(TestHelper::GetTrackParameters((0 == generator() % 2) ? 1 : -1,
+            TrackState(position, momentum), &trackAddresses[iTrack]));
+        parameters.m_trackStateAtEnd = TrackState(position + momentum * 10.f, momentum * 0.9f);
+        parameters.m_trackStateAtCalorimeter = TrackState(position + momentum * 20.f, momentum * 0.8f);
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Track::Create(*pPandora, parameters));
+    }
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::ProcessEvent(*pPandora));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Reset(*pPandora));
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    TestHelixBatch();
+    TestHelixBatchNotFound();
+    TestClosestApproachPairs(1);
+    TestClosestApproachPairs(4);
+
+    return TestHelper::Finish("HelixTest");
+}
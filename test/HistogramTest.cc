@@ -0,0 +1,573 @@
+/**
+ *  @file   PandoraSDK/test/HistogramTest.cc
+ * 
+ *  @brief  Test histogram bin contents, sums, maxima and moments against reference maps of bin contents, and test histogram merging
+ *          and binary persistency.
+ * 
+ *  $Log: $
+ */
+
+#include "Helpers/ParallelHelper.h"
+
+#include "Objects/Histograms.h"
+
+#include "Pandora/Pandora.h"
+#include "Pandora/StatusCodes.h"
+
+#include "Persistency/BinaryFileReader.h"
+#include "Persistency/BinaryFileWriter.h"
+
+#include "TestHelper.h"
+
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <random>
+
+using namespace pandora;
+using namespace pandora_test;
+
+typedef std::map<int, double> ReferenceBinMap;
+typedef std::map<std::pair<int, int>, double> ReferenceTwoDBinMap;
+
+/**
+ *  @brief  Get a random value, usually within a histogram range extended by a few bins either side, otherwise a special value
+ * 
+ *  @param  low the low edge of the histogram range
+ *  @param  high the high edge of the histogram range
+ *  @param  generator the random number generator
+ * 
+ *  @return the value
+ */
+float GetRandomValue(const float low, const float high, std::mt19937 &generator)
+{
+    const FloatVector specialValues{std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity(),
+        -std::numeric_limits<float>::infinity(), low, high};
+
+    if (0 == generator() % 20)
+        return specialValues[generator() % specialValues.size()];
+
+    std::uniform_real_distribution<float> distribution(low - 0.2f * (high - low), high + 0.2f * (high - low));
+    return distribution(generator);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Get a random weight, a multiple of one half so that all sums of weights are exact
+ * 
+ *  @param  generator the random number generator
+ * 
+ *  @return the weight
+ */
+float GetRandomWeight(std::mt19937 &generator)
+{
+    return 0.5f * static_cast<float>(1 + generator() % 4);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Check a histogram against a reference map of bin contents
+ * 
+ *  @param  histogram the histogram
+ *  @param  referenceBinMap the reference map of bin contents
+ *  @param  generator the random number generator, used to choose the bin ranges to check
+ */
+void CheckHistogram(const Histogram &histogram, const ReferenceBinMap &referenceBinMap, std::mt19937 &generator)
+{
+    const int underflowBin(histogram.GetUnderflowBinNumber()), overflowBin(histogram.GetOverflowBinNumber());
+
+    for (int xBin = underflowBin - 1; xBin <= overflowBin + 1; ++xBin)
+        PANDORA_TEST_CHECK(histogram.GetBinContent(xBin) == (referenceBinMap.count(xBin) ? referenceBinMap.at(xBin) : 0.));
+
+    for (unsigned int iRange = 0; iRange < 20; ++iRange)
+    {
+        const int xLowBin(underflowBin - 2 + static_cast<int>(generator() % (histogram.GetNBinsX() + 5)));
+        const int xHighBin(underflowBin - 2 + static_cast<int>(generator() % (histogram.GetNBinsX() + 5)));
+
+        double sum(0.), maximumValue(0.), sumEntries(0.), sumXEntries(0.), sumXXEntries(0.);
+        int maximumBin(underflowBin);
+
+        for (const ReferenceBinMap::value_type &mapEntry : referenceBinMap)
+        {
+            if ((mapEntry.first < xLowBin) || (mapEntry.first > xHighBin))
+                continue;
+
+            sum += mapEntry.second;
+
+            if (mapEntry.second > maximumValue)
+            {
+                maximumValue = mapEntry.second;
+                maximumBin = mapEntry.first;
+            }
+
+            if ((mapEntry.first < histogram.GetMinBinNumber()) || (mapEntry.first > histogram.GetMaxBinNumber()))
+                continue;
+
+            const double binCenter(histogram.GetXLow() + histogram.GetXBinWidth() * (0.5 + mapEntry.first));
+            sumEntries += mapEntry.second;
+            sumXEntries += mapEntry.second * binCenter;
+            sumXXEntries += mapEntry.second * binCenter * binCenter;
+        }
+
+        PANDORA_TEST_CHECK(histogram.GetCumulativeSum(xLowBin, xHighBin) == sum);
+
+        float histogramMaximumValue(0.f);
+        int histogramMaximumBin(0);
+        histogram.GetMaximum(xLowBin, xHighBin, histogramMaximumValue, histogramMaximumBin);
+        PANDORA_TEST_CHECK((histogramMaximumValue == maximumValue) && (histogramMaximumBin == maximumBin));
+
+        const double meanX((sumEntries > 0.) ? sumXEntries / sumEntries : 0.);
+        const double standardDeviationX((sumEntries > 0.) ? std::sqrt(std::max(0., sumXXEntries / sumEntries - meanX * meanX)) : 0.);
+        PANDORA_TEST_CHECK(TestHelper::IsClose(histogram.GetMeanX(xLowBin, xHighBin), meanX, 1.e-4));
+        PANDORA_TEST_CHECK(TestHelper::IsClose(histogram.GetStandardDeviationX(xLowBin, xHighBin), standardDeviationX, 1.e-2));
+    }
+
+    double totalSum(0.);
+
+    for (const ReferenceBinMap::value_type &mapEntry : referenceBinMap)
+    {
+        if ((mapEntry.first >= histogram.GetMinBinNumber()) && (mapEntry.first <= histogram.GetMaxBinNumber()))
+            totalSum += mapEntry.second;
+    }
+
+    PANDORA_TEST_CHECK(histogram.GetCumulativeSum() == totalSum);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Check a two dimensional histogram against a reference map of bin contents
+ * 
+ *  @param  histogram the histogram
+ *  @param  referenceBinMap the reference map of bin contents
+ *  @param  generator the random number generator, used to choose the bin ranges to check
+ */
+void CheckTwoDHistogram(const TwoDHistogram &histogram, const ReferenceTwoDBinMap &referenceBinMap, std::mt19937 &generator)
+{
+    const int underflowBinX(histogram.GetUnderflowBinNumberX()), overflowBinX(histogram.GetOverflowBinNumberX());
+    const int underflowBinY(histogram.GetUnderflowBinNumberY()), overflowBinY(histogram.GetOverflowBinNumberY());
+
+    for (int yBin = underflowBinY - 1; yBin <= overflowBinY + 1; ++yBin)
+    {
+        for (int xBin = underflowBinX - 1; xBin <= overflowBinX + 1; ++xBin)
+        {
+            const ReferenceTwoDBinMap::const_iterator iter(referenceBinMap.find(std::make_pair(xBin, yBin)));
+            PANDORA_TEST_CHECK(histogram.GetBinContent(xBin, yBin) == ((referenceBinMap.end() != iter) ? iter->second : 0.));
+        }
+    }
+
+    for (unsigned int iRange = 0; iRange < 20; ++iRange)
+    {
+        const int xLowBin(underflowBinX - 2 + static_cast<int>(generator() % (histogram.GetNBinsX() + 5)));
+        const int xHighBin(underflowBinX - 2 + static_cast<int>(generator() % (histogram.GetNBinsX() + 5)));
+        const int yLowBin(underflowBinY - 2 + static_cast<int>(generator() % (histogram.GetNBinsY() + 5)));
+        const int yHighBin(underflowBinY - 2 + static_cast<int>(generator() % (histogram.GetNBinsY() + 5)));
+
+        double sum(0.), maximumValue(0.), sumEntries(0.), sumXEntries(0.), sumYEntries(0.);
+        int maximumBinX(underflowBinX), maximumBinY(underflowBinY);
+
+        // ATTN The maximum is the first bin with the largest content, scanning rows of increasing y bin
+        for (int yBin = yLowBin; yBin <= yHighBin; ++yBin)
+        {
+            for (int xBin = xLowBin; xBin <= xHighBin; ++xBin)
+            {
+                const ReferenceTwoDBinMap::const_iterator iter(referenceBinMap.find(std::make_pair(xBin, yBin)));
+
+                if (referenceBinMap.end() == iter)
+                    continue;
+
+                sum += iter->second;
+
+                if (iter->second > maximumValue)
+                {
+                    maximumValue = iter->second;
+                    maximumBinX = xBin;
+                    maximumBinY = yBin;
+                }
+
+                if ((xBin < histogram.GetMinBinNumberX()) || (xBin > histogram.GetMaxBinNumberX()) ||
+                    (yBin < histogram.GetMinBinNumberY()) || (yBin > histogram.GetMaxBinNumberY()))
+                {
+                    continue;
+                }
+
+                sumEntries += iter->second;
+                sumXEntries += iter->second * (histogram.GetXLow() + histogram.GetXBinWidth() * (0.5 + xBin));
+                sumYEntries += iter->second * (histogram.GetYLow() + histogram.GetYBinWidth() * (0.5 + yBin));
+            }
+        }
+
+        PANDORA_TEST_CHECK(histogram.GetCumulativeSum(xLowBin, xHighBin, yLowBin, yHighBin) == sum);
+
+        float histogramMaximumValue(0.f);
+        int histogramMaximumBinX(0), histogramMaximumBinY(0);
+        histogram.GetMaximum(xLowBin, xHighBin, yLowBin, yHighBin, histogramMaximumValue, histogramMaximumBinX, histogramMaximumBinY);
+        PANDORA_TEST_CHECK((histogramMaximumValue == maximumValue) && (histogramMaximumBinX == maximumBinX) &&
+            (histogramMaximumBinY == maximumBinY));
+
+        PANDORA_TEST_CHECK(TestHelper::IsClose(histogram.GetMeanX(xLowBin, xHighBin, yLowBin, yHighBin),
+            (sumEntries > 0.) ? sumXEntries / sumEntries : 0., 1.e-4));
+        PANDORA_TEST_CHECK(TestHelper::IsClose(histogram.GetMeanY(xLowBin, xHighBin, yLowBin, yHighBin),
+            (sumEntries > 0.) ? sumYEntries / sumEntries : 0., 1.e-4));
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test a histogram for a random sequence of fills, bin content changes and scalings
+ */
+void TestHistogram()
+{
+    std::mt19937 generator(34);
+    Histogram histogram(20, -5.f, 15.f);
+    ReferenceBinMap referenceBinMap;
+
+    for (unsigned int iOperation = 0; iOperation < 5000; ++iOperation)
+    {
+        if (0 == generator() % 50)
+        {
+            const int xBin(histogram.GetUnderflowBinNumber() + static_cast<int>(generator() % (histogram.GetNBinsX() + 2)));
+            const float value(GetRandomWeight(generator));
+            histogram.SetBinContent(xBin, value);
+            referenceBinMap[xBin] = value;
+        }
+        else if (0 == generator() % 500)
+        {
+            const float scaleFactor((0 == generator() % 2) ? 2.f : 0.5f);
+            histogram.Scale(scaleFactor);
+
+            for (ReferenceBinMap::value_type &mapEntry : referenceBinMap)
+                mapEntry.second *= scaleFactor;
+        }
+        else
+        {
+            const float valueX(GetRandomValue(histogram.GetXLow(), histogram.GetXHigh(), generator)), weight(GetRandomWeight(generator));
+            histogram.Fill(valueX, weight);
+
+            if (!std::isnan(valueX))
+                referenceBinMap[histogram.GetBinNumber(valueX)] += weight;
+        }
+
+        if (0 == iOperation % 100)
+            CheckHistogram(histogram, referenceBinMap, generator);
+    }
+
+    CheckHistogram(histogram, referenceBinMap, generator);
+    CheckHistogram(Histogram(histogram), referenceBinMap, generator);
+
+    PANDORA_TEST_CHECK(STATUS_CODE_INVALID_PARAMETER == TestHelper::GetStatusCode([&]() -> StatusCode
+    {
+        histogram.SetBinContent(histogram.GetOverflowBinNumber() + 1, 1.f);
+        return STATUS_CODE_SUCCESS;
+    }));
+
+    histogram.Reset();
+    CheckHistogram(histogram, ReferenceBinMap(), generator);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test a two dimensional histogram for a random sequence of fills, bin content changes and scalings, querying sums throughout
+ */
+void TestTwoDHistogram()
+{
+    std::mt19937 generator(340);
+    TwoDHistogram histogram(12, 0.f, 6.f, 9, -3.f, 6.f);
+    ReferenceTwoDBinMap referenceBinMap;
+
+    for (unsigned int iOperation = 0; iOperation < 5000; ++iOperation)
+    {
+        if (0 == generator() % 50)
+        {
+            const int xBin(histogram.GetUnderflowBinNumberX() + static_cast<int>(generator() % (histogram.GetNBinsX() + 2)));
+            const int yBin(histogram.GetUnderflowBinNumberY() + static_cast<int>(generator() % (histogram.GetNBinsY() + 2)));
+            const float value(GetRandomWeight(generator));
+            histogram.SetBinContent(xBin, yBin, value);
+            referenceBinMap[std::make_pair(xBin, yBin)] = value;
+        }
+        else if (0 == generator() % 500)
+        {
+            const float scaleFactor((0 == generator() % 2) ? 2.f : 0.5f);
+            histogram.Scale(scaleFactor);
+
+            for (ReferenceTwoDBinMap::value_type &mapEntry : referenceBinMap)
+                mapEntry.second *= scaleFactor;
+        }
+        else
+        {
+            const float valueX(GetRandomValue(histogram.GetXLow(), histogram.GetXHigh(), generator));
+            const float valueY(GetRandomValue(histogram.GetYLow(), histogram.GetYHigh(), generator));
+            const float weight(GetRandomWeight(generator));
+            histogram.Fill(valueX, valueY, weight);
+
+            if (!std::isnan(valueX) && !std::isnan(valueY))
+                referenceBinMap[std::make_pair(histogram.GetBinNumberX(valueX), histogram.GetBinNumberY(valueY))] += weight;
+        }
+
+        // ATTN Sums are queried between changes, so the summed area table is repeatedly invalidated and rebuilt
+        if (0 == iOperation % 100)
+            CheckTwoDHistogram(histogram, referenceBinMap, generator);
+    }
+
+    CheckTwoDHistogram(histogram, referenceBinMap, generator);
+
+    const TwoDHistogram copiedHistogram(histogram);
+    TwoDHistogram assignedHistogram(2, 0.f, 1.f, 2, 0.f, 1.f);
+    assignedHistogram = histogram;
+    histogram.Reset();
+
+    CheckTwoDHistogram(copiedHistogram, referenceBinMap, generator);
+    CheckTwoDHistogram(assignedHistogram, referenceBinMap, generator);
+    CheckTwoDHistogram(histogram, ReferenceTwoDBinMap(), generator);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Whether two histograms have identical bin contents, including the underflow and overflow bins
+ * 
+ *  @param  lhs the first histogram
+ *  @param  rhs the second histogram
+ * 
+ *  @return boolean
+ */
+bool IsIdentical(const Histogram &lhs, const Histogram &rhs)
+{
+    for (int xBin = lhs.GetUnderflowBinNumber(); xBin <= lhs.GetOverflowBinNumber(); ++xBin)
+    {
+        if (lhs.GetBinContent(xBin) != rhs.GetBinContent(xBin))
+            return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Whether two two dimensional histograms have identical bin contents, including the underflow and overflow bins
+ * 
+ *  @param  lhs the first histogram
+ *  @param  rhs the second histogram
+ * 
+ *  @return boolean
+ */
+bool IsIdentical(const TwoDHistogram &lhs, const TwoDHistogram &rhs)
+{
+    for (int yBin = lhs.GetUnderflowBinNumberY(); yBin <= lhs.GetOverflowBinNumberY(); ++yBin)
+    {
+        for (int xBin = lhs.GetUnderflowBinNumberX(); xBin <= lhs.GetOverflowBinNumberX(); ++xBin)
+        {
+            if (lhs.GetBinContent(xBin, yBin) != rhs.GetBinContent(xBin, yBin))
+                return false;
+        }
+    }
+
+    return (lhs.GetCumulativeSum() == rhs.GetCumulativeSum());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test histograms filled in parallel, via a histogram accumulator, against histograms filled serially, and test histogram
+ *          addition
+ */
+void TestMerging()
+{
+    std::mt19937 generator(35);
+    const unsigned int nValues(100000), nThreads(4);
+    FloatVector valuesX, valuesY, weights;
+
+    for (unsigned int iValue = 0; iValue < nValues; ++iValue)
+    {
+        valuesX.push_back(GetRandomValue(0.f, 10.f, generator));
+        valuesY.push_back(GetRandomValue(-5.f, 5.f, generator));
+        weights.push_back(GetRandomWeight(generator));
+    }
+
+    Histogram serialHistogram(25, 0.f, 10.f);
+    TwoDHistogram serialTwoDHistogram(25, 0.f, 10.f, 20, -5.f, 5.f);
+
+    for (unsigned int iValue = 0; iValue < nValues; ++iValue)
+    {
+        serialHistogram.Fill(valuesX[iValue], weights[iValue]);
+        serialTwoDHistogram.Fill(valuesX[iValue], valuesY[iValue], weights[iValue]);
+    }
+
+    // The prototype contents are not copied to the partial histograms
+    Histogram mergedHistogram(serialHistogram), prototypeHistogram(serialHistogram);
+    TwoDHistogram mergedTwoDHistogram(serialTwoDHistogram), prototypeTwoDHistogram(serialTwoDHistogram);
+    mergedHistogram.Reset();
+    mergedTwoDHistogram.Reset();
+
+    const unsigned int nBlocks(ParallelHelper::GetNBlocks(nValues, nThreads));
+    HistogramAccumulator<Histogram> accumulator(prototypeHistogram, nBlocks);
+    HistogramAccumulator<TwoDHistogram> twoDAccumulator(prototypeTwoDHistogram, nBlocks);
+    PANDORA_TEST_CHECK((nBlocks > 1) && (nBlocks == accumulator.GetNPartials()) && (nBlocks == twoDAccumulator.GetNPartials()));
+
+    for (unsigned int iRepeat = 0; iRepeat < 2; ++iRepeat)
+    {
+        ParallelHelper::ForEachBlock(nValues, nThreads, [&](const size_t blockIndex, const size_t begin, const size_t end)
+        {
+            Histogram &histogram(accumulator.GetPartial(blockIndex));
+            TwoDHistogram &twoDHistogram(twoDAccumulator.GetPartial(blockIndex));
+
+            for (size_t iValue = begin; iValue < end; ++iValue)
+            {
+                histogram.Fill(valuesX[iValue], weights[iValue]);
+                twoDHistogram.Fill(valuesX[iValue], valuesY[iValue], weights[iValue]);
+            }
+        });
+
+        accumulator.Merge(mergedHistogram);
+        twoDAccumulator.Merge(mergedTwoDHistogram);
+        PANDORA_TEST_CHECK(IsIdentical(mergedHistogram, serialHistogram));
+        PANDORA_TEST_CHECK(IsIdentical(mergedTwoDHistogram, serialTwoDHistogram));
+
+        accumulator.Reset();
+        twoDAccumulator.Reset();
+        mergedHistogram.Reset();
+        mergedTwoDHistogram.Reset();
+    }
+
+    PANDORA_TEST_CHECK(STATUS_CODE_OUT_OF_RANGE == TestHelper::GetStatusCode([&]() -> StatusCode
+    {
+        accumulator.GetPartial(nBlocks);
+        return STATUS_CODE_SUCCESS;
+    }));
+
+    // Scaled addition, and addition of histograms with different binning
+    Histogram scaledHistogram(serialHistogram);
+    scaledHistogram.Add(serialHistogram, -3.f);
+    Histogram expectedHistogram(serialHistogram);
+    expectedHistogram.Scale(-2.f);
+    PANDORA_TEST_CHECK(IsIdentical(scaledHistogram, expectedHistogram));
+
+    TwoDHistogram scaledTwoDHistogram(serialTwoDHistogram);
+    // Build the summed area table before the addition, which must then invalidate it
+    scaledTwoDHistogram.GetCumulativeSum(0, 5, 0, 5);
+    scaledTwoDHistogram.Add(serialTwoDHistogram, -3.f);
+    TwoDHistogram expectedTwoDHistogram(serialTwoDHistogram);
+    expectedTwoDHistogram.Scale(-2.f);
+    PANDORA_TEST_CHECK(IsIdentical(scaledTwoDHistogram, expectedTwoDHistogram));
+
+    PANDORA_TEST_CHECK(STATUS_CODE_INVALID_PARAMETER == TestHelper::GetStatusCode([&]() -> StatusCode
+    {
+        scaledHistogram.Add(Histogram(25, 0.f, 11.f));
+        return STATUS_CODE_SUCCESS;
+    }));
+    PANDORA_TEST_CHECK(STATUS_CODE_INVALID_PARAMETER == TestHelper::GetStatusCode([&]() -> StatusCode
+    {
+        scaledTwoDHistogram.Add(TwoDHistogram(25, 0.f, 10.f, 21, -5.f, 5.f));
+        return STATUS_CODE_SUCCESS;
+    }));
+    PANDORA_TEST_CHECK(IsIdentical(scaledHistogram, expectedHistogram));
+    PANDORA_TEST_CHECK(IsIdentical(scaledTwoDHistogram, expectedTwoDHistogram));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test that histograms written to a binary file are read back unchanged, and that truncated or corrupt files are rejected
+ */
+void TestBinaryPersistency()
+{
+    std::mt19937 generator(36);
+    Histogram histogram(40, -2.f, 8.f);
+    TwoDHistogram twoDHistogram(30, 0.f, 3.f, 25, -1.f, 1.f);
+
+    for (unsigned int iValue = 0; iValue < 5000; ++iValue)
+    {
+        histogram.Fill(GetRandomValue(-3.f, 9.f, generator), GetRandomWeight(generator));
+        twoDHistogram.Fill(GetRandomValue(-0.5f, 3.5f, generator), GetRandomValue(-1.5f, 1.5f, generator), GetRandomWeight(generator));
+    }
+
+    const Pandora pandora;
+    const std::string fileName("HistogramTest.pndr"), truncatedFileName("HistogramTestTruncated.pndr"),
+        corruptFileName("HistogramTestCorrupt.pndr");
+
+    {
+        BinaryFileWriter fileWriter(pandora, fileName, OVERWRITE);
+        histogram.WriteToBinary(fileWriter, "Histogram");
+        twoDHistogram.WriteToBinary(fileWriter, "TwoDHistogram");
+    }
+
+    {
+        BinaryFileReader fileReader(pandora, fileName);
+        const Histogram readHistogram(fileReader, "Histogram");
+        const TwoDHistogram readTwoDHistogram(fileReader, "TwoDHistogram");
+
+        PANDORA_TEST_CHECK((readHistogram.GetNBinsX() == histogram.GetNBinsX()) && (readHistogram.GetXLow() == histogram.GetXLow()) &&
+            (readHistogram.GetXHigh() == histogram.GetXHigh()) && IsIdentical(readHistogram, histogram));
+        PANDORA_TEST_CHECK((readTwoDHistogram.GetNBinsX() == twoDHistogram.GetNBinsX()) &&
+            (readTwoDHistogram.GetNBinsY() == twoDHistogram.GetNBinsY()) && (readTwoDHistogram.GetYLow() == twoDHistogram.GetYLow()) &&
+            (readTwoDHistogram.GetYHigh() == twoDHistogram.GetYHigh()) && IsIdentical(readTwoDHistogram, twoDHistogram));
+    }
+
+    {
+        BinaryFileReader fileReader(pandora, fileName);
+        PANDORA_TEST_CHECK(STATUS_CODE_NOT_FOUND == TestHelper::GetStatusCode([&]() -> StatusCode
+        {
+            const Histogram readHistogram(fileReader, "OtherHistogram");
+            return STATUS_CODE_SUCCESS;
+        }));
+    }
+
+    // A file truncated part way through the bin contents of the second histogram
+    std::ifstream fileStream(fileName, std::ios::in | std::ios::binary);
+    const std::string fileContents((std::istreambuf_iterator<char>(fileStream)), std::istreambuf_iterator<char>());
+    TestHelper::WriteFile(truncatedFileName, fileContents.substr(0, fileContents.size() - 10 * sizeof(float)));
+
+    {
+        BinaryFileReader fileReader(pandora, truncatedFileName);
+        const Histogram readHistogram(fileReader, "Histogram");
+        PANDORA_TEST_CHECK(IsIdentical(readHistogram, histogram));
+        PANDORA_TEST_CHECK(STATUS_CODE_FAILURE == TestHelper::GetStatusCode([&]() -> StatusCode
+        {
+            const TwoDHistogram readTwoDHistogram(fileReader, "TwoDHistogram");
+            return STATUS_CODE_SUCCESS;
+        }));
+    }
+
+    // A corrupt number of bin contents, which must be rejected before any allocation is made
+    {
+        BinaryFileWriter fileWriter(pandora, corruptFileName, OVERWRITE);
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == fileWriter.WriteVariable(std::string("Histogram")));
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == fileWriter.WriteVariable(10));
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == fileWriter.WriteVariable(0.f));
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == fileWriter.WriteVariable(1.f));
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == fileWriter.WriteVariable(std::numeric_limits<unsigned int>::max()));
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == fileWriter.WriteVariable(FloatVector(12, 1.f)));
+    }
+
+    {
+        BinaryFileReader fileReader(pandora, corruptFileName);
+        PANDORA_TEST_CHECK(STATUS_CODE_FAILURE == TestHelper::GetStatusCode([&]() -> StatusCode
+        {
+            const Histogram readHistogram(fileReader, "Histogram");
+            return STATUS_CODE_SUCCESS;
+        }));
+    }
+
+    std::remove(fileName.c_str());
+    std::remove(truncatedFileName.c_str());
+    std::remove(corruptFileName.c_str());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    TestHistogram();
+    TestTwoDHistogram();
+    TestMerging();
+    TestBinaryPersistency();
+
+    return TestHelper::Finish("HistogramTest");
+}
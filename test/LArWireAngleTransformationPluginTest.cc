@@ -0,0 +1,512 @@
+/**
+ *  @file   PandoraSDK/test/LArWireAngleTransformationPluginTest.cc
+ * 
+ *  @brief  Test of the lar wire angle transformation plugin, comparing batch transformations with the single position transformations,
+ *          and with a reference plugin, for wire angles taken from the lar tpcs and from the plugin settings.
+ * 
+ *  $Log: $
+ */
+
+#include "Api/PandoraApi.h"
+
+#include "Geometry/LArTPC.h"
+
+#include "Managers/GeometryManager.h"
+#include "Managers/PluginManager.h"
+
+#include "Plugins/LArWireAngleTransformationPlugin.h"
+
+#include "Xml/tinyxml.h"
+
+#include "TestHelper.h"
+
+#include <limits>
+#include <random>
+
+using namespace pandora;
+using namespace pandora_test;
+
+/**
+ *  @brief  ReferenceTransformationPlugin class, implementing only the single position transformations, directly from the wire angles,
+ *          so that its batch transformations are the default implementations provided by the lar transformation plugin interface
+ */
+class ReferenceTransformationPlugin : public LArTransformationPlugin
+{
+public:
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  wireAngleU the u wire angle to the vertical, units radians
+     *  @param  wireAngleV the v wire angle to the vertical, units radians
+     *  @param  wireAngleW the w wire angle to the vertical, units radians
+     */
+    ReferenceTransformationPlugin(const double wireAngleU, const double wireAngleV, const double wireAngleW);
+
+    double UVtoW(const double u, const double v) const;
+    double VWtoU(const double v, const double w) const;
+    double WUtoV(const double w, const double u) const;
+    double UVtoY(const double u, const double v) const;
+    double UVtoZ(const double u, const double v) const;
+    double UWtoY(const double u, const double w) const;
+    double UWtoZ(const double u, const double w) const;
+    double VWtoY(const double v, const double w) const;
+    double VWtoZ(const double v, const double w) const;
+    double YZtoU(const double y, const double z) const;
+    double YZtoV(const double y, const double z) const;
+    double YZtoW(const double y, const double z) const;
+
+    void GetMinChiSquaredYZ(const double u, const double v, const double w, const double sigmaU, const double sigmaV, const double sigmaW,
+        double &y, double &z, double &chiSquared) const;
+
+    void GetMinChiSquaredYZ(const double u, const double v, const double w, const double sigmaU, const double sigmaV, const double sigmaW,
+        const double uFit, const double vFit, const double wFit, const double sigmaFit, double &y, double &z, double &chiSquared) const;
+
+private:
+    StatusCode ReadSettings(const TiXmlHandle xmlHandle);
+
+    /**
+     *  @brief  Get the y and z coordinates of the crossing point of wires from two planes
+     * 
+     *  @param  wireAngleA the first wire angle to the vertical
+     *  @param  a the first wire coordinate
+     *  @param  wireAngleB the second wire angle to the vertical
+     *  @param  b the second wire coordinate
+     *  @param  y to receive the y coordinate
+     *  @param  z to receive the z coordinate
+     */
+    static void GetCrossingPoint(const double wireAngleA, const double a, const double wireAngleB, const double b, double &y, double &z);
+
+    double      m_wireAngle[3];     ///< The u, v and w wire angles to the vertical, units radians
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+ReferenceTransformationPlugin::ReferenceTransformationPlugin(const double wireAngleU, const double wireAngleV, const double wireAngleW) :
+    m_wireAngle{wireAngleU, wireAngleV, wireAngleW}
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+double ReferenceTransformationPlugin::UVtoW(const double u, const double v) const
+{
+    double y(0.), z(0.);
+    GetCrossingPoint(m_wireAngle[0], u, m_wireAngle[1], v, y, z);
+    return this->YZtoW(y, z);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+double ReferenceTransformationPlugin::VWtoU(const double v, const double w) const
+{
+    double y(0.), z(0.);
+    GetCrossingPoint(m_wireAngle[1], v, m_wireAngle[2], w, y, z);
+    return this->YZtoU(y, z);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+double ReferenceTransformationPlugin::WUtoV(const double w, const double u) const
+{
+    double y(0.), z(0.);
+    GetCrossingPoint(m_wireAngle[2], w, m_wireAngle[0], u, y, z);
+    return this->YZtoV(y, z);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+double ReferenceTransformationPlugin::UVtoY(const double u, const double v) const
+{
+    double y(0.), z(0.);
+    GetCrossingPoint(m_wireAngle[0], u, m_wireAngle[1], v, y, z);
+    return y;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+double ReferenceTransformationPlugin::UVtoZ(const double u, const double v) const
+{
+    double y(0.), z(0.);
+    GetCrossingPoint(m_wireAngle[0], u, m_wireAngle[1], v, y, z);
+    return z;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+double ReferenceTransformationPlugin::UWtoY(const double u, const double w) const
+{
+    double y(0.), z(0.);
+    GetCrossingPoint(m_wireAngle[0], u, m_wireAngle[2], w, y, z);
+    return y;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+double ReferenceTransformationPlugin::UWtoZ(const double u, const double w) const
+{
+    double y(0.), z(0.);
+    GetCrossingPoint(m_wireAngle[0], u, m_wireAngle[2], w, y, z);
+    return z;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+double ReferenceTransformationPlugin::VWtoY(const double v, const double w) const
+{
+    double y(0.), z(0.);
+    GetCrossingPoint(m_wireAngle[1], v, m_wireAngle[2], w, y, z);
+    return y;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+double ReferenceTransformationPlugin::VWtoZ(const double v, const double w) const
+{
+    double y(0.), z(0.);
+    GetCrossingPoint(m_wireAngle[1], v, m_wireAngle[2], w, y, z);
+    return z;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+double ReferenceTransformationPlugin::YZtoU(const double y, const double z) const
+{
+    return (z * std::cos(m_wireAngle[0]) - y * std::sin(m_wireAngle[0]));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+double ReferenceTransformationPlugin::YZtoV(const double y, const double z) const
+{
+    return (z * std::cos(m_wireAngle[1]) - y * std::sin(m_wireAngle[1]));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+double ReferenceTransformationPlugin::YZtoW(const double y, const double z) const
+{
+    return (z * std::cos(m_wireAngle[2]) - y * std::sin(m_wireAngle[2]));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ReferenceTransformationPlugin::GetMinChiSquaredYZ(const double u, const double v, const double w, const double sigmaU,
+    const double sigmaV, const double sigmaW, double &y, double &z, double &chiSquared) const
+{
+    this->GetMinChiSquaredYZ(u, v, w, sigmaU, sigmaV, sigmaW, 0., 0., 0., -1., y, z, chiSquared);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ReferenceTransformationPlugin::GetMinChiSquaredYZ(const double u, const double v, const double w, const double sigmaU,
+    const double sigmaV, const double sigmaW, const double uFit, const double vFit, const double wFit, const double sigmaFit, double &y,
+    double &z, double &chiSquared) const
+{
+    if ((sigmaU < std::numeric_limits<double>::epsilon()) || (sigmaV < std::numeric_limits<double>::epsilon()) ||
+        (sigmaW < std::numeric_limits<double>::epsilon()))
+    {
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    }
+
+    // Solve the normal equations for the weighted least squares fit of y and z to the wire coordinates and, optionally, the fit values
+    const double positions[3] = {u, v, w}, fitPositions[3] = {uFit, vFit, wFit};
+    const double weights[3] = {1. / (sigmaU * sigmaU), 1. / (sigmaV * sigmaV), 1. / (sigmaW * sigmaW)};
+    const double fitWeight((sigmaFit > 0.) ? 1. / (sigmaFit * sigmaFit) : 0.);
+
+    double syy(0.), syz(0.), szz(0.), by(0.), bz(0.);
+
+    for (unsigned int iView = 0; iView < 3; ++iView)
+    {
+        const double sinAngle(std::sin(m_wireAngle[iView])), cosAngle(std::cos(m_wireAngle[iView]));
+        const double weight(weights[iView] + fitWeight), target(weights[iView] * positions[iView] + fitWeight * fitPositions[iView]);
+        syy += weight * sinAngle * sinAngle;
+        syz -= weight * sinAngle * cosAngle;
+        szz += weight * cosAngle * cosAngle;
+        by -= sinAngle * target;
+        bz += cosAngle * target;
+    }
+
+    const double determinant(syy * szz - syz * syz);
+    y = (szz * by - syz * bz) / determinant;
+    z = (syy * bz - syz * by) / determinant;
+    chiSquared = 0.;
+
+    for (unsigned int iView = 0; iView < 3; ++iView)
+    {
+        const double projection(z * std::cos(m_wireAngle[iView]) - y * std::sin(m_wireAngle[iView]));
+        chiSquared += weights[iView] * (projection - positions[iView]) * (projection - positions[iView]);
+        chiSquared += fitWeight * (projection - fitPositions[iView]) * (projection - fitPositions[iView]);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode ReferenceTransformationPlugin::ReadSettings(const TiXmlHandle /*xmlHandle*/)
+{
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ReferenceTransformationPlugin::GetCrossingPoint(const double wireAngleA, const double a, const double wireAngleB, const double b,
+    double &y, double &z)
+{
+    const double sinAngleDifference(std::sin(wireAngleA - wireAngleB));
+    y = (-std::cos(wireAngleB) * a + std::cos(wireAngleA) * b) / sinAngleDifference;
+    z = (-std::sin(wireAngleB) * a + std::sin(wireAngleA) * b) / sinAngleDifference;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+typedef void (LArTransformationPlugin::*BatchTransformation)(const double *const, const double *const, const unsigned int,
+    double *const) const;
+typedef double (LArTransformationPlugin::*Transformation)(const double, const double) const;
+
+/**
+ *  @brief  Compare a batch transformation with the single position transformation, for the plugin under test and the reference plugin
+ * 
+ *  @param  plugin the plugin under test
+ *  @param  referencePlugin the reference plugin
+ *  @param  batchTransformation the batch transformation
+ *  @param  transformation the single position transformation
+ *  @param  first the first coordinates
+ *  @param  second the second coordinates
+ */
+void CompareTransformation(const LArTransformationPlugin &plugin, const LArTransformationPlugin &referencePlugin,
+    const BatchTransformation batchTransformation, const Transformation transformation, const std::vector<double> &first,
+    const std::vector<double> &second)
+{
+    std::vector<double> results(first.size(), 0.), referenceResults(first.size(), 0.);
+    (plugin.*batchTransformation)(first.data(), second.data(), first.size(), results.data());
+    (referencePlugin.*batchTransformation)(first.data(), second.data(), first.size(), referenceResults.data());
+
+    for (unsigned int index = 0; index < first.size(); ++index)
+    {
+        PANDORA_TEST_CHECK(results[index] == (plugin.*transformation)(first[index], second[index]));
+        PANDORA_TEST_CHECK(referenceResults[index] == (referencePlugin.*transformation)(first[index], second[index]));
+        PANDORA_TEST_CHECK(TestHelper::IsClose(results[index], referenceResults[index], 1.e-9));
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Get the xml settings specifying the wire angles for the lar wire angle transformation plugin
+ * 
+ *  @param  wireAngleU the u wire angle to the vertical, units radians
+ *  @param  wireAngleV the v wire angle to the vertical, units radians
+ *  @param  wireAngleW the w wire angle to the vertical, units radians
+ * 
+ *  @return the xml settings
+ */
+std::string GetPluginSettings(const double wireAngleU, const double wireAngleV, const double wireAngleW)
+{
+    return ("<pandora>\n"
+        "    <LArTransformationPlugin>\n"
+        "        <ShouldUseLArTPCWireAngles>false</ShouldUseLArTPCWireAngles>\n"
+        "        <WireAngleU>" + std::to_string(wireAngleU) + "</WireAngleU>\n"
+        "        <WireAngleV>" + std::to_string(wireAngleV) + "</WireAngleV>\n"
+        "        <WireAngleW>" + std::to_string(wireAngleW) + "</WireAngleW>\n"
+        "    </LArTransformationPlugin>\n"
+        "</pandora>\n");
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Compare the plugin batch and single position transformations with one another and with those of a reference plugin
+ * 
+ *  @param  plugin the plugin under test
+ *  @param  referencePlugin the reference plugin, with the same wire angles
+ */
+void CompareWithReference(const LArTransformationPlugin &plugin, const ReferenceTransformationPlugin &referencePlugin)
+{
+    // Wire coordinates of random points, with the u coordinates smeared so that the three views are not exactly consistent
+    std::mt19937 generator(6);
+    std::uniform_real_distribution<double> distribution(-1., 1.);
+    const unsigned int nPositions(10007);
+    std::vector<double> yCoordinates, zCoordinates, uCoordinates, vCoordinates, wCoordinates;
+
+    for (unsigned int index = 0; index < nPositions; ++index)
+    {
+        const double y(5000. * distribution(generator)), z(5000. * distribution(generator));
+        yCoordinates.push_back(y);
+        zCoordinates.push_back(z);
+        uCoordinates.push_back(referencePlugin.YZtoU(y, z) + 0.1 * distribution(generator));
+        vCoordinates.push_back(referencePlugin.YZtoV(y, z));
+        wCoordinates.push_back(referencePlugin.YZtoW(y, z));
+    }
+
+    const std::vector<double> &u(uCoordinates), &v(vCoordinates), &w(wCoordinates), &y(yCoordinates), &z(zCoordinates);
+    CompareTransformation(plugin, referencePlugin, &LArTransformationPlugin::UVtoWBatch, &LArTransformationPlugin::UVtoW, u, v);
+    CompareTransformation(plugin, referencePlugin, &LArTransformationPlugin::VWtoUBatch, &LArTransformationPlugin::VWtoU, v, w);
+    CompareTransformation(plugin, referencePlugin, &LArTransformationPlugin::WUtoVBatch, &LArTransformationPlugin::WUtoV, w, u);
+    CompareTransformation(plugin, referencePlugin, &LArTransformationPlugin::UVtoYBatch, &LArTransformationPlugin::UVtoY, u, v);
+    CompareTransformation(plugin, referencePlugin, &LArTransformationPlugin::UVtoZBatch, &LArTransformationPlugin::UVtoZ, u, v);
+    CompareTransformation(plugin, referencePlugin, &LArTransformationPlugin::UWtoYBatch, &LArTransformationPlugin::UWtoY, u, w);
+    CompareTransformation(plugin, referencePlugin, &LArTransformationPlugin::UWtoZBatch, &LArTransformationPlugin::UWtoZ, u, w);
+    CompareTransformation(plugin, referencePlugin, &LArTransformationPlugin::VWtoYBatch, &LArTransformationPlugin::VWtoY, v, w);
+    CompareTransformation(plugin, referencePlugin, &LArTransformationPlugin::VWtoZBatch, &LArTransformationPlugin::VWtoZ, v, w);
+    CompareTransformation(plugin, referencePlugin, &LArTransformationPlugin::YZtoUBatch, &LArTransformationPlugin::YZtoU, y, z);
+    CompareTransformation(plugin, referencePlugin, &LArTransformationPlugin::YZtoVBatch, &LArTransformationPlugin::YZtoV, y, z);
+    CompareTransformation(plugin, referencePlugin, &LArTransformationPlugin::YZtoWBatch, &LArTransformationPlugin::YZtoW, y, z);
+
+    // The v and w coordinates are consistent, so recover the original y and z coordinates
+    for (unsigned int index = 0; index < nPositions; ++index)
+    {
+        PANDORA_TEST_CHECK(TestHelper::IsClose(plugin.VWtoY(v[index], w[index]), y[index], 1.e-9));
+        PANDORA_TEST_CHECK(TestHelper::IsClose(plugin.VWtoZ(v[index], w[index]), z[index], 1.e-9));
+    }
+
+    // Chi squared minimisation, without and with fit positions
+    std::vector<double> fitY(nPositions, 0.), fitZ(nPositions, 0.), chiSquared(nPositions, 0.);
+    std::vector<double> referenceFitY(nPositions, 0.), referenceFitZ(nPositions, 0.), referenceChiSquared(nPositions, 0.);
+
+    for (const bool useFitPositions : {false, true})
+    {
+        if (useFitPositions)
+        {
+            plugin.GetMinChiSquaredYZBatch(u.data(), v.data(), w.data(), w.data(), u.data(), v.data(), nPositions, 0.5, 1., 2., 3.,
+                fitY.data(), fitZ.data(), chiSquared.data());
+            referencePlugin.GetMinChiSquaredYZBatch(u.data(), v.data(), w.data(), w.data(), u.data(), v.data(), nPositions, 0.5, 1., 2., 3.,
+                referenceFitY.data(), referenceFitZ.data(), referenceChiSquared.data());
+        }
+        else
+        {
+            plugin.GetMinChiSquaredYZBatch(u.data(), v.data(), w.data(), nPositions, 0.5, 1., 2., fitY.data(), fitZ.data(),
+                chiSquared.data());
+            referencePlugin.GetMinChiSquaredYZBatch(u.data(), v.data(), w.data(), nPositions, 0.5, 1., 2., referenceFitY.data(),
+                referenceFitZ.data(), referenceChiSquared.data());
+        }
+
+        for (unsigned int index = 0; index < nPositions; ++index)
+        {
+            double singleY(0.), singleZ(0.), singleChiSquared(0.);
+
+            if (useFitPositions)
+            {
+                plugin.GetMinChiSquaredYZ(u[index], v[index], w[index], 0.5, 1., 2., w[index], u[index], v[index], 3., singleY, singleZ,
+                    singleChiSquared);
+            }
+            else
+            {
+                plugin.GetMinChiSquaredYZ(u[index], v[index], w[index], 0.5, 1., 2., singleY, singleZ, singleChiSquared);
+            }
+
+            PANDORA_TEST_CHECK((singleY == fitY[index]) && (singleZ == fitZ[index]) && (singleChiSquared == chiSquared[index]));
+            PANDORA_TEST_CHECK(TestHelper::IsClose(fitY[index], referenceFitY[index], 1.e-6));
+            PANDORA_TEST_CHECK(TestHelper::IsClose(fitZ[index], referenceFitZ[index], 1.e-6));
+            PANDORA_TEST_CHECK(TestHelper::IsClose(chiSquared[index], referenceChiSquared[index], 1.e-5));
+        }
+    }
+
+    // Exactly consistent wire coordinates give zero chi squared, and zero resolutions are rejected
+    double fitYValue(0.), fitZValue(0.), chiSquaredValue(0.);
+    plugin.GetMinChiSquaredYZ(referencePlugin.YZtoU(12., 34.), referencePlugin.YZtoV(12., 34.), referencePlugin.YZtoW(12., 34.), 1., 1.,
+        1., fitYValue, fitZValue, chiSquaredValue);
+    PANDORA_TEST_CHECK(TestHelper::IsClose(fitYValue, 12., 1.e-9));
+    PANDORA_TEST_CHECK(TestHelper::IsClose(fitZValue, 34., 1.e-9));
+    PANDORA_TEST_CHECK(chiSquaredValue < 1.e-12);
+
+    PANDORA_TEST_CHECK(STATUS_CODE_INVALID_PARAMETER == TestHelper::GetStatusCode([&]() -> StatusCode
+    {
+        plugin.GetMinChiSquaredYZ(1., 2., 3., 0., 1., 1., fitYValue, fitZValue, chiSquaredValue);
+        return STATUS_CODE_SUCCESS;
+    }));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test the transformations for wire angles taken from the lar tpcs registered with the geometry
+ */
+void TestLArTPCWireAngles()
+{
+    const Pandora *const pPandora(new Pandora());
+
+    for (unsigned int volumeId = 0; volumeId < 2; ++volumeId)
+    {
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Geometry::LArTPC::Create(*pPandora,
+            TestHelper::GetLArTPCParameters(volumeId, CartesianVector(1000.f * volumeId, 0.f, 0.f), 1000.f)));
+    }
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetLArTransformationPlugin(*pPandora, new LArWireAngleTransformationPlugin));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == TestHelper::ReadSettings(*pPandora, "<pandora></pandora>\n"));
+
+    const LArTPC *const pLArTPC(pPandora->GetGeometry()->GetLArTPCMap().begin()->second);
+    const ReferenceTransformationPlugin referencePlugin(pLArTPC->GetWireAngleU(), pLArTPC->GetWireAngleV(), pLArTPC->GetWireAngleW());
+    CompareWithReference(*pPandora->GetPlugins()->GetLArTransformationPlugin(), referencePlugin);
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test the transformations for wire angles specified in the plugin settings, which need no lar tpcs
+ */
+void TestSettingsWireAngles()
+{
+    const Pandora *const pPandora(new Pandora());
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetLArTransformationPlugin(*pPandora, new LArWireAngleTransformationPlugin));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == TestHelper::ReadSettings(*pPandora, GetPluginSettings(0.6, -0.6, 0.1)));
+
+    const ReferenceTransformationPlugin referencePlugin(0.6, -0.6, 0.1);
+    CompareWithReference(*pPandora->GetPlugins()->GetLArTransformationPlugin(), referencePlugin);
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test that the plugin fails to initialize without lar tpcs or wire angle settings, for lar tpcs with differing wire angles,
+ *          and for two views sharing a wire angle
+ */
+void TestInvalidWireAngles()
+{
+    // ATTN Pandora reports any failure in reading settings as STATUS_CODE_FAILURE
+    const auto getStatusCode = [](const bool shouldCreateLArTPCs, const float wireAngleU, const std::string &settings)
+    {
+        const Pandora *const pPandora(new Pandora());
+
+        for (unsigned int volumeId = 0; shouldCreateLArTPCs && (volumeId < 2); ++volumeId)
+        {
+            PandoraApi::Geometry::LArTPC::Parameters parameters(TestHelper::GetLArTPCParameters(volumeId,
+                CartesianVector(1000.f * volumeId, 0.f, 0.f), 1000.f));
+
+            if (volumeId > 0)
+                parameters.m_wireAngleU = wireAngleU;
+
+            PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Geometry::LArTPC::Create(*pPandora, parameters));
+        }
+
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetLArTransformationPlugin(*pPandora, new LArWireAngleTransformationPlugin));
+        const StatusCode statusCode(TestHelper::ReadSettings(*pPandora, settings));
+        delete pPandora;
+
+        return statusCode;
+    };
+
+    const std::string defaultSettings("<pandora></pandora>\n");
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == getStatusCode(true, 0.5f, defaultSettings));
+    PANDORA_TEST_CHECK(STATUS_CODE_FAILURE == getStatusCode(false, 0.5f, defaultSettings));
+    PANDORA_TEST_CHECK(STATUS_CODE_FAILURE == getStatusCode(true, 0.6f, defaultSettings));
+
+    // Wire angles specified in the plugin settings take precedence over those of the lar tpcs
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == getStatusCode(true, 0.6f, GetPluginSettings(0.6, -0.6, 0.1)));
+    PANDORA_TEST_CHECK(STATUS_CODE_FAILURE == getStatusCode(false, 0.5f, GetPluginSettings(0.6, 0.6, 0.1)));
+    PANDORA_TEST_CHECK(STATUS_CODE_FAILURE == getStatusCode(false, 0.5f, "<pandora><LArTransformationPlugin>"
+        "<ShouldUseLArTPCWireAngles>false</ShouldUseLArTPCWireAngles></LArTransformationPlugin></pandora>\n"));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    TestLArTPCWireAngles();
+    TestSettingsWireAngles();
+    TestInvalidWireAngles();
+
+    return TestHelper::Finish("LArWireAngleTransformationPluginTest");
+}
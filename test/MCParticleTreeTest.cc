@@ -0,0 +1,245 @@
+/**
+ *  @file   PandoraSDK/test/MCParticleTreeTest.cc
+ * 
+ *  @brief  Test the mc particle parent and daughter lists, and the pfo targets, against a recursive reference implementation.
+ * 
+ *  $Log: $
+ */
+
+#include "Pandora/AlgorithmHeaders.h"
+
+#include "TestHelper.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <unordered_map>
+
+using namespace pandora;
+using namespace pandora_test;
+
+typedef std::vector<std::pair<unsigned int, unsigned int>> RelationshipVector;
+typedef std::unordered_map<const MCParticle *, const MCParticle *> PfoTargetMap;
+typedef std::pair<const MCParticle *, const MCParticle *> MCParticleRelationship;
+
+/**
+ *  @brief  Whether an mc particle passes the pfo selection cuts, for the default pandora settings
+ * 
+ *  @param  pMCParticle the address of the mc particle
+ * 
+ *  @return boolean
+ */
+bool PassesPfoSelectionCuts(const MCParticle *const pMCParticle)
+{
+    const int particleId(pMCParticle->GetParticleId());
+
+    return ((pMCParticle->GetOuterRadius() > 500.f) && (pMCParticle->GetInnerRadius() <= 500.f) &&
+        (pMCParticle->GetMomentum().GetMagnitude() > 0.01f) &&
+        !((particleId == PROTON || particleId == NEUTRON) && (pMCParticle->GetEnergy() < 1.2f)));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Recursively set the reference pfo target for an mc particle and its relatives
+ * 
+ *  @param  pMCParticle the address of the mc particle
+ *  @param  pPfoTarget the address of the pfo target
+ *  @param  onlyDaughters whether to set the pfo target only for daughters, rather than for daughters and parents
+ *  @param  pfoTargetMap the reference pfo target map
+ */
+void SetReferencePfoTarget(const MCParticle *const pMCParticle, const MCParticle *const pPfoTarget, const bool onlyDaughters,
+    PfoTargetMap &pfoTargetMap)
+{
+    if (!pfoTargetMap.insert(PfoTargetMap::value_type(pMCParticle, pPfoTarget)).second)
+        return;
+
+    for (const MCParticle *const pDaughterMCParticle : pMCParticle->GetDaughterList())
+        SetReferencePfoTarget(pDaughterMCParticle, pPfoTarget, false, pfoTargetMap);
+
+    if (!onlyDaughters)
+    {
+        for (const MCParticle *const pParentMCParticle : pMCParticle->GetParentList())
+            SetReferencePfoTarget(pParentMCParticle, pPfoTarget, false, pfoTargetMap);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Recursively apply the reference pfo selection rules, starting from a root mc particle
+ * 
+ *  @param  pMCParticle the address of the mc particle
+ *  @param  mcPfoSet the mc particles already selected from this root mc particle
+ *  @param  pfoTargetMap the reference pfo target map
+ */
+void ApplyReferencePfoSelectionRules(const MCParticle *const pMCParticle, MCParticleSet &mcPfoSet, PfoTargetMap &pfoTargetMap)
+{
+    if (!mcPfoSet.count(pMCParticle) && PassesPfoSelectionCuts(pMCParticle))
+    {
+        SetReferencePfoTarget(pMCParticle, pMCParticle, true, pfoTargetMap);
+        mcPfoSet.insert(pMCParticle);
+    }
+    else
+    {
+        for (const MCParticle *const pDaughterMCParticle : pMCParticle->GetDaughterList())
+            ApplyReferencePfoSelectionRules(pDaughterMCParticle, mcPfoSet, pfoTargetMap);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Check the mc particle tree and pfo targets against the input relationships and the reference implementation
+ * 
+ *  @param  algorithm the calling algorithm
+ *  @param  mcParticleAddresses the mc particle parent addresses
+ *  @param  relationships the input parent-daughter relationships, as indices into the mc particle addresses
+ * 
+ *  @return the status code
+ */
+StatusCode CheckMCParticleTree(const Algorithm &algorithm, const std::vector<int> &mcParticleAddresses,
+    const RelationshipVector &relationships)
+{
+    const MCParticleList *pMCParticleList(nullptr);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::GetCurrentList(algorithm, pMCParticleList));
+
+    std::unordered_map<const void *, const MCParticle *> addressToMCParticleMap;
+
+    for (const MCParticle *const pMCParticle : *pMCParticleList)
+        addressToMCParticleMap[pMCParticle->GetUid()] = pMCParticle;
+
+    PANDORA_TEST_CHECK(mcParticleAddresses.size() == addressToMCParticleMap.size());
+
+    std::set<MCParticleRelationship> relationshipSet;
+
+    for (const RelationshipVector::value_type &relationship : relationships)
+    {
+        relationshipSet.insert(MCParticleRelationship(addressToMCParticleMap.at(&mcParticleAddresses[relationship.first]),
+            addressToMCParticleMap.at(&mcParticleAddresses[relationship.second])));
+    }
+
+    // Daughters without duplicates, ordered by sort key and then by input list order; parents in input list order
+    for (const MCParticle *const pMCParticle : *pMCParticleList)
+    {
+        MCParticleVector expectedDaughters, expectedParents;
+
+        for (const MCParticle *const pOtherMCParticle : *pMCParticleList)
+        {
+            if (relationshipSet.count(MCParticleRelationship(pMCParticle, pOtherMCParticle)))
+                expectedDaughters.push_back(pOtherMCParticle);
+
+            if (relationshipSet.count(MCParticleRelationship(pOtherMCParticle, pMCParticle)))
+                expectedParents.push_back(pOtherMCParticle);
+        }
+
+        std::stable_sort(expectedDaughters.begin(), expectedDaughters.end(), PointerLessThan<MCParticle>());
+
+        const MCParticleList &daughterList(pMCParticle->GetDaughterList()), &parentList(pMCParticle->GetParentList());
+        PANDORA_TEST_CHECK((expectedDaughters.size() == daughterList.size()) &&
+            std::equal(expectedDaughters.begin(), expectedDaughters.end(), daughterList.begin()));
+        PANDORA_TEST_CHECK((expectedParents.size() == parentList.size()) &&
+            std::equal(expectedParents.begin(), expectedParents.end(), parentList.begin()));
+        PANDORA_TEST_CHECK(pMCParticle->IsRootParticle() == parentList.empty());
+    }
+
+    // Pfo targets, from root mc particles in input list order
+    PfoTargetMap pfoTargetMap;
+
+    for (const MCParticle *const pMCParticle : *pMCParticleList)
+    {
+        MCParticleSet mcPfoSet;
+
+        if (pMCParticle->IsRootParticle())
+            ApplyReferencePfoSelectionRules(pMCParticle, mcPfoSet, pfoTargetMap);
+    }
+
+    unsigned int nPfoTargets(0);
+
+    for (const MCParticle *const pMCParticle : *pMCParticleList)
+    {
+        const PfoTargetMap::const_iterator iter(pfoTargetMap.find(pMCParticle));
+        PANDORA_TEST_CHECK((pfoTargetMap.end() != iter) == pMCParticle->IsPfoTargetSet());
+
+        if (pfoTargetMap.end() == iter)
+            continue;
+
+        PANDORA_TEST_CHECK(iter->second == pMCParticle->GetPfoTarget());
+        nPfoTargets += (pMCParticle->IsPfoTarget() ? 1 : 0);
+    }
+
+    PANDORA_TEST_CHECK(nPfoTargets > 10);
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test the mc particle tree for a random hierarchy, in which mc particles can have several parents, and many mc particles share
+ *          their sort keys
+ * 
+ *  @param  nThreads the number of threads
+ */
+void TestMCParticleTree(const unsigned int nThreads)
+{
+    std::mt19937 generator(30);
+    const unsigned int nMCParticles(400);
+    std::vector<int> mcParticleAddresses(nMCParticles);
+    RelationshipVector relationships;
+
+    const Pandora *const pPandora(TestHelper::CreatePandora([&](const Algorithm &algorithm) -> StatusCode
+    {
+        return CheckMCParticleTree(algorithm, mcParticleAddresses, relationships);
+    }, nThreads));
+
+    // Vertex radii below, within and beyond the pfo selection radius, given an mc particle range of 100 along z
+    const FloatVector radii{100.f, 495.f, 700.f};
+    const IntVector particleIds{211, 22, PROTON, NEUTRON};
+
+    for (unsigned int iMCParticle = 0; iMCParticle < nMCParticles; ++iMCParticle)
+    {
+        const CartesianVector vertex(radii[generator() % radii.size()], 0.f, 0.f);
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::MCParticle::Create(*pPandora, TestHelper::GetMCParticleParameters(
+            particleIds[generator() % particleIds.size()], 0.5f + static_cast<float>(generator() % 2), vertex,
+            &mcParticleAddresses[iMCParticle])));
+
+        // Parents created earlier, so the hierarchy is acyclic, with some repeated relationships
+        const unsigned int nParents((iMCParticle < 20) ? 0 : generator() % 3);
+
+        for (unsigned int iParent = 0; iParent < nParents; ++iParent)
+        {
+            const unsigned int parentIndex(iMCParticle - 1 - generator() % std::min(iMCParticle, 30u));
+            const unsigned int nRepeats(1 + ((0 == generator() % 10) ? 1 : 0));
+
+            for (unsigned int iRepeat = 0; iRepeat < nRepeats; ++iRepeat)
+            {
+                relationships.emplace_back(parentIndex, iMCParticle);
+                PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetMCParentDaughterRelationship(*pPandora,
+                    &mcParticleAddresses[parentIndex], &mcParticleAddresses[iMCParticle]));
+            }
+        }
+    }
+
+    // Relationships with unknown mc particles are ignored
+    int unknownAddress(0);
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetMCParentDaughterRelationship(*pPandora, &mcParticleAddresses[0],
+        &unknownAddress));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetMCParentDaughterRelationship(*pPandora, &unknownAddress,
+        &mcParticleAddresses[1]));
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::ProcessEvent(*pPandora));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Reset(*pPandora));
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    TestMCParticleTree(1);
+    TestMCParticleTree(4);
+
+    return TestHelper::Finish("MCParticleTreeTest");
+}
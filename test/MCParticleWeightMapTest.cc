@@ -0,0 +1,178 @@
+/**
+ *  @file   PandoraSDK/test/MCParticleWeightMapTest.cc
+ * 
+ *  @brief  Test that the mc particle weight map behaves as a std::map ordered by PointerLessThan<MCParticle>.
+ * 
+ *  $Log: $
+ */
+
+#include "Pandora/AlgorithmHeaders.h"
+
+#include "TestHelper.h"
+
+#include <map>
+#include <random>
+
+using namespace pandora;
+using namespace pandora_test;
+
+typedef std::map<const MCParticle *, float, PointerLessThan<MCParticle>> ReferenceWeightMap;
+
+/**
+ *  @brief  Whether an mc particle weight map holds the same entries, in the same order, as a reference map
+ * 
+ *  @param  mcParticleWeightMap the mc particle weight map
+ *  @param  referenceWeightMap the reference map
+ * 
+ *  @return boolean
+ */
+bool IsIdentical(const MCParticleWeightMap &mcParticleWeightMap, const ReferenceWeightMap &referenceWeightMap)
+{
+    if ((mcParticleWeightMap.size() != referenceWeightMap.size()) || (mcParticleWeightMap.empty() != referenceWeightMap.empty()))
+        return false;
+
+    ReferenceWeightMap::const_iterator referenceIter(referenceWeightMap.begin());
+
+    for (const MCParticleWeightMap::value_type &mapEntry : mcParticleWeightMap)
+    {
+        if ((mapEntry.first != referenceIter->first) || (mapEntry.second != referenceIter->second))
+            return false;
+
+        ++referenceIter;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Apply the same random sequence of operations to an mc particle weight map and to a reference map, comparing them throughout
+ * 
+ *  @param  mcParticleVector the mc particles
+ */
+void TestOperations(const MCParticleVector &mcParticleVector)
+{
+    std::mt19937 generator(27);
+    MCParticleWeightMap mcParticleWeightMap;
+    ReferenceWeightMap referenceWeightMap;
+
+    for (unsigned int iOperation = 0; iOperation < 20000; ++iOperation)
+    {
+        // Draw the mc particles from a range that varies, so that the map size repeatedly crosses the number of local entries
+        const unsigned int nMCParticles(1 + (iOperation / 500) % mcParticleVector.size());
+        const MCParticle *const pMCParticle(mcParticleVector[generator() % nMCParticles]);
+        const float weight(0.125f * (generator() % 16));
+
+        switch (generator() % 8)
+        {
+        case 0:
+        case 1:
+            mcParticleWeightMap[pMCParticle] += weight;
+            referenceWeightMap[pMCParticle] += weight;
+            break;
+        case 2:
+        case 3:
+        {
+            const std::pair<MCParticleWeightMap::iterator, bool> result(
+                mcParticleWeightMap.insert(MCParticleWeightMap::value_type(pMCParticle, weight)));
+            const std::pair<ReferenceWeightMap::iterator, bool> referenceResult(
+                referenceWeightMap.insert(ReferenceWeightMap::value_type(pMCParticle, weight)));
+            PANDORA_TEST_CHECK(result.second == referenceResult.second);
+            PANDORA_TEST_CHECK((result.first->first == pMCParticle) && (result.first->second == referenceResult.first->second));
+            break;
+        }
+        case 4:
+        {
+            const MCParticleWeightMap::iterator iter(mcParticleWeightMap.find(pMCParticle));
+            const ReferenceWeightMap::iterator referenceIter(referenceWeightMap.find(pMCParticle));
+            PANDORA_TEST_CHECK((mcParticleWeightMap.end() == iter) == (referenceWeightMap.end() == referenceIter));
+
+            if (mcParticleWeightMap.end() != iter)
+            {
+                iter->second *= 2.f;
+                referenceIter->second *= 2.f;
+            }
+
+            break;
+        }
+        case 5:
+        {
+            PANDORA_TEST_CHECK(mcParticleWeightMap.count(pMCParticle) == referenceWeightMap.count(pMCParticle));
+            const StatusCode statusCode(TestHelper::GetStatusCode([&]() -> StatusCode
+            {
+                PANDORA_TEST_CHECK(mcParticleWeightMap.at(pMCParticle) == referenceWeightMap.at(pMCParticle));
+                return STATUS_CODE_SUCCESS;
+            }));
+            PANDORA_TEST_CHECK((referenceWeightMap.count(pMCParticle) ? STATUS_CODE_SUCCESS : STATUS_CODE_NOT_FOUND) == statusCode);
+            break;
+        }
+        case 6:
+        {
+            // Copies, in either direction between local and heap storage
+            MCParticleWeightMap copiedWeightMap(mcParticleWeightMap);
+            PANDORA_TEST_CHECK(IsIdentical(copiedWeightMap, referenceWeightMap));
+
+            MCParticleWeightMap assignedWeightMap;
+            assignedWeightMap[mcParticleVector.back()] = 1.f;
+            assignedWeightMap = copiedWeightMap;
+            mcParticleWeightMap = assignedWeightMap;
+            break;
+        }
+        default:
+            if (0 == generator() % 50)
+            {
+                mcParticleWeightMap.clear();
+                referenceWeightMap.clear();
+            }
+
+            break;
+        }
+
+        PANDORA_TEST_CHECK(IsIdentical(mcParticleWeightMap, referenceWeightMap));
+        PANDORA_TEST_CHECK(IsIdentical(static_cast<const MCParticleWeightMap &>(mcParticleWeightMap), referenceWeightMap));
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test the mc particle weight map, using mc particles created in a pandora instance
+ */
+void TestMCParticleWeightMap()
+{
+    const Pandora *const pPandora(TestHelper::CreatePandora([&](const Algorithm &algorithm) -> StatusCode
+    {
+        const MCParticleList *pMCParticleList(nullptr);
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::GetCurrentList(algorithm, pMCParticleList));
+
+        MCParticleVector mcParticleVector(pMCParticleList->begin(), pMCParticleList->end());
+        PANDORA_TEST_CHECK(mcParticleVector.size() > 4);
+        TestOperations(mcParticleVector);
+
+        return STATUS_CODE_SUCCESS;
+    }));
+
+    const unsigned int nMCParticles(10);
+    std::vector<int> mcParticleAddresses(nMCParticles);
+
+    for (unsigned int iMCParticle = 0; iMCParticle < nMCParticles; ++iMCParticle)
+    {
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::MCParticle::Create(*pPandora, TestHelper::GetMCParticleParameters(211,
+            1.f + iMCParticle, CartesianVector(0.f, 0.f, 0.f), &mcParticleAddresses[iMCParticle])));
+    }
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::ProcessEvent(*pPandora));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Reset(*pPandora));
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    TestMCParticleWeightMap();
+
+    return TestHelper::Finish("MCParticleWeightMapTest");
+}
@@ -0,0 +1,548 @@
+/**
+ *  @file   PandoraSDK/test/ParticleFlowObjectTest.cc
+ * 
+ *  @brief  Test pfo properties, relationships and address lists.
+ * 
+ *  $Log: $
+ */
+
+#include "Pandora/AlgorithmHeaders.h"
+
+#include "TestHelper.h"
+
+#include <algorithm>
+#include <limits>
+#include <list>
+#include <random>
+
+using namespace pandora;
+using namespace pandora_test;
+
+/**
+ *  @brief  Whether a pfo holds exactly the expected properties, by name and by interned id
+ * 
+ *  @param  pPfo the address of the pfo
+ *  @param  expectedPropertiesMap the expected properties
+ * 
+ *  @return boolean
+ */
+bool HasProperties(const ParticleFlowObject *const pPfo, const PropertiesMap &expectedPropertiesMap)
+{
+    if ((pPfo->GetPropertiesMap() != expectedPropertiesMap) || (pPfo->GetProperties().size() != expectedPropertiesMap.size()))
+        return false;
+
+    for (const PropertiesMap::value_type &expectedEntry : expectedPropertiesMap)
+    {
+        PropertyId propertyId(0);
+
+        if (!PropertyRegistry::FindPropertyId(expectedEntry.first, propertyId) || !pPfo->HasProperty(propertyId) ||
+            (pPfo->GetProperty(propertyId) != expectedEntry.second) ||
+            (PropertyRegistry::GetPropertyName(propertyId) != expectedEntry.first))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Check that a property change is rejected with a specified status code, leaving the pfo properties unchanged and leaving
+ *          any new names, those beginning "Unregistered", unregistered
+ * 
+ *  @param  algorithm the calling algorithm
+ *  @param  pPfo the address of the pfo
+ *  @param  metadata the metadata describing the property change
+ *  @param  expectedStatusCode the expected status code
+ */
+void CheckRejected(const Algorithm &algorithm, const ParticleFlowObject *const pPfo,
+    const PandoraContentApi::ParticleFlowObject::Metadata &metadata, const StatusCode expectedStatusCode)
+{
+    const PropertiesMap propertiesMap(pPfo->GetPropertiesMap());
+    PANDORA_TEST_CHECK(expectedStatusCode == PandoraContentApi::ParticleFlowObject::AlterMetadata(algorithm, pPfo, metadata));
+    PANDORA_TEST_CHECK(HasProperties(pPfo, propertiesMap));
+
+    for (const PropertiesMap::value_type &entryToAdd : metadata.m_propertiesToAdd)
+    {
+        PropertyId propertyId(0);
+
+        if (0 == entryToAdd.first.find("Unregistered"))
+            PANDORA_TEST_CHECK(!PropertyRegistry::FindPropertyId(entryToAdd.first, propertyId));
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test pfo property round trips, and rejected property changes
+ * 
+ *  @param  algorithm the calling algorithm
+ * 
+ *  @return the status code
+ */
+StatusCode CheckProperties(const Algorithm &algorithm)
+{
+    const PfoList *pPfoList(nullptr);
+    std::string pfoListName;
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::CreateTemporaryListAndSetCurrent(algorithm, pPfoList,
+        pfoListName));
+
+    // Properties given at creation, by name
+    PandoraContentApi::ParticleFlowObject::Parameters parameters(TestHelper::GetPfoParameters());
+    parameters.m_propertiesToAdd["TestPropertyA"] = 1.f;
+    parameters.m_propertiesToAdd["TestPropertyB"] = 2.f;
+
+    const ParticleFlowObject *pPfo(nullptr);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::ParticleFlowObject::Create(algorithm, parameters, pPfo));
+
+    PropertiesMap expectedPropertiesMap(parameters.m_propertiesToAdd);
+    PANDORA_TEST_CHECK(HasProperties(pPfo, expectedPropertiesMap));
+
+    // Properties added and removed by interned id, and by name
+    const PropertyId propertyIdA(PropertyRegistry::GetPropertyId("TestPropertyA"));
+    const PropertyId propertyIdC(PropertyRegistry::GetPropertyId("TestPropertyC"));
+    PANDORA_TEST_CHECK(PropertyRegistry::GetPropertyId("TestPropertyA") == propertyIdA);
+    PANDORA_TEST_CHECK(!pPfo->HasProperty(propertyIdC));
+
+    PandoraContentApi::ParticleFlowObject::Metadata idMetadata;
+    idMetadata.m_propertyIdsToAdd.push_back(PropertyVector::value_type(propertyIdC, 3.f));
+    idMetadata.m_propertyIdsToRemove.push_back(propertyIdA);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::ParticleFlowObject::AlterMetadata(algorithm, pPfo, idMetadata));
+
+    expectedPropertiesMap.erase("TestPropertyA");
+    expectedPropertiesMap["TestPropertyC"] = 3.f;
+    PANDORA_TEST_CHECK(HasProperties(pPfo, expectedPropertiesMap));
+    PANDORA_TEST_CHECK(STATUS_CODE_NOT_FOUND == TestHelper::GetStatusCode([&]() -> StatusCode
+    {
+        pPfo->GetProperty(propertyIdA);
+        return STATUS_CODE_SUCCESS;
+    }));
+
+    PandoraContentApi::ParticleFlowObject::Metadata nameMetadata;
+    nameMetadata.m_propertiesToAdd["TestPropertyA"] = 4.f;
+    nameMetadata.m_propertiesToAdd["TestPropertyB"] = 5.f;
+    nameMetadata.m_propertiesToRemove.push_back("TestPropertyC");
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::ParticleFlowObject::AlterMetadata(algorithm, pPfo, nameMetadata));
+
+    expectedPropertiesMap = nameMetadata.m_propertiesToAdd;
+    PANDORA_TEST_CHECK(HasProperties(pPfo, expectedPropertiesMap));
+
+    // Properties given by interned id are applied after those given by name
+    PandoraContentApi::ParticleFlowObject::Metadata orderMetadata;
+    orderMetadata.m_propertiesToAdd["TestPropertyA"] = 6.f;
+    orderMetadata.m_propertyIdsToAdd.push_back(PropertyVector::value_type(propertyIdA, 7.f));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::ParticleFlowObject::AlterMetadata(algorithm, pPfo, orderMetadata));
+
+    expectedPropertiesMap["TestPropertyA"] = 7.f;
+    PANDORA_TEST_CHECK(HasProperties(pPfo, expectedPropertiesMap));
+
+    // Rejected changes, each including a new name that must not be registered
+    PandoraContentApi::ParticleFlowObject::Metadata absentMetadata;
+    absentMetadata.m_propertiesToAdd["UnregisteredPropertyD"] = 8.f;
+    absentMetadata.m_propertyIdsToRemove.push_back(propertyIdC);
+    CheckRejected(algorithm, pPfo, absentMetadata, STATUS_CODE_NOT_FOUND);
+
+    PandoraContentApi::ParticleFlowObject::Metadata unknownNameMetadata;
+    unknownNameMetadata.m_propertiesToAdd["UnregisteredPropertyE"] = 8.f;
+    unknownNameMetadata.m_propertiesToRemove.push_back("UnregisteredPropertyF");
+    CheckRejected(algorithm, pPfo, unknownNameMetadata, STATUS_CODE_NOT_FOUND);
+
+    PandoraContentApi::ParticleFlowObject::Metadata unknownIdMetadata;
+    unknownIdMetadata.m_propertiesToAdd["UnregisteredPropertyG"] = 8.f;
+    unknownIdMetadata.m_propertyIdsToAdd.push_back(PropertyVector::value_type(std::numeric_limits<PropertyId>::max(), 8.f));
+    CheckRejected(algorithm, pPfo, unknownIdMetadata, STATUS_CODE_INVALID_PARAMETER);
+
+    PandoraContentApi::ParticleFlowObject::Metadata conflictMetadata;
+    conflictMetadata.m_propertiesToAdd["UnregisteredPropertyH"] = 8.f;
+    conflictMetadata.m_propertiesToAdd["TestPropertyB"] = 8.f;
+    conflictMetadata.m_propertiesToRemove.push_back("TestPropertyB");
+    CheckRejected(algorithm, pPfo, conflictMetadata, STATUS_CODE_INVALID_PARAMETER);
+
+    PandoraContentApi::ParticleFlowObject::Metadata idConflictMetadata;
+    idConflictMetadata.m_propertiesToAdd["UnregisteredPropertyI"] = 8.f;
+    idConflictMetadata.m_propertyIdsToAdd.push_back(PropertyVector::value_type(propertyIdA, 8.f));
+    idConflictMetadata.m_propertyIdsToRemove.push_back(propertyIdA);
+    CheckRejected(algorithm, pPfo, idConflictMetadata, STATUS_CODE_INVALID_PARAMETER);
+
+    // Pfos cannot be created with properties to remove
+    PandoraContentApi::ParticleFlowObject::Parameters removalParameters(TestHelper::GetPfoParameters());
+    removalParameters.m_propertiesToRemove.push_back("TestPropertyA");
+
+    const ParticleFlowObject *pRemovalPfo(nullptr);
+    PANDORA_TEST_CHECK(STATUS_CODE_INVALID_PARAMETER == PandoraContentApi::ParticleFlowObject::Create(algorithm, removalParameters,
+        pRemovalPfo));
+    PANDORA_TEST_CHECK((nullptr == pRemovalPfo) && (1 == pPfoList->size()));
+
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::SaveList<Pfo>(algorithm, pfoListName, "TestPfos"));
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test pfo properties, for a pfo created in a pandora instance
+ */
+void TestProperties()
+{
+    const Pandora *const pPandora(TestHelper::CreatePandora(CheckProperties));
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::ProcessEvent(*pPandora));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Reset(*pPandora));
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test an indexed list against a std::list, for random operations on lists that grow and shrink across the indexing threshold,
+ *          including lists initialised with duplicate entries
+ */
+void TestIndexedList()
+{
+    typedef std::list<int> IntList;
+    std::mt19937 generator(32);
+
+    for (unsigned int iList = 0; iList < 200; ++iList)
+    {
+        IntList referenceList;
+        const unsigned int nInitialValues(iList % 20), nValues(1 + iList % 30);
+
+        for (unsigned int iValue = 0; iValue < nInitialValues; ++iValue)
+            referenceList.push_back(generator() % nValues);
+
+        IndexedList<IntList> indexedList(referenceList);
+
+        for (unsigned int iOperation = 0; iOperation < 200; ++iOperation)
+        {
+            const int value(generator() % nValues);
+            const IntList::iterator referenceIter(std::find(referenceList.begin(), referenceList.end(), value));
+            const bool isPresent(referenceList.end() != referenceIter);
+            PANDORA_TEST_CHECK(isPresent == indexedList.Contains(value));
+
+            switch (generator() % 4)
+            {
+            case 0:
+            case 1:
+                PANDORA_TEST_CHECK((isPresent ? STATUS_CODE_ALREADY_PRESENT : STATUS_CODE_SUCCESS) == indexedList.Add(value));
+
+                if (!isPresent)
+                    referenceList.push_back(value);
+
+                break;
+            case 2:
+                PANDORA_TEST_CHECK((isPresent ? STATUS_CODE_SUCCESS : STATUS_CODE_NOT_FOUND) == indexedList.Remove(value));
+
+                if (isPresent)
+                    referenceList.erase(referenceIter);
+
+                break;
+            default:
+            {
+                const IndexedList<IntList> copiedList(indexedList);
+                IndexedList<IntList> assignedList(IntList(1, value));
+                assignedList = copiedList;
+                indexedList = assignedList;
+                break;
+            }
+            }
+
+            PANDORA_TEST_CHECK(referenceList == indexedList.GetList());
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Check pfo parent-daughter relationships, and pfo clusters, as they are added and removed
+ * 
+ *  @param  algorithm the calling algorithm
+ * 
+ *  @return the status code
+ */
+StatusCode CheckRelationships(const Algorithm &algorithm)
+{
+    const PfoList *pPfoList(nullptr);
+    std::string pfoListName;
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::CreateTemporaryListAndSetCurrent(algorithm, pPfoList,
+        pfoListName));
+
+    const unsigned int nPfos(30);
+    PfoVector pfoVector;
+
+    for (unsigned int iPfo = 0; iPfo < nPfos; ++iPfo)
+    {
+        const ParticleFlowObject *pPfo(nullptr);
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::ParticleFlowObject::Create(algorithm,
+            TestHelper::GetPfoParameters(), pPfo));
+        pfoVector.push_back(pPfo);
+    }
+
+    // The first pfo is the parent of all others, and each other pfo is also the daughter of its predecessor
+    const ParticleFlowObject *const pParentPfo(pfoVector.front());
+    PANDORA_TEST_CHECK(STATUS_CODE_INVALID_PARAMETER == PandoraContentApi::SetPfoParentDaughterRelationship(algorithm, pParentPfo,
+        pParentPfo));
+
+    for (unsigned int iPfo = 1; iPfo < nPfos; ++iPfo)
+    {
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::SetPfoParentDaughterRelationship(algorithm, pParentPfo,
+            pfoVector[iPfo]));
+        PANDORA_TEST_CHECK(STATUS_CODE_ALREADY_PRESENT == PandoraContentApi::SetPfoParentDaughterRelationship(algorithm, pParentPfo,
+            pfoVector[iPfo]));
+
+        if (iPfo > 1)
+        {
+            PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::SetPfoParentDaughterRelationship(algorithm,
+                pfoVector[iPfo - 1], pfoVector[iPfo]));
+        }
+    }
+
+    // Remove every third daughter of the parent pfo, then restore one of them at the end of the daughter list
+    PfoList expectedDaughterList;
+
+    for (unsigned int iPfo = 1; iPfo < nPfos; ++iPfo)
+    {
+        if (0 == iPfo % 3)
+        {
+            PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::RemovePfoParentDaughterRelationship(algorithm, pParentPfo,
+                pfoVector[iPfo]));
+            PANDORA_TEST_CHECK(STATUS_CODE_NOT_FOUND == PandoraContentApi::RemovePfoParentDaughterRelationship(algorithm, pParentPfo,
+                pfoVector[iPfo]));
+        }
+        else
+        {
+            expectedDaughterList.push_back(pfoVector[iPfo]);
+        }
+    }
+
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::SetPfoParentDaughterRelationship(algorithm, pParentPfo,
+        pfoVector[3]));
+    expectedDaughterList.push_back(pfoVector[3]);
+
+    PANDORA_TEST_CHECK(expectedDaughterList == pParentPfo->GetDaughterPfoList());
+    PANDORA_TEST_CHECK(pParentPfo->GetParentPfoList().empty());
+
+    for (unsigned int iPfo = 1; iPfo < nPfos; ++iPfo)
+    {
+        PfoList expectedParentList;
+
+        if (0 != iPfo % 3)
+            expectedParentList.push_back(pParentPfo);
+
+        if (iPfo > 1)
+            expectedParentList.push_back(pfoVector[iPfo - 1]);
+
+        if (3 == iPfo)
+            expectedParentList.push_back(pParentPfo);
+
+        PANDORA_TEST_CHECK(expectedParentList == pfoVector[iPfo]->GetParentPfoList());
+    }
+
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::SaveList<Pfo>(algorithm, pfoListName, "TestPfos"));
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test pfo relationships, for pfos created in a pandora instance
+ */
+void TestRelationships()
+{
+    const Pandora *const pPandora(TestHelper::CreatePandora(CheckRelationships));
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::ProcessEvent(*pPandora));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Reset(*pPandora));
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Whether a pfo reports the expected track and cluster address lists, building the expected cluster address lists from copies
+ *          of the cluster ordered calo hit lists, to which the isolated calo hits are added
+ * 
+ *  @param  pPfo the address of the pfo
+ * 
+ *  @return boolean
+ */
+bool HasExpectedAddressLists(const ParticleFlowObject *const pPfo)
+{
+    TrackAddressList expectedTrackAddressList;
+
+    for (const Track *const pTrack : pPfo->GetTrackList())
+        expectedTrackAddressList.push_back(pTrack->GetParentAddress());
+
+    ClusterAddressList expectedClusterAddressList;
+
+    for (const Cluster *const pCluster : pPfo->GetClusterList())
+    {
+        OrderedCaloHitList orderedCaloHitList(pCluster->GetOrderedCaloHitList());
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, orderedCaloHitList.Add(pCluster->GetIsolatedCaloHitList()));
+
+        CaloHitAddressList caloHitAddressList;
+
+        for (const OrderedCaloHitList::value_type &layerEntry : orderedCaloHitList)
+        {
+            for (const CaloHit *const pCaloHit : *layerEntry.second)
+                caloHitAddressList.push_back(pCaloHit->GetParentAddress());
+        }
+
+        expectedClusterAddressList.push_back(caloHitAddressList);
+    }
+
+    return ((expectedTrackAddressList == pPfo->GetTrackAddressList()) && (expectedClusterAddressList == pPfo->GetClusterAddressList()));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Check the pfo track and cluster address lists as the pfo, and the content of its clusters, change
+ * 
+ *  @param  algorithm the calling algorithm
+ * 
+ *  @return the status code
+ */
+StatusCode CheckAddressLists(const Algorithm &algorithm)
+{
+    const CaloHitList *pCaloHitList(nullptr);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::GetCurrentList(algorithm, pCaloHitList));
+
+    const TrackList *pTrackList(nullptr);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::GetCurrentList(algorithm, pTrackList));
+
+    const CaloHitVector caloHitVector(pCaloHitList->begin(), pCaloHitList->end());
+    const TrackVector trackVector(pTrackList->begin(), pTrackList->end());
+    PANDORA_TEST_CHECK((caloHitVector.size() >= 40) && (trackVector.size() >= 3));
+
+    // Three clusters, each with ten calo hits, the first also holding two isolated calo hits
+    const ClusterList *pClusterList(nullptr);
+    std::string clusterListName;
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::CreateTemporaryListAndSetCurrent(algorithm, pClusterList,
+        clusterListName));
+
+    ClusterVector clusterVector;
+
+    for (unsigned int iCluster = 0; iCluster < 3; ++iCluster)
+    {
+        PandoraContentApi::Cluster::Parameters parameters;
+        parameters.m_caloHitList.insert(parameters.m_caloHitList.end(), caloHitVector.begin() + 10 * iCluster,
+            caloHitVector.begin() + 10 * (iCluster + 1));
+
+        const Cluster *pCluster(nullptr);
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::Cluster::Create(algorithm, parameters, pCluster));
+        clusterVector.push_back(pCluster);
+    }
+
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::AddIsolatedToCluster(algorithm, clusterVector[0],
+        caloHitVector[30]));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::AddIsolatedToCluster(algorithm, clusterVector[0],
+        caloHitVector[31]));
+
+    const PfoList *pPfoList(nullptr);
+    std::string pfoListName;
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::CreateTemporaryListAndSetCurrent(algorithm, pPfoList,
+        pfoListName));
+
+    PandoraContentApi::ParticleFlowObject::Parameters parameters(TestHelper::GetPfoParameters());
+    parameters.m_clusterList.push_back(clusterVector[0]);
+    parameters.m_clusterList.push_back(clusterVector[1]);
+    parameters.m_trackList.push_back(trackVector[0]);
+
+    const ParticleFlowObject *pPfo(nullptr);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::ParticleFlowObject::Create(algorithm, parameters, pPfo));
+    PANDORA_TEST_CHECK(HasExpectedAddressLists(pPfo));
+
+    // Address lists obtained earlier are unaffected by later changes
+    const ClusterAddressList originalClusterAddressList(pPfo->GetClusterAddressList());
+    const TrackAddressList originalTrackAddressList(pPfo->GetTrackAddressList());
+
+    // Calo hits moved between clusters in the pfo, without any change to the pfo itself
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::RemoveFromCluster(algorithm, clusterVector[1], caloHitVector[10]));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::AddToCluster(algorithm, clusterVector[0], caloHitVector[10]));
+    PANDORA_TEST_CHECK(HasExpectedAddressLists(pPfo));
+    PANDORA_TEST_CHECK(originalClusterAddressList != pPfo->GetClusterAddressList());
+
+    // Isolated calo hits added and removed
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::AddIsolatedToCluster(algorithm, clusterVector[1],
+        caloHitVector[32]));
+    PANDORA_TEST_CHECK(HasExpectedAddressLists(pPfo));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::RemoveIsolatedFromCluster(algorithm, clusterVector[0],
+        caloHitVector[30]));
+    PANDORA_TEST_CHECK(HasExpectedAddressLists(pPfo));
+
+    // A cluster outside the pfo is changed, then added to the pfo
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::RemoveFromCluster(algorithm, clusterVector[2], caloHitVector[20]));
+    PANDORA_TEST_CHECK(HasExpectedAddressLists(pPfo));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::AddToPfo(algorithm, pPfo, clusterVector[2]));
+    PANDORA_TEST_CHECK(HasExpectedAddressLists(pPfo));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::RemoveFromPfo(algorithm, pPfo, clusterVector[0]));
+    PANDORA_TEST_CHECK(HasExpectedAddressLists(pPfo));
+    PANDORA_TEST_CHECK(2 == pPfo->GetClusterAddressList().size());
+
+    // Tracks added and removed
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::AddToPfo(algorithm, pPfo, trackVector[1]));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::AddToPfo(algorithm, pPfo, trackVector[2]));
+    PANDORA_TEST_CHECK(HasExpectedAddressLists(pPfo));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::RemoveFromPfo(algorithm, pPfo, trackVector[0]));
+    PANDORA_TEST_CHECK(HasExpectedAddressLists(pPfo));
+    PANDORA_TEST_CHECK((TrackAddressList{trackVector[1]->GetParentAddress(), trackVector[2]->GetParentAddress()} ==
+        pPfo->GetTrackAddressList()));
+
+    PANDORA_TEST_CHECK((2 == originalClusterAddressList.size()) && (12 == originalClusterAddressList.front().size()));
+    PANDORA_TEST_CHECK(TrackAddressList(1, trackVector[0]->GetParentAddress()) == originalTrackAddressList);
+
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::SaveList<Cluster>(algorithm, clusterListName, "TestClusters"));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::SaveList<Pfo>(algorithm, pfoListName, "TestPfos"));
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test pfo address lists, for pfos built from calo hits and tracks created in a pandora instance
+ */
+void TestAddressLists()
+{
+    const Pandora *const pPandora(TestHelper::CreatePandora(CheckAddressLists));
+
+    const unsigned int nCaloHits(40), nTracks(3);
+    std::vector<int> caloHitAddresses(nCaloHits), trackAddresses(nTracks);
+
+    for (unsigned int iCaloHit = 0; iCaloHit < nCaloHits; ++iCaloHit)
+    {
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::CaloHit::Create(*pPandora, TestHelper::GetCaloHitParameters(
+            CartesianVector(static_cast<float>(iCaloHit), 0.f, 10.f * static_cast<float>(iCaloHit % 7)), ECAL,
+            &caloHitAddresses[iCaloHit])));
+    }
+
+    for (unsigned int iTrack = 0; iTrack < nTracks; ++iTrack)
+    {
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Track::Create(*pPandora, TestHelper::GetTrackParameters(1,
+            TrackState(CartesianVector(0.f, 0.f, 0.f), CartesianVector(1.f, 0.f, static_cast<float>(iTrack))), &trackAddresses[iTrack])));
+    }
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::ProcessEvent(*pPandora));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Reset(*pPandora));
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    TestProperties();
+    TestIndexedList();
+    TestRelationships();
+    TestAddressLists();
+
+    return TestHelper::Finish("ParticleFlowObjectTest");
+}
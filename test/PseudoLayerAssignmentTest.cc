@@ -0,0 +1,201 @@
+/**
+ *  @file   PandoraSDK/test/PseudoLayerAssignmentTest.cc
+ * 
+ *  @brief  Test the deferred pseudo layer assignment for calo hits, serial and parallel, including the rejection of calo hits for
+ *          which the pseudo layer plugin fails.
+ * 
+ *  $Log: $
+ */
+
+#include "Pandora/AlgorithmHeaders.h"
+
+#include "TestHelper.h"
+#include "TestPlugins.h"
+
+#include <limits>
+#include <map>
+#include <random>
+
+using namespace pandora;
+using namespace pandora_test;
+
+typedef std::map<const void *, unsigned int> PseudoLayerMap;
+
+/**
+ *  @brief  The outcome of processing an event
+ */
+class EventOutcome
+{
+public:
+    PseudoLayerMap                          m_pseudoLayerMap;       ///< The pseudo layers of the input calo hits, by parent address
+    unsigned int                            m_nMatchedCaloHits;     ///< The number of input calo hits matched to an mc particle
+    unsigned int                            m_nRejectedCaloHits;    ///< The number of calo hits rejected in pseudo layer assignment
+    unsigned int                            m_nPluginCalls;         ///< The number of pseudo layer calculations requested
+    TestPseudoLayerPlugin::ThreadIdSet      m_threadIds;            ///< The ids of the threads requesting pseudo layer calculations
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Process an event, with a calo hit at each position, each calo hit being related to a single mc particle
+ * 
+ *  @param  nThreads the number of threads
+ *  @param  pPseudoLayerPlugin address of the pseudo layer plugin, to be owned by the pandora instance
+ *  @param  positionVectors the calo hit positions, whose addresses are used as the calo hit parent addresses
+ * 
+ *  @return the event outcome
+ */
+EventOutcome ProcessEvent(const unsigned int nThreads, TestPseudoLayerPlugin *const pPseudoLayerPlugin,
+    const CartesianPointVector &positionVectors)
+{
+    EventOutcome eventOutcome;
+
+    const Pandora *const pPandora(TestHelper::CreatePandora([&eventOutcome](const Algorithm &algorithm) -> StatusCode
+    {
+        const CaloHitList *pCaloHitList(nullptr);
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::GetCurrentList(algorithm, pCaloHitList));
+
+        eventOutcome.m_nMatchedCaloHits = 0;
+
+        for (const CaloHit *const pCaloHit : *pCaloHitList)
+        {
+            eventOutcome.m_pseudoLayerMap[pCaloHit->GetParentAddress()] = pCaloHit->GetPseudoLayer();
+
+            if (!pCaloHit->GetMCParticleWeightMap().empty())
+                ++eventOutcome.m_nMatchedCaloHits;
+        }
+
+        return STATUS_CODE_SUCCESS;
+    }, nThreads));
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetPseudoLayerPlugin(*pPandora, pPseudoLayerPlugin));
+
+    const int mcParticleAddress(0);
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::MCParticle::Create(*pPandora,
+        TestHelper::GetMCParticleParameters(211, 100.f, CartesianVector(0.f, 0.f, 0.f), &mcParticleAddress)));
+
+    // ATTN Calo hit creation succeeds whether or not a pseudo layer can later be assigned
+    for (const CartesianVector &positionVector : positionVectors)
+    {
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::CaloHit::Create(*pPandora,
+            TestHelper::GetCaloHitParameters(positionVector, ECAL, &positionVector)));
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetCaloHitToMCParticleRelationship(*pPandora, &positionVector,
+            &mcParticleAddress));
+    }
+
+    PANDORA_TEST_CHECK(0 == pPseudoLayerPlugin->GetNCalls());
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::ProcessEvent(*pPandora));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::GetNRejectedCaloHits(*pPandora, eventOutcome.m_nRejectedCaloHits));
+
+    eventOutcome.m_nPluginCalls = pPseudoLayerPlugin->GetNCalls();
+    eventOutcome.m_threadIds = pPseudoLayerPlugin->GetThreadIds();
+
+    // The rejected calo hit count is reset with the event
+    unsigned int nRejectedCaloHits(std::numeric_limits<unsigned int>::max());
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Reset(*pPandora));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::GetNRejectedCaloHits(*pPandora, nRejectedCaloHits));
+    PANDORA_TEST_CHECK(0 == nRejectedCaloHits);
+
+    delete pPandora;
+    return eventOutcome;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Get the expected pseudo layers of calo hits at a list of positions
+ * 
+ *  @param  positionVectors the calo hit positions, whose addresses are used as the calo hit parent addresses
+ *  @param  maxDistance the maximum distance from the origin, beyond which the pseudo layer calculation fails
+ * 
+ *  @return the expected pseudo layers, by parent address
+ */
+PseudoLayerMap GetExpectedPseudoLayers(const CartesianPointVector &positionVectors, const float maxDistance)
+{
+    PseudoLayerMap pseudoLayerMap;
+
+    for (const CartesianVector &positionVector : positionVectors)
+    {
+        if (positionVector.GetMagnitude() <= maxDistance)
+            pseudoLayerMap[&positionVector] = 1 + static_cast<unsigned int>(positionVector.GetMagnitude() / 10.f);
+    }
+
+    return pseudoLayerMap;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test that serial and parallel deferred pseudo layer assignment give the expected pseudo layers, calling the plugin from a
+ *          single thread unless it declares itself thread safe
+ */
+void TestPseudoLayers()
+{
+    std::mt19937 generator(47);
+    std::uniform_real_distribution<float> distribution(-1000.f, 1000.f);
+    CartesianPointVector positionVectors;
+
+    for (unsigned int iCaloHit = 0; iCaloHit < 20000; ++iCaloHit)
+        positionVectors.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+
+    const PseudoLayerMap expectedPseudoLayerMap(GetExpectedPseudoLayers(positionVectors, std::numeric_limits<float>::max()));
+    const float noMaxDistance(std::numeric_limits<float>::max());
+
+    const EventOutcome serialOutcome(ProcessEvent(1, new TestPseudoLayerPlugin(10.f, noMaxDistance, true), positionVectors));
+    const EventOutcome parallelOutcome(ProcessEvent(4, new TestPseudoLayerPlugin(10.f, noMaxDistance, true), positionVectors));
+    const EventOutcome unsafeOutcome(ProcessEvent(4, new TestPseudoLayerPlugin(10.f, noMaxDistance, false), positionVectors));
+
+    for (const EventOutcome &eventOutcome : {serialOutcome, parallelOutcome, unsafeOutcome})
+    {
+        PANDORA_TEST_CHECK(expectedPseudoLayerMap == eventOutcome.m_pseudoLayerMap);
+        PANDORA_TEST_CHECK(positionVectors.size() == eventOutcome.m_nMatchedCaloHits);
+        PANDORA_TEST_CHECK(0 == eventOutcome.m_nRejectedCaloHits);
+        PANDORA_TEST_CHECK(positionVectors.size() == eventOutcome.m_nPluginCalls);
+    }
+
+    PANDORA_TEST_CHECK(1 == serialOutcome.m_threadIds.size());
+    PANDORA_TEST_CHECK(parallelOutcome.m_threadIds.size() > 1);
+    PANDORA_TEST_CHECK(1 == unsafeOutcome.m_threadIds.size());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test that calo hits for which the pseudo layer calculation fails are rejected and counted, before they can be matched to mc
+ *          particles, without affecting the other calo hits
+ */
+void TestRejectedCaloHits()
+{
+    std::mt19937 generator(48);
+    std::uniform_real_distribution<float> distribution(-1000.f, 1000.f);
+    CartesianPointVector positionVectors;
+
+    for (unsigned int iCaloHit = 0; iCaloHit < 5000; ++iCaloHit)
+        positionVectors.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+
+    const float maxDistance(1500.f);
+    const PseudoLayerMap expectedPseudoLayerMap(GetExpectedPseudoLayers(positionVectors, maxDistance));
+    PANDORA_TEST_CHECK(!expectedPseudoLayerMap.empty() && (expectedPseudoLayerMap.size() < positionVectors.size()));
+
+    for (const unsigned int nThreads : {1u, 4u})
+    {
+        for (const bool isThreadSafe : {true, false})
+        {
+            const EventOutcome eventOutcome(ProcessEvent(nThreads, new TestPseudoLayerPlugin(10.f, maxDistance, isThreadSafe),
+                positionVectors));
+            PANDORA_TEST_CHECK(expectedPseudoLayerMap == eventOutcome.m_pseudoLayerMap);
+            PANDORA_TEST_CHECK(expectedPseudoLayerMap.size() == eventOutcome.m_nMatchedCaloHits);
+            PANDORA_TEST_CHECK(positionVectors.size() - expectedPseudoLayerMap.size() == eventOutcome.m_nRejectedCaloHits);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    TestPseudoLayers();
+    TestRejectedCaloHits();
+
+    return TestHelper::Finish("PseudoLayerAssignmentTest");
+}
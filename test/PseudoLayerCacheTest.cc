@@ -0,0 +1,294 @@
+/**
+ *  @file   PandoraSDK/test/PseudoLayerCacheTest.cc
+ * 
+ *  @brief  Test the cross-event pseudo layer cache hit, miss and flush statistics, and the pseudo layers it assigns, for cells keyed
+ *          by position and by user-supplied cell id.
+ * 
+ *  $Log: $
+ */
+
+#include "Pandora/AlgorithmHeaders.h"
+
+#include "Managers/PseudoLayerCache.h"
+
+#include "TestHelper.h"
+#include "TestPlugins.h"
+
+#include <map>
+#include <random>
+
+using namespace pandora;
+using namespace pandora_test;
+
+typedef std::map<const void *, unsigned int> PseudoLayerMap;
+
+/**
+ *  @brief  Create a pandora instance whose test algorithm records the pseudo layers of the input calo hits
+ * 
+ *  @param  nThreads the number of threads
+ *  @param  cacheSettings the pseudo layer cache xml settings
+ *  @param  pseudoLayerMap to receive the pseudo layers of the input calo hits in each event, by parent address
+ * 
+ *  @return the address of the pandora instance, to be deleted by the caller
+ */
+const Pandora *CreatePandora(const unsigned int nThreads, const std::string &cacheSettings, PseudoLayerMap &pseudoLayerMap)
+{
+    const Pandora *const pPandora(new Pandora());
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == TestHelper::RegisterTestAlgorithm(*pPandora, [&pseudoLayerMap](const Algorithm &algorithm)
+    {
+        const CaloHitList *pCaloHitList(nullptr);
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::GetCurrentList(algorithm, pCaloHitList));
+
+        pseudoLayerMap.clear();
+
+        for (const CaloHit *const pCaloHit : *pCaloHitList)
+            pseudoLayerMap[pCaloHit->GetParentAddress()] = pCaloHit->GetPseudoLayer();
+
+        return STATUS_CODE_SUCCESS;
+    }));
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == TestHelper::ReadSettings(*pPandora, TestHelper::GetSettings(nThreads, cacheSettings)));
+
+    return pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Get the xml settings enabling the pseudo layer cache
+ * 
+ *  @param  maxNEntries the maximum number of cells for which pseudo layers may be cached
+ * 
+ *  @return the xml settings
+ */
+std::string GetCacheSettings(const unsigned int maxNEntries)
+{
+    return ("    <ShouldCachePseudoLayers>true</ShouldCachePseudoLayers>\n    <PseudoLayerCacheMaxEntries>" + std::to_string(maxNEntries) +
+        "</PseudoLayerCacheMaxEntries>\n");
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Process an event, with a calo hit at each position
+ * 
+ *  @param  pandora the pandora instance
+ *  @param  positionVectors the calo hit positions, whose addresses are used as the calo hit parent addresses
+ *  @param  useCellIds whether to give each calo hit a cell id, equal to its index in the list of positions
+ */
+void ProcessEvent(const Pandora &pandora, const CartesianPointVector &positionVectors, const bool useCellIds)
+{
+    for (unsigned int iCaloHit = 0; iCaloHit < positionVectors.size(); ++iCaloHit)
+    {
+        PandoraApi::CaloHit::Parameters parameters(TestHelper::GetCaloHitParameters(positionVectors[iCaloHit], ECAL,
+            &positionVectors[iCaloHit]));
+
+        if (useCellIds)
+            parameters.m_cellId = iCaloHit;
+
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::CaloHit::Create(pandora, parameters));
+    }
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::ProcessEvent(pandora));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Reset(pandora));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Get the expected pseudo layers of calo hits at a list of positions
+ * 
+ *  @param  positionVectors the calo hit positions, whose addresses are used as the calo hit parent addresses
+ *  @param  layerThickness the pseudo layer thickness
+ * 
+ *  @return the expected pseudo layers, by parent address
+ */
+PseudoLayerMap GetExpectedPseudoLayers(const CartesianPointVector &positionVectors, const float layerThickness)
+{
+    PseudoLayerMap pseudoLayerMap;
+
+    for (const CartesianVector &positionVector : positionVectors)
+        pseudoLayerMap[&positionVector] = 1 + static_cast<unsigned int>(positionVector.GetMagnitude() / layerThickness);
+
+    return pseudoLayerMap;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Check the pseudo layer cache statistics
+ * 
+ *  @param  pandora the pandora instance
+ *  @param  nEntries the expected number of cached cells
+ *  @param  nCacheHits the expected number of cache hits
+ *  @param  nCacheMisses the expected number of cache misses
+ *  @param  nFlushes the expected number of cache flushes
+ */
+void CheckCache(const Pandora &pandora, const unsigned int nEntries, const std::uint64_t nCacheHits, const std::uint64_t nCacheMisses,
+    const unsigned int nFlushes)
+{
+    const PseudoLayerCache *pPseudoLayerCache(nullptr);
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::GetPseudoLayerCache(pandora, pPseudoLayerCache));
+
+    if (!pPseudoLayerCache)
+        return;
+
+    PANDORA_TEST_CHECK(nEntries == pPseudoLayerCache->GetNEntries());
+    PANDORA_TEST_CHECK(nCacheHits == pPseudoLayerCache->GetNCacheHits());
+    PANDORA_TEST_CHECK(nCacheMisses == pPseudoLayerCache->GetNCacheMisses());
+    PANDORA_TEST_CHECK(nFlushes == pPseudoLayerCache->GetNFlushes());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Get random calo hit positions
+ * 
+ *  @param  nPositions the number of positions
+ *  @param  seed the random number generator seed
+ * 
+ *  @return the positions
+ */
+CartesianPointVector GetPositionVectors(const unsigned int nPositions, const unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> distribution(-1000.f, 1000.f);
+    CartesianPointVector positionVectors;
+
+    for (unsigned int iPosition = 0; iPosition < nPositions; ++iPosition)
+        positionVectors.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+
+    return positionVectors;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test the cache statistics for repeated events with the same cells, for events whose cells overflow the cache, and after
+ *          a geometry change
+ */
+void TestCacheStatistics()
+{
+    const CartesianPointVector positionVectorsA(GetPositionVectors(100, 48)), positionVectorsB(GetPositionVectors(100, 49));
+    const PseudoLayerMap expectedPseudoLayerMapA(GetExpectedPseudoLayers(positionVectorsA, 10.f));
+    const PseudoLayerMap expectedPseudoLayerMapB(GetExpectedPseudoLayers(positionVectorsB, 10.f));
+
+    for (const unsigned int nThreads : {1u, 4u})
+    {
+        PseudoLayerMap pseudoLayerMap;
+        const Pandora *const pPandora(CreatePandora(nThreads, GetCacheSettings(150), pseudoLayerMap));
+        TestPseudoLayerPlugin *const pPseudoLayerPlugin(new TestPseudoLayerPlugin(10.f));
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetPseudoLayerPlugin(*pPandora, pPseudoLayerPlugin));
+
+        // The cache is created on first use
+        const PseudoLayerCache *pPseudoLayerCache(nullptr);
+        PANDORA_TEST_CHECK(STATUS_CODE_NOT_INITIALIZED == PandoraApi::GetPseudoLayerCache(*pPandora, pPseudoLayerCache));
+
+        ProcessEvent(*pPandora, positionVectorsA, false);
+        PANDORA_TEST_CHECK(expectedPseudoLayerMapA == pseudoLayerMap);
+        PANDORA_TEST_CHECK(100 == pPseudoLayerPlugin->GetNCalls());
+        CheckCache(*pPandora, 100, 0, 100, 0);
+
+        // A repeated event is served entirely from the cache, without calling the plugin
+        ProcessEvent(*pPandora, positionVectorsA, false);
+        PANDORA_TEST_CHECK(expectedPseudoLayerMapA == pseudoLayerMap);
+        PANDORA_TEST_CHECK(100 == pPseudoLayerPlugin->GetNCalls());
+        CheckCache(*pPandora, 100, 100, 100, 0);
+
+        // New cells fill the cache to its maximum size, then flush it, leaving the cells inserted after the flush
+        ProcessEvent(*pPandora, positionVectorsB, false);
+        PANDORA_TEST_CHECK(expectedPseudoLayerMapB == pseudoLayerMap);
+        PANDORA_TEST_CHECK(200 == pPseudoLayerPlugin->GetNCalls());
+        CheckCache(*pPandora, 50, 100, 200, 1);
+
+        ProcessEvent(*pPandora, positionVectorsA, false);
+        PANDORA_TEST_CHECK(expectedPseudoLayerMapA == pseudoLayerMap);
+        PANDORA_TEST_CHECK(300 == pPseudoLayerPlugin->GetNCalls());
+        CheckCache(*pPandora, 150, 100, 300, 1);
+
+        // A geometry change clears the cache, without counting as a flush, so that every cell is recalculated
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Geometry::LArTPC::Create(*pPandora,
+            TestHelper::GetLArTPCParameters(0, CartesianVector(0.f, 0.f, 0.f), 100.f)));
+        CheckCache(*pPandora, 0, 100, 300, 1);
+
+        ProcessEvent(*pPandora, positionVectorsA, false);
+        PANDORA_TEST_CHECK(expectedPseudoLayerMapA == pseudoLayerMap);
+        PANDORA_TEST_CHECK(400 == pPseudoLayerPlugin->GetNCalls());
+        CheckCache(*pPandora, 100, 100, 400, 1);
+
+        delete pPandora;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test that cells with user-supplied cell ids are keyed by id alone, so that a cell keeps its cached pseudo layer whatever the
+ *          position of its calo hits
+ */
+void TestCellIds()
+{
+    const CartesianPointVector positionVectorsA(GetPositionVectors(100, 50)), positionVectorsB(GetPositionVectors(100, 51));
+    const PseudoLayerMap expectedPseudoLayerMapA(GetExpectedPseudoLayers(positionVectorsA, 10.f));
+
+    PseudoLayerMap pseudoLayerMap;
+    const Pandora *const pPandora(CreatePandora(1, GetCacheSettings(1000), pseudoLayerMap));
+    TestPseudoLayerPlugin *const pPseudoLayerPlugin(new TestPseudoLayerPlugin(10.f));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetPseudoLayerPlugin(*pPandora, pPseudoLayerPlugin));
+
+    ProcessEvent(*pPandora, positionVectorsA, true);
+    PANDORA_TEST_CHECK(expectedPseudoLayerMapA == pseudoLayerMap);
+    CheckCache(*pPandora, 100, 0, 100, 0);
+
+    ProcessEvent(*pPandora, positionVectorsB, true);
+    PANDORA_TEST_CHECK(100 == pPseudoLayerPlugin->GetNCalls());
+    CheckCache(*pPandora, 100, 100, 100, 0);
+
+    for (unsigned int iCaloHit = 0; iCaloHit < positionVectorsB.size(); ++iCaloHit)
+        PANDORA_TEST_CHECK(expectedPseudoLayerMapA.at(&positionVectorsA[iCaloHit]) == pseudoLayerMap[&positionVectorsB[iCaloHit]]);
+
+    // The same positions, without cell ids, are distinct cells
+    ProcessEvent(*pPandora, positionVectorsA, false);
+    PANDORA_TEST_CHECK(expectedPseudoLayerMapA == pseudoLayerMap);
+    PANDORA_TEST_CHECK(200 == pPseudoLayerPlugin->GetNCalls());
+    CheckCache(*pPandora, 200, 100, 200, 0);
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test that no cache is created by default, each pseudo layer then being calculated by the plugin
+ */
+void TestCacheDisabled()
+{
+    const CartesianPointVector positionVectors(GetPositionVectors(100, 52));
+
+    PseudoLayerMap pseudoLayerMap;
+    const Pandora *const pPandora(CreatePandora(1, std::string(), pseudoLayerMap));
+    TestPseudoLayerPlugin *const pPseudoLayerPlugin(new TestPseudoLayerPlugin(10.f));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetPseudoLayerPlugin(*pPandora, pPseudoLayerPlugin));
+
+    ProcessEvent(*pPandora, positionVectors, false);
+    ProcessEvent(*pPandora, positionVectors, false);
+    PANDORA_TEST_CHECK(GetExpectedPseudoLayers(positionVectors, 10.f) == pseudoLayerMap);
+    PANDORA_TEST_CHECK(200 == pPseudoLayerPlugin->GetNCalls());
+
+    const PseudoLayerCache *pPseudoLayerCache(nullptr);
+    PANDORA_TEST_CHECK(STATUS_CODE_NOT_INITIALIZED == PandoraApi::GetPseudoLayerCache(*pPandora, pPseudoLayerCache));
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    TestCacheStatistics();
+    TestCellIds();
+    TestCacheDisabled();
+
+    return TestHelper::Finish("PseudoLayerCacheTest");
+}
@@ -0,0 +1,145 @@
+/**
+ *  @file   PandoraSDK/test/RegularPolygonTest.cc
+ * 
+ *  @brief  Test the regular polygon edge table queries, single point and block, against a test of the point against every edge.
+ * 
+ *  $Log: $
+ */
+
+#include "Geometry/RegularPolygon.h"
+
+#include "TestHelper.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+using namespace pandora;
+using namespace pandora_test;
+
+/**
+ *  @brief  Whether a point lies inside a regular polygon, testing the point against every edge
+ * 
+ *  @param  rCoordinate the polygon r coordinate
+ *  @param  phiCoordinate the polygon phi coordinate
+ *  @param  symmetryOrder the polygon symmetry order, at least three
+ *  @param  x the point x coordinate
+ *  @param  y the point y coordinate
+ *  @param  tolerance the distance by which to move each edge outwards
+ * 
+ *  @return boolean
+ */
+bool IsInsideEveryEdge(const float rCoordinate, const float phiCoordinate, const unsigned int symmetryOrder, const float x, const float y,
+    const float tolerance)
+{
+    static const float pi(std::acos(-1.f));
+
+    for (unsigned int i = 0; i < symmetryOrder; ++i)
+    {
+        const float phi(phiCoordinate + 2.f * pi * static_cast<float>(i) / static_cast<float>(symmetryOrder));
+
+        if (!(x * std::sin(phi) + y * std::cos(phi) < rCoordinate + tolerance))
+            return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test polygons of each symmetry order, with points spread around and close to their edges and vertices
+ */
+void TestPolygons()
+{
+    std::mt19937 generator(43);
+    std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+
+    for (unsigned int symmetryOrder = 0; symmetryOrder < 17; ++symmetryOrder)
+    {
+        const float rCoordinate(100.f + 50.f * distribution(generator)), phiCoordinate(3.f * distribution(generator));
+        const RegularPolygon polygon(rCoordinate, phiCoordinate, symmetryOrder);
+
+        FloatVector xCoordinates, yCoordinates;
+
+        for (unsigned int iPoint = 0; iPoint < 20000; ++iPoint)
+        {
+            // Half the points lie within a small distance of the vertex r coordinate, so that many lie close to an edge or vertex
+            const float r((0 == iPoint % 2) ? 200.f * std::fabs(distribution(generator)) :
+                polygon.GetVertexRCoordinate() * (1.f + 0.01f * distribution(generator)));
+            const float phi(4.f * distribution(generator));
+            xCoordinates.push_back(r * std::sin(phi));
+            yCoordinates.push_back(r * std::cos(phi));
+        }
+
+        std::vector<unsigned char> isInsideVector(xCoordinates.size());
+        polygon.IsInside(xCoordinates.data(), yCoordinates.data(), xCoordinates.size(), isInsideVector.data());
+
+        for (unsigned int index = 0; index < xCoordinates.size(); ++index)
+        {
+            const float x(xCoordinates[index]), y(yCoordinates[index]);
+            const bool isInside(polygon.IsInside(x, y));
+            PANDORA_TEST_CHECK(isInside == static_cast<bool>(isInsideVector[index]));
+
+            if (0 == symmetryOrder)
+            {
+                PANDORA_TEST_CHECK(isInside == (x * x + y * y < rCoordinate * rCoordinate));
+            }
+            else if (symmetryOrder < 3)
+            {
+                PANDORA_TEST_CHECK(!isInside);
+            }
+            else
+            {
+                for (const float tolerance : {0.f, 5.f, -5.f})
+                {
+                    PANDORA_TEST_CHECK(polygon.IsInside(x, y, tolerance) ==
+                        IsInsideEveryEdge(rCoordinate, phiCoordinate, symmetryOrder, x, y, tolerance));
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test that non-finite points, and points tested against polygons with large phi coordinates, are handled without error
+ */
+void TestNonFinitePoints()
+{
+    const float nan(std::numeric_limits<float>::quiet_NaN()), inf(std::numeric_limits<float>::infinity());
+    const float xCoordinates[6] = {nan, 0.f, nan, inf, -inf, 0.f};
+    const float yCoordinates[6] = {0.f, nan, nan, 0.f, inf, -inf};
+
+    for (const unsigned int symmetryOrder : {0u, 3u, 8u})
+    {
+        const RegularPolygon polygon(100.f, 0.5f, symmetryOrder);
+        unsigned char isInsideArray[6] = {1, 1, 1, 1, 1, 1};
+        polygon.IsInside(xCoordinates, yCoordinates, 6, isInsideArray);
+
+        for (unsigned int index = 0; index < 6; ++index)
+        {
+            PANDORA_TEST_CHECK(!polygon.IsInside(xCoordinates[index], yCoordinates[index]));
+            PANDORA_TEST_CHECK(!polygon.IsInside(xCoordinates[index], yCoordinates[index], 10.f));
+            PANDORA_TEST_CHECK(0 == isInsideArray[index]);
+        }
+    }
+
+    // A phi coordinate far outside [-pi, pi] gives a sector far outside the int range before reduction by the symmetry order
+    const RegularPolygon largePhiPolygon(100.f, 1.e12f, 8);
+    PANDORA_TEST_CHECK(largePhiPolygon.IsInside(0.f, 0.f));
+
+    for (const float x : {-1000.f, 10.f, 1000.f})
+        PANDORA_TEST_CHECK(largePhiPolygon.IsInside(x, 10.f) == IsInsideEveryEdge(100.f, 1.e12f, 8, x, 10.f, 0.f));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    TestPolygons();
+    TestNonFinitePoints();
+
+    return TestHelper::Finish("RegularPolygonTest");
+}
@@ -0,0 +1,246 @@
+/**
+ *  @file   PandoraSDK/test/SortKeyTest.cc
+ * 
+ *  @brief  Test that sort keys order positions and energies as the equivalent floating point comparisons do.
+ * 
+ *  $Log: $
+ */
+
+#include "Pandora/AlgorithmHeaders.h"
+
+#include "TestHelper.h"
+
+#include <algorithm>
+#include <limits>
+#include <list>
+#include <random>
+
+using namespace pandora;
+using namespace pandora_test;
+
+/**
+ *  @brief  SortableObject class, an object with a position, an energy and its sort key
+ */
+class SortableObject
+{
+public:
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  x the x coordinate
+     *  @param  y the y coordinate
+     *  @param  z the z coordinate
+     *  @param  energy the energy
+     */
+    SortableObject(const float x, const float y, const float z, const float energy);
+
+    /**
+     *  @brief  Get the sort key
+     * 
+     *  @return the sort key
+     */
+    const SortKey &GetSortKey() const;
+
+    /**
+     *  @brief  Whether this object precedes another, comparing z, then x, then y coordinates (ascending) and then energy (descending)
+     * 
+     *  @param  rhs the object for comparison
+     * 
+     *  @return boolean
+     */
+    bool IsBefore(const SortableObject &rhs) const;
+
+private:
+    float       m_x;            ///< The x coordinate
+    float       m_y;            ///< The y coordinate
+    float       m_z;            ///< The z coordinate
+    float       m_energy;       ///< The energy
+    SortKey     m_sortKey;      ///< The sort key
+};
+
+typedef std::vector<const SortableObject *> SortableObjectVector;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+SortableObject::SortableObject(const float x, const float y, const float z, const float energy) :
+    m_x(x),
+    m_y(y),
+    m_z(z),
+    m_energy(energy),
+    m_sortKey(x, y, z, energy)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const SortKey &SortableObject::GetSortKey() const
+{
+    return m_sortKey;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool SortableObject::IsBefore(const SortableObject &rhs) const
+{
+    if (m_z != rhs.m_z)
+        return (m_z < rhs.m_z);
+
+    if (m_x != rhs.m_x)
+        return (m_x < rhs.m_x);
+
+    if (m_y != rhs.m_y)
+        return (m_y < rhs.m_y);
+
+    return (m_energy > rhs.m_energy);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Create objects whose coordinates and energies are drawn from a small set of values, so that many objects share some or all of
+ *          their coordinates. The values include signed zeros, infinities, denormals and the extremes of the float range.
+ * 
+ *  @param  nObjects the number of objects
+ *  @param  objects to receive the objects
+ */
+void CreateObjects(const unsigned int nObjects, std::vector<SortableObject> &objects)
+{
+    const FloatVector values{-std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::max(), -1000.f, -1.f, -1.e-3f,
+        -std::numeric_limits<float>::denorm_min(), -0.f, 0.f, std::numeric_limits<float>::denorm_min(), std::numeric_limits<float>::min(),
+        1.e-3f, 1.f, 1.f + std::numeric_limits<float>::epsilon(), 1000.f, std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::infinity()};
+
+    std::mt19937 generator(28);
+    objects.clear();
+
+    for (unsigned int iObject = 0; iObject < nObjects; ++iObject)
+    {
+        objects.emplace_back(values[generator() % values.size()], values[generator() % values.size()], values[generator() % values.size()],
+            values[generator() % values.size()]);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test sort key comparisons against the equivalent floating point comparisons, for every pair of objects
+ */
+void TestSortKeys()
+{
+    std::vector<SortableObject> objects;
+    CreateObjects(1000, objects);
+
+    for (const SortableObject &lhs : objects)
+    {
+        for (const SortableObject &rhs : objects)
+        {
+            PANDORA_TEST_CHECK((lhs.GetSortKey() < rhs.GetSortKey()) == lhs.IsBefore(rhs));
+            PANDORA_TEST_CHECK((lhs.GetSortKey() == rhs.GetSortKey()) == (!lhs.IsBefore(rhs) && !rhs.IsBefore(lhs)));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test sorting vectors and lists by sort key against a stable sort using the equivalent floating point comparisons
+ */
+void TestSortByKey()
+{
+    std::vector<SortableObject> objects;
+    CreateObjects(20000, objects);
+
+    SortableObjectVector objectVector;
+
+    for (const SortableObject &object : objects)
+        objectVector.push_back(&object);
+
+    SortableObjectVector expectedObjectVector(objectVector);
+    std::stable_sort(expectedObjectVector.begin(), expectedObjectVector.end(),
+        [](const SortableObject *const pLhs, const SortableObject *const pRhs) {return pLhs->IsBefore(*pRhs);});
+
+    std::list<const SortableObject *> objectList(objectVector.begin(), objectVector.end());
+    SortByKey(objectVector);
+    SortByKey(objectList);
+
+    // Objects with identical keys retain their input order
+    PANDORA_TEST_CHECK(expectedObjectVector == objectVector);
+    PANDORA_TEST_CHECK(std::equal(expectedObjectVector.begin(), expectedObjectVector.end(), objectList.begin()));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test that calo hits and mc particles are ordered by their sort keys
+ */
+void TestPandoraObjects()
+{
+    const Pandora *const pPandora(TestHelper::CreatePandora([&](const Algorithm &algorithm) -> StatusCode
+    {
+        const CaloHitList *pCaloHitList(nullptr);
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::GetCurrentList(algorithm, pCaloHitList));
+
+        for (const CaloHit *const pLhs : *pCaloHitList)
+        {
+            const SortableObject lhs(pLhs->GetPositionVector().GetX(), pLhs->GetPositionVector().GetY(), pLhs->GetPositionVector().GetZ(),
+                pLhs->GetInputEnergy());
+
+            for (const CaloHit *const pRhs : *pCaloHitList)
+            {
+                const SortableObject rhs(pRhs->GetPositionVector().GetX(), pRhs->GetPositionVector().GetY(),
+                    pRhs->GetPositionVector().GetZ(), pRhs->GetInputEnergy());
+                PANDORA_TEST_CHECK(PointerLessThan<CaloHit>()(pLhs, pRhs) == lhs.IsBefore(rhs));
+            }
+        }
+
+        const MCParticleList *pMCParticleList(nullptr);
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::GetCurrentList(algorithm, pMCParticleList));
+
+        for (const MCParticle *const pLhs : *pMCParticleList)
+        {
+            const SortableObject lhs(pLhs->GetVertex().GetX(), pLhs->GetVertex().GetY(), pLhs->GetVertex().GetZ(), pLhs->GetEnergy());
+
+            for (const MCParticle *const pRhs : *pMCParticleList)
+            {
+                const SortableObject rhs(pRhs->GetVertex().GetX(), pRhs->GetVertex().GetY(), pRhs->GetVertex().GetZ(), pRhs->GetEnergy());
+                PANDORA_TEST_CHECK(PointerLessThan<MCParticle>()(pLhs, pRhs) == lhs.IsBefore(rhs));
+            }
+        }
+
+        return STATUS_CODE_SUCCESS;
+    }));
+
+    std::mt19937 generator(280);
+    const unsigned int nObjects(300);
+    std::vector<int> caloHitAddresses(nObjects), mcParticleAddresses(nObjects);
+
+    for (unsigned int iObject = 0; iObject < nObjects; ++iObject)
+    {
+        const CartesianVector positionVector(static_cast<float>(generator() % 3), static_cast<float>(generator() % 3) - 1.f,
+            static_cast<float>(generator() % 3) - 2.f);
+
+        PandoraApi::CaloHit::Parameters caloHitParameters(
+            TestHelper::GetCaloHitParameters(positionVector, ECAL, &caloHitAddresses[iObject]));
+        caloHitParameters.m_inputEnergy = 0.5f * static_cast<float>(generator() % 3);
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::CaloHit::Create(*pPandora, caloHitParameters));
+
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::MCParticle::Create(*pPandora, TestHelper::GetMCParticleParameters(211,
+            1.f + static_cast<float>(generator() % 3), positionVector, &mcParticleAddresses[iObject])));
+    }
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::ProcessEvent(*pPandora));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Reset(*pPandora));
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    TestSortKeys();
+    TestSortByKey();
+    TestPandoraObjects();
+
+    return TestHelper::Finish("SortKeyTest");
+}
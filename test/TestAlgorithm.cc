@@ -0,0 +1,55 @@
+/**
+ *  @file   PandoraSDK/test/TestAlgorithm.cc
+ * 
+ *  @brief  Implementation of the test algorithm class.
+ * 
+ *  $Log: $
+ */
+
+#include "Helpers/XmlHelper.h"
+
+#include "TestAlgorithm.h"
+
+using namespace pandora;
+
+namespace pandora_test
+{
+
+const std::string TestAlgorithm::ALGORITHM_TYPE("Test");
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+TestAlgorithm::Factory::Factory(const RunFunction &runFunction) :
+    m_runFunction(runFunction)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+Algorithm *TestAlgorithm::Factory::CreateAlgorithm() const
+{
+    return new TestAlgorithm(m_runFunction);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+TestAlgorithm::TestAlgorithm(const RunFunction &runFunction) :
+    m_runFunction(runFunction)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode TestAlgorithm::Run()
+{
+    return m_runFunction(*this);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode TestAlgorithm::ReadSettings(const TiXmlHandle /*xmlHandle*/)
+{
+    return STATUS_CODE_SUCCESS;
+}
+
+} // namespace pandora_test
@@ -0,0 +1,63 @@
+/**
+ *  @file   PandoraSDK/test/TestAlgorithm.h
+ * 
+ *  @brief  Header file for the test algorithm class.
+ * 
+ *  $Log: $
+ */
+#ifndef PANDORA_TEST_ALGORITHM_H
+#define PANDORA_TEST_ALGORITHM_H 1
+
+#include "Pandora/Algorithm.h"
+
+#include <functional>
+
+namespace pandora_test
+{
+
+/**
+ *  @brief  TestAlgorithm class, calling a function supplied by the test for each event, so that the test can use the content api
+ */
+class TestAlgorithm : public pandora::Algorithm
+{
+public:
+    typedef std::function<pandora::StatusCode(const pandora::Algorithm &)> RunFunction;
+
+    /**
+     *  @brief  Factory class for instantiating algorithm
+     */
+    class Factory : public pandora::AlgorithmFactory
+    {
+    public:
+        /**
+         *  @brief  Constructor
+         * 
+         *  @param  runFunction the function to call for each event
+         */
+        Factory(const RunFunction &runFunction);
+
+        pandora::Algorithm *CreateAlgorithm() const;
+
+    private:
+        RunFunction         m_runFunction;          ///< The function to call for each event
+    };
+
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  runFunction the function to call for each event
+     */
+    TestAlgorithm(const RunFunction &runFunction);
+
+    static const std::string ALGORITHM_TYPE;        ///< The algorithm type with which test algorithms are registered
+
+private:
+    pandora::StatusCode Run();
+    pandora::StatusCode ReadSettings(const pandora::TiXmlHandle xmlHandle);
+
+    RunFunction             m_runFunction;          ///< The function to call for each event
+};
+
+} // namespace pandora_test
+
+#endif // #ifndef PANDORA_TEST_ALGORITHM_H
@@ -0,0 +1,242 @@
+/**
+ *  @file   PandoraSDK/test/TestHelper.cc
+ * 
+ *  @brief  Implementation of the test helper class.
+ * 
+ *  $Log: $
+ */
+
+#include "Pandora/Pandora.h"
+
+#include "TestHelper.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+using namespace pandora;
+
+namespace pandora_test
+{
+
+unsigned int TestHelper::m_nChecks = 0;
+unsigned int TestHelper::m_nFailures = 0;
+unsigned int TestHelper::m_nSettingsFiles = 0;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void TestHelper::Check(const bool isPassed, const char *const pExpression, const char *const pFileName, const int lineNumber)
+{
+    ++m_nChecks;
+
+    if (isPassed)
+        return;
+
+    if (++m_nFailures <= MAX_REPORTED_FAILURES)
+        std::cout << pFileName << ":" << lineNumber << ": check failed: " << pExpression << std::endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool TestHelper::IsClose(const double lhs, const double rhs, const double tolerance)
+{
+    return (std::fabs(lhs - rhs) <= tolerance * std::max(1., std::max(std::fabs(lhs), std::fabs(rhs))));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int TestHelper::Finish(const std::string &testName)
+{
+    std::cout << testName << ": " << m_nChecks << " checks, " << m_nFailures << " failures" << std::endl;
+    return ((0 == m_nFailures) ? 0 : 1);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void TestHelper::WriteFile(const std::string &fileName, const std::string &contents)
+{
+    std::ofstream file(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    file << contents;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode TestHelper::ReadSettings(const Pandora &pandora, const std::string &settings)
+{
+    // Include the process id, so that test executables run concurrently in the same directory do not share settings files
+    const std::string settingsFileName("PandoraSDKTestSettings_" + std::to_string(::getpid()) + "_" + std::to_string(m_nSettingsFiles++) +
+        ".xml");
+    TestHelper::WriteFile(settingsFileName, settings);
+
+    const StatusCode statusCode(PandoraApi::ReadSettings(pandora, settingsFileName));
+    std::remove(settingsFileName.c_str());
+
+    return statusCode;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::string TestHelper::GetSettings(const unsigned int nThreads, const std::string &pluginSettings)
+{
+    return ("<pandora>\n    <NumberOfThreads>" + std::to_string(nThreads) + "</NumberOfThreads>\n" + pluginSettings +
+        "    <algorithm type = \"" + TestAlgorithm::ALGORITHM_TYPE + "\"/>\n</pandora>\n");
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode TestHelper::RegisterTestAlgorithm(const Pandora &pandora, const TestAlgorithm::RunFunction &runFunction)
+{
+    return PandoraApi::RegisterAlgorithmFactory(pandora, TestAlgorithm::ALGORITHM_TYPE, new TestAlgorithm::Factory(runFunction));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const Pandora *TestHelper::CreatePandora(const TestAlgorithm::RunFunction &runFunction, const unsigned int nThreads)
+{
+    const Pandora *const pPandora(new Pandora());
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == TestHelper::RegisterTestAlgorithm(*pPandora, runFunction));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == TestHelper::ReadSettings(*pPandora, TestHelper::GetSettings(nThreads)));
+
+    return pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+PandoraApi::CaloHit::Parameters TestHelper::GetCaloHitParameters(const CartesianVector &positionVector, const HitType hitType,
+    const void *const pParentAddress)
+{
+    PandoraApi::CaloHit::Parameters parameters;
+    parameters.m_positionVector = positionVector;
+    parameters.m_expectedDirection = CartesianVector(0.f, 0.f, 1.f);
+    parameters.m_cellNormalVector = CartesianVector(0.f, 0.f, 1.f);
+    parameters.m_cellGeometry = RECTANGULAR;
+    parameters.m_cellSize0 = 1.f;
+    parameters.m_cellSize1 = 4.f;
+    parameters.m_cellThickness = 1.f;
+    parameters.m_nCellRadiationLengths = 1.f;
+    parameters.m_nCellInteractionLengths = 1.f;
+    parameters.m_time = 0.f;
+    parameters.m_inputEnergy = 1.f;
+    parameters.m_mipEquivalentEnergy = 1.f;
+    parameters.m_electromagneticEnergy = 1.f;
+    parameters.m_hadronicEnergy = 1.f;
+    parameters.m_isDigital = false;
+    parameters.m_hitType = hitType;
+    parameters.m_hitRegion = ((TPC_VIEW_U == hitType) || (TPC_VIEW_V == hitType) || (TPC_VIEW_W == hitType) || (TPC_3D == hitType)) ?
+        SINGLE_REGION : BARREL;
+    parameters.m_layer = 1;
+    parameters.m_isInOuterSamplingLayer = false;
+    parameters.m_pParentAddress = pParentAddress;
+
+    return parameters;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+PandoraApi::MCParticle::Parameters TestHelper::GetMCParticleParameters(const int particleId, const float energy,
+    const CartesianVector &vertex, const void *const pParentAddress)
+{
+    PandoraApi::MCParticle::Parameters parameters;
+    parameters.m_energy = energy;
+    parameters.m_momentum = CartesianVector(0.f, 0.f, energy);
+    parameters.m_vertex = vertex;
+    parameters.m_endpoint = vertex + CartesianVector(0.f, 0.f, 100.f);
+    parameters.m_particleId = particleId;
+    parameters.m_mcParticleType = MC_3D;
+    parameters.m_pParentAddress = pParentAddress;
+
+    return parameters;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+PandoraApi::Track::Parameters TestHelper::GetTrackParameters(const int charge, const TrackState &trackState,
+    const void *const pParentAddress)
+{
+    PandoraApi::Track::Parameters parameters;
+    parameters.m_d0 = 0.f;
+    parameters.m_z0 = 0.f;
+    parameters.m_particleId = (charge < 0) ? -211 : 211;
+    parameters.m_charge = charge;
+    parameters.m_mass = 0.13957f;
+    parameters.m_momentumAtDca = trackState.GetMomentum();
+    parameters.m_trackStateAtStart = trackState;
+    parameters.m_trackStateAtEnd = trackState;
+    parameters.m_trackStateAtCalorimeter = trackState;
+    parameters.m_timeAtCalorimeter = 0.f;
+    parameters.m_reachesCalorimeter = true;
+    parameters.m_isProjectedToEndCap = false;
+    parameters.m_canFormPfo = true;
+    parameters.m_canFormClusterlessPfo = false;
+    parameters.m_pParentAddress = pParentAddress;
+
+    return parameters;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+PandoraApi::Geometry::LArTPC::Parameters TestHelper::GetLArTPCParameters(const unsigned int volumeId, const CartesianVector &center,
+    const float width)
+{
+    PandoraApi::Geometry::LArTPC::Parameters parameters;
+    parameters.m_larTPCVolumeId = volumeId;
+    parameters.m_centerX = center.GetX();
+    parameters.m_centerY = center.GetY();
+    parameters.m_centerZ = center.GetZ();
+    parameters.m_widthX = width;
+    parameters.m_widthY = width;
+    parameters.m_widthZ = width;
+    parameters.m_wirePitchU = 3.f;
+    parameters.m_wirePitchV = 3.f;
+    parameters.m_wirePitchW = 3.f;
+    parameters.m_wireAngleU = 0.5f;
+    parameters.m_wireAngleV = -0.5f;
+    parameters.m_wireAngleW = 0.f;
+    parameters.m_sigmaUVW = 1.f;
+    parameters.m_isDriftInPositiveX = true;
+
+    return parameters;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+PandoraApi::Geometry::SubDetector::Parameters TestHelper::GetSubDetectorParameters(const std::string &name,
+    const SubDetectorType subDetectorType, const float innerR, const float innerZ, const unsigned int innerSymmetryOrder,
+    const float outerR, const float outerZ, const unsigned int outerSymmetryOrder)
+{
+    PandoraApi::Geometry::SubDetector::Parameters parameters;
+    parameters.m_subDetectorName = name;
+    parameters.m_subDetectorType = subDetectorType;
+    parameters.m_innerRCoordinate = innerR;
+    parameters.m_innerZCoordinate = innerZ;
+    parameters.m_innerPhiCoordinate = 0.1f;
+    parameters.m_innerSymmetryOrder = innerSymmetryOrder;
+    parameters.m_outerRCoordinate = outerR;
+    parameters.m_outerZCoordinate = outerZ;
+    parameters.m_outerPhiCoordinate = 0.f;
+    parameters.m_outerSymmetryOrder = outerSymmetryOrder;
+    parameters.m_isMirroredInZ = false;
+    parameters.m_nLayers = 0;
+
+    return parameters;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+PandoraContentApi::ParticleFlowObject::Parameters TestHelper::GetPfoParameters()
+{
+    PandoraContentApi::ParticleFlowObject::Parameters parameters;
+    parameters.m_particleId = 211;
+    parameters.m_charge = 1;
+    parameters.m_mass = 0.13957f;
+    parameters.m_energy = 1.f;
+    parameters.m_momentum = CartesianVector(0.f, 0.f, 1.f);
+
+    return parameters;
+}
+
+} // namespace pandora_test
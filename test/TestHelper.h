@@ -0,0 +1,216 @@
+/**
+ *  @file   PandoraSDK/test/TestHelper.h
+ * 
+ *  @brief  Header file for the test helper class.
+ * 
+ *  $Log: $
+ */
+#ifndef PANDORA_TEST_HELPER_H
+#define PANDORA_TEST_HELPER_H 1
+
+#include "Api/PandoraApi.h"
+#include "Api/PandoraContentApi.h"
+
+#include "TestAlgorithm.h"
+
+#include <string>
+
+namespace pandora_test
+{
+
+/**
+ *  @brief  TestHelper class, recording the outcome of the checks made by a test executable and providing the common test fixtures
+ */
+class TestHelper
+{
+public:
+    /**
+     *  @brief  Record the outcome of a check, reporting the first few failures
+     * 
+     *  @param  isPassed whether the check passed
+     *  @param  pExpression the checked expression
+     *  @param  pFileName the name of the file containing the check
+     *  @param  lineNumber the line number of the check
+     */
+    static void Check(const bool isPassed, const char *const pExpression, const char *const pFileName, const int lineNumber);
+
+    /**
+     *  @brief  Whether two values agree to within a tolerance, relative to their magnitudes where these exceed one
+     * 
+     *  @param  lhs the first value
+     *  @param  rhs the second value
+     *  @param  tolerance the tolerance
+     * 
+     *  @return boolean
+     */
+    static bool IsClose(const double lhs, const double rhs, const double tolerance);
+
+    /**
+     *  @brief  Report the test outcome
+     * 
+     *  @param  testName the test name
+     * 
+     *  @return the exit code for the test executable, zero if all checks passed
+     */
+    static int Finish(const std::string &testName);
+
+    /**
+     *  @brief  Get the status code with which a function exits, either by returning normally or by throwing a status code exception
+     * 
+     *  @param  function the function
+     * 
+     *  @return the status code
+     */
+    template <typename FUNCTION>
+    static pandora::StatusCode GetStatusCode(const FUNCTION &function);
+
+    /**
+     *  @brief  Write a file, e.g. a binary file for a test to read, replacing any existing file
+     * 
+     *  @param  fileName the file name
+     *  @param  contents the file contents
+     */
+    static void WriteFile(const std::string &fileName, const std::string &contents);
+
+    /**
+     *  @brief  Read pandora settings from a string, via a temporary xml file
+     * 
+     *  @param  pandora the pandora instance
+     *  @param  settings the xml settings
+     * 
+     *  @return the status code returned by PandoraApi::ReadSettings
+     */
+    static pandora::StatusCode ReadSettings(const pandora::Pandora &pandora, const std::string &settings);
+
+    /**
+     *  @brief  Get the xml settings running a single test algorithm
+     * 
+     *  @param  nThreads the number of threads pandora may use
+     *  @param  pluginSettings any plugin settings, e.g. "<BFieldPlugin>...</BFieldPlugin>"
+     * 
+     *  @return the xml settings
+     */
+    static std::string GetSettings(const unsigned int nThreads = 1, const std::string &pluginSettings = std::string());
+
+    /**
+     *  @brief  Register a test algorithm, of type TestAlgorithm::ALGORITHM_TYPE, with pandora
+     * 
+     *  @param  pandora the pandora instance
+     *  @param  runFunction the function to call for each event
+     * 
+     *  @return the status code
+     */
+    static pandora::StatusCode RegisterTestAlgorithm(const pandora::Pandora &pandora, const TestAlgorithm::RunFunction &runFunction);
+
+    /**
+     *  @brief  Create a pandora instance, with the default plugins, running a single test algorithm
+     * 
+     *  @param  runFunction the function for the test algorithm to call for each event
+     *  @param  nThreads the number of threads pandora may use
+     * 
+     *  @return the address of the pandora instance, to be deleted by the caller
+     */
+    static const pandora::Pandora *CreatePandora(const TestAlgorithm::RunFunction &runFunction, const unsigned int nThreads = 1);
+
+    /**
+     *  @brief  Get calo hit parameters with typical values, for a calo hit of unit energy
+     * 
+     *  @param  positionVector the calo hit position
+     *  @param  hitType the calo hit type
+     *  @param  pParentAddress the calo hit parent address
+     * 
+     *  @return the calo hit parameters
+     */
+    static PandoraApi::CaloHit::Parameters GetCaloHitParameters(const pandora::CartesianVector &positionVector,
+        const pandora::HitType hitType, const void *const pParentAddress);
+
+    /**
+     *  @brief  Get mc particle parameters with typical values, for an mc particle travelling along the z axis
+     * 
+     *  @param  particleId the pdg code
+     *  @param  energy the energy
+     *  @param  vertex the production vertex
+     *  @param  pParentAddress the mc particle parent address
+     * 
+     *  @return the mc particle parameters
+     */
+    static PandoraApi::MCParticle::Parameters GetMCParticleParameters(const int particleId, const float energy,
+        const pandora::CartesianVector &vertex, const void *const pParentAddress);
+
+    /**
+     *  @brief  Get track parameters with typical values, for a track with the same state at its start, end and calorimeter
+     * 
+     *  @param  charge the charge
+     *  @param  trackState the track state
+     *  @param  pParentAddress the track parent address
+     * 
+     *  @return the track parameters
+     */
+    static PandoraApi::Track::Parameters GetTrackParameters(const int charge, const pandora::TrackState &trackState,
+        const void *const pParentAddress);
+
+    /**
+     *  @brief  Get lar tpc parameters with typical values, for a cubic lar tpc
+     * 
+     *  @param  volumeId the lar tpc volume id
+     *  @param  center the lar tpc center
+     *  @param  width the lar tpc width in x, y and z
+     * 
+     *  @return the lar tpc parameters
+     */
+    static PandoraApi::Geometry::LArTPC::Parameters GetLArTPCParameters(const unsigned int volumeId, const pandora::CartesianVector &center,
+        const float width);
+
+    /**
+     *  @brief  Get sub detector parameters with typical values, for a sub detector without layers that is not mirrored in z
+     * 
+     *  @param  name the sub detector name
+     *  @param  subDetectorType the sub detector type
+     *  @param  innerR the inner r coordinate
+     *  @param  innerZ the inner z coordinate
+     *  @param  innerSymmetryOrder the inner symmetry order
+     *  @param  outerR the outer r coordinate
+     *  @param  outerZ the outer z coordinate
+     *  @param  outerSymmetryOrder the outer symmetry order
+     * 
+     *  @return the sub detector parameters
+     */
+    static PandoraApi::Geometry::SubDetector::Parameters GetSubDetectorParameters(const std::string &name,
+        const pandora::SubDetectorType subDetectorType, const float innerR, const float innerZ, const unsigned int innerSymmetryOrder,
+        const float outerR, const float outerZ, const unsigned int outerSymmetryOrder);
+
+    /**
+     *  @brief  Get pfo parameters with typical values, for a charged pion along the z axis, without any clusters, tracks or vertices
+     * 
+     *  @return the pfo parameters
+     */
+    static PandoraContentApi::ParticleFlowObject::Parameters GetPfoParameters();
+
+private:
+    static unsigned int     m_nChecks;              ///< The number of checks made
+    static unsigned int     m_nFailures;            ///< The number of failed checks
+    static unsigned int     m_nSettingsFiles;       ///< The number of temporary settings files written
+
+    static const unsigned int MAX_REPORTED_FAILURES = 20;   ///< The maximum number of failed checks to report individually
+};
+
+#define PANDORA_TEST_CHECK(expression) pandora_test::TestHelper::Check((expression), #expression, __FILE__, __LINE__)
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename FUNCTION>
+inline pandora::StatusCode TestHelper::GetStatusCode(const FUNCTION &function)
+{
+    try
+    {
+        return function();
+    }
+    catch (const pandora::StatusCodeException &statusCodeException)
+    {
+        return statusCodeException.GetStatusCode();
+    }
+}
+
+} // namespace pandora_test
+
+#endif // #ifndef PANDORA_TEST_HELPER_H
@@ -0,0 +1,105 @@
+/**
+ *  @file   PandoraSDK/test/TestPlugins.cc
+ * 
+ *  @brief  Implementation of the plugins shared by the tests.
+ * 
+ *  $Log: $
+ */
+
+#include "Objects/CartesianVector.h"
+
+#include "Pandora/StatusCodes.h"
+
+#include "Xml/tinyxml.h"
+
+#include "TestPlugins.h"
+
+using namespace pandora;
+
+namespace pandora_test
+{
+
+TestBFieldPlugin::TestBFieldPlugin(const float bField) :
+    m_bField(bField)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+float TestBFieldPlugin::GetBField(const CartesianVector &/*positionVector*/) const
+{
+    return m_bField;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode TestBFieldPlugin::ReadSettings(const TiXmlHandle /*xmlHandle*/)
+{
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+TestPseudoLayerPlugin::TestPseudoLayerPlugin(const float layerThickness, const float maxDistance, const bool isThreadSafe) :
+    m_layerThickness(layerThickness),
+    m_maxDistance(maxDistance),
+    m_isThreadSafe(isThreadSafe),
+    m_nCalls(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int TestPseudoLayerPlugin::GetPseudoLayer(const CartesianVector &positionVector) const
+{
+    ++m_nCalls;
+
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_threadIds.insert(std::this_thread::get_id());
+    }
+
+    if (positionVector.GetMagnitude() > m_maxDistance)
+        throw StatusCodeException(STATUS_CODE_OUT_OF_RANGE);
+
+    return (1 + static_cast<unsigned int>(positionVector.GetMagnitude() / m_layerThickness));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int TestPseudoLayerPlugin::GetPseudoLayerAtIp() const
+{
+    return 1;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool TestPseudoLayerPlugin::IsThreadSafe() const
+{
+    return m_isThreadSafe;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int TestPseudoLayerPlugin::GetNCalls() const
+{
+    return m_nCalls;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+TestPseudoLayerPlugin::ThreadIdSet TestPseudoLayerPlugin::GetThreadIds() const
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    return m_threadIds;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode TestPseudoLayerPlugin::ReadSettings(const TiXmlHandle /*xmlHandle*/)
+{
+    return STATUS_CODE_SUCCESS;
+}
+
+} // namespace pandora_test
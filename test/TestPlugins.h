@@ -0,0 +1,95 @@
+/**
+ *  @file   PandoraSDK/test/TestPlugins.h
+ * 
+ *  @brief  Header file for the plugins shared by the tests.
+ * 
+ *  $Log: $
+ */
+#ifndef PANDORA_TEST_PLUGINS_H
+#define PANDORA_TEST_PLUGINS_H 1
+
+#include "Plugins/BFieldPlugin.h"
+#include "Plugins/PseudoLayerPlugin.h"
+
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace pandora_test
+{
+
+/**
+ *  @brief  TestBFieldPlugin class, providing a uniform bfield
+ */
+class TestBFieldPlugin : public pandora::BFieldPlugin
+{
+public:
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  bField the bfield, units Tesla
+     */
+    TestBFieldPlugin(const float bField);
+
+    float GetBField(const pandora::CartesianVector &positionVector) const;
+
+private:
+    pandora::StatusCode ReadSettings(const pandora::TiXmlHandle xmlHandle);
+
+    const float                 m_bField;           ///< The bfield, units Tesla
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  TestPseudoLayerPlugin class, assigning pseudo layers by distance from the origin and recording the calls made to it
+ */
+class TestPseudoLayerPlugin : public pandora::PseudoLayerPlugin
+{
+public:
+    typedef std::set<std::thread::id> ThreadIdSet;
+
+    /**
+     *  @brief  Constructor
+     * 
+     *  @param  layerThickness the distance from the origin spanned by each pseudo layer
+     *  @param  maxDistance the maximum distance from the origin, beyond which the pseudo layer calculation fails
+     *  @param  isThreadSafe whether the plugin declares itself thread safe
+     */
+    TestPseudoLayerPlugin(const float layerThickness = 10.f, const float maxDistance = std::numeric_limits<float>::max(),
+        const bool isThreadSafe = true);
+
+    unsigned int GetPseudoLayer(const pandora::CartesianVector &positionVector) const;
+    unsigned int GetPseudoLayerAtIp() const;
+    bool IsThreadSafe() const;
+
+    /**
+     *  @brief  Get the number of pseudo layer calculations requested, including those that failed
+     * 
+     *  @return the number of pseudo layer calculations
+     */
+    unsigned int GetNCalls() const;
+
+    /**
+     *  @brief  Get the ids of the threads that have requested pseudo layer calculations
+     * 
+     *  @return the thread ids
+     */
+    ThreadIdSet GetThreadIds() const;
+
+private:
+    pandora::StatusCode ReadSettings(const pandora::TiXmlHandle xmlHandle);
+
+    const float                         m_layerThickness;   ///< The distance from the origin spanned by each pseudo layer
+    const float                         m_maxDistance;      ///< The maximum distance from the origin, beyond which the calculation fails
+    const bool                          m_isThreadSafe;     ///< Whether the plugin declares itself thread safe
+    mutable std::atomic<unsigned int>   m_nCalls;           ///< The number of pseudo layer calculations requested
+    mutable ThreadIdSet                 m_threadIds;        ///< The ids of the threads that have requested pseudo layer calculations
+    mutable std::mutex                  m_mutex;            ///< The mutex guarding the thread ids
+};
+
+} // namespace pandora_test
+
+#endif // #ifndef PANDORA_TEST_PLUGINS_H
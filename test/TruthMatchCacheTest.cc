@@ -0,0 +1,215 @@
+/**
+ *  @file   PandoraSDK/test/TruthMatchCacheTest.cc
+ * 
+ *  @brief  Test that the truth match cache gives the same truth matches serially and in parallel, and recalculates only outdated matches.
+ * 
+ *  $Log: $
+ */
+
+#include "Pandora/AlgorithmHeaders.h"
+
+#include "TestHelper.h"
+
+#include <random>
+
+using namespace pandora;
+using namespace pandora_test;
+
+/**
+ *  @brief  Whether two truth matches are identical
+ * 
+ *  @param  lhs the first truth match
+ *  @param  rhs the second truth match
+ * 
+ *  @return boolean
+ */
+bool IsIdentical(const TruthMatch &lhs, const TruthMatch &rhs)
+{
+    const MCParticleWeightMap &lhsWeightMap(lhs.GetMCParticleWeightMap()), &rhsWeightMap(rhs.GetMCParticleWeightMap());
+
+    return ((lhs.GetMainMCParticle() == rhs.GetMainMCParticle()) && (lhs.GetMainMCParticleWeight() == rhs.GetMainMCParticleWeight()) &&
+        (lhs.GetTotalWeight() == rhs.GetTotalWeight()) && (lhsWeightMap.size() == rhsWeightMap.size()) &&
+        std::equal(lhsWeightMap.begin(), lhsWeightMap.end(), rhsWeightMap.begin()));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Cluster the input calo hits randomly and check the serial and parallel truth matches for the clusters and for pfos
+ * 
+ *  @param  algorithm the calling algorithm
+ * 
+ *  @return the status code
+ */
+StatusCode CheckTruthMatches(const Algorithm &algorithm)
+{
+    const CaloHitList *pCaloHitList(nullptr);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::GetCurrentList(algorithm, pCaloHitList));
+
+    std::mt19937 generator(7);
+    const unsigned int nClusters(100);
+    std::vector<CaloHitList> clusterCaloHitLists(nClusters);
+
+    for (const CaloHit *const pCaloHit : *pCaloHitList)
+        clusterCaloHitLists[generator() % nClusters].push_back(pCaloHit);
+
+    const ClusterList *pClusterList(nullptr);
+    std::string clusterListName;
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::CreateTemporaryListAndSetCurrent(algorithm, pClusterList,
+        clusterListName));
+
+    // Hold back one calo hit from the first cluster, to be added later
+    const CaloHit *const pHeldBackCaloHit(clusterCaloHitLists.front().back());
+    clusterCaloHitLists.front().pop_back();
+
+    for (const CaloHitList &caloHitList : clusterCaloHitLists)
+    {
+        PandoraContentApi::Cluster::Parameters parameters;
+        parameters.m_caloHitList = caloHitList;
+
+        const Cluster *pCluster(nullptr);
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::Cluster::Create(algorithm, parameters, pCluster));
+    }
+
+    const ClusterList clusterList(*pClusterList);
+    PANDORA_TEST_CHECK(nClusters == clusterList.size());
+
+    // Serial truth matches, then parallel truth matches for a list in which some clusters appear several times, each calculated once
+    TruthMatchCache serialTruthMatchCache, parallelTruthMatchCache;
+    serialTruthMatchCache.CalculateTruthMatches(clusterList, 1);
+
+    ClusterList duplicatedClusterList(clusterList);
+    duplicatedClusterList.insert(duplicatedClusterList.end(), clusterList.begin(), clusterList.end());
+    duplicatedClusterList.push_back(clusterList.front());
+
+    for (unsigned int iRepeat = 0; iRepeat < 20; ++iRepeat)
+    {
+        parallelTruthMatchCache.Clear();
+        parallelTruthMatchCache.CalculateTruthMatches(duplicatedClusterList, 4);
+        PANDORA_TEST_CHECK(clusterList.size() == parallelTruthMatchCache.GetNCacheMisses());
+        PANDORA_TEST_CHECK(clusterList.size() + 1 == parallelTruthMatchCache.GetNCacheHits());
+
+        for (const Cluster *const pCluster : clusterList)
+        {
+            const TruthMatch &serialTruthMatch(serialTruthMatchCache.GetTruthMatch(pCluster));
+            PANDORA_TEST_CHECK(IsIdentical(serialTruthMatch, parallelTruthMatchCache.GetTruthMatch(pCluster)));
+            PANDORA_TEST_CHECK(serialTruthMatch.GetMainMCParticle() == MCParticleHelper::GetMainMCParticle(pCluster));
+        }
+    }
+
+    // Only a cluster whose content has changed is recalculated
+    const unsigned int nCacheMisses(serialTruthMatchCache.GetNCacheMisses()), nCacheHits(serialTruthMatchCache.GetNCacheHits());
+    PANDORA_TEST_CHECK(clusterList.size() == nCacheMisses);
+
+    const Cluster *const pChangedCluster(clusterList.front());
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::AddToCluster(algorithm, pChangedCluster, pHeldBackCaloHit));
+    serialTruthMatchCache.CalculateTruthMatches(clusterList, 1);
+    PANDORA_TEST_CHECK(nCacheMisses + 1 == serialTruthMatchCache.GetNCacheMisses());
+    PANDORA_TEST_CHECK(nCacheHits + clusterList.size() - 1 == serialTruthMatchCache.GetNCacheHits());
+
+    TruthMatchCache newTruthMatchCache;
+    const TruthMatch &newTruthMatch(newTruthMatchCache.GetTruthMatch(pChangedCluster));
+    PANDORA_TEST_CHECK(IsIdentical(newTruthMatch, serialTruthMatchCache.GetTruthMatch(pChangedCluster)));
+
+    // Pfos, each holding several clusters
+    const PfoList *pPfoList(nullptr);
+    std::string pfoListName;
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::CreateTemporaryListAndSetCurrent(algorithm, pPfoList,
+        pfoListName));
+
+    ClusterList::const_iterator clusterIter(clusterList.begin());
+
+    while (clusterList.end() != clusterIter)
+    {
+        PandoraContentApi::ParticleFlowObject::Parameters parameters(TestHelper::GetPfoParameters());
+
+        for (unsigned int iCluster = 0; (iCluster < 3) && (clusterList.end() != clusterIter); ++iCluster)
+            parameters.m_clusterList.push_back(*(clusterIter++));
+
+        const ParticleFlowObject *pPfo(nullptr);
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::ParticleFlowObject::Create(algorithm, parameters, pPfo));
+    }
+
+    TruthMatchCache::PfoToTruthMatchMap serialPfoToTruthMatchMap, parallelPfoToTruthMatchMap;
+    serialTruthMatchCache.CalculateTruthMatches(*pPfoList, 1, serialPfoToTruthMatchMap);
+    parallelTruthMatchCache.Clear();
+    parallelTruthMatchCache.CalculateTruthMatches(*pPfoList, 4, parallelPfoToTruthMatchMap);
+
+    PANDORA_TEST_CHECK(pPfoList->size() == serialPfoToTruthMatchMap.size());
+    PANDORA_TEST_CHECK(pPfoList->size() == parallelPfoToTruthMatchMap.size());
+
+    for (const ParticleFlowObject *const pPfo : *pPfoList)
+    {
+        TruthMatch truthMatch;
+        serialTruthMatchCache.GetTruthMatch(pPfo, truthMatch);
+        PANDORA_TEST_CHECK(serialPfoToTruthMatchMap.count(pPfo) && parallelPfoToTruthMatchMap.count(pPfo));
+
+        if (!serialPfoToTruthMatchMap.count(pPfo) || !parallelPfoToTruthMatchMap.count(pPfo))
+            continue;
+
+        PANDORA_TEST_CHECK(IsIdentical(truthMatch, serialPfoToTruthMatchMap.at(pPfo)));
+        PANDORA_TEST_CHECK(IsIdentical(truthMatch, parallelPfoToTruthMatchMap.at(pPfo)));
+        PANDORA_TEST_CHECK(truthMatch.GetMainMCParticle() == MCParticleHelper::GetMainMCParticle(&pPfo->GetClusterList()));
+    }
+
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::SaveList<Cluster>(algorithm, clusterListName, "TestClusters"));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::SaveList<Pfo>(algorithm, pfoListName, "TestPfos"));
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  Test the truth match cache, for calo hits with several contributing mc particles
+ */
+void TestTruthMatchCache()
+{
+    const Pandora *const pPandora(TestHelper::CreatePandora(CheckTruthMatches));
+
+    std::mt19937 generator(8);
+    std::uniform_real_distribution<float> distribution(0.f, 1.f);
+    const unsigned int nMCParticles(20), nCaloHits(2000);
+    std::vector<int> mcParticleAddresses(nMCParticles), caloHitAddresses(nCaloHits);
+
+    for (unsigned int iMCParticle = 0; iMCParticle < nMCParticles; ++iMCParticle)
+    {
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::MCParticle::Create(*pPandora, TestHelper::GetMCParticleParameters(
+            (0 == iMCParticle) ? 14 : 211, 1.f + iMCParticle, CartesianVector(static_cast<float>(iMCParticle), 0.f, 0.f),
+            &mcParticleAddresses[iMCParticle])));
+
+        if (iMCParticle > 0)
+        {
+            PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetMCParentDaughterRelationship(*pPandora, &mcParticleAddresses[0],
+                &mcParticleAddresses[iMCParticle]));
+        }
+    }
+
+    for (unsigned int iCaloHit = 0; iCaloHit < nCaloHits; ++iCaloHit)
+    {
+        PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::CaloHit::Create(*pPandora, TestHelper::GetCaloHitParameters(
+            CartesianVector(100.f * distribution(generator), 0.f, 100.f * distribution(generator)), TPC_3D, &caloHitAddresses[iCaloHit])));
+
+        // Several contributing mc particles per calo hit, with weights chosen to produce some equal weight sums
+        for (unsigned int iContribution = 0; iContribution < 3; ++iContribution)
+        {
+            const unsigned int iMCParticle(1 + generator() % (nMCParticles - 1));
+            PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::SetCaloHitToMCParticleRelationship(*pPandora, &caloHitAddresses[iCaloHit],
+                &mcParticleAddresses[iMCParticle], 0.25f * (1 + generator() % 4)));
+        }
+    }
+
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::ProcessEvent(*pPandora));
+    PANDORA_TEST_CHECK(STATUS_CODE_SUCCESS == PandoraApi::Reset(*pPandora));
+
+    delete pPandora;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    TestTruthMatchCache();
+
+    return TestHelper::Finish("TruthMatchCacheTest");
+}